@@ -66,6 +66,8 @@
 #define dCrgCpOptionCheckEps            15       /* [double],  expected min. accuracy                                                     [m] */
 #define dCrgCpOptionCheckInc            16       /* [double],  expected min. increment                                                    [m] */
 #define dCrgCpOptionCheckTol            17       /* [double],  expected abs. tolerance                                                    [m] */
+#define dCrgCpOptionRefLinePredict      18       /* [integer], start the search on the reference line at the interval predicted               */
+                                                 /*            from the u velocity of the previous queries                              [0/1] */
 
 /**
 * Mode definitions for option: dCrgCpOptionBorderModeU
@@ -117,12 +119,29 @@
 #define dCrgModRefLineOffsetPhi    42     /* [double], rotation applied on reference line                           [rad] */
 #define dCrgModRefLineRotCenterX   43     /* [double], rotation center on reference line                              [m] */
 #define dCrgModRefLineRotCenterY   44     /* [double], rotation center on reference line                              [m] */
+#define dCrgModFilterMode          45     /* [int],    filter applied to the grid data z values, see dCrgFilterXXX    [-] */
+#define dCrgModFilterSizeU         46     /* [int],    size of the filter mask in u direction                         [-] */
+#define dCrgModFilterSizeV         47     /* [int],    size of the filter mask in v direction                         [-] */
+#define dCrgModFilterWeight        48     /* [double], weight of the filter mask                                      [-] */
+#define dCrgModFilterRepeat        49     /* [int],    number of times the filter is applied                          [-] */
+#define dCrgModFilterUBegin        50     /* [double], start of the filtered range in u direction                     [m] */
+#define dCrgModFilterUEnd          51     /* [double], end of the filtered range in u direction                       [m] */
+#define dCrgModFilterVBegin        52     /* [double], start of the filtered range in v direction                     [m] */
+#define dCrgModFilterVEnd          53     /* [double], end of the filtered range in v direction                       [m] */
+#define dCrgModLimitZMin           54     /* [double], lower limit of the grid data z values                          [m] */
+#define dCrgModLimitZMax           55     /* [double], upper limit of the grid data z values                          [m] */
+#define dCrgModPeakLimit           56     /* [double], threshold of the peak detection, detected peaks are limited    [-] */
+#define dCrgModPeakRadius          57     /* [int],    radius of the window used for the peak detection               [-] */
+#define dCrgModLimitUBegin         58     /* [double], start of the limited range in u direction                      [m] */
+#define dCrgModLimitUEnd           59     /* [double], end of the limited range in u direction                        [m] */
+#define dCrgModLimitVBegin         60     /* [double], start of the limited range in v direction                      [m] */
+#define dCrgModLimitVEnd           61     /* [double], end of the limited range in v direction                        [m] */
 
 /**
 * define size of option / modifier structure for contact point and data set structure
 * NOTE: this must be at least be " 1 + MAX( dCrgCpOptionXXX, dCrgModXXX ) "
 */
-#define dCrgSizeOptList            50   /* size of option / modifier list [-] */
+#define dCrgSizeOptList            62   /* size of option / modifier list [-] */
 
 /**
 * Mode definitions for modifier: dCrgModGridNaNMode
@@ -131,12 +150,55 @@
 #define dCrgGridNaNSetZero          1   /* replace NaNs with zeros            */
 #define dCrgGridNaNKeepLast         2   /* keep last valid boundary value     */      /* default */
 
+/**
+* Mode definitions for modifier: dCrgModFilterMode
+*/
+#define dCrgFilterNone              0   /* no filter                                                      */      /* default */
+#define dCrgFilterMean              1   /* mean value of the mask                                         */
+#define dCrgFilterGauss             2   /* binomial smoothing in u and v direction                        */
+#define dCrgFilterSobel             3   /* first derivative in u, binomial smoothing in v, added to z     */
+#define dCrgFilter2Diff             4   /* second derivative in u, binomial smoothing in v, added to z    */
+#define dCrgFilterLaplace           5   /* second derivative in u and v direction, added to z             */
+#define dCrgFilterMask              6   /* mask set by crgDataSetModifierSetFilterMask()                  */
+
 /**
 * Mode definitions for modifier: dCrgModRefPointOrient
 */
 #define dCrgOrientFwd               0   /* forward orientation                */
 #define dCrgOrientRev               1   /* reverse orientation                */
 
+/**
+* Memory layout of the elevation grid, to be selected before loading a file
+*/
+#define dCrgGridLayoutRows          0   /* one allocation per v channel               */      /* default */
+#define dCrgGridLayoutContiguous    1   /* all v channels in one cache aligned block  */
+
+/**
+* Access method for the file data, to be selected before loading a file
+*/
+#define dCrgFileAccessBuffered      0   /* read complete file into heap buffer        */
+#define dCrgFileAccessMapped        1   /* map file into memory (where supported)     */      /* default */
+
+/**
+* Format of the data section of a CRG file written by crgDataSetWrite()
+*/
+#define dCrgFileFormatBinarySingle  0   /* KRBI: kernel, real, binary                 */
+#define dCrgFileFormatBinaryDouble  1   /* KDBI: kernel, double, binary               */
+#define dCrgFileFormatAsciiSingle   2   /* LRFI: long, real, formatted                */
+#define dCrgFileFormatAsciiDouble   3   /* LDFI: long, double, formatted              */
+
+/**
+* Index definitions for the statistics of a contact patch, see crgEvalPatch()
+*/
+#define dCrgPatchStatZMin           0   /* minimum elevation                                   [m] */
+#define dCrgPatchStatZMax           1   /* maximum elevation                                   [m] */
+#define dCrgPatchStatZMean          2   /* mean elevation (fitted plane at center)             [m] */
+#define dCrgPatchStatSlopeLength    3   /* slope of the fitted plane along the patch length    [-] */
+#define dCrgPatchStatSlopeWidth     4   /* slope of the fitted plane across the patch width    [-] */
+#define dCrgPatchStatZEnvelope      5   /* center height of the fitted plane resting on the    [m] */
+                                        /* highest sample (enveloped height)                       */
+#define dCrgPatchStatSize           6   /* number of statistics values                         [-] */
+
 /* ====== TYPE DEFINITIONS ====== */
 
 /* ====== METHODS in crgMgr.c ====== */
@@ -280,6 +342,38 @@
     */
     extern void crgDataSetModifierSetDefault( int dataSetId );
     
+    /**
+    * set a filter mask to be applied to the grid data z values as a convolution
+    * (i.e. with the mask mirrored), and select it by the modifiers dCrgModFilterMode,
+    * dCrgModFilterSizeU and dCrgModFilterSizeV; weight, repetitions and range are
+    * taken from the remaining filter modifiers when the modifiers are applied
+    * @param  dataSetId    identifier of the applicable dataset
+    * @param  mask         sizeV rows of sizeU coefficients each, the coefficient for
+    *                      the offsets iu and iv is mask[iv * sizeU + iu]
+    * @param  sizeU        size of the mask in u direction
+    * @param  sizeV        size of the mask in v direction
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataSetModifierSetFilterMask( int dataSetId, const double* mask, int sizeU, int sizeV );
+    
+    /**
+    * detect peaks of the grid data z values as crg_peakfinder.m does: samples whose
+    * laplacian of the absolute values exceeds the threshold are candidates; within a
+    * window around each candidate, samples whose absolute value exceeds twice the
+    * median of the window (at least 0.05m) are peaks. The range is given by the
+    * modifiers dCrgModLimitUBegin, dCrgModLimitUEnd, dCrgModLimitVBegin and
+    * dCrgModLimitVEnd, it defaults to the complete grid.
+    * @param  dataSetId    identifier of the applicable dataset
+    * @param  threshold    threshold of the laplacian, crg_peakfinder.m uses 0.5
+    * @param  radius       radius of the window around a candidate, crg_peakfinder.m uses 3
+    * @param  u            receives the u positions of the peaks, may be NULL       [m]
+    * @param  v            receives the v positions of the peaks, may be NULL       [m]
+    * @param  z            receives the grid data z values of the peaks, may be NULL [m]
+    * @param  maxPeaks     maximum number of peaks stored, sorted by u and v
+    * @return total number of peaks, -1 on error
+    */
+    extern int crgDataSetGetPeaks( int dataSetId, double threshold, int radius, double* u, double* v, double* z, int maxPeaks );
+    
     /**
     * set the default options for a data set; these will be transfered to
     * contact points which are derived from the data set
@@ -355,8 +449,96 @@
     * @return identifier of the resulting data set or 0 if not successful
     */
     extern int crgLoaderReadFile( const char* filename );
+
+    /**
+    * read the header of a CRG file without its data section, e.g. for querying
+    * the u and v ranges, the increments or the road information of many files;
+    * the number of cross sections follows from the size of the data section of
+    * binary files or from the u range given by the header of ASCII files, only
+    * the first and last records of binary files with a u channel are read;
+    * files whose reference line is given by x/y data are loaded completely;
+    * the resulting data set cannot be evaluated before crgLoaderReadData()
+    * @param filename   full filename of the CRG input file including path
+    * @return identifier of the resulting data set or 0 if not successful
+    */
+    extern int crgLoaderReadHeader( const char* filename );
+
+    /**
+    * load the data of a data set which has been created by crgLoaderReadHeader();
+    * the identifier, the options and the modifiers of the data set are kept
+    * @param dataSetId  identifier of the applicable dataset
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgLoaderReadData( int dataSetId );
+
+    /**
+    * set the memory layout of the elevation grid for data sets loaded afterwards
+    * @param layout     memory layout [dCrgGridLayoutRows, dCrgGridLayoutContiguous]
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgLoaderSetGridLayout( int layout );
+    
+    /**
+    * set the method for accessing the file data of data sets loaded afterwards;
+    * memory mapping falls back to buffered reading where it is not available
+    * @param mode       access method [dCrgFileAccessBuffered, dCrgFileAccessMapped]
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgLoaderSetFileAccess( int mode );
+    
+    /**
+    * set the number of threads decoding the data section of ASCII files loaded
+    * afterwards; the data is split into record aligned chunks of at least 4 MB;
+    * the grid filter modifiers use the same number of threads
+    * @param noThreads  number of threads, 0 for one thread per processor (default)
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgLoaderSetNoThreads( int noThreads );
+    
+    /**
+    * set the quantization of the elevation grid of CRG files loaded afterwards;
+    * the samples are stored as 16 bit integers with an offset and a scale per
+    * block of 64 x 64 samples and dequantized during the evaluation; a file whose
+    * samples cannot be represented within the given error keeps its float grid;
+    * modifiers which alter the grid re-quantize it within the remaining error,
+    * modifiers placing a reference point refer to the quantized surface
+    * @param maxError   maximum deviation of a sample from its float value, 0 = off (default) [m]
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgLoaderSetGridQuantization( double maxError );
+
+    /**
+    * stream the elevation grid of binary files loaded subsequently instead of
+    * keeping it in memory; only the cross sections around the positions which
+    * have been evaluated recently stay resident, a background thread reads the
+    * road ahead of them; evaluations read resident pages without a lock and
+    * wait for the file on a miss only, see crgDataSetGetStreamStat(); ASCII
+    * files are always loaded completely
+    * @param uBehind  length of the road kept behind the evaluated positions     [m]
+    * @param uAhead   length of the road read ahead of the evaluated positions   [m]
+    *                 (0 for both = keep the complete grid in memory, default)
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgLoaderSetStreaming( double uBehind, double uAhead );
     
 /* ====== METHODS in crgContactPoint.c ====== */
+    /*
+    * thread safety of contact points and evaluations:
+    * - data sets may be evaluated from any number of threads at the same time
+    *   as long as they are not modified (no modifiers applied, no options set,
+    *   not released) while evaluations are running
+    * - a contact point holds the history and the results of its queries; it
+    *   must not be used by more than one thread at a time, so each thread (or
+    *   each wheel) shall work with contact points of its own
+    * - contact points may be created and deleted while other threads evaluate;
+    *   the evaluation itself takes no locks; on a streamed grid, it locks the
+    *   data set only on a miss and at its first access to a page after the
+    *   prefetch thread has looked ahead, see crgLoaderSetStreaming()
+    * - performance statistics are counted per contact point
+    * - global settings (message level, kernels, memory callbacks) shall be made
+    *   before the threads start evaluating
+    */
+
     /**
     * create a new contact point working on the indicated data set
     * @param  dataSetId index of data set which is to be used
@@ -471,6 +653,20 @@
     * @return 1 if successful, otherwise 0
     */
     extern int crgEvalxy2uv( int cpId, double x, double y, double* u, double* v );
+
+    /**
+    * convert an array of (x,y) positions into the corresponding (u,v) positions;
+    * positions which are close to each other (e.g. a tire patch) share the search
+    * for the reference line interval and the history is updated once per batch
+    * @param cpId  id of the contact point to use for the query
+    * @param n     number of positions
+    * @param x     array of x co-ordinates
+    * @param y     array of y co-ordinates
+    * @param u     array of resulting u co-ordinates
+    * @param v     array of resulting v co-ordinates
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvalxy2uvBatch( int cpId, int n, const double* x, const double* y, double* u, double* v );
          
 /* ====== METHODS in crgEvaluv2xy.c ====== */
     /**
@@ -495,6 +691,20 @@
     */
     extern int crgEvaluv2z( int cpId, double u, double v, double* z );
 
+    /**
+    * compute the z values at an array of (u,v) positions using bilinear interpolation;
+    * the contact point and its options are resolved once for the whole batch and the
+    * results are identical to those of successive calls of crgEvaluv2z()
+    * @param cpId    id of the contact point to use for the query
+    * @param n       number of positions
+    * @param u       array of u co-ordinates
+    * @param v       array of v co-ordinates
+    * @param z       array of resulting z co-ordinates
+    * @param status  array of resulting status per position (1 = ok, 0 = error), may be NULL
+    * @return 1 if successful for all positions, otherwise 0
+    */
+    extern int crgEvaluv2zBatch( int cpId, int n, const double* u, const double* v, double* z, int* status );
+
     /**
     * compute the z value at a given (x,y) position using bilinear interpolation
     * @param cpId  id of the contact point to use for the query
@@ -504,6 +714,64 @@
     * @return 1 if successful, otherwise 0
     */
     extern int crgEvalxy2z( int cpId, double x, double y, double* z );
+
+    /**
+    * compute the z value at a given (u,v) position together with its analytic
+    * derivatives by u and v and the inertial normal of the surface; the normal
+    * follows the mapping of (u,v) to (x,y) along the reference line
+    * @param cpId  id of the contact point to use for the query
+    * @param u     u co-ordinate
+    * @param v     v co-ordinate
+    * @param z     pointer to resulting z co-ordinate
+    * @param dzdu  pointer to resulting derivative of z by u, may be NULL
+    * @param dzdv  pointer to resulting derivative of z by v, may be NULL
+    * @param nrm   array of 3 values for the resulting unit normal (x, y, z), may be NULL
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvaluv2zn( int cpId, double u, double v, double* z, double* dzdu, double* dzdv, double* nrm );
+
+    /**
+    * compute z values, derivatives and surface normals at an array of (u,v) positions
+    * @param cpId    id of the contact point to use for the query
+    * @param n       number of positions
+    * @param u       array of u co-ordinates
+    * @param v       array of v co-ordinates
+    * @param z       array of resulting z co-ordinates
+    * @param dzdu    array of resulting derivatives of z by u, may be NULL
+    * @param dzdv    array of resulting derivatives of z by v, may be NULL
+    * @param nrm     array of 3 * n values for the resulting unit normals, may be NULL
+    * @param status  array of resulting status per position (1 = ok, 0 = error), may be NULL
+    * @return 1 if successful for all positions, otherwise 0
+    */
+    extern int crgEvaluv2znBatch( int cpId, int n, const double* u, const double* v, double* z, double* dzdu, double* dzdv, double* nrm, int* status );
+
+    /**
+    * compute the z value, its derivatives by u and v and the surface normal at a given (x,y) position
+    * @param cpId  id of the contact point to use for the query
+    * @param x     x co-ordinate
+    * @param y     y co-ordinate
+    * @param z     pointer to resulting z co-ordinate
+    * @param dzdu  pointer to resulting derivative of z by u, may be NULL
+    * @param dzdv  pointer to resulting derivative of z by v, may be NULL
+    * @param nrm   array of 3 values for the resulting unit normal (x, y, z), may be NULL
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvalxy2zn( int cpId, double x, double y, double* z, double* dzdu, double* dzdv, double* nrm );
+
+    /**
+    * compute z values, derivatives and surface normals at an array of (x,y) positions;
+    * the positions are converted with the batch search of crgEvalxy2uvBatch()
+    * @param cpId  id of the contact point to use for the query
+    * @param n     number of positions
+    * @param x     array of x co-ordinates
+    * @param y     array of y co-ordinates
+    * @param z     array of resulting z co-ordinates
+    * @param dzdu  array of resulting derivatives of z by u, may be NULL
+    * @param dzdv  array of resulting derivatives of z by v, may be NULL
+    * @param nrm   array of 3 * n values for the resulting unit normals, may be NULL
+    * @return 1 if successful for all positions, otherwise 0
+    */
+    extern int crgEvalxy2znBatch( int cpId, int n, const double* x, const double* y, double* z, double* dzdu, double* dzdv, double* nrm );
       
 /* ====== METHODS in crgEvalpk.c ====== */
     /**
@@ -530,6 +798,164 @@
     */
     extern int crgEvalxy2pk( int cpId, double x, double y, double* phi, double* curv );
       
+/* ====== METHODS in crgEvalxy2all.c ====== */
+    /**
+    * convert a given (x,y) position into the corresponding (u,v) position and
+    * compute elevation, heading and curvature at this position in one call; the
+    * results are identical to those of crgEvalxy2uv(), crgEvaluv2z() and
+    * crgEvaluv2pk() but the u interval is determined only once
+    * @param cpId  id of the contact point to use for the query
+    * @param x     x co-ordinate
+    * @param y     y co-ordinate
+    * @param u     pointer to resulting u co-ordinate
+    * @param v     pointer to resulting v co-ordinate
+    * @param z     pointer to resulting z co-ordinate
+    * @param phi   pointer to resulting heading angle
+    * @param curv  pointer to resulting curvature
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvalxy2all( int cpId, double x, double y, double* u, double* v, double* z, double* phi, double* curv );
+
+    /**
+    * evaluate an array of (x,y) positions like crgEvalxy2all(); the positions are
+    * converted with crgEvalxy2uvBatch() and their elevations with crgEvaluv2zBatch()
+    * @param cpId  id of the contact point to use for the query
+    * @param n     number of positions
+    * @param x     array of x co-ordinates
+    * @param y     array of y co-ordinates
+    * @param u     array of resulting u co-ordinates
+    * @param v     array of resulting v co-ordinates
+    * @param z     array of resulting z co-ordinates
+    * @param phi   array of resulting heading angles
+    * @param curv  array of resulting curvatures
+    * @return 1 if successful for all positions, otherwise 0
+    */
+    extern int crgEvalxy2allBatch( int cpId, int n, const double* x, const double* y, double* u, double* v, double* z, double* phi, double* curv );
+      
+/* ====== METHODS in crgEvalPatch.c ====== */
+    /**
+    * evaluate the elevation on a rectangular contact patch, e.g. under a tire;
+    * only the corners of the patch are converted to (u,v), the samples are
+    * interpolated between them and evaluated directly on the grid
+    * @param cpId     id of the contact point to use for the query
+    * @param x        x co-ordinate of the patch center
+    * @param y        y co-ordinate of the patch center
+    * @param phi      heading of the patch (direction of its length)
+    * @param length   length of the patch
+    * @param width    width of the patch
+    * @param nLength  number of samples along the length
+    * @param nWidth   number of samples across the width
+    * @param z        array of nLength * nWidth resulting z co-ordinates, sample k
+    *                 across the width (right to left) of row j along the length
+    *                 (rear to front) is stored at z[j * nWidth + k]
+    * @param stat     array of dCrgPatchStatSize resulting statistics values
+    *                 [dCrgPatchStatxxx], may be NULL
+    * @return 1 if successful for all samples, otherwise 0
+    */
+    extern int crgEvalPatch( int cpId, double x, double y, double phi, double length, double width, int nLength, int nWidth, double* z, double* stat );
+      
+/* ====== METHODS in crgSnapshot.c ====== */
+    /**
+    * save a fully prepared data set (including applied modifiers) as native
+    * binary snapshot for fast re-loading; the snapshot is bound to the content
+    * of the primary CRG file from which the data set has been loaded; data sets
+    * with a quantized grid cannot be saved
+    * @param dataSetId  identifier of the applicable dataset
+    * @param filename   full filename of the snapshot file
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataSetSave( int dataSetId, const char* filename );
+
+    /**
+    * load a data set from a snapshot file; fails if the snapshot has been written
+    * with a different byte order or library version or if the primary CRG file
+    * has changed since (in these cases, load the CRG file instead)
+    * @param filename   full filename of the snapshot file
+    * @return identifier of the resulting data set or 0 if not successful
+    */
+    extern int crgDataSetLoadSnapshot( const char* filename );
+
+/* ====== METHODS in crgWriter.c ====== */
+    /**
+    * write a data set as CRG file which may be read by crgLoaderReadFile(); the
+    * header holds the road parameters, the options and the modifiers of the data
+    * set (modifiers which have already been applied are not written again); data
+    * sets with a quantized or a streamed grid cannot be written
+    * @param dataSetId  identifier of the applicable dataset
+    * @param filename   full filename of the CRG file
+    * @param format     format of the data section [dCrgFileFormatxxx]
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataSetWrite( int dataSetId, const char* filename, int format );
+
+/* ====== METHODS in crgGridStream.c ====== */
+    /**
+    * get the counters of a data set whose elevation grid is streamed, see
+    * crgLoaderSetStreaming()
+    * @param dataSetId  identifier of the applicable dataset
+    * @param noMisses   number of accesses which had to wait for cross sections to be read [-]
+    * @param noLoads    number of pages of cross sections read from the file, including those read ahead [-]
+    * @return 1 if the grid of the data set is streamed, otherwise 0
+    */
+    extern int crgDataSetGetStreamStat( int dataSetId, long* noMisses, long* noLoads );
+
+    /**
+    * reset the counters of a data set whose elevation grid is streamed
+    * @param dataSetId  identifier of the applicable dataset
+    * @return 1 if the grid of the data set is streamed, otherwise 0
+    */
+    extern int crgDataSetResetStreamStat( int dataSetId );
+
+/* ====== METHODS in crgGridRerender.c ====== */
+    /**
+    * create a new data set by re-rendering the grid of a data set with other u and
+    * v increments, see crg_rerender.m; the source is not altered, so it may be
+    * re-rendered repeatedly; the grid values are interpolated as by crgEvaluv2z()
+    * without slope and banking, which are resampled separately, and the reference
+    * line keeps its shape; the new cross sections start at the beginning of the
+    * source and end at its end or at most one increment before
+    * @param dataSetId  identifier of the applicable dataset
+    * @param uInc       u increment of the new data set, 0 to keep the increment       [m]
+    * @param vInc       v increment of regular long sections across the v range of the
+    *                   source, 0 to keep the long sections of the source               [m]
+    * @param v          explicit v positions of the long sections in increasing order;
+    *                   if given, vInc is ignored; positions beyond the v range of the
+    *                   source take its values at the border, may be NULL              [m]
+    * @param noV        number of explicit v positions
+    * @return identifier of the resulting data set or 0 if not successful
+    */
+    extern int crgDataSetRerender( int dataSetId, double uInc, double vInc, const double* v, int noV );
+
+/* ====== METHODS in crgGridView.c ====== */
+    /**
+    * create a view of a u/v index window of a data set, see crg_cut_iuiv.m; the
+    * view refers to the grid of the data set instead of copying it, only the
+    * reference line and the long sections are copied; the view is evaluated as
+    * any other data set, its u co-ordinates are those of the window within the
+    * data set; the data set cannot be released while views refer to it and
+    * modifiers cannot be applied to either of them
+    * @param dataSetId  identifier of the applicable dataset, may be a view itself
+    * @param iuBeg      index of the first cross section of the window
+    * @param iuEnd      index of the last cross section of the window
+    * @param ivBeg      index of the first long section of the window
+    * @param ivEnd      index of the last long section of the window
+    * @return identifier of the view or 0 if not successful
+    */
+    extern int crgDataSetCreateView( int dataSetId, int iuBeg, int iuEnd, int ivBeg, int ivEnd );
+
+    /**
+    * create a new data set by appending data sets along u, see crg_append.m; all
+    * data sets must have the same u increment and long sections; each reference
+    * line is moved and turned to continue the last segment of its predecessor
+    * and its elevation is shifted to continue that of the predecessor; the last
+    * cross section of a data set and the first one of its successor are joined,
+    * keeping the values of the former; a single data set is copied
+    * @param dataSetIds identifiers of the data sets in order of u
+    * @param noDataSets number of data sets
+    * @return identifier of the resulting data set or 0 if not successful
+    */
+    extern int crgDataSetAppend( const int* dataSetIds, int noDataSets );
+
 /* ====== METHODS in crgPortability.c ====== */
     /**
     * print a message with a defined criticality level
@@ -30,6 +30,8 @@
 #define _CRG_BASELIB_PRIVATE_H
 
 /* ====== INCLUSIONS ====== */
+#include <stdio.h>
+
 /* include the public part */
 #include "crgBaseLib.h"
 
@@ -45,6 +47,12 @@
 */
 #define dCrgHistoryStdSize  50
 
+/**
+* CRG reference line prediction, maximum number of steps along the reference line
+* before the search falls back to the history
+*/
+#define dCrgPredictMaxSteps  6
+
 /**
 * CRG v index table, default size
 */
@@ -66,6 +74,13 @@
 */
 #define dCrgParallelLimit  1.0e-6
 
+/**
+* kernels for the bilinear interpolation in batch evaluations
+*/
+#define dCrgKernelAuto     0
+#define dCrgKernelScalar   1
+#define dCrgKernelSSE2     2
+#define dCrgKernelAVX2     3
 
 /**
 * data definitions for the loader and for modificators
@@ -80,6 +95,62 @@
 #define dCrgDataDefZEnd               0x0040
 #define dCrgDataDefZStart             0x0080
 
+/**
+* library-wide locks for tables shared between threads
+*/
+#define dCrgLockDataSets               0       /* list of data sets                     */
+#define dCrgLockContactPoints          1       /* table of contact points               */
+#define dCrgLockMessages               2       /* message counters and output           */
+#define dCrgLockKernel                 3       /* selection of the batch z kernel       */
+#define dCrgLockLoader                 4       /* settings of the loader                */
+#define dCrgNoLocks                    5       /* number of locks                       */
+
+/**
+* contact point table, organized in blocks which never move once allocated
+*/
+#define dCrgCpBlockSize              256       /* contact points per block              */
+#define dCrgCpMaxBlocks              256       /* maximum number of blocks              */
+
+/**
+* byte order of the machine, evaluated without any modifiable state
+*/
+#define dCrgBigEndian                  ( !mCrgEndianTest.cVal[0] )
+
+/**
+* alignment of the rows of a contiguous elevation grid
+*/
+#define dCrgGridAlign                 64       /* [byte] */
+
+/**
+* quantized elevation grid, blocks of samples sharing an offset and a scale
+*/
+#define dCrgQuantBlockBits             6       /* log2 of the number of samples per block edge   */
+#define dCrgQuantBlockSize             ( 1 << dCrgQuantBlockBits )
+#define dCrgQuantNaN              -32768       /* quantized value representing NaN              */
+#define dCrgQuantMax               32767       /* maximum magnitude of a quantized value        */
+
+/**
+* streamed elevation grid, pages of cross sections read from the file on demand
+*/
+#define dCrgStreamPageBits             8       /* log2 of the number of cross sections per page  */
+#define dCrgStreamPageSize             ( 1 << dCrgStreamPageBits )
+#define dCrgStreamSpareSlots           4       /* page buffers beyond the window, e.g. for misses */
+#define dCrgStreamMaxActive           16       /* maximum number of active pages considered      */
+#define dCrgStreamSlotFree             0       /* page buffer is unused                          */
+#define dCrgStreamSlotLoading          1       /* page buffer is being read from the file        */
+#define dCrgStreamSlotResident         2       /* page buffer holds a valid page                 */
+
+/**
+* memory barriers ordering accesses to data which is shared without a lock
+*/
+#if defined( __clang__ ) || ( defined( __GNUC__ ) && ( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 7 ) ) )
+#    define dCrgPortBarrierAcquire()   __atomic_thread_fence( __ATOMIC_ACQUIRE )
+#    define dCrgPortBarrierRelease()   __atomic_thread_fence( __ATOMIC_RELEASE )
+#else
+#    define dCrgPortBarrierAcquire()   crgPortMemoryBarrier()
+#    define dCrgPortBarrierRelease()   crgPortMemoryBarrier()
+#endif
+
 /* ====== TYPE DEFINITIONS ====== */
 /** 
 * this structure stores administrative information about a single CRG file
@@ -95,6 +166,19 @@ typedef struct
     int     defMask;      /* mask of defined data in header section         [-] */
     size_t  recordSize;   /* size of a single data record                [byte] */
     int     sectionType;  /* temporarily used while reading file            [-] */
+    struct CrgLoaderContextStruct* loaderCtx; /* state of the running load     [-] */
+    int     gridLayout;   /* memory layout of the elevation grid            [-] */
+    float*  gridBuffer;   /* single block holding all z channels, if any    [-] */
+    size_t  fileMapSize;  /* size of mapped file data, 0 if buffered     [byte] */
+    size_t  fileMapDone;  /* leading part of mapping already released    [byte] */
+    char*   sourceFile;   /* name of the primary CRG file                   [-] */
+    int     modsApplied;  /* modifiers have been applied to the data      [0/1] */
+    char*   snapshotBuffer; /* snapshot holding the channel data, if any    [-] */
+    size_t  snapshotSize;   /* size of the snapshot                      [byte] */
+    int     snapshotMapped; /* snapshot is memory mapped                  [0/1] */
+    int     headerOnly;     /* only the header has been read             [0/1] */
+    struct CrgDataStruct* viewOwner; /* data set owning the grid of a view    [-] */
+    int     noViews;        /* number of views referring to the grid        [-] */
 } CrgAdminStruct;
 
 /** 
@@ -174,22 +258,50 @@ typedef struct
     unsigned int noIter;            /* total number of iterations in history    [-] */
     unsigned int noCallsLoop1;      /* total number of calls to loop 1          [-] */
     unsigned int noCallsLoop2;      /* total number of calls to loop 2          [-] */
+    unsigned int noInserts;         /* total number of new entries in history   [-] */
+    unsigned int noReplaced;        /* total number of replaced entries         [-] */
+    unsigned int noPredictHits;     /* total number of successful predictions   [-] */
+    unsigned int noPredictMisses;   /* total number of failed predictions       [-] */
 } CrgHistoryStatStruct;
 
 /** 
-* structure for information about query history for faster access
+* structure for information about query history for faster access;
+* the entries form a ring buffer, the newest entry is found at position "head";
+* the slots are chained into buckets keyed by the reference line index so that
+* an interval which is hit again at the same place replaces its older entry
 */
 typedef struct
 {
     int    totalSize;               /* total size of the history                                      [-] */
-    int    usedSize;                /* size of valid data in the history                              [-] */
+    int    usedSize;                /* number of ring slots in use, including released slots          [-] */
     int    entrySize;               /* size of a history entry                                     [byte] */
+    int    head;                    /* ring slot of the newest entry                                  [-] */
+    int    bucketMask;              /* number of buckets minus one (number is a power of 2)           [-] */
     double closeDist;               /* square of a distance considered 'close' to a point in history [m2] */
     double farDist;                 /* square of a distance considered 'far' to a point in history   [m2] */
     CrgHistoryEntryStruct* entry;   /* entries of the history, dynamically allocated                  [-] */
+    int*   next;                    /* next slot in the same bucket, -1 at end, -2 for released slot  [-] */
+    int*   prev;                    /* previous slot in the same bucket, -1 at start                  [-] */
+    int*   bucket;                  /* first slot of each bucket, -1 if empty                         [-] */
     CrgHistoryStatStruct   stat;    /* statistics information about history use                       [-] */
 } CrgHistoryStruct;
 
+/**
+* iterate the slots of a history from the newest to the oldest entry
+*/
+#define dCrgHistoryPrevSlot( hist, slot ) ( ( slot ) ? ( slot ) - 1 : ( hist )->totalSize - 1 )
+#define dCrgHistorySlotValid( hist, slot ) ( ( hist )->next[slot] != -2 )
+
+/** 
+* structure for the prediction of the reference line interval from the motion of a contact point
+*/
+typedef struct
+{
+    short  active;                  /* is prediction active?                                        [0/1] */
+    short  noValid;                 /* number of valid previous results (up to 2)                     [-] */
+    double u[2];                    /* u values of the previous results, latest first                 [m] */
+} CrgPredictorStruct;
+
 /** 
 * structure for performance measurement data
 */
@@ -239,9 +351,135 @@ typedef struct
 } CrgIndexTable;
 
 /**
-* now the complete structure composed of the previous sub-structures
+* a uniform grid over the reference line for the initial search of x/y positions;
+* the reference line is split into chunks of consecutive intervals, each chunk is
+* registered in all cells touched by its bounding box widened by the v range
+*/
+typedef struct
+{
+    short   valid;                      /* validity of the grid                                             [0/1] */
+    double  xMin;                       /* x co-ordinate of the lower left corner of the grid                 [m] */
+    double  yMin;                       /* y co-ordinate of the lower left corner of the grid                 [m] */
+    double  cellSize;                   /* edge length of a grid cell                                         [m] */
+    double  maxDist2;                   /* square of the distance up to which a search result is certain     [m2] */
+    size_t  noCellsX;                   /* number of cells in x direction                                     [-] */
+    size_t  noCellsY;                   /* number of cells in y direction                                     [-] */
+    size_t  noChunks;                   /* number of chunks of the reference line                             [-] */
+    double* chunkBox;                   /* widened bounding box per chunk (xMin, yMin, xMax, yMax)            [m] */
+    size_t* cellStart;                  /* first entry of each cell in the entry list, noCells + 1 values     [-] */
+    size_t* entry;                      /* indices of the chunks registered in the cells                      [-] */
+} CrgRefLineIndexStruct;
+
+/**
+* geometry of the reference line which depends on the data set only and is therefore
+* computed once instead of per evaluation; packed as one array per quantity
+*/
+typedef struct
+{
+    short   valid;                      /* validity of the tables                                           [0/1] */
+    size_t  size;                       /* number of reference line points                                    [-] */
+    size_t  curvWindow;                 /* half width of the curvature window in points                       [-] */
+    double* invLen;                     /* inverse length of each interval, size - 1 values                 [1/m] */
+    double* begNormX;                   /* x component of bisector normal at start of each interval,          [-] */
+                                        /* scaled to unit distance from the interval                              */
+    double* begNormY;                   /* y component of bisector normal at start of each interval           [-] */
+    double* endNormX;                   /* x component of bisector normal at end of each interval             [-] */
+    double* endNormY;                   /* y component of bisector normal at end of each interval             [-] */
+    double* curv;                       /* curvature over the window around each point, size values         [1/m] */
+} CrgRefLineGeomStruct;
+
+/**
+* elevation grid quantized to 16 bit integers with an offset and a scale per block
+* of dCrgQuantBlockSize x dCrgQuantBlockSize samples; replaces the float z channels
+*/
+typedef struct
+{
+    short   valid;                      /* validity of the quantized grid                                   [0/1] */
+    size_t  sizeU;                      /* number of samples per v channel                                    [-] */
+    size_t  noBlocksU;                  /* number of blocks in u direction                                    [-] */
+    size_t  noBlocksV;                  /* number of blocks in v direction                                    [-] */
+    short*  data;                       /* quantized samples, one row of sizeU values per v channel           [-] */
+    double* offset;                     /* offset of each block                                               [m] */
+    double* scale;                      /* scale of each block                                                [m] */
+    double  errorBound;                 /* maximum error requested for the quantization                       [m] */
+    double  maxError;                   /* maximum error achieved, accumulated over re-quantizations          [m] */
+} CrgGridQuantStruct;
+
+/**
+* buffer holding a page of dCrgStreamPageSize cross sections of a streamed grid
+*/
+typedef struct
+{
+    float*  data;                       /* samples of the page, dCrgStreamPageSize values per v channel       [m] */
+    size_t  page;                       /* index of the page held by the buffer                                [-] */
+    int     state;                      /* state of the buffer [dCrgStreamSlotFree]                             [-] */
+    unsigned long lastUse;              /* value of the access counter at the last access to the page          [-] */
+    volatile unsigned long stamp;       /* incremented before and after the buffer changes, odd in between     [-] */
+} CrgGridStreamSlotStruct;
+
+/**
+* elevation grid streamed from a binary file instead of z channels; only the
+* pages around the recently accessed cross sections stay resident, a thread
+* reads the pages ahead of them in the background
+*/
+typedef struct
+{
+    short   valid;                      /* validity of the streamed grid                                    [0/1] */
+    char*   fileName;                   /* name of the file holding the data section                           [-] */
+    FILE*   fPtr;                       /* the file, read with random access                                   [-] */
+    size_t  dataOffset;                 /* position of the first record within the file                     [byte] */
+    size_t  recordSize;                 /* size of a single record                                          [byte] */
+    size_t  sizeU;                      /* number of cross sections                                            [-] */
+    size_t  noPages;                    /* number of pages                                                     [-] */
+    double  uBehind;                    /* length of the road kept behind the active cross sections            [m] */
+    double  uAhead;                     /* length of the road read ahead of the active cross sections          [m] */
+    size_t  pagesBehind;                /* number of pages kept behind an active page                          [-] */
+    size_t  pagesAhead;                 /* number of pages read ahead of an active page                        [-] */
+    size_t  noSlots;                    /* number of page buffers                                              [-] */
+    CrgGridStreamSlotStruct* slot;      /* the page buffers                                                    [-] */
+    int*    pageSlot;                   /* index of the buffer holding each page, -1 if not resident           [-] */
+    int     direction;                  /* direction of travel along the reference line                     [+/-1] */
+    unsigned long useCount;             /* access counter                                                      [-] */
+    unsigned long activeCount;          /* pages accessed after this value of the counter are active           [-] */
+    unsigned long cycleCount;           /* value of the counter when the current prefetch cycle started        [-] */
+    int     prefetch;                   /* the prefetch thread is requested to complete the window          [0/1] */
+    int     stop;                       /* the prefetch thread is requested to terminate                    [0/1] */
+    int     version;                    /* incremented whenever the decoding of the samples changes            [-] */
+    void*   mutex;                      /* guards the page table, the buffers and the counters                 [-] */
+    void*   fileMutex;                  /* guards the file and the read buffers                                [-] */
+    void*   cond;                       /* signals completed pages and prefetch requests                       [-] */
+    void*   thread;                     /* the prefetch thread                                                 [-] */
+    char*   readBuffer;                 /* records of a page as stored in the file                             [-] */
+    double* record;                     /* a single decoded record                                             [-] */
+    CrgChannelFStruct* pageChannels;    /* v channels referring to the rows of the page being decoded          [-] */
+    double  zScale;                     /* factor applied to the samples read from the file                    [-] */
+    int     nanMode;                    /* NaN handling applied to the samples read from the file              [-] */
+    double  nanOffset;                  /* offset applied by the NaN handling                                  [m] */
+    double  zMin;                       /* minimum sample of the file                                          [m] */
+    double  zMax;                       /* maximum sample of the file                                          [m] */
+    double  zSumBeg;                    /* sum of the samples of the first cross section                       [m] */
+    double  zSumEnd;                    /* sum of the samples of the last cross section                        [m] */
+    size_t  noBeg;                      /* number of valid samples of the first cross section                  [-] */
+    size_t  noEnd;                      /* number of valid samples of the last cross section                   [-] */
+    size_t  noValues;                   /* number of valid samples of the file                                 [-] */
+    long    noMisses;                   /* accesses which had to wait for a page to be read                    [-] */
+    long    noLoads;                    /* pages read from the file                                            [-] */
+} CrgGridStreamStruct;
+
+/**
+* filter mask set via the API, applied by the modifier dCrgModFilterMode
 */
 typedef struct
+{
+    double* mask;                       /* sizeV rows of sizeU coefficients                                    [-] */
+    int     sizeU;                      /* size of the mask in u direction                                     [-] */
+    int     sizeV;                      /* size of the mask in v direction                                     [-] */
+} CrgGridFilterStruct;
+
+/**
+* now the complete structure composed of the previous sub-structures
+*/
+typedef struct CrgDataStruct
 {
     CrgAdminStruct       admin;                       /* administrative data                                                              */
     size_t               noChannels;                  /* total number of available channels in crg data                               [-] */
@@ -257,10 +495,29 @@ typedef struct
     CrgOptionsStruct     modifiers;                   /* list of modifiers to be applied on the data set                              [-] */
     CrgOptionsStruct     options;                     /* list of default options for new contact points                               [-] */
     CrgUtilityStruct     util;                        /* utility information, also used for increased performance                     [-] */
-    CrgPerformanceStruct perfStat;                    /* data for performance statistics                                              [-] */
     CrgIndexTable        indexTableV;                 /* an index table for faster access to v indices in irregularly spaced v grids  [-] */
+    CrgRefLineIndexStruct refLineIndex;               /* spatial index of the reference line for the search of x/y positions          [-] */
+    CrgRefLineGeomStruct refLineGeom;                 /* precomputed geometry of the reference line intervals                         [-] */
+    CrgGridQuantStruct   gridQuant;                   /* quantized elevation grid replacing the z channels, if any                    [-] */
+    CrgGridStreamStruct  gridStream;                  /* streamed elevation grid replacing the z channels, if any                     [-] */
+    CrgGridFilterStruct  gridFilter;                  /* filter mask set via the API, if any                                          [-] */
 } CrgDataStruct;
 
+/**
+* evaluation of z values specialized for the options of a contact point and the
+* properties of its data set; positions outside the bounds take the generic path
+*/
+typedef struct CrgEvalKernelTag
+{
+    int ( *func )( const struct CrgEvalKernelTag* kernel, CrgDataStruct *crgData, CrgOptionsStruct* optionList,
+                   CrgPerformanceStruct* perfStat, double u, double v, double* z );
+                                    /* function evaluating the z value at a given position            [-] */
+    double uMin;                    /* minimum u value for the specialized path                       [m] */
+    double uMax;                    /* maximum u value for the specialized path                       [m] */
+    double vMin;                    /* minimum v value for the specialized path                       [m] */
+    double vMax;                    /* maximum v value for the specialized path                       [m] */
+} CrgEvalKernelStruct;
+
 /**
 * a structure holding contact point information (and providing additional memory for queries)
 */
@@ -278,6 +535,9 @@ typedef struct
     CrgHistoryEntryStruct histEntry;   /* information about the previous query                                */
     CrgOptionsStruct      options;     /* list of options to be applied when using the contact point      [-] */
     CrgHistoryStruct      history;     /* history for successive queries                                  [-] */
+    CrgPredictorStruct    predict;     /* reference line interval prediction for successive queries       [-] */
+    CrgPerformanceStruct  perfStat;    /* statistics of the evaluations made with this contact point      [-] */
+    CrgEvalKernelStruct   evalKernel;  /* z evaluation specialized for the options of the contact point   [-] */
     double smoothBaseBeg;              /* base value for smoothing at the begin of the data set           [m] */
     double smoothBaseEnd;              /* base value for smoothing at the end of the data set             [m] */
 } CrgContactPointStruct;
@@ -297,8 +557,17 @@ typedef union
     float fVal;
 } CrgNanUnionFloat;
 
+/**
+* union for detecting the byte order of the machine
+*/
+typedef union
+{
+    int  iVal;
+    char cVal[sizeof( int )];
+} CrgEndianUnion;
+
 /* ====== GLOBAL VARIABLES ====== */
-extern int mCrgBigEndian;             /* endian-ness of machine */
+extern const CrgEndianUnion mCrgEndianTest;   /* iVal = 1, for detecting the endian-ness of the machine */
 
 
 /* ====== METHODS in crgLoader.c ====== */
@@ -332,6 +601,52 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgCheckMods( CrgDataStruct* crgData );
 
+    /**
+    * release the z channels of a data set, taking into account the grid layout
+    * @param  crgData     pointer to the CRG data set whose z channels are to be released
+    */
+    extern void crgLoaderReleaseGrid( CrgDataStruct* crgData );
+
+    /**
+    * allocate the z channels of a data set according to its grid layout
+    * @param  crgData     pointer to the CRG data set whose z channels are to be allocated
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgLoaderAllocateGrid( CrgDataStruct* crgData );
+
+    /**
+    * handle the NaNs of a single cross section, see crgLoaderHandleNaNs()
+    * @param  channelZ       the v channels holding the cross section
+    * @param  noChannels     number of v channels
+    * @param  index          index of the cross section within the channels
+    * @param  mode           NaN handling mode [dCrgGridNaNKeep]
+    * @param  offset         offset to be applied to former NaNs
+    * @param  offsetApplied  pointer to the state of the offset, carried from one cross section to the next
+    * @param  indexLR        pointer to the resulting index of the leftmost valid sample, may be NULL
+    * @param  indexRL        pointer to the resulting index of the rightmost valid sample, may be NULL
+    * @return number of NaNs found
+    */
+    extern size_t crgLoaderHandleNaNsSection( CrgChannelFStruct* channelZ, size_t noChannels, size_t index, int mode, double offset,
+                                              int* offsetApplied, size_t* indexLR, size_t* indexRL );
+
+    /**
+    * decode consecutive binary records into the given v channels, without
+    * altering the channels of the data set
+    * @param  crgData        pointer to the CRG data set defining the record format
+    * @param  dataPtr        pointer to the first record
+    * @param  noRecords      number of records
+    * @param  record         buffer for a single decoded record
+    * @param  channelZ       v channels receiving the samples, starting at index 0
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgLoaderDecodeZ( CrgDataStruct* crgData, char* dataPtr, size_t noRecords, double* record, CrgChannelFStruct* channelZ );
+
+    /**
+    * get the number of threads processing a data set in parallel, see crgLoaderSetNoThreads()
+    * @return number of threads
+    */
+    extern int crgLoaderGetNoThreads( void );
+
 
 /* ====== METHODS in crgStatistics.c ====== */
     /**
@@ -347,6 +662,21 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern void crgCalcUtilityData( CrgDataStruct *crgData );
     
+    /**
+    * calculate the geometry tables of the reference line (interval lengths,
+    * bisector normals and curvature) which are used by the evaluation
+    * routines; existing tables are replaced
+    * @param crgData    pointer to data set which is to be analyzed
+    * @return 1 if successful, otherwise 0 (evaluations compute the geometry on the fly)
+    */
+    extern int crgCalcRefLineGeom( CrgDataStruct *crgData );
+    
+    /**
+    * release the geometry tables of the reference line
+    * @param crgData    pointer to the data set
+    */
+    extern void crgReleaseRefLineGeom( CrgDataStruct *crgData );
+    
     /**
     * print the elevation data contained in a CRG file to shell
     * @param crgData    pointer to data set which is to be printed
@@ -367,6 +697,16 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern CrgDataStruct* crgDataSetAccess( int id );
     
+    /**
+    * replace a data set by another one, e.g. once the data of a data set which
+    * holds the header of a file only has been loaded; the replacing data set
+    * takes over the ID, the options and the modifiers of the replaced one
+    * @param dataSetId    ID of the data set which is to be replaced
+    * @param sourceId     ID of the data set replacing it, invalid afterwards
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataSetReplace( int dataSetId, int sourceId );
+    
     /**
     * set the size of a data-set specific history
     * @param dataSetId    ID of the applicable data set
@@ -463,6 +803,29 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     * @return 1 if successful, otherwise 0
     */
     extern int crgContactPointSetHistoryForDataSet( CrgDataStruct *crgData, int histSize );
+    
+    /**
+    * re-select the z evaluation kernels of all contact points referring to a
+    * given CRG data set after the data set has been modified
+    * @param  crgData     pointer to the applicable CRG data set
+    */
+    extern void crgContactPointSelectKernelForDataSet( CrgDataStruct *crgData );
+
+    /**
+    * register a reference line interval as the newest entry of a contact point's history;
+    * an older entry for the same interval is released
+    * @param cp         pointer to the contact point which is to be modified
+    * @param x          x co-ordinate of the query
+    * @param y          y co-ordinate of the query
+    * @param index      reference line index of the query
+    */
+    extern void crgContactPointHistoryPush( CrgContactPointStruct *cp, double x, double y, size_t index );
+
+    /**
+    * remove all entries from a contact point's history
+    * @param cp         pointer to the contact point which is to be modified
+    */
+    extern void crgContactPointHistoryClear( CrgContactPointStruct *cp );
 
     /**
     * pre-load reference line history with data at given u value
@@ -646,6 +1009,33 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, double* v );
     
+    /**
+    * convert an array of (x,y) positions into the corresponding (u,v) positions
+    * @param cp    pointer to contact point which is to be used
+    * @param n     number of positions
+    * @param x     array of x co-ordinates
+    * @param y     array of y co-ordinates
+    * @param u     array of resulting u co-ordinates
+    * @param v     array of resulting v co-ordinates
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvalxy2uvBatchPtr( CrgContactPointStruct *cp, int n, const double* x, const double* y, double* u, double* v );
+    
+    /**
+    * build the spatial index of the reference line which is used whenever
+    * the history of a contact point gives no hint for an x/y position;
+    * an existing index is replaced
+    * @param crgData    pointer to the CRG data set
+    * @return 1 if successful, otherwise 0 (searches will scan the reference line)
+    */
+    extern int crgEvalxy2uvBuildIndex( CrgDataStruct* crgData );
+    
+    /**
+    * release the spatial index of the reference line
+    * @param crgData    pointer to the CRG data set
+    */
+    extern void crgEvalxy2uvReleaseIndex( CrgDataStruct* crgData );
+    
     /**
     * depending on reference line settings (i.e. closing of reference line),
     * this routine will clip an incoming u value to the valid range or leave
@@ -675,12 +1065,56 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     * compute the z value at a given (u,v) position using bilinear interpolation
     * @param crgData    pointer to data set which holds the data
     * @param optionList pointer to a list holding all applicable options
+    * @param perfStat   pointer to the statistics of the calling contact point, may be NULL
+    * @param u          u co-ordinate
+    * @param v          v co-ordinate
+    * @param z          pointer to resulting z co-ordinate
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, CrgPerformanceStruct* perfStat, double u, double v, double* z );
+
+    /**
+    * compute the z value and its analytic derivatives by u and v at a given (u,v)
+    * position; the z value is identical to the one of crgDataEvaluv2z(), the
+    * derivatives take all border modes, offsets and smoothing zones into account
+    * @param crgData    pointer to data set which holds the data
+    * @param optionList pointer to a list holding all applicable options
+    * @param perfStat   pointer to the statistics of the calling contact point, may be NULL
     * @param u          u co-ordinate
     * @param v          v co-ordinate
     * @param z          pointer to resulting z co-ordinate
+    * @param dzdu       pointer to resulting derivative of z by u, may be NULL
+    * @param dzdv       pointer to resulting derivative of z by v, may be NULL
     * @return 1 if successful, otherwise 0
     */
-    extern int crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u, double v, double* z );
+    extern int crgDataEvaluv2zGrad( CrgDataStruct *crgData, CrgOptionsStruct* optionList, CrgPerformanceStruct* perfStat, double u, double v, double* z,
+                                    double* dzdu, double* dzdv );
+
+    /**
+    * compute the z value at a position in the core area of the data set whose
+    * u interval is already known; positions outside the core area or within a
+    * smoothing zone must be evaluated with crgDataEvaluv2z()
+    * @param crgData    pointer to data set which holds the data
+    * @param perfStat   pointer to the statistics of the calling contact point, may be NULL
+    * @param indexU     index of the u interval
+    * @param fracU      fraction within the u interval
+    * @param v          v co-ordinate
+    * @param z          pointer to resulting z co-ordinate
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataEvaluv2zCore( CrgDataStruct *crgData, CrgPerformanceStruct* perfStat, size_t indexU, double fracU, double v, double* z );
+
+    /**
+    * get the grid values at the corners of a cell of the elevation grid, regardless
+    * of whether the grid is held as floats, quantized or streamed; the mean value
+    * of the z channel is not included
+    * @param crgData    pointer to data set which holds the data
+    * @param indexU     index of the u interval
+    * @param indexV     index of the v interval
+    * @param c          resulting values at (indexU, indexV), (indexU+1, indexV),
+    *                   (indexU, indexV+1) and (indexU+1, indexV+1)
+    */
+    extern void crgDataGridCellCorners( CrgDataStruct *crgData, size_t indexU, size_t indexV, double* c );
 
     /**
     * compute the z value at a given (u,v) position using bilinear interpolation
@@ -692,6 +1126,47 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgEvaluv2zPtr( CrgContactPointStruct *cp, double u, double v, double* z );
 
+    /**
+    * compute the z values at an array of (u,v) positions using bilinear interpolation;
+    * positions in the core area are evaluated in a tight loop, all others are passed
+    * to crgDataEvaluv2z()
+    * @param crgData    pointer to data set which holds the data
+    * @param optionList pointer to a list holding all applicable options
+    * @param perfStat   pointer to the statistics of the calling contact point, may be NULL
+    * @param n          number of positions
+    * @param u          array of u co-ordinates
+    * @param v          array of v co-ordinates
+    * @param z          array of resulting z co-ordinates
+    * @param status     array of resulting status per position (1 = ok, 0 = error), may be NULL
+    * @return 1 if successful for all positions, otherwise 0
+    */
+    extern int crgDataEvaluv2zBatch( CrgDataStruct *crgData, CrgOptionsStruct* optionList, CrgPerformanceStruct* perfStat, int n, const double* u, const double* v, double* z, int* status );
+
+    /**
+    * compute the z values at an array of (u,v) positions using bilinear interpolation
+    * @param cp      pointer to contact point which is to be used
+    * @param n       number of positions
+    * @param u       array of u co-ordinates
+    * @param v       array of v co-ordinates
+    * @param z       array of resulting z co-ordinates
+    * @param status  array of resulting status per position (1 = ok, 0 = error), may be NULL
+    * @return 1 if successful for all positions, otherwise 0
+    */
+    extern int crgEvaluv2zBatchPtr( CrgContactPointStruct *cp, int n, const double* u, const double* v, double* z, int* status );
+
+    /**
+    * compute the z value, its derivatives by u and v and the surface normal at a given (u,v) position
+    * @param cp    pointer to contact point which is to be used
+    * @param u     u co-ordinate
+    * @param v     v co-ordinate
+    * @param z     pointer to resulting z co-ordinate
+    * @param dzdu  pointer to resulting derivative of z by u, may be NULL
+    * @param dzdv  pointer to resulting derivative of z by v, may be NULL
+    * @param nrm   array of 3 values for the resulting inertial unit normal (x, y, z), may be NULL
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvaluv2znPtr( CrgContactPointStruct *cp, double u, double v, double* z, double* dzdu, double* dzdv, double* nrm );
+
     /**
     * compute the z value of reference line at given u position
     * @param crgData  pointer to data set which holds the data
@@ -700,6 +1175,34 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     * @return 1 if successful, otherwise 0
     */
     extern int crgDataEvalu2Refz( CrgDataStruct *crgData, double u, double* z );
+
+    /**
+    * select the kernel for the bilinear interpolation in batch evaluations;
+    * by default, the fastest kernel supported by the CPU is used
+    * @param kernel  id of the kernel (dCrgKernelAuto, dCrgKernelScalar, ...)
+    * @return 1 if the kernel is available on this platform, otherwise 0
+    */
+    extern int crgEvalzSetKernel( int kernel );
+
+    /**
+    * select the fastest kernel supported by the CPU unless a kernel has
+    * been selected before; called when contact points are created so that
+    * concurrent evaluations only read the selection
+    */
+    extern void crgEvalzInitKernel( void );
+
+    /**
+    * select the z evaluation kernel of a contact point from its options and
+    * the properties of its data set; to be called whenever one of them changes
+    * @param cp    pointer to the contact point
+    */
+    extern void crgEvalzSelectCpKernel( CrgContactPointStruct* cp );
+
+    /**
+    * get the name of the kernel used for the bilinear interpolation in batch evaluations
+    * @return name of the kernel
+    */
+    extern const char* crgEvalzGetKernelName( void );
     
 /* ====== METHODS in crgEvalpk.c ====== */
     /**
@@ -714,6 +1217,222 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgDataEvaluv2pk( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u, double v, double* phi, double* curv );
 
+    /**
+    * compute the heading and curvature value for a u interval which is already known
+    * @param crgData    pointer to data set which holds the data
+    * @param optionList pointer to a list holding all applicable options
+    * @param indexU     index of the u interval
+    * @param v          v co-ordinate
+    * @param phi        pointer to resulting heading angle
+    * @param curv       pointer to resulting curvature
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataEvalpkAtIndex( CrgDataStruct *crgData, CrgOptionsStruct* optionList, size_t indexU, double v, double* phi, double* curv );
+
+/* ====== METHODS in crgEvalxy2all.c ====== */
+    /**
+    * convert a given (x,y) position into the corresponding (u,v) position and
+    * compute elevation, heading and curvature at this position
+    * @param cp    pointer to contact point which is to be used
+    * @param x     x co-ordinate
+    * @param y     y co-ordinate
+    * @param u     pointer to resulting u co-ordinate
+    * @param v     pointer to resulting v co-ordinate
+    * @param z     pointer to resulting z co-ordinate
+    * @param phi   pointer to resulting heading angle
+    * @param curv  pointer to resulting curvature
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvalxy2allPtr( CrgContactPointStruct *cp, double x, double y, double* u, double* v, double* z, double* phi, double* curv );
+
+/* ====== METHODS in crgEvalPatch.c ====== */
+    /**
+    * evaluate the elevation on a rectangular contact patch
+    * @param cp       pointer to contact point which is to be used
+    * @param x        x co-ordinate of the patch center
+    * @param y        y co-ordinate of the patch center
+    * @param phi      heading of the patch
+    * @param length   length of the patch
+    * @param width    width of the patch
+    * @param nLength  number of samples along the length
+    * @param nWidth   number of samples across the width
+    * @param z        array of nLength * nWidth resulting z co-ordinates
+    * @param stat     array of dCrgPatchStatSize resulting statistics values, may be NULL
+    * @return 1 if successful for all samples, otherwise 0
+    */
+    extern int crgEvalPatchPtr( CrgContactPointStruct *cp, double x, double y, double phi, double length, double width, int nLength, int nWidth, double* z, double* stat );
+
+/* ====== METHODS in crgSnapshot.c ====== */
+    /**
+    * release the snapshot holding the channel data of a data set, if any
+    * @param crgData    pointer to the data set
+    */
+    extern void crgSnapshotRelease( CrgDataStruct* crgData );
+
+/* ====== METHODS in crgGridQuant.c ====== */
+    /**
+    * replace the float z channels of a data set by a quantized grid; the data
+    * set keeps its float channels if the error bound cannot be met
+    * @param crgData    pointer to the data set
+    * @param maxError   maximum deviation of a quantized sample from its float value [m]
+    * @return 1 if the grid has been quantized, otherwise 0
+    */
+    extern int crgDataGridQuantize( CrgDataStruct* crgData, double maxError );
+
+    /**
+    * restore the float z channels of a data set from its quantized grid; the
+    * achieved error and the error bound are kept for a later re-quantization
+    * @param crgData    pointer to the data set
+    * @return 1 if successful or if the grid is not quantized, otherwise 0
+    */
+    extern int crgDataGridExpand( CrgDataStruct* crgData );
+
+    /**
+    * release the quantized grid of a data set, if any
+    * @param crgData    pointer to the data set
+    */
+    extern void crgDataGridReleaseQuant( CrgDataStruct* crgData );
+
+/* ====== METHODS in crgGridFilter.c ====== */
+    /**
+    * apply the filter defined by the modifiers dCrgModFilterXXX to the z channels
+    * of a data set
+    * @param crgData    pointer to the data set
+    * @param gain       pointer to the resulting factor by which deviations of the
+    *                   samples may be amplified by the filter, may be NULL
+    * @return 1 if the filter has been applied, otherwise 0
+    */
+    extern int crgDataGridFilter( CrgDataStruct* crgData, double* gain );
+
+    /**
+    * get the index range of the grid given by four modifiers; the range defaults
+    * to the complete grid, the positions are rounded to the nearest samples
+    * @param crgData    pointer to the data set
+    * @param uBeginId   id of the modifier holding the start of the range in u direction
+    * @param uEndId     id of the modifier holding the end of the range in u direction
+    * @param vBeginId   id of the modifier holding the start of the range in v direction
+    * @param vEndId     id of the modifier holding the end of the range in v direction
+    * @param iuBeg      resulting index of the first sample in u direction
+    * @param iuEnd      resulting index of the last sample in u direction
+    * @param ivBeg      resulting index of the first v channel
+    * @param ivEnd      resulting index of the last v channel
+    * @return 1 if the range is not empty and the z channels are complete, otherwise 0
+    */
+    extern int crgDataGridGetRange( CrgDataStruct* crgData, unsigned int uBeginId, unsigned int uEndId, unsigned int vBeginId, unsigned int vEndId,
+                                    size_t* iuBeg, size_t* iuEnd, size_t* ivBeg, size_t* ivEnd );
+
+    /**
+    * keep a copy of a filter mask for the modifier dCrgModFilterMode
+    * @param crgData    pointer to the data set
+    * @param mask       sizeV rows of sizeU coefficients
+    * @param sizeU      size of the mask in u direction
+    * @param sizeV      size of the mask in v direction
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataGridFilterSetMask( CrgDataStruct* crgData, const double* mask, int sizeU, int sizeV );
+
+    /**
+    * release the filter mask of a data set, if any
+    * @param crgData    pointer to the data set
+    */
+    extern void crgDataGridFilterRelease( CrgDataStruct* crgData );
+
+/* ====== METHODS in crgGridPeak.c ====== */
+    /**
+    * limit the peaks and the values of the z channels of a data set as defined by
+    * the modifiers dCrgModPeakXXX and dCrgModLimitXXX
+    * @param crgData    pointer to the data set
+    * @return 1 if the limits have been applied, otherwise 0
+    */
+    extern int crgDataGridLimit( CrgDataStruct* crgData );
+
+    /**
+    * detect the peaks of the z channels of a data set within the range given by
+    * the modifiers dCrgModLimitUBegin etc.
+    * @param crgData    pointer to the data set
+    * @param threshold  threshold of the laplacian of the absolute values
+    * @param radius     radius of the window around a candidate
+    * @param u          resulting u positions of the peaks, may be NULL          [m]
+    * @param v          resulting v positions of the peaks, may be NULL          [m]
+    * @param z          resulting grid values of the peaks, may be NULL          [m]
+    * @param maxPeaks   maximum number of peaks stored in u, v and z
+    * @return total number of peaks, -1 on error
+    */
+    extern int crgDataGridGetPeaks( CrgDataStruct* crgData, double threshold, int radius, double* u, double* v, double* z, int maxPeaks );
+
+/* ====== METHODS in crgGridStream.c ====== */
+    /**
+    * prepare streaming the grid of a binary file; the z channels of the data
+    * set are not allocated, the samples are scanned for their statistics only
+    * @param crgData    pointer to the data set
+    * @param fileName   name of the file holding the data section
+    * @param dataOffset position of the data section within the file      [byte]
+    * @param uBehind    length of the road kept behind the active positions [m]
+    * @param uAhead     length of the road read ahead of the active positions [m]
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataGridStreamInit( CrgDataStruct* crgData, const char* fileName, size_t dataOffset, double uBehind, double uAhead );
+
+    /**
+    * account for the samples of a record while scanning the file
+    * @param crgData    pointer to the data set
+    * @param record     the decoded record
+    * @param nRec       index of the record
+    */
+    extern void crgDataGridStreamScan( CrgDataStruct* crgData, const double* record, size_t nRec );
+
+    /**
+    * allocate the page buffers once the file has been scanned and start the
+    * prefetch thread
+    * @param crgData    pointer to the data set
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataGridStreamStart( CrgDataStruct* crgData );
+
+    /**
+    * stop the prefetch thread and release the streamed grid of a data set, if any
+    * @param crgData    pointer to the data set
+    */
+    extern void crgDataGridStreamRelease( CrgDataStruct* crgData );
+
+    /**
+    * fetch the z values at the corners of grid cells; waits for pages which
+    * are not resident
+    * @param crgData    pointer to the data set
+    * @param n          number of cells
+    * @param indexU     array of u indices of the cells
+    * @param indexV     array of v indices of the cells
+    * @param c          array of 4 * n resulting values, for each cell at (indexU, indexV),
+    *                   (indexU+1, indexV), (indexU, indexV+1) and (indexU+1, indexV+1)
+    */
+    extern void crgDataGridStreamCorners( CrgDataStruct* crgData, int n, const size_t* indexU, const size_t* indexV, double* c );
+
+    /**
+    * scale the samples of a streamed grid; resident pages are discarded
+    * @param crgData    pointer to the data set
+    * @param factor     the scale factor
+    */
+    extern void crgDataGridStreamScale( CrgDataStruct* crgData, double factor );
+
+    /**
+    * set the NaN handling of a streamed grid; as with a resident grid, only
+    * the first handling replacing NaNs takes effect
+    * @param crgData    pointer to the data set
+    * @param mode       NaN handling mode [dCrgGridNaNKeep]
+    * @param offset     offset to be applied to former NaNs
+    */
+    extern void crgDataGridStreamSetNaNMode( CrgDataStruct* crgData, int mode, double offset );
+
+    /**
+    * get the statistics of the samples of a streamed grid, gathered while scanning the file
+    * @param crgData    pointer to the data set
+    * @param zMeanBeg   pointer to the mean elevation of the first cross section [m]
+    * @param zMeanEnd   pointer to the mean elevation of the last cross section  [m]
+    * @param zMin       pointer to the minimum elevation                         [m]
+    * @param zMax       pointer to the maximum elevation                         [m]
+    */
+    extern void crgDataGridStreamGetStat( CrgDataStruct* crgData, double* zMeanBeg, double* zMeanEnd, double* zMin, double* zMax );
+
 /* ====== METHODS in crgPortability.c ====== */
     /**
     * set the maximum level of messages that will be handled,
@@ -743,6 +1462,115 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     * @return 0 if message of the given level may be printed
     */
     extern int crgPortMsgIsPrintable( int level );
+    
+    /**
+    * acquire one of the library-wide locks guarding shared tables; locks
+    * are not recursive, i.e. a holder must not acquire the same lock again
+    * @param lockId the lock [dCrgLockDataSets]
+    */
+    extern void crgPortLock( int lockId );
+    
+    /**
+    * release a lock acquired with crgPortLock()
+    * @param lockId the lock [dCrgLockDataSets]
+    */
+    extern void crgPortUnlock( int lockId );
+    
+    /**
+    * run a number of tasks concurrently and return once all of them are
+    * done; the calling thread executes the first task, tasks are run one
+    * after another where no threads are available
+    * @param task       function executing a single task
+    * @param data       data passed to each task
+    * @param noTasks    number of tasks to run
+    */
+    extern void crgPortRunTasks( void ( *task )( void* data, int taskId ), void* data, int noTasks );
+    
+    /**
+    * create a mutex guarding data of a single object, e.g. of a data set
+    * @return handle of the mutex, NULL if not available
+    */
+    extern void* crgPortMutexCreate( void );
+    
+    /**
+    * delete a mutex created with crgPortMutexCreate()
+    * @param mutex  handle of the mutex, may be NULL
+    */
+    extern void crgPortMutexDelete( void* mutex );
+    
+    /**
+    * acquire a mutex; mutexes are not recursive
+    * @param mutex  handle of the mutex, NULL is ignored
+    */
+    extern void crgPortMutexLock( void* mutex );
+    
+    /**
+    * release a mutex acquired with crgPortMutexLock()
+    * @param mutex  handle of the mutex, NULL is ignored
+    */
+    extern void crgPortMutexUnlock( void* mutex );
+    
+    /**
+    * create a condition variable
+    * @return handle of the condition variable, NULL if not available
+    */
+    extern void* crgPortCondCreate( void );
+    
+    /**
+    * delete a condition variable created with crgPortCondCreate()
+    * @param cond   handle of the condition variable, may be NULL
+    */
+    extern void crgPortCondDelete( void* cond );
+    
+    /**
+    * release a mutex held by the calling thread, wait for the condition
+    * variable to be signalled and re-acquire the mutex; wake-ups may be
+    * spurious, so the caller has to check its condition again
+    * @param cond   handle of the condition variable
+    * @param mutex  handle of the mutex held by the calling thread
+    */
+    extern void crgPortCondWait( void* cond, void* mutex );
+    
+    /**
+    * wake all threads waiting for a condition variable
+    * @param cond   handle of the condition variable, NULL is ignored
+    */
+    extern void crgPortCondBroadcast( void* cond );
+    
+    /**
+    * start a thread running in the background until its task returns
+    * @param task   function executed by the thread
+    * @param data   data passed to the function
+    * @return handle of the thread, NULL if no thread could be started
+    */
+    extern void* crgPortThreadStart( void ( *task )( void* data ), void* data );
+    
+    /**
+    * wait for a thread started with crgPortThreadStart() to finish and
+    * release its handle
+    * @param thread handle of the thread, may be NULL
+    */
+    extern void crgPortThreadJoin( void* thread );
+    
+    /**
+    * set the position of a file, also beyond the range of a long
+    * @param fPtr   the file
+    * @param offset position from the start of the file       [byte]
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgPortFileSeek( FILE* fPtr, size_t offset );
+    
+    /**
+    * get the number of processors available for concurrent tasks
+    * @return number of processors, at least 1
+    */
+    extern int crgPortGetNoProcessors( void );
+
+    /**
+    * full memory barrier, used by dCrgPortBarrierAcquire() and
+    * dCrgPortBarrierRelease() where the compiler provides no fences
+    */
+    extern void crgPortMemoryBarrier( void );
 
 
 #endif /* _CRG_BASELIB_PRIVATE_H */
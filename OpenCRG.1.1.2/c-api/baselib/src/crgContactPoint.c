@@ -27,11 +27,51 @@
 #include <string.h>
 
 /* ====== DEFINITIONS ====== */
+#define dCpBlock( cpId )  ( ( cpId ) / dCrgCpBlockSize )
+#define dCpEntry( cpId )  ( ( cpId ) % dCrgCpBlockSize )
 
 /* ====== TYPE DEFINITIONS ====== */
 
+/* ====== LOCAL METHODS ====== */
+/**
+* remove a contact point from the table and free it, caller holds dCrgLockContactPoints
+* @param cpId  id of the contact point
+* @return 1 if successful, otherwise 0
+*/
+static int deleteContactPoint( int cpId );
+
+/**
+* set a double option of a contact point including its immediate effects
+* @param cp           pointer to the contact point
+* @param optionId     id of the option
+* @param optionValue  value of the option
+* @return 1 if successful, otherwise 0
+*/
+static int optionSetDouble( CrgContactPointStruct* cp, unsigned int optionId, double optionValue );
+
+/**
+* set the default options of a contact point
+* @param cp  pointer to the contact point
+*/
+static void setDefaultOptions( CrgContactPointStruct* cp );
+
+/**
+* take over the prediction option of a contact point and restart the prediction
+* @param cp  pointer to the contact point
+*/
+static void updatePredictor( CrgContactPointStruct* cp );
+
+/**
+* remove a slot of a contact point's history from its bucket and mark it as released
+* @param hist  pointer to the history
+* @param slot  ring slot which is to be released
+*/
+static void unlinkHistorySlot( CrgHistoryStruct* hist, int slot );
+
 /* ====== LOCAL VARIABLES ====== */
-static CrgContactPointStruct** cpTable = NULL;
+/* --- the contact point table is kept in blocks which never move, so contact points --- */
+/* --- are looked up without locking while other threads create or delete entries   --- */
+static CrgContactPointStruct** cpTable[dCrgCpMaxBlocks];   /* guarded by dCrgLockContactPoints */
 static int cpTableSize = 0;
 
 /* ====== IMPLEMENTATION ====== */
@@ -47,47 +87,76 @@ crgContactPointCreate( int dataSetId )
     if ( !crgData )
         return -1;
 
-    cp = ( CrgContactPointStruct* )  crgCalloc( 1, sizeof( CrgContactPointStruct ) );
-
-    /* --- get the maximum ID of existing data sets --- */
-    for ( i = 0; i < cpTableSize; i++ )
+    if ( crgData->admin.headerOnly )
     {
-        /* --- found some free space in list of contact points? --- */
-        if ( !cpTable[i] )
-            tgtId = i;
-        else
-            ++validIds;
+        crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointCreate: data of data set <%d> has not been read.\n", dataSetId );
+        return -1;
     }
 
-    /* --- any unused ID available or do we need to exend the data management list? --- */
-    if ( tgtId < 0 )
-    {
-        cpTable = ( CrgContactPointStruct** ) crgRealloc( cpTable, ( cpTableSize + 1 ) * sizeof( CrgContactPointStruct* ) );
-        tgtId   = cpTableSize;
-        cpTableSize++;
-    }
-    
-    if ( !cpTable || !cp )
+    cp = ( CrgContactPointStruct* )  crgCalloc( 1, sizeof( CrgContactPointStruct ) );
+
+    if ( !cp )
     {
         crgMsgPrint( dCrgMsgLevelFatal, "crgCreateContactPoint: could not allocate new contact point.\n" );
         return -1;
     }
     
+    /* --- the contact point is set up completely before other threads may see it --- */
+    
     /* --- allocate space for the history --- */
     crgContactPointPtrSetHistory( cp, dCrgHistoryStdSize );
 
-    /* --- now register contact point in table --- */
-    cpTable[tgtId] = cp;
-    cp->crgData    = crgData;
+    cp->crgData = crgData;
     
     /* --- allocate the memory for the options --- */
     crgOptionCreateList( &( cp->options ) );
     
     /* --- set the default options of the contact point --- */
-    crgContactPointSetDefaultOptions( tgtId );
+    setDefaultOptions( cp );
     
     /* --- get the options defined in the data set --- */
     crgOptionCopyAll( &( cp->options ), &( crgData->options ) );
+    updatePredictor( cp );
+    crgEvalzSelectCpKernel( cp );
+    
+    /* --- evaluations shall not need to select a kernel on the fly --- */
+    crgEvalzInitKernel();
+    
+    crgPortLock( dCrgLockContactPoints );
+    
+    /* --- get the maximum ID of existing contact points --- */
+    for ( i = 0; i < cpTableSize; i++ )
+    {
+        /* --- found some free space in list of contact points? --- */
+        if ( !cpTable[dCpBlock( i )][dCpEntry( i )] )
+            tgtId = i;
+        else
+            ++validIds;
+    }
+
+    /* --- any unused ID available or do we need to extend the contact point table? --- */
+    if ( tgtId < 0 && cpTableSize < dCrgCpMaxBlocks * dCrgCpBlockSize )
+    {
+        if ( !cpTable[dCpBlock( cpTableSize )] )
+            cpTable[dCpBlock( cpTableSize )] = ( CrgContactPointStruct** ) crgCalloc( dCrgCpBlockSize, sizeof( CrgContactPointStruct* ) );
+        
+        if ( cpTable[dCpBlock( cpTableSize )] )
+            tgtId = cpTableSize++;
+    }
+    
+    /* --- now register contact point in table --- */
+    if ( tgtId >= 0 )
+        cpTable[dCpBlock( tgtId )][dCpEntry( tgtId )] = cp;
+    
+    crgPortUnlock( dCrgLockContactPoints );
+    
+    if ( tgtId < 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCreateContactPoint: could not allocate new contact point.\n" );
+        crgContactPointReset( cp );
+        crgFree( cp );
+        return -1;
+    }
     
 #ifdef dCrgEnableDebug2
     crgMsgPrint( dCrgMsgLevelNotice, "crgContactPointCreate: created contact point %d. Now have %d contact points.\n", tgtId, validIds );
@@ -99,18 +168,30 @@ crgContactPointCreate( int dataSetId )
 
 int 
 crgContactPointDelete( int cpId )
+{
+    int result;
+    
+    crgPortLock( dCrgLockContactPoints );
+    result = deleteContactPoint( cpId );
+    crgPortUnlock( dCrgLockContactPoints );
+    
+    return result;
+}
+
+static int
+deleteContactPoint( int cpId )
 {
     CrgContactPointStruct* cp = crgContactPointGetFromId( cpId );
    
     if ( !cp )
         return 0;
 
+    /* --- mark contact point in cp table as unused --- */
+    cpTable[dCpBlock( cpId )][dCpEntry( cpId )] = NULL;
+    
     /* --- free data associated with the contact point --- */
     crgContactPointReset( cp );
     
-    /* --- mark contact point in cp table as unused --- */
-    cpTable[cpId] = NULL;
-    
     /* --- free the actual contact point data --- */
     crgFree( cp );
     
@@ -127,10 +208,12 @@ crgContactPointDeleteAll( int dataSetId )
     CrgContactPointStruct* cp = NULL; 
     int cpId;
     
+    crgPortLock( dCrgLockContactPoints );
+    
     for ( cpId = 0; cpId < cpTableSize; cpId++ )
     {
         if ( dataSetId == -1 )
-            crgContactPointDelete( cpId );
+            deleteContactPoint( cpId );
         else
         {
             cp = crgContactPointGetFromId( cpId );
@@ -140,7 +223,7 @@ crgContactPointDeleteAll( int dataSetId )
                 if ( cp->crgData )
                 {
                     if ( cp->crgData->admin.id == dataSetId )
-                        crgContactPointDelete( cpId );
+                        deleteContactPoint( cpId );
                 }
             }
         }
@@ -149,11 +232,18 @@ crgContactPointDeleteAll( int dataSetId )
     /* --- now release any memory held for the contact point management --- */
     if ( dataSetId == -1 )
     {
-        crgFree( cpTable );
+        for ( cpId = 0; cpId < dCrgCpMaxBlocks; cpId++ )
+        {
+            if ( cpTable[cpId] )
+                crgFree( cpTable[cpId] );
+            
+            cpTable[cpId] = NULL;
+        }
     
-        cpTable     = NULL;
         cpTableSize = 0;
     }
+    
+    crgPortUnlock( dCrgLockContactPoints );
 }
 
 void
@@ -165,6 +255,20 @@ crgContactPointReset( CrgContactPointStruct* cp )
     if ( cp->history.entry )
         crgFree( cp->history.entry );
     
+    if ( cp->history.next )
+        crgFree( cp->history.next );
+    
+    if ( cp->history.prev )
+        crgFree( cp->history.prev );
+    
+    if ( cp->history.bucket )
+        crgFree( cp->history.bucket );
+    
+    cp->history.entry  = NULL;
+    cp->history.next   = NULL;
+    cp->history.prev   = NULL;
+    cp->history.bucket = NULL;
+    
     if ( cp->options.entry )
         crgFree( cp->options.entry );
     
@@ -187,16 +291,25 @@ crgContactPointSetCrgData( CrgContactPointStruct* cp, int dataSetId )
     /* --- history etc. won't work anymore! --- */
     crgContactPointReset( cp );
     
+    cp->predict.noValid = 0;
+    
+    crgEvalzSelectCpKernel( cp );
+    
     return 1;
 }
 
 CrgContactPointStruct* 
 crgContactPointGetFromId( int cpId )
 {
-    if ( cpId < 0 || cpId >= cpTableSize )
+    CrgContactPointStruct** block;
+    
+    if ( cpId < 0 || cpId >= dCrgCpMaxBlocks * dCrgCpBlockSize )
         return NULL;
     
-    return cpTable[cpId];
+    if ( !( block = cpTable[dCpBlock( cpId )] ) )
+        return NULL;
+    
+    return block[dCpEntry( cpId )];
 }
 
 int 
@@ -210,7 +323,15 @@ crgContactPointOptionSetInt( int cpId, unsigned int optionId, int optionValue )
         return 0;
     }
     
-    return crgOptionSetInt( &( cp->options ), optionId, optionValue );
+    if ( !crgOptionSetInt( &( cp->options ), optionId, optionValue ) )
+        return 0;
+    
+    if ( optionId == dCrgCpOptionRefLinePredict )
+        updatePredictor( cp );
+    
+    crgEvalzSelectCpKernel( cp );
+    
+    return 1;
 }
 
 int 
@@ -224,26 +345,7 @@ crgContactPointOptionSetDouble( int cpId, unsigned int optionId, double optionVa
         return 0;
     }
     
-    /* --- some options have immediate effect on other settings --- */
-    /* --- or should be registered at additional places for     --- */
-    /* --- higher performance during queries                    --- */
-    switch ( optionId )
-    {
-        case dCrgCpOptionRefLineSearchU:
-            crgContactPointPreloadHistoryU( cp, optionValue );
-            break;
-        case dCrgCpOptionRefLineSearchUFrac:
-            crgContactPointPreloadHistoryUFrac( cp, optionValue );
-            break;
-        case dCrgCpOptionRefLineClose:
-            cp->history.closeDist = optionValue * optionValue; /* internally, square of distance is used */
-            break;
-        case dCrgCpOptionRefLineFar:
-            cp->history.farDist = optionValue * optionValue;     /* internally, square of distance is used */
-            break;
-    }
-    
-    return crgOptionSetDouble( &( cp->options ), optionId, optionValue );
+    return optionSetDouble( cp, optionId, optionValue );
 }
 
 int 
@@ -285,7 +387,13 @@ crgContactPointOptionRemove( int cpId, unsigned int optionId )
         return 0;
     }
 
-    return crgOptionRemove( &( cp->options ), optionId );
+    if ( !crgOptionRemove( &( cp->options ), optionId ) )
+        return 0;
+    
+    updatePredictor( cp );
+    crgEvalzSelectCpKernel( cp );
+    
+    return 1;
 }
 
 int
@@ -299,7 +407,13 @@ crgContactPointOptionRemoveAll( int cpId )
         return 0;
     }
     
-    return crgOptionRemoveAll( &( cp->options ) );
+    if ( !crgOptionRemoveAll( &( cp->options ) ) )
+        return 0;
+    
+    updatePredictor( cp );
+    crgEvalzSelectCpKernel( cp );
+    
+    return 1;
 }
 
 void
@@ -316,6 +430,37 @@ crgContactPointOptionsPrint( int cpId )
     crgOptionsPrint( &( cp->options ), "option" );
 }
 
+static int
+optionSetDouble( CrgContactPointStruct* cp, unsigned int optionId, double optionValue )
+{
+    /* --- some options have immediate effect on other settings --- */
+    /* --- or should be registered at additional places for     --- */
+    /* --- higher performance during queries                    --- */
+    switch ( optionId )
+    {
+        case dCrgCpOptionRefLineSearchU:
+            crgContactPointPreloadHistoryU( cp, optionValue );
+            break;
+        case dCrgCpOptionRefLineSearchUFrac:
+            crgContactPointPreloadHistoryUFrac( cp, optionValue );
+            break;
+        case dCrgCpOptionRefLineClose:
+            cp->history.closeDist = optionValue * optionValue; /* internally, square of distance is used */
+            break;
+        case dCrgCpOptionRefLineFar:
+            cp->history.farDist = optionValue * optionValue;     /* internally, square of distance is used */
+            break;
+    }
+    
+    if ( !crgOptionSetDouble( &( cp->options ), optionId, optionValue ) )
+        return 0;
+    
+    /* --- border and smoothing options select the evaluation kernel --- */
+    crgEvalzSelectCpKernel( cp );
+    
+    return 1;
+}
+
 void
 crgContactPointSetDefaultOptions( int cpId )
 {
@@ -327,11 +472,27 @@ crgContactPointSetDefaultOptions( int cpId )
         return;
     }
     
+    setDefaultOptions( cp );
+}
+
+static void
+setDefaultOptions( CrgContactPointStruct* cp )
+{
     crgOptionSetDefaultOptions( &( cp->options ) );
     
     /* --- copy history options back to contact point's history buffer --- */
-    crgContactPointOptionSetDouble( cpId, dCrgCpOptionRefLineClose, 0.3 );
-    crgContactPointOptionSetDouble( cpId, dCrgCpOptionRefLineFar,   2.2 );
+    optionSetDouble( cp, dCrgCpOptionRefLineClose, 0.3 );
+    optionSetDouble( cp, dCrgCpOptionRefLineFar,   2.2 );
+    
+    updatePredictor( cp );
+    crgEvalzSelectCpKernel( cp );
+}
+
+static void
+updatePredictor( CrgContactPointStruct* cp )
+{
+    cp->predict.active  = ( short ) crgOptionHasValueInt( &( cp->options ), dCrgCpOptionRefLinePredict, 1 );
+    cp->predict.noValid = 0;
 }
 
 int
@@ -371,6 +532,8 @@ crgContactPointSetHistory( int cpId, int histSize )
 int
 crgContactPointPtrSetHistory( CrgContactPointStruct *cp, int histSize )
 {
+    int noBuckets;
+    
     if ( !cp )
         return 0;
     
@@ -384,20 +547,49 @@ crgContactPointPtrSetHistory( CrgContactPointStruct *cp, int histSize )
     if ( cp->history.entry )
         crgFree( cp->history.entry );
     
-    cp->history.entry     = NULL;
-    cp->history.totalSize = histSize;
-    cp->history.usedSize  = 0;
-    cp->history.entrySize = sizeof( CrgHistoryEntryStruct );
-
+    if ( cp->history.next )
+        crgFree( cp->history.next );
+    
+    if ( cp->history.prev )
+        crgFree( cp->history.prev );
+    
+    if ( cp->history.bucket )
+        crgFree( cp->history.bucket );
+    
+    cp->history.entry      = NULL;
+    cp->history.next       = NULL;
+    cp->history.prev       = NULL;
+    cp->history.bucket     = NULL;
+    cp->history.totalSize  = histSize;
+    cp->history.usedSize   = 0;
+    cp->history.head       = 0;
+    cp->history.bucketMask = 0;
+    cp->history.entrySize  = sizeof( CrgHistoryEntryStruct );
+    
     if ( histSize )
-        cp->history.entry = ( CrgHistoryEntryStruct* ) crgCalloc( histSize, sizeof( CrgHistoryEntryStruct ) );
+    {
+        /* --- at least two buckets per entry keep the bucket chains short --- */
+        noBuckets = 1;
+        
+        while ( noBuckets < 2 * histSize )
+            noBuckets *= 2;
+        
+        cp->history.bucketMask = noBuckets - 1;
+        
+        cp->history.entry  = ( CrgHistoryEntryStruct* ) crgCalloc( histSize, sizeof( CrgHistoryEntryStruct ) );
+        cp->history.next   = ( int* ) crgCalloc( histSize, sizeof( int ) );
+        cp->history.prev   = ( int* ) crgCalloc( histSize, sizeof( int ) );
+        cp->history.bucket = ( int* ) crgCalloc( noBuckets, sizeof( int ) );
+    }
     
-    if ( !( cp->history.entry ) )
+    if ( histSize && !( cp->history.entry && cp->history.next && cp->history.prev && cp->history.bucket ) )
     {
         crgMsgPrint( dCrgMsgLevelNotice, "crgContactPointPtrSetHistory: could not allocate history.\n" );
         return 0;
     }
     
+    crgContactPointHistoryClear( cp );
+    
     /* --- pre-calculate some history variables (note: it's the square value!) --- */
     if ( cp->crgData )
     {
@@ -418,22 +610,50 @@ crgContactPointSetHistoryForDataSet( CrgDataStruct *crgData, int histSize )
 {
     int i;
     int result = 1;
+    CrgContactPointStruct* cp;
     
     if ( !crgData )
         return 0;
     
+    crgPortLock( dCrgLockContactPoints );
+    
     for ( i = 0; i < cpTableSize; i++ )
     {
-        if ( cpTable[i] )
+        if ( ( cp = crgContactPointGetFromId( i ) ) )
         {
-            if ( cpTable[i]->crgData == crgData )
-                result = result && crgContactPointSetHistoryForDataSet( crgData, histSize );
+            if ( cp->crgData == crgData )
+                result = crgContactPointPtrSetHistory( cp, histSize ) && result;
         }
     }
     
+    crgPortUnlock( dCrgLockContactPoints );
+    
     return result;
 }
 
+void
+crgContactPointSelectKernelForDataSet( CrgDataStruct *crgData )
+{
+    int i;
+    CrgContactPointStruct* cp;
+    
+    if ( !crgData )
+        return;
+    
+    crgPortLock( dCrgLockContactPoints );
+    
+    for ( i = 0; i < cpTableSize; i++ )
+    {
+        if ( ( cp = crgContactPointGetFromId( i ) ) )
+        {
+            if ( cp->crgData == crgData )
+                crgEvalzSelectCpKernel( cp );
+        }
+    }
+    
+    crgPortUnlock( dCrgLockContactPoints );
+}
+
 void
 crgContactPointPreloadHistoryU( CrgContactPointStruct *cp, double u )
 {
@@ -453,10 +673,6 @@ crgContactPointPreloadHistoryU( CrgContactPointStruct *cp, double u )
     if ( !cp->history.totalSize )
         return;
     
-    /* --- shift previous values --- */
-    if ( cp->history.totalSize > 1 )
-        memmove( &( cp->history.entry[1] ), cp->history.entry, ( cp->history.totalSize - 1 ) * cp->history.entrySize );
-    
     /* --- compute x and y for u on reference line --- */
     frac = ( u - cp->crgData->channelU.info.first ) / cp->crgData->channelU.info.inc;
     
@@ -473,16 +689,118 @@ crgContactPointPreloadHistoryU( CrgContactPointStruct *cp, double u )
     
     frac -= index;
 
+    /* --- old elements will be deleted from stack, the motion starts anew --- */
+    crgContactPointHistoryClear( cp );
+    
+    cp->predict.noValid = 0;
+    
     cp->history.entry[0].x     = cp->crgData->channelX.data[index] + frac * ( cp->crgData->channelX.data[index+1] - cp->crgData->channelX.data[index] );
     cp->history.entry[0].y     = cp->crgData->channelY.data[index] + frac * ( cp->crgData->channelY.data[index+1] - cp->crgData->channelY.data[index] );
     cp->history.entry[0].index = index;
-    
-    /* --- old elements will be deleted from stack --- */
-    cp->history.usedSize = 1;
+    cp->history.next[0]        = -1;
+    cp->history.prev[0]        = -1;
+    cp->history.bucket[index & cp->history.bucketMask] = 0;
+    cp->history.usedSize       = 1;
     
     /** @todo: check whether restricting used size is ok or whether pre-loading of multiple values shall be allowed */
 }
     
+void
+crgContactPointHistoryPush( CrgContactPointStruct *cp, double x, double y, size_t index )
+{
+    CrgHistoryStruct* hist = &( cp->history );
+    int    slot;
+    double dx;
+    double dy;
+    
+    if ( hist->totalSize < 2 )
+        return;
+    
+    /* --- same interval as the newest entry: just update the position --- */
+    if ( !hist->usedSize || hist->entry[hist->head].index != index )
+    {
+        /* --- the newest older entry of the same interval is released if it was made at the same place; --- */
+        /* --- entries of other places on the interval (e.g. the other wheel of an axle) are kept        --- */
+        for ( slot = hist->bucket[index & hist->bucketMask]; slot >= 0; slot = hist->next[slot] )
+        {
+            if ( hist->entry[slot].index != index )
+                continue;
+            
+            dx = x - hist->entry[slot].x;
+            dy = y - hist->entry[slot].y;
+            
+            if ( dx * dx + dy * dy < hist->closeDist )
+            {
+                unlinkHistorySlot( hist, slot );
+                
+#ifdef dCrgEnableStats
+                if ( hist->stat.active )
+                    hist->stat.noReplaced++;
+#endif
+            }
+            break;
+        }
+        
+        /* --- advance the head, the oldest entry is overwritten if the ring is full --- */
+        if ( hist->usedSize )
+            hist->head = ( hist->head + 1 < hist->totalSize ) ? hist->head + 1 : 0;
+        
+        if ( hist->usedSize < hist->totalSize )
+            hist->usedSize++;
+        else if ( dCrgHistorySlotValid( hist, hist->head ) )
+            unlinkHistorySlot( hist, hist->head );
+        
+        /* --- newest entry goes to the front of its bucket --- */
+        slot = hist->bucket[index & hist->bucketMask];
+        
+        hist->entry[hist->head].index = index;
+        hist->next[hist->head]        = slot;
+        hist->prev[hist->head]        = -1;
+        
+        if ( slot >= 0 )
+            hist->prev[slot] = hist->head;
+        
+        hist->bucket[index & hist->bucketMask] = hist->head;
+        
+#ifdef dCrgEnableStats
+        if ( hist->stat.active )
+            hist->stat.noInserts++;
+#endif
+    }
+    
+    hist->entry[hist->head].x = x;
+    hist->entry[hist->head].y = y;
+}
+
+static void
+unlinkHistorySlot( CrgHistoryStruct* hist, int slot )
+{
+    if ( hist->prev[slot] >= 0 )
+        hist->next[hist->prev[slot]] = hist->next[slot];
+    else
+        hist->bucket[hist->entry[slot].index & hist->bucketMask] = hist->next[slot];
+    
+    if ( hist->next[slot] >= 0 )
+        hist->prev[hist->next[slot]] = hist->prev[slot];
+    
+    hist->next[slot] = -2;
+}
+
+void
+crgContactPointHistoryClear( CrgContactPointStruct *cp )
+{
+    int i;
+    
+    if ( !cp || !cp->history.totalSize )
+        return;
+    
+    for ( i = 0; i <= cp->history.bucketMask; i++ )
+        cp->history.bucket[i] = -1;
+    
+    cp->history.usedSize = 0;
+    cp->history.head     = 0;
+}
+
 void
 crgContactPointPreloadHistoryUFrac( CrgContactPointStruct *cp, double uFrac )
 {
@@ -520,8 +838,7 @@ crgContactPointActivatePerfStat( int cpId )
     crgContactPointResetPerfStat( cp );
     
     cp->history.stat.active = 1;
-    if ( cp->crgData )
-        cp->crgData->perfStat.active = 1;
+    cp->perfStat.active     = 1;
 }
 
 void
@@ -542,8 +859,7 @@ crgContactPointDeActivatePerfStat( int cpId )
     }
     
     cp->history.stat.active = 0;
-    if ( cp->crgData )
-        cp->crgData->perfStat.active = 0;
+    cp->perfStat.active     = 0;
 }
 
 void
@@ -559,9 +875,7 @@ crgContactPointResetPerfStat( CrgContactPointStruct *cp )
         return;
     
     memset( &( cp->history.stat ), 0, sizeof( CrgHistoryStatStruct ) );
-    
-    if ( cp->crgData )
-        memset( &( cp->crgData->perfStat ), 0, sizeof( CrgPerformanceStruct ) );
+    memset( &( cp->perfStat ), 0, sizeof( CrgPerformanceStruct ) );
 }
 
 void
@@ -584,38 +898,55 @@ crgContactPointPrintPerfStat( int cpId )
     crgMsgPrint( dCrgMsgLevelNotice, "        total number of iterations:       %d\n", cp->history.stat.noIter         );
     crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop 1:  %d\n", cp->history.stat.noCallsLoop1   );
     crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop 2:  %d\n", cp->history.stat.noCallsLoop2   );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of new entries:      %d\n", cp->history.stat.noInserts      );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of replaced entries: %d\n", cp->history.stat.noReplaced     );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of predicted hits:   %d\n", cp->history.stat.noPredictHits  );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of predicted misses: %d\n", cp->history.stat.noPredictMisses );
     
-    if ( cp->crgData )
+    if ( cp->history.stat.noTotalQueries )
     {
-        crgMsgPrint( dCrgMsgLevelNotice, "    Evaluation\n" );
-        crgMsgPrint( dCrgMsgLevelNotice, "        total number of queries:             %d\n", cp->crgData->perfStat.noTotalQueries     );
-        crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop V1:    %d\n", cp->crgData->perfStat.noCallsLoopV1      );
-        crgMsgPrint( dCrgMsgLevelNotice, "        max. number of calls to loop V1:     %d\n", cp->crgData->perfStat.maxCallsLoopV1     );
-        crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to border U:   %d\n", cp->crgData->perfStat.noCallsBorderU     );
-        crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to border V:   %d\n", cp->crgData->perfStat.noCallsBorderV     );
+        crgMsgPrint( dCrgMsgLevelNotice, "        close hit rate:                   %.2f%%\n", 
+                     100.0 * cp->history.stat.noCloseHits / cp->history.stat.noTotalQueries );
+        crgMsgPrint( dCrgMsgLevelNotice, "        iterations per query:             %.3f\n", 
+                     1.0 * cp->history.stat.noIter / cp->history.stat.noTotalQueries );
+        crgMsgPrint( dCrgMsgLevelNotice, "        calls to loops 1/2 per query:     %.3f\n", 
+                     1.0 * ( cp->history.stat.noCallsLoop1 + cp->history.stat.noCallsLoop2 ) / cp->history.stat.noTotalQueries );
     }
+    crgMsgPrint( dCrgMsgLevelNotice, "    Evaluation\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of queries:             %d\n", cp->perfStat.noTotalQueries     );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop V1:    %d\n", cp->perfStat.noCallsLoopV1      );
+    crgMsgPrint( dCrgMsgLevelNotice, "        max. number of calls to loop V1:     %d\n", cp->perfStat.maxCallsLoopV1     );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to border U:   %d\n", cp->perfStat.noCallsBorderU     );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to border V:   %d\n", cp->perfStat.noCallsBorderV     );
 }
 
 void
 crgContactPointPrintHistory( CrgContactPointStruct *cp, double x, double y )
 {
     int i;
+    int slot;
     
     if ( !cp )
         return;
     
     crgMsgPrint( dCrgMsgLevelNotice, "History for contact point %p during query %d\n", ( void* ) ( cp ), cp->history.stat.noTotalQueries );
     
-    for ( i = 0; i < cp->history.usedSize; i++ )
+    for ( i = 0, slot = cp->history.head; i < cp->history.usedSize; i++, slot = dCrgHistoryPrevSlot( &( cp->history ), slot ) )
     {
-        double dx =  ( cp->history.entry[i].x - x );
-        double dy =  ( cp->history.entry[i].y - y );
+        double dx;
+        double dy;
         double dist2;
         
+        if ( !dCrgHistorySlotValid( &( cp->history ), slot ) )
+            continue;
+        
+        dx = cp->history.entry[slot].x - x;
+        dy = cp->history.entry[slot].y - y;
+        
         dist2 = dx * dx + dy * dy;
 
         crgMsgPrint( dCrgMsgLevelNotice, "entry %d: x / y = %.3f / %.3f, dist2 = %.3lf, index = %d\n", 
-                                         i, cp->history.entry[i].x, cp->history.entry[i].y, dist2, cp->history.entry[i].index  );
+                                         i, cp->history.entry[slot].x, cp->history.entry[slot].y, dist2, ( int ) cp->history.entry[slot].index  );
     }
     
 }
@@ -0,0 +1,241 @@
+/* ===================================================
+ *  file:       crgEvalPatch.c
+ * ---------------------------------------------------
+ *  purpose:	evaluate the elevation on a rectangular
+ *              contact patch (e.g. under a tire) and
+ *              compute its aggregate statistics
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include <math.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dPatchChunkSize  64       /* number of samples handed to the interpolation kernels at once [-] */
+
+/* ====== TYPE DEFINITIONS ====== */
+
+/* ====== LOCAL METHODS ====== */
+/**
+* compute the relative position of a sample along one edge of the patch
+* @param idx     index of the sample
+* @param n       number of samples along the edge
+* @return relative position in the range [0, 1], 0.5 for a single sample
+*/
+static double samplePos( int idx, int n );
+
+/**
+* compute the aggregate statistics of the samples of a patch
+* @param z       array of the samples
+* @param length  length of the patch
+* @param width   width of the patch
+* @param nLength number of samples along the length
+* @param nWidth  number of samples across the width
+* @param stat    array of dCrgPatchStatSize resulting values
+*/
+static void calcPatchStat( const double* z, double length, double width, int nLength, int nWidth, double* stat );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgEvalPatch( int cpId, double x, double y, double phi, double length, double width, int nLength, int nWidth, double* z, double* stat )
+{
+    CrgContactPointStruct* cp;
+
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+
+    return crgEvalPatchPtr( cp, x, y, phi, length, width, nLength, nWidth, z, stat );
+}
+
+int
+crgEvalPatchPtr( CrgContactPointStruct *cp, double x, double y, double phi, double length, double width, int nLength, int nWidth, double* z, double* stat )
+{
+    CrgDataStruct*    crgData;
+    CrgOptionsStruct* optionList;
+    int    retVal  = 1;
+    int    direct  = 1;
+    int    noPts   = nLength * nWidth;
+    int    noChunk = 0;
+    int    idx;
+    int    i;
+    double cosPhi  = cos( phi );
+    double sinPhi  = sin( phi );
+    double cornerU[4];
+    double cornerV[4];
+    double u[dPatchChunkSize];
+    double v[dPatchChunkSize];
+    double period;
+    double a;
+    double b;
+    double s;
+    double t;
+
+    if ( !cp || !z || nLength < 1 || nWidth < 1 )
+        return 0;
+
+    if ( !( crgData = cp->crgData ) )
+        return 0;
+
+    optionList = &( cp->options );
+
+    /* --- invert the corners (rear right, rear left, front right, front left) only --- */
+    for ( i = 0; i < 4; i++ )
+    {
+        s = ( ( i & 2 ) ? 0.5 : -0.5 ) * length;
+        t = ( ( i & 1 ) ? 0.5 : -0.5 ) * width;
+
+        if ( !crgEvalxy2uvPtr( cp, x + s * cosPhi - t * sinPhi, y + t * cosPhi + s * sinPhi, &( cornerU[i] ), &( cornerV[i] ) ) )
+            direct = 0;
+    }
+
+    /* --- a patch across the end of a closed reference line must not be torn apart --- */
+    if ( crgData->util.uIsClosed )
+    {
+        period = crgData->util.uCloseMax - crgData->util.uCloseMin;
+
+        for ( i = 1; i < 4; i++ )
+        {
+            if ( cornerU[i] - cornerU[0] > 0.5 * period )
+                cornerU[i] -= period;
+            else if ( cornerU[0] - cornerU[i] > 0.5 * period )
+                cornerU[i] += period;
+        }
+    }
+
+    /* --- sample positions are handed to the interpolation kernels in chunks --- */
+    for ( idx = 0; idx < noPts; idx += noChunk )
+    {
+        noChunk = noPts - idx < dPatchChunkSize ? noPts - idx : dPatchChunkSize;
+
+        for ( i = 0; i < noChunk; i++ )
+        {
+            a = samplePos( ( idx + i ) / nWidth, nLength );
+            b = samplePos( ( idx + i ) % nWidth, nWidth );
+
+            if ( direct )
+            {
+                /* --- bilinear interpolation of the corner positions in (u,v) space --- */
+                u[i] = ( 1.0 - a ) * ( ( 1.0 - b ) * cornerU[0] + b * cornerU[1] ) + a * ( ( 1.0 - b ) * cornerU[2] + b * cornerU[3] );
+                v[i] = ( 1.0 - a ) * ( ( 1.0 - b ) * cornerV[0] + b * cornerV[1] ) + a * ( ( 1.0 - b ) * cornerV[2] + b * cornerV[3] );
+            }
+            else
+            {
+                /* --- fallback: full inversion of each sample --- */
+                s = ( a - 0.5 ) * length;
+                t = ( b - 0.5 ) * width;
+
+                if ( !crgEvalxy2uvPtr( cp, x + s * cosPhi - t * sinPhi, y + t * cosPhi + s * sinPhi, &( u[i] ), &( v[i] ) ) )
+                    retVal = 0;
+            }
+        }
+
+        if ( !crgDataEvaluv2zBatch( crgData, optionList, &( cp->perfStat ), noChunk, u, v, &( z[idx] ), NULL ) )
+            retVal = 0;
+    }
+
+    if ( stat )
+        calcPatchStat( z, length, width, nLength, nWidth, stat );
+
+    cp->z = z[( nLength / 2 ) * nWidth + nWidth / 2];
+
+    return retVal;
+}
+
+static double
+samplePos( int idx, int n )
+{
+    if ( n < 2 )
+        return 0.5;
+
+    return ( double ) idx / ( n - 1 );
+}
+
+static void
+calcPatchStat( const double* z, double length, double width, int nLength, int nWidth, double* stat )
+{
+    int    j;
+    int    k;
+    int    noPts  = nLength * nWidth;
+    double sumZ   = 0.0;
+    double sumSZ  = 0.0;
+    double sumTZ  = 0.0;
+    double sumSS  = 0.0;
+    double sumTT  = 0.0;
+    double slopeS = 0.0;
+    double slopeT = 0.0;
+    double dzMax;
+    double dz;
+    double s;
+    double t;
+
+    stat[dCrgPatchStatZMin] = z[0];
+    stat[dCrgPatchStatZMax] = z[0];
+
+    for ( j = 0; j < nLength; j++ )
+    {
+        s = ( samplePos( j, nLength ) - 0.5 ) * length;
+
+        for ( k = 0; k < nWidth; k++ )
+        {
+            t = ( samplePos( k, nWidth ) - 0.5 ) * width;
+
+            if ( z[j * nWidth + k] < stat[dCrgPatchStatZMin] )
+                stat[dCrgPatchStatZMin] = z[j * nWidth + k];
+
+            if ( z[j * nWidth + k] > stat[dCrgPatchStatZMax] )
+                stat[dCrgPatchStatZMax] = z[j * nWidth + k];
+
+            sumZ  += z[j * nWidth + k];
+            sumSZ += s * z[j * nWidth + k];
+            sumTZ += t * z[j * nWidth + k];
+            sumSS += s * s;
+            sumTT += t * t;
+        }
+    }
+
+    /* --- the samples are symmetric to the center, so the least squares plane decouples --- */
+    stat[dCrgPatchStatZMean] = sumZ / noPts;
+
+    if ( sumSS > 0.0 )
+        slopeS = sumSZ / sumSS;
+
+    if ( sumTT > 0.0 )
+        slopeT = sumTZ / sumTT;
+
+    stat[dCrgPatchStatSlopeLength] = slopeS;
+    stat[dCrgPatchStatSlopeWidth]  = slopeT;
+
+    /* --- lift the fitted plane until it rests on the highest sample (residuals sum up to zero) --- */
+    dzMax = 0.0;
+
+    for ( j = 0; j < nLength; j++ )
+    {
+        s = ( samplePos( j, nLength ) - 0.5 ) * length;
+
+        for ( k = 0; k < nWidth; k++ )
+        {
+            t  = ( samplePos( k, nWidth ) - 0.5 ) * width;
+            dz = z[j * nWidth + k] - stat[dCrgPatchStatZMean] - slopeS * s - slopeT * t;
+
+            if ( dz > dzMax )
+                dzMax = dz;
+        }
+    }
+
+    stat[dCrgPatchStatZEnvelope] = stat[dCrgPatchStatZMean] + dzMax;
+}
@@ -75,7 +75,6 @@ int
 crgDataEvaluv2pk( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u, double v, double* phi, double* curv )
 {
     size_t indexU = 0;
-    size_t nU;
     double fracU;
 
     /* --- compute the fallback solution --- */
@@ -108,8 +107,14 @@ crgDataEvaluv2pk( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u
             indexU = crgData->channelU.info.size - 2;
     }
     
-    fracU -= indexU;
+    return crgDataEvalpkAtIndex( crgData, optionList, indexU, v, phi, curv );
+}
 
+int
+crgDataEvalpkAtIndex( CrgDataStruct *crgData, CrgOptionsStruct* optionList, size_t indexU, double v, double* phi, double* curv )
+{
+    size_t nU;
+    
     /* get curvature on road sections of 0.5m length - if possible */
     nU = ( size_t ) ( 0.5 / crgData->channelU.info.inc );
     
@@ -135,14 +140,20 @@ crgDataEvaluv2pk( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u
         *     P1: iu1 = iu     : (X1, Y1)
         *     P2: iu2 = iu + nu: (X2, Y2)
         *     curv = dphi/ds = (P1-P0)x(P2-P1) / |P1-P0|**3
+        *     unless it has been prepared with the data set
         */
-        double hd  = 1.0 / pow( crgData->channelU.info.inc * nU, 3.0 );
-        double dx0 = crgData->channelX.data[indexU]    - crgData->channelX.data[indexU-nU];
-        double dx1 = crgData->channelX.data[indexU+nU] - crgData->channelX.data[indexU];
-        double dy0 = crgData->channelY.data[indexU]    - crgData->channelY.data[indexU-nU];
-        double dy1 = crgData->channelY.data[indexU+nU] - crgData->channelY.data[indexU];
-        
-        *curv = ( dx0 * dy1 - dy0 * dx1 ) * hd;
+        if ( crgData->refLineGeom.valid && crgData->refLineGeom.curvWindow == nU && indexU < crgData->refLineGeom.size )
+            *curv = crgData->refLineGeom.curv[indexU];
+        else
+        {
+            double hd  = 1.0 / pow( crgData->channelU.info.inc * nU, 3.0 );
+            double dx0 = crgData->channelX.data[indexU]    - crgData->channelX.data[indexU-nU];
+            double dx1 = crgData->channelX.data[indexU+nU] - crgData->channelX.data[indexU];
+            double dy0 = crgData->channelY.data[indexU]    - crgData->channelY.data[indexU-nU];
+            double dy1 = crgData->channelY.data[indexU+nU] - crgData->channelY.data[indexU];
+            
+            *curv = ( dx0 * dy1 - dy0 * dx1 ) * hd;
+        }
         
         /* now take v into account if the corresponding option is set */
         if ( crgOptionHasValueInt( optionList, dCrgCpOptionCurvMode, dCrgCurvLateral ) &&
@@ -133,6 +133,20 @@ crgDataEvaluv2xy( CrgDataStruct* crgData, CrgOptionsStruct* optionList, double u
     p2[0] = crgData->channelX.data[index+1];
     p2[1] = crgData->channelY.data[index+1];
     
+    /* --- normals through P1 and P2 have been prepared with the data set? --- */
+    if ( crgData->refLineGeom.valid )
+    {
+        a[0] = p1[0] + v * crgData->refLineGeom.begNormX[index];
+        a[1] = p1[1] + v * crgData->refLineGeom.begNormY[index];
+        b[0] = p2[0] + v * crgData->refLineGeom.endNormX[index];
+        b[1] = p2[1] + v * crgData->refLineGeom.endNormY[index];
+        
+        *x = a[0] + frac * ( b[0] - a[0] );
+        *y = a[1] + frac * ( b[1] - a[1] );
+        
+        return 1;
+    }
+    
     /* --- normal on P1P2 --- */
     n12[0] = - ( p2[1] - p1[1] );
     n12[1] =     p2[0] - p1[0];
@@ -0,0 +1,171 @@
+/* ===================================================
+ *  file:       crgEvalxy2all.c
+ * ---------------------------------------------------
+ *  purpose:	compute u/v position, elevation, heading
+ *              and curvature at a given x/y position
+ *              in one call
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+
+/* ====== TYPE DEFINITIONS ====== */
+
+/* ====== LOCAL METHODS ====== */
+/**
+* find the u interval of a (u,v) position once and compute elevation,
+* heading and curvature from it
+* @param cp      pointer to contact point which is to be used
+* @param u       u co-ordinate
+* @param v       v co-ordinate
+* @param z       pointer to resulting z co-ordinate, NULL if elevation is not required
+* @param phi     pointer to resulting heading angle
+* @param curv    pointer to resulting curvature
+* @return 1 if successful, otherwise 0
+*/
+static int evalFromUV( CrgContactPointStruct* cp, double u, double v, double* z, double* phi, double* curv );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgEvalxy2all( int cpId, double x, double y, double* u, double* v, double* z, double* phi, double* curv )
+{
+    CrgContactPointStruct* cp;
+
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+
+    return crgEvalxy2allPtr( cp, x, y, u, v, z, phi, curv );
+}
+
+int
+crgEvalxy2allPtr( CrgContactPointStruct *cp, double x, double y, double* u, double* v, double* z, double* phi, double* curv )
+{
+    int retVal;
+
+    /* --- compute the fallback solution --- */
+    *z    = 0.0;
+    *phi  = 0.0;
+    *curv = 0.0;
+
+    if ( !crgEvalxy2uvPtr( cp, x, y, u, v ) )
+        return 0;
+
+    retVal = evalFromUV( cp, *u, *v, z, phi, curv );
+
+    /* --- transfer the result --- */
+    cp->z    = *z;
+    cp->phi  = *phi;
+    cp->curv = *curv;
+
+    return retVal;
+}
+
+int
+crgEvalxy2allBatch( int cpId, int n, const double* x, const double* y, double* u, double* v, double* z, double* phi, double* curv )
+{
+    CrgContactPointStruct* cp;
+    int retVal;
+    int i;
+
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+
+    if ( n < 0 || ( n && ( !phi || !curv ) ) )
+        return 0;
+
+    /* --- positions and elevations take the batch paths, they share the search and the kernels --- */
+    if ( !crgEvalxy2uvBatchPtr( cp, n, x, y, u, v ) )
+        return 0;
+
+    retVal = crgEvaluv2zBatchPtr( cp, n, u, v, z, NULL );
+
+    for ( i = 0; i < n; i++ )
+        evalFromUV( cp, u[i], v[i], NULL, &( phi[i] ), &( curv[i] ) );
+
+    if ( n > 0 )
+    {
+        cp->phi  = phi[n-1];
+        cp->curv = curv[n-1];
+    }
+
+    return retVal;
+}
+
+static int
+evalFromUV( CrgContactPointStruct* cp, double u, double v, double* z, double* phi, double* curv )
+{
+    CrgDataStruct*    crgData    = cp->crgData;
+    CrgOptionsStruct* optionList = &( cp->options );
+    int    retVal = 1;
+    size_t indexU = 0;
+    double uPos   = u;
+    double fracU;
+
+    *phi  = 0.0;
+    *curv = 0.0;
+
+    if ( !crgData )
+    {
+        if ( z )
+            *z = 0.0;
+
+        return 0;
+    }
+
+    /* --- wrap u once for all quantities --- */
+    if ( crgData->util.uIsClosed )
+        crgEvalu2uvalid( crgData, optionList, &uPos );
+
+    fracU = ( uPos - crgData->channelU.info.first ) / crgData->channelU.info.inc;
+
+    if ( fracU >= 0.0 )
+    {
+        indexU = ( size_t ) fracU;
+
+        /* data dimension is at least 2x2 */
+        if ( indexU >= crgData->channelU.info.size - 1 )
+        {
+            indexU = crgData->channelU.info.size - 2;
+            fracU  = 1.0;
+        }
+        else
+            fracU -= indexU;
+    }
+
+    if ( z )
+    {
+        /* --- positions outside the core area or within a smoothing zone take the full path --- */
+        if ( ( uPos < crgData->channelU.info.first ) || ( uPos > crgData->channelU.info.last ) ||
+             ( v < crgData->channelV.info.first ) || ( v > crgData->channelV.info.last ) ||
+             ( optionList->entry[dCrgCpOptionSmoothUBegin].valid &&
+               ( ( uPos - crgData->channelU.info.first ) <= optionList->entry[dCrgCpOptionSmoothUBegin].dValue ) ) ||
+             ( optionList->entry[dCrgCpOptionSmoothUEnd].valid &&
+               ( ( crgData->channelU.info.last - uPos ) <= optionList->entry[dCrgCpOptionSmoothUEnd].dValue ) ) )
+            retVal = crgDataEvaluv2z( crgData, optionList, &( cp->perfStat ), u, v, z );
+        else
+            retVal = crgDataEvaluv2zCore( crgData, &( cp->perfStat ), indexU, fracU, v, z );
+    }
+
+    /* --- center line available as x/y data? --- */
+    if ( crgData->channelX.info.size )
+        crgDataEvalpkAtIndex( crgData, optionList, indexU, v, phi, curv );
+
+    return retVal;
+}
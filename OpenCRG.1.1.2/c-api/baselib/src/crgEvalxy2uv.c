@@ -29,10 +29,57 @@
 #include <math.h>
 
 /* ====== DEFINITIONS ====== */
+#define dMaxBatchBuckets  16   /* maximum number of reference line intervals tracked within a batch [-] */
+#define dIndexChunkSize   16   /* reference line intervals per chunk of the spatial index           [-] */
+#define dIndexCellsPerChunk 1  /* target number of grid cells per chunk                             [-] */
 
 /* ====== TYPE DEFINITIONS ====== */
 
 /* ====== LOCAL METHODS ====== */
+/**
+* find the index at which the search for the reference line interval starts;
+* the history is checked first, then the reference line is scanned globally
+* @param cp      pointer to contact point which is to be used
+* @param crgData pointer to the data set of the contact point
+* @param x       x co-ordinate
+* @param y       y co-ordinate
+* @return index of the start point on the reference line
+*/
+static size_t findStartIndex( CrgContactPointStruct *cp, CrgDataStruct* crgData, double x, double y );
+
+/**
+* find the reference line interval closest to an (x,y) position using the spatial index
+* @param crgData pointer to the data set
+* @param x       x co-ordinate
+* @param y       y co-ordinate
+* @param index   pointer to resulting index of the end point of the interval
+* @return 1 if the interval could be determined, 0 if the reference line must be scanned
+*/
+static int findIndexInGrid( CrgDataStruct* crgData, double x, double y, size_t* index );
+
+/**
+* starting at a given index, walk along the reference line until the interval
+* containing the (x,y) position is found and compute the (u,v) position
+* @param cp       pointer to contact point which is to be used
+* @param crgData  pointer to the data set of the contact point
+* @param indexMin index of the start point on the reference line
+* @param x        x co-ordinate
+* @param y        y co-ordinate
+* @param u        pointer to resulting u co-ordinate
+* @param v        pointer to resulting v co-ordinate
+* @param maxSteps maximum number of steps along the reference line, 0 for no limit
+* @return index which is to be registered in the history, 0 if the walk exceeded maxSteps
+*/
+static size_t evalFromIndex( CrgContactPointStruct *cp, CrgDataStruct* crgData, size_t indexMin, double x, double y, double* u, double* v, int maxSteps );
+
+/**
+* predict the reference line interval of the next query from the u velocity
+* of the previous results
+* @param cp       pointer to contact point which is to be used
+* @param crgData  pointer to the data set of the contact point
+* @return index of the start point on the reference line
+*/
+static size_t predictIndex( CrgContactPointStruct *cp, CrgDataStruct* crgData );
 
 /* ====== IMPLEMENTATION ====== */
 
@@ -50,39 +97,9 @@ crgEvalxy2uv( int cpId, double x, double y, double* u, double* v )
 int 
 crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, double* v )
 {
-    size_t indexMin = 0;
-    int useHist  =  0;
     CrgDataStruct* crgData;
-    double x0;
-    double x1;
-    double x2;
-    double x3;
-    double y0;
-    double y1;
-    double y2;
-    double y3;
-    double xxx1;
-    double xxx2;
-    double x2xx;
-    double x2x0;
-    double x2x1;
-    double x3x1;
-    double yyy1;
-    double yyy2;
-    double y2y0;
-    double y2y1;
-    double y3y1;
-    double y2yy;
-    double dProd;
-    double t_dProd;
-    double ta;
-    double tb;
-    double du;
-    double dist2Min = 0;
+    size_t indexMin;
     size_t indexP1;
-    size_t i;
-    int j;
-    size_t lastIdx;
     
     if ( !cp )
         return 0;
@@ -102,49 +119,235 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
     else if ( !( crgData->channelX.info.valid ) )
         return 1;
 
-    /* --- check for the information in the history  --- */
-    /* --- look for search start interval in history --- */
+#ifdef dCrgEnableStats
+    if ( cp->history.stat.active )
+        cp->history.stat.noTotalQueries++;
+#endif
 
-    for ( j = 0; j < cp->history.usedSize; j++ )
+    indexP1 = 0;
+    
+    /* --- a vehicle moves steadily, so try the predicted interval first --- */
+    if ( cp->predict.active && cp->predict.noValid == 2 )
+    {
+        indexP1 = evalFromIndex( cp, crgData, predictIndex( cp, crgData ), cp->x, cp->y, &( cp->u ), &( cp->v ), dCrgPredictMaxSteps );
+        
+#ifdef dCrgEnableStats
+        if ( cp->history.stat.active )
+        {
+            if ( indexP1 )
+                cp->history.stat.noPredictHits++;
+            else
+                cp->history.stat.noPredictMisses++;
+        }
+#endif
+    }
+    
+    /* --- no prediction or prediction was too far off --- */
+    if ( !indexP1 )
+    {
+        indexMin = findStartIndex( cp, crgData, cp->x, cp->y );
+        indexP1  = evalFromIndex( cp, crgData, indexMin, cp->x, cp->y, &( cp->u ), &( cp->v ), 0 );
+    }
+    
+    /* --- remember result in history --- */
+    crgContactPointHistoryPush( cp, cp->x, cp->y, indexP1 );
+    
+    if ( cp->predict.active )
+    {
+        cp->predict.u[1] = cp->predict.u[0];
+        cp->predict.u[0] = cp->u;
+        
+        if ( cp->predict.noValid < 2 )
+            cp->predict.noValid++;
+    }
+    
+    *u = cp->u;
+    *v = cp->v;
+    
+    return 1;
+}
+
+int
+crgEvalxy2uvBatch( int cpId, int n, const double* x, const double* y, double* u, double* v )
+{
+    CrgContactPointStruct* cp;
+    
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+   
+    return crgEvalxy2uvBatchPtr( cp, n, x, y, u, v );
+}
+
+int
+crgEvalxy2uvBatchPtr( CrgContactPointStruct *cp, int n, const double* x, const double* y, double* u, double* v )
+{
+    CrgDataStruct*        crgData;
+    CrgHistoryEntryStruct bucket[dMaxBatchBuckets];   /* reference line intervals hit within this batch */
+    int    noBuckets = 0;
+    int    i;
+    int    k;
+    int    hitBucket;
+    double dx;
+    double dy;
+    size_t indexMin;
+    size_t indexP1;
+    
+    if ( !cp || n < 0 || ( n && ( !x || !y || !u || !v ) ) )
+        return 0;
+    
+    if ( !n )
+        return 1;
+    
+    crgData = cp->crgData;
+    
+    /* --- no reference line: fallback solution --- */
+    if ( !crgData || !( crgData->channelX.info.valid ) )
+    {
+        for ( i = 0; i < n; i++ )
+        {
+            u[i] = x[i];
+            v[i] = y[i];
+        }
+    }
+    else
+    {
+        for ( i = 0; i < n; i++ )
+        {
+#ifdef dCrgEnableStats
+            if ( cp->history.stat.active )
+                cp->history.stat.noTotalQueries++;
+#endif
+
+            /* --- most points of a patch fall into an interval which has already been found --- */
+            hitBucket = -1;
+            
+            for ( k = noBuckets - 1; k >= 0; k-- )
+            {
+                dx = x[i] - bucket[k].x;
+                dy = y[i] - bucket[k].y;
+                
+                if ( dx * dx + dy * dy < cp->history.closeDist )
+                {
+                    hitBucket = k;
+                    break;
+                }
+            }
+            
+            if ( hitBucket >= 0 )
+            {
+                indexMin = bucket[hitBucket].index;
+                
+#ifdef dCrgEnableStats
+                if ( cp->history.stat.active )
+                    cp->history.stat.noCloseHits++;
+#endif
+            }
+            else
+                indexMin = findStartIndex( cp, crgData, x[i], y[i] );
+            
+            indexP1 = evalFromIndex( cp, crgData, indexMin, x[i], y[i], &( u[i] ), &( v[i] ), 0 );
+            
+            /* --- register the interval in the list of buckets --- */
+            if ( ( hitBucket < 0 ) || ( bucket[hitBucket].index != indexP1 ) )
+            {
+                for ( hitBucket = noBuckets - 1; hitBucket >= 0; hitBucket-- )
+                    if ( bucket[hitBucket].index == indexP1 )
+                        break;
+            }
+            
+            if ( hitBucket < 0 )
+            {
+                if ( noBuckets == dMaxBatchBuckets )
+                {
+                    memmove( &( bucket[0] ), &( bucket[1] ), ( dMaxBatchBuckets - 1 ) * sizeof( CrgHistoryEntryStruct ) );
+                    noBuckets--;
+                }
+                
+                hitBucket = noBuckets++;
+                bucket[hitBucket].index = indexP1;
+            }
+            
+            bucket[hitBucket].x = x[i];
+            bucket[hitBucket].y = y[i];
+        }
+        
+        /* --- update the history once for the entire batch; latest interval ends up in front --- */
+        for ( k = 0; k < noBuckets; k++ )
+            crgContactPointHistoryPush( cp, bucket[k].x, bucket[k].y, bucket[k].index );
+    }
+    
+    /* --- the points of a batch do not describe a motion --- */
+    cp->predict.noValid = 0;
+    
+    /* --- the contact point reflects the last query of the batch --- */
+    cp->x = x[n-1];
+    cp->y = y[n-1];
+    cp->u = u[n-1];
+    cp->v = v[n-1];
+    
+    return 1;
+}
+
+static size_t
+findStartIndex( CrgContactPointStruct *cp, CrgDataStruct* crgData, double x, double y )
+{
+    CrgHistoryStruct* hist;
+    size_t indexMin = 0;
+    int    useHist  = 0;
+    int    slot;
+    double dist2Min = 0;
+    size_t i;
+    int    j;
+    
+    /* --- check for the information in the history  --- */
+    /* --- look for search start interval in history, newest entry first --- */
+    hist = &( cp->history );
+    slot = hist->head;
+    
+    for ( j = 0; j < hist->usedSize; j++, slot = dCrgHistoryPrevSlot( hist, slot ) )
     {
         double dist2;
         double dx;
         double dy;
         
+        /* --- skip entries which have been replaced by a newer one --- */
+        if ( !dCrgHistorySlotValid( hist, slot ) )
+            continue;
+        
 #ifdef dCrgEnableStats
-        if ( cp->history.stat.active )
-            cp->history.stat.noIter++;
+        if ( hist->stat.active )
+            hist->stat.noIter++;
 #endif
 
-        dx = cp->x - cp->history.entry[j].x;
-        dy = cp->y - cp->history.entry[j].y;
+        dx = x - hist->entry[slot].x;
+        dy = y - hist->entry[slot].y;
         
         dist2 = dx * dx + dy * dy;
         
         /* ---  first choice: closer than 10*DUINC to history points (fast) --- */
-        if ( dist2 <  cp->history.closeDist )
+        if ( dist2 <  hist->closeDist )
         {
             useHist  = 1;
-            indexMin = cp->history.entry[j].index;
+            indexMin = hist->entry[slot].index;
             
 #ifdef dCrgEnableStats
-            if ( cp->history.stat.active )
-                cp->history.stat.noCloseHits++;
+            if ( hist->stat.active )
+                hist->stat.noCloseHits++;
 #endif
             break;
         } 
         /* --- second choice: find closest point in history which is not too far away (still fairly fast) --- */
-        else if ( dist2 < cp->history.farDist )
+        else if ( dist2 < hist->farDist )
         {
             if ( !useHist || ( dist2 < dist2Min ) )
             {
                 dist2Min = dist2;
-                indexMin = cp->history.entry[j].index;
+                indexMin = hist->entry[slot].index;
                 useHist  = 1;
                 
 #ifdef dCrgEnableStats
-                if ( cp->history.stat.active )
-                    cp->history.stat.noFarHits++;
+                if ( hist->stat.active )
+                    hist->stat.noFarHits++;
 #endif
                 
                 /* --- code runs faster if using first fairly good point instead of waiting for point within closeDist --- */
@@ -154,16 +357,28 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         }
     }
     
-    /* --- did not find close enough point in history               --- */
-    /* --- third choice: find globally closest reference line point --- */
+    /* --- did not find close enough point in history                  --- */
+    /* --- third choice: look up the closest interval in the spatial index --- */
+    if ( !useHist && findIndexInGrid( crgData, x, y, &indexMin ) )
+    {
+        useHist = 1;
+        
+#ifdef dCrgEnableStats
+        if ( cp->history.stat.active )
+            cp->history.stat.noNoHits++;
+#endif
+    }
+    
+    /* --- position is not covered by the index                     --- */
+    /* --- last choice: find globally closest reference line point  --- */
     if ( !useHist )
     {
         i = 0;
         
         while ( i < crgData->channelX.info.size )
         {
-            double dx = cp->x - crgData->channelX.data[i];
-            double dy = cp->y - crgData->channelY.data[i];
+            double dx = x - crgData->channelX.data[i];
+            double dy = y - crgData->channelY.data[i];
             
             double dist2 = dx * dx + dy * dy;
             
@@ -196,12 +411,334 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
 #endif
     }
     
-#ifdef dCrgEnableStats
-    if ( cp->history.stat.active )
-        cp->history.stat.noTotalQueries++;
-#endif
+    return indexMin;
+}
+
+static int
+findIndexInGrid( CrgDataStruct* crgData, double x, double y, size_t* index )
+{
+    CrgRefLineIndexStruct* grid = &( crgData->refLineIndex );
+    const double* xData = crgData->channelX.data;
+    const double* yData = crgData->channelY.data;
+    const double* box;
+    double dist2Min = 0.0;
+    double dist2;
+    double dx;
+    double dy;
+    double sx;
+    double sy;
+    double len2;
+    double t;
+    size_t cellX;
+    size_t cellY;
+    size_t cell;
+    size_t k;
+    size_t i;
+    size_t iEnd;
+    size_t chunk;
+    int    found = 0;
+    
+    if ( !grid->valid )
+        return 0;
+    
+    /* --- outside of the grid, the point is farther from the reference line than the v range --- */
+    if ( x < grid->xMin || y < grid->yMin )
+        return 0;
+    
+    cellX = ( size_t ) ( ( x - grid->xMin ) / grid->cellSize );
+    cellY = ( size_t ) ( ( y - grid->yMin ) / grid->cellSize );
+    
+    if ( cellX >= grid->noCellsX || cellY >= grid->noCellsY )
+        return 0;
+    
+    cell = cellY * grid->noCellsX + cellX;
+    
+    for ( k = grid->cellStart[cell]; k < grid->cellStart[cell+1]; k++ )
+    {
+        chunk = grid->entry[k];
+        box   = &( grid->chunkBox[4*chunk] );
+        
+        if ( x < box[0] || y < box[1] || x > box[2] || y > box[3] )
+            continue;
+        
+        i    = chunk * dIndexChunkSize;
+        iEnd = i + dIndexChunkSize;
+        
+        if ( iEnd > crgData->channelX.info.size - 1 )
+            iEnd = crgData->channelX.info.size - 1;
+        
+        /* --- distance to each interval of the chunk --- */
+        for ( ; i < iEnd; i++ )
+        {
+            sx   = xData[i+1] - xData[i];
+            sy   = yData[i+1] - yData[i];
+            dx   = x - xData[i];
+            dy   = y - yData[i];
+            len2 = sx * sx + sy * sy;
+            t    = ( len2 > 0.0 ) ? ( dx * sx + dy * sy ) / len2 : 0.0;
+            
+            if ( t > 1.0 )
+                t = 1.0;
+            else if ( t < 0.0 )
+                t = 0.0;
+            
+            dx -= t * sx;
+            dy -= t * sy;
+            
+            dist2 = dx * dx + dy * dy;
+            
+            if ( !found || dist2 < dist2Min )
+            {
+                dist2Min = dist2;
+                *index   = i + 1;
+                found    = 1;
+            }
+        }
+    }
+    
+    /* --- a closer interval of another cell can only exist beyond the widening of the boxes --- */
+    return found && ( dist2Min <= grid->maxDist2 );
+}
 
-/* -- found the start? --- */
+int
+crgEvalxy2uvBuildIndex( CrgDataStruct* crgData )
+{
+    CrgRefLineIndexStruct* grid;
+    size_t noPoints;
+    size_t noCells;
+    size_t chunk;
+    size_t cell;
+    size_t cellX;
+    size_t cellY;
+    size_t cellX0;
+    size_t cellX1;
+    size_t cellY0;
+    size_t cellY1;
+    size_t i;
+    size_t iEnd;
+    size_t* fill;
+    double* box;
+    double width;
+    double xMax = 0.0;
+    double yMax = 0.0;
+    double cellSize;
+    
+    if ( !crgData )
+        return 0;
+    
+    crgEvalxy2uvReleaseIndex( crgData );
+    
+    grid     = &( crgData->refLineIndex );
+    noPoints = crgData->channelX.info.size;
+    
+    if ( !crgData->channelX.info.valid || !crgData->channelX.data || !crgData->channelY.data || noPoints < 2 )
+        return 0;
+    
+    /* --- every point within the v range of an interval lies inside the widened box of its chunk --- */
+    width = fabs( crgData->channelV.info.first );
+    
+    if ( fabs( crgData->channelV.info.last ) > width )
+        width = fabs( crgData->channelV.info.last );
+    
+    width += crgData->channelU.info.inc;
+    
+    grid->noChunks = ( noPoints - 2 ) / dIndexChunkSize + 1;
+    grid->chunkBox = ( double* ) crgCalloc( 4 * grid->noChunks, sizeof( double ) );
+    
+    if ( !grid->chunkBox )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalxy2uvBuildIndex: could not allocate index.\n" );
+        return 0;
+    }
+    
+    for ( chunk = 0; chunk < grid->noChunks; chunk++ )
+    {
+        box  = &( grid->chunkBox[4*chunk] );
+        i    = chunk * dIndexChunkSize;
+        iEnd = i + dIndexChunkSize;
+        
+        if ( iEnd > noPoints - 1 )
+            iEnd = noPoints - 1;
+        
+        box[0] = box[2] = crgData->channelX.data[i];
+        box[1] = box[3] = crgData->channelY.data[i];
+        
+        for ( ++i; i <= iEnd; i++ )
+        {
+            if ( crgData->channelX.data[i] < box[0] ) box[0] = crgData->channelX.data[i];
+            if ( crgData->channelY.data[i] < box[1] ) box[1] = crgData->channelY.data[i];
+            if ( crgData->channelX.data[i] > box[2] ) box[2] = crgData->channelX.data[i];
+            if ( crgData->channelY.data[i] > box[3] ) box[3] = crgData->channelY.data[i];
+        }
+        
+        box[0] -= width;
+        box[1] -= width;
+        box[2] += width;
+        box[3] += width;
+        
+        if ( !chunk || box[0] < grid->xMin ) grid->xMin = box[0];
+        if ( !chunk || box[1] < grid->yMin ) grid->yMin = box[1];
+        if ( !chunk || box[2] > xMax )       xMax       = box[2];
+        if ( !chunk || box[3] > yMax )       yMax       = box[3];
+    }
+    
+    /* --- about dIndexCellsPerChunk cells per chunk, but no cell smaller than a chunk --- */
+    cellSize = sqrt( ( xMax - grid->xMin ) * ( yMax - grid->yMin ) / ( dIndexCellsPerChunk * grid->noChunks ) );
+    
+    if ( cellSize < dIndexChunkSize * crgData->channelU.info.inc )
+        cellSize = dIndexChunkSize * crgData->channelU.info.inc;
+    
+    if ( !( cellSize > 0.0 ) )
+    {
+        crgEvalxy2uvReleaseIndex( crgData );
+        return 0;
+    }
+    
+    grid->cellSize = cellSize;
+    grid->maxDist2 = width * width;
+    grid->noCellsX = ( size_t ) ( ( xMax - grid->xMin ) / cellSize ) + 1;
+    grid->noCellsY = ( size_t ) ( ( yMax - grid->yMin ) / cellSize ) + 1;
+    noCells        = grid->noCellsX * grid->noCellsY;
+    
+    grid->cellStart = ( size_t* ) crgCalloc( noCells + 1, sizeof( size_t ) );
+    fill            = ( size_t* ) crgCalloc( noCells, sizeof( size_t ) );
+    
+    if ( !grid->cellStart || !fill )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalxy2uvBuildIndex: could not allocate index.\n" );
+        crgFree( fill );
+        crgEvalxy2uvReleaseIndex( crgData );
+        return 0;
+    }
+    
+    /* --- two passes: count the entries per cell, then fill them in --- */
+    for ( i = 0; i < 2; i++ )
+    {
+        for ( chunk = 0; chunk < grid->noChunks; chunk++ )
+        {
+            box    = &( grid->chunkBox[4*chunk] );
+            cellX0 = ( size_t ) ( ( box[0] - grid->xMin ) / cellSize );
+            cellY0 = ( size_t ) ( ( box[1] - grid->yMin ) / cellSize );
+            cellX1 = ( size_t ) ( ( box[2] - grid->xMin ) / cellSize );
+            cellY1 = ( size_t ) ( ( box[3] - grid->yMin ) / cellSize );
+            
+            if ( cellX1 >= grid->noCellsX )
+                cellX1 = grid->noCellsX - 1;
+            
+            if ( cellY1 >= grid->noCellsY )
+                cellY1 = grid->noCellsY - 1;
+            
+            for ( cellY = cellY0; cellY <= cellY1; cellY++ )
+            {
+                for ( cellX = cellX0; cellX <= cellX1; cellX++ )
+                {
+                    cell = cellY * grid->noCellsX + cellX;
+                    
+                    if ( i )
+                        grid->entry[grid->cellStart[cell] + fill[cell]] = chunk;
+                    
+                    fill[cell]++;
+                }
+            }
+        }
+        
+        if ( i )
+            break;
+        
+        for ( cell = 0; cell < noCells; cell++ )
+        {
+            grid->cellStart[cell+1] = grid->cellStart[cell] + fill[cell];
+            fill[cell] = 0;
+        }
+        
+        if ( !( grid->entry = ( size_t* ) crgCalloc( grid->cellStart[noCells] + 1, sizeof( size_t ) ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgEvalxy2uvBuildIndex: could not allocate index.\n" );
+            crgFree( fill );
+            crgEvalxy2uvReleaseIndex( crgData );
+            return 0;
+        }
+    }
+    
+    crgFree( fill );
+    
+    grid->valid = 1;
+    
+    crgMsgPrint( dCrgMsgLevelDebug, "crgEvalxy2uvBuildIndex: %ld x %ld cells of %.3f m, %ld chunks, %ld entries\n",
+                 ( long ) grid->noCellsX, ( long ) grid->noCellsY, cellSize, ( long ) grid->noChunks, ( long ) grid->cellStart[noCells] );
+    
+    return 1;
+}
+
+void
+crgEvalxy2uvReleaseIndex( CrgDataStruct* crgData )
+{
+    if ( !crgData )
+        return;
+    
+    if ( crgData->refLineIndex.chunkBox )
+        crgFree( crgData->refLineIndex.chunkBox );
+    
+    if ( crgData->refLineIndex.cellStart )
+        crgFree( crgData->refLineIndex.cellStart );
+    
+    if ( crgData->refLineIndex.entry )
+        crgFree( crgData->refLineIndex.entry );
+    
+    memset( &( crgData->refLineIndex ), 0, sizeof( CrgRefLineIndexStruct ) );
+}
+
+static size_t
+predictIndex( CrgContactPointStruct *cp, CrgDataStruct* crgData )
+{
+    double frac;
+    
+    /* --- extrapolate u linearly from the previous two results --- */
+    frac = ( 2.0 * cp->predict.u[0] - cp->predict.u[1] - crgData->channelU.info.first ) / crgData->channelU.info.inc;
+    
+    /* --- the walk starts at the end point of the interval --- */
+    if ( frac < 0.0 )
+        return 1;
+    
+    if ( frac >= crgData->channelX.info.size - 2 )
+        return crgData->channelX.info.size - 1;
+    
+    return ( size_t ) frac + 1;
+}
+
+static size_t
+evalFromIndex( CrgContactPointStruct *cp, CrgDataStruct* crgData, size_t indexMin, double x, double y, double* u, double* v, int maxSteps )
+{
+    double x0;
+    double x1;
+    double x2;
+    double x3;
+    double y0;
+    double y1;
+    double y2;
+    double y3;
+    double xxx1;
+    double xxx2;
+    double x2xx;
+    double x2x0;
+    double x2x1;
+    double x3x1;
+    double yyy1;
+    double yyy2;
+    double y2y0;
+    double y2y1;
+    double y3y1;
+    double y2yy;
+    double dProd;
+    double t_dProd;
+    double ta;
+    double tb;
+    double du;
+    size_t indexP1;
+    size_t lastIdx;
+    int    noSteps = 0;
+
+    /* -- found the start? --- */
     if ( indexMin < 1 )
         indexMin = 1;
         
@@ -225,9 +762,9 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         *  - hd is negative for P "left"  of normal on P3-P1 through P2
         *  - hd is positive for P "right" of normal on P3-P1 through P2
         */
-        xxx2 = cp->x - crgData->channelX.data[indexMin];
+        xxx2 = x - crgData->channelX.data[indexMin];
         x3x1 = crgData->channelX.data[indexP1] - crgData->channelX.data[indexMin-1];
-        yyy2 = cp->y - crgData->channelY.data[indexMin];
+        yyy2 = y - crgData->channelY.data[indexMin];
         y3y1 = crgData->channelY.data[indexP1] - crgData->channelY.data[indexMin-1];
 
         dProd = xxx2 * x3x1 + yyy2 * y3y1;
@@ -245,13 +782,17 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
 
         if ( dProd > 0.0 )
         {
+             /* --- a predicted start which is too far off is abandoned --- */
+             if ( maxSteps && ++noSteps > maxSteps )
+                 return 0;
+             
              if ( indexMin < ( crgData->channelX.info.size - 1 ) )
                  indexMin++;
              else if(crgData->util.uIsClosed)
              {
-                t_dProd = (cp->x - crgData->channelX.data[0])
+                t_dProd = (x - crgData->channelX.data[0])
                                 * (crgData->channelX.data[1] - crgData->channelX.data[0])
-                                + (cp->y - crgData->channelY.data[0])
+                                + (y - crgData->channelY.data[0])
                                 * (crgData->channelY.data[1] - crgData->channelY.data[0]);
 
                 if (t_dProd <= 0.0) break;  /* crgData->channelU.data[0] may be closer */
@@ -292,9 +833,9 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         *  - hd is negative for P "left"  of normal on P2-P0 through P1
         *  - hd is positive for P "right" of normal on P2-P0 through P1
         */
-        xxx1 = cp->x - x1;
+        xxx1 = x - x1;
         x2x0 = x2    - x0;
-        yyy1 = cp->y - y1;
+        yyy1 = y - y1;
         y2y0 = y2    - y0;
 
         dProd   = xxx1 * x2x0 + yyy1 * y2y0;
@@ -312,6 +853,9 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
 
         if ( dProd < 0.0 )
         {
+            if ( maxSteps && ++noSteps > maxSteps )
+                return 0;
+            
             if ( indexMin > 1 )
                 indexMin--;
             else if (crgData->util.uIsClosed)
@@ -320,9 +864,9 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
                if(t_dProd != 0.0) break; /* last reference point already checked */
 
                lastIdx = crgData->channelX.info.size-1;
-               t_dProd = (cp->x - crgData->channelX.data[lastIdx])
+               t_dProd = (x - crgData->channelX.data[lastIdx])
                                * (crgData->channelX.data[lastIdx] - crgData->channelX.data[lastIdx-1])
-                               + (cp->y - crgData->channelY.data[lastIdx])
+                               + (y - crgData->channelY.data[lastIdx])
                                * (crgData->channelY.data[lastIdx] - crgData->channelY.data[lastIdx-1]);
 
                if (t_dProd >= 0.0) break;  /* crgData->channelU.data[end] may be closer */
@@ -345,7 +889,10 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
     x2x1 = x2 - x1;
     y2y1 = y2 - y1;
 
-    cp->v = ( x2x1 * yyy1 - y2y1 * xxx1 ) / sqrt( x2x1 * x2x1 + y2y1 * y2y1 );
+    if ( crgData->refLineGeom.valid )
+        *v = ( x2x1 * yyy1 - y2y1 * xxx1 ) * crgData->refLineGeom.invLen[indexMin-1];
+    else
+        *v = ( x2x1 * yyy1 - y2y1 * xxx1 ) / sqrt( x2x1 * x2x1 + y2y1 * y2y1 );
     
    /*
     * here we could check distance related to curvature:
@@ -375,14 +922,14 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
     x3x1 = x3 - x1;
     y3y1 = y3 - y1;
 
-    x2xx = x2 - cp->x;
-    y2yy = y2 - cp->y;
+    x2xx = x2 - x;
+    y2yy = y2 - y;
 
     ta = dProd / ( x2x0 * x2x1 + y2y0 * y2y1 );
     tb = ( x3x1 * x2xx + y3y1 * y2yy ) / ( x3x1 * x2x1 + y3y1 * y2y1 );
     du = ta / ( ta + tb ) * crgData->channelU.info.inc;
     
-    cp->u = ( indexMin - 1 ) * crgData->channelU.info.inc + du + crgData->channelU.info.first;
+    *u = ( indexMin - 1 ) * crgData->channelU.info.inc + du + crgData->channelU.info.first;
 
     /* --- test again if point is closest to begin or end of reference line    --- */
     /* --- and reference line is closed, then check whether point             --- */
@@ -390,64 +937,44 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
     /* --- co-ordinates as required                                           --- */
     if ( crgOptionHasValueInt( &( cp->options ), dCrgRefLineCloseTrack, 1 ) && crgData->util.uIsClosed )
     {
-        if ( cp->u > crgData->util.uCloseMax )
+        if ( *u > crgData->util.uCloseMax )
         {
-            double dx1 = cp->x - crgData->channelX.info.first;
-            double dy1 = cp->y - crgData->channelY.info.first;
+            double dx1 = x - crgData->channelX.info.first;
+            double dy1 = y - crgData->channelY.info.first;
             
-            cp->u = crgData->channelU.info.first + dx1 * crgData->util.phiFirstCos + dy1 * crgData->util.phiFirstSin;
-            cp->v =                              + dy1 * crgData->util.phiFirstCos - dx1 * crgData->util.phiFirstSin;
+            *u = crgData->channelU.info.first + dx1 * crgData->util.phiFirstCos + dy1 * crgData->util.phiFirstSin;
+            *v =                              + dy1 * crgData->util.phiFirstCos - dx1 * crgData->util.phiFirstSin;
         }
-        else if ( cp->u < crgData->util.uCloseMin )
+        else if ( *u < crgData->util.uCloseMin )
         {
-            double dx1 = cp->x - crgData->channelX.info.last;
-            double dy1 = cp->y - crgData->channelY.info.last;
+            double dx1 = x - crgData->channelX.info.last;
+            double dy1 = y - crgData->channelY.info.last;
             
-            cp->u = crgData->channelU.info.last + dx1 * crgData->util.phiLastCos + dy1 * crgData->util.phiLastSin;
-            cp->v =                             + dy1 * crgData->util.phiLastCos - dx1 * crgData->util.phiLastSin;
+            *u = crgData->channelU.info.last + dx1 * crgData->util.phiLastCos + dy1 * crgData->util.phiLastSin;
+            *v =                             + dy1 * crgData->util.phiLastCos - dx1 * crgData->util.phiLastSin;
         }
     }
     else
     {
-        if ( cp->u < crgData->channelU.info.first )
-        {
-            double dx1 = cp->x - crgData->channelX.info.first;
-            double dy1 = cp->y - crgData->channelY.info.first;
-            
-            cp->u = crgData->channelU.info.first + dx1 * crgData->util.phiFirstCos + dy1 * crgData->util.phiFirstSin;
-            cp->v =                              + dy1 * crgData->util.phiFirstCos - dx1 * crgData->util.phiFirstSin;
-        }
-        else if ( cp->u > crgData->channelU.info.last )
+        if ( *u < crgData->channelU.info.first )
         {
-            double dx1 = cp->x - crgData->channelX.info.last;
-            double dy1 = cp->y - crgData->channelY.info.last;
+            double dx1 = x - crgData->channelX.info.first;
+            double dy1 = y - crgData->channelY.info.first;
             
-            cp->u = crgData->channelU.info.last + dx1 * crgData->util.phiLastCos + dy1 * crgData->util.phiLastSin;
-            cp->v =                             + dy1 * crgData->util.phiLastCos - dx1 * crgData->util.phiLastSin;
+            *u = crgData->channelU.info.first + dx1 * crgData->util.phiFirstCos + dy1 * crgData->util.phiFirstSin;
+            *v =                              + dy1 * crgData->util.phiFirstCos - dx1 * crgData->util.phiFirstSin;
         }
-    }
-
-    /* --- remember result in history --- */
-    if ( cp->history.totalSize > 1 )
-    {
-        /* --- avoid registering twice for the same index --- */
-        if ( cp->history.entry[0].index != indexP1 )
+        else if ( *u > crgData->channelU.info.last )
         {
-            memmove( &( cp->history.entry[1] ), cp->history.entry, ( cp->history.totalSize - 1 ) * cp->history.entrySize );
+            double dx1 = x - crgData->channelX.info.last;
+            double dy1 = y - crgData->channelY.info.last;
             
-            if ( cp->history.usedSize < cp->history.totalSize )
-                cp->history.usedSize++;
+            *u = crgData->channelU.info.last + dx1 * crgData->util.phiLastCos + dy1 * crgData->util.phiLastSin;
+            *v =                             + dy1 * crgData->util.phiLastCos - dx1 * crgData->util.phiLastSin;
         }
-        
-        cp->history.entry[0].x     = cp->x;
-        cp->history.entry[0].y     = cp->y;
-        cp->history.entry[0].index = indexP1;
     }
     
-    *u = cp->u;
-    *v = cp->v;
-    
-    return 1;
+    return indexP1;
 }
 
 int 
@@ -29,12 +29,259 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+/* --- vectorized kernels are available on x86 platforms only --- */
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+#define dCrgUseSSE2
+#include <emmintrin.h>
+#endif
+
+#if defined( dCrgUseSSE2 ) && defined( __x86_64__ ) && \
+    ( ( __GNUC__ > 4 ) || ( ( __GNUC__ == 4 ) && ( __GNUC_MINOR__ >= 9 ) ) )
+#define dCrgUseAVX2
+#include <immintrin.h>
+#endif
+
 /* ====== DEFINITIONS ====== */
 #define dMaxBorderError  1.0e-8   /* maximum tolerance for position outside a border [m] */
+#define dBatchChunkSize  64       /* number of positions handed to the interpolation kernel at once [-] */
+
+/**
+* fetch the z values at the corners of a grid cell from the float channels
+*/
+#define dCrgCellCornersFloat( crgData, indexU, indexV, c )                       \
+    do                                                                           \
+    {                                                                            \
+        c[0] = ( crgData )->channelZ[indexV].data[indexU];                       \
+        c[1] = ( crgData )->channelZ[indexV].data[( indexU ) + 1];               \
+        c[2] = ( crgData )->channelZ[( indexV ) + 1].data[indexU];               \
+        c[3] = ( crgData )->channelZ[( indexV ) + 1].data[( indexU ) + 1];       \
+    } while ( 0 )
+
+/**
+* fetch the z values at the corners of a grid cell, either from the float
+* channels, from the quantized grid or from the pages of a streamed grid
+*/
+#define dCrgCellCorners( crgData, indexU, indexV, c )                            \
+    do                                                                           \
+    {                                                                            \
+        if ( ( crgData )->gridQuant.valid )                                      \
+            quantCorners( crgData, indexU, indexV, c );                          \
+        else if ( ( crgData )->gridStream.valid )                                \
+            crgDataGridStreamCorners( crgData, 1, &( indexU ), &( indexV ), c ); \
+        else                                                                     \
+            dCrgCellCornersFloat( crgData, indexU, indexV, c );                  \
+    } while ( 0 )
+
+/**
+* representations of the elevation grid, selecting the kernel of a contact point
+*/
+#define dGridFloat       0        /* float channels */
+#define dGridQuant       1        /* quantized grid */
+#define dGridStream      2        /* streamed grid  */
 
 /* ====== TYPE DEFINITIONS ====== */
+/**
+* kernel for bilinear interpolation of n positions with given grid indices and fractions
+*/
+typedef void ( *BilinearKernel )( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+                                  const double* fracU, const double* fracV, double* z );
 
 /* ====== LOCAL METHODS ====== */
+/**
+* find the v interval and the fraction within this interval for a data set
+* with variably spaced v axis; v position must already be mapped to the
+* valid v range
+* @param crgData    pointer to data set which holds the data
+* @param vPos       v co-ordinate
+* @param indexV     pointer to resulting index of the v interval
+* @param fracV      pointer to resulting fraction within the v interval
+*/
+static void findIndexVIrregular( CrgDataStruct *crgData, CrgPerformanceStruct* perfStat, double vPos, size_t* indexV, double* fracV );
+
+/**
+* dequantize the z values at the corners of a grid cell of a quantized grid
+* @param crgData    pointer to data set which holds the data
+* @param indexU     u index of the cell
+* @param indexV     v index of the cell
+* @param c          resulting values at (indexU, indexV), (indexU+1, indexV),
+*                   (indexU, indexV+1) and (indexU+1, indexV+1)
+*/
+static void quantCorners( CrgDataStruct *crgData, size_t indexU, size_t indexV, double* c );
+
+/**
+* bilinear interpolation kernel for a quantized grid; within a block the quantized
+* values are interpolated before they are scaled, so the results agree with those
+* of crgDataEvaluv2z() up to rounding
+* @param crgData    pointer to data set which holds the data
+* @param n          number of positions
+* @param indexU     array of u indices
+* @param indexV     array of v indices
+* @param fracU      array of fractions within the u intervals
+* @param fracV      array of fractions within the v intervals
+* @param z          array of resulting z values (including the mean value of the channel)
+*/
+static void bilinearQuant( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+                           const double* fracU, const double* fracV, double* z );
+
+/**
+* bilinear interpolation kernel for a streamed grid; the corners of all cells
+* are fetched at once, so the pages are locked once per call
+* @param crgData    pointer to data set which holds the data
+* @param n          number of positions, at most dBatchChunkSize
+* @param indexU     array of u indices
+* @param indexV     array of v indices
+* @param fracU      array of fractions within the u intervals
+* @param fracV      array of fractions within the v intervals
+* @param z          array of resulting z values (including the mean value of the channel)
+*/
+static void bilinearStream( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+                            const double* fracU, const double* fracV, double* z );
+
+/**
+* bilinear interpolation kernels; all kernels use the same sequence of
+* operations as crgDataEvaluv2z() and therefore yield identical results
+* @param crgData    pointer to data set which holds the data
+* @param n          number of positions
+* @param indexU     array of u indices
+* @param indexV     array of v indices
+* @param fracU      array of fractions within the u intervals
+* @param fracV      array of fractions within the v intervals
+* @param z          array of resulting z values (including the mean value of the channel)
+*/
+static void bilinearScalar( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+                            const double* fracU, const double* fracV, double* z );
+#ifdef dCrgUseSSE2
+static void bilinearSSE2( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+                          const double* fracU, const double* fracV, double* z );
+#endif
+#ifdef dCrgUseAVX2
+static void bilinearAVX2( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+                          const double* fracU, const double* fracV, double* z ) __attribute__ (( target( "avx2" ) ));
+#endif
+
+/**
+* check whether a kernel is supported by the CPU
+* @param kernel  id of the kernel
+* @return 1 if supported, otherwise 0
+*/
+static int kernelIsSupported( int kernel );
+
+/**
+* select the kernel for the bilinear interpolation, caller holds dCrgLockKernel
+* @param kernel  id of the kernel
+* @return 1 if supported, otherwise 0
+*/
+static int selectKernel( int kernel );
+
+/**
+* compute the inertial surface normal from the derivatives of z by u and v and
+* the horizontal directions of u and v at the given position; without geometry
+* tables of the reference line, the heading at its start is used
+* @param crgData    pointer to data set which holds the data
+* @param optionList pointer to a list holding all applicable options
+* @param u          u co-ordinate
+* @param v          v co-ordinate
+* @param dzdu       derivative of z by u
+* @param dzdv       derivative of z by v
+* @param nrm        resulting unit normal vector (x, y, z)
+*/
+static void surfaceNormal( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u, double v, double dzdu, double dzdv, double* nrm );
+
+/**
+* evaluate z at a position inside the bounds of the kernel with the arithmetic of
+* crgDataEvaluv2z() for the core area, all other positions take the generic path;
+* the properties of the data set are passed as constants, so that each caller
+* is compiled into a variant without further branches
+* @param kernel     pointer to the kernel of the contact point
+* @param crgData    pointer to data set which holds the data
+* @param optionList pointer to a list holding all applicable options
+* @param perfStat   pointer to the performance statistics of the contact point
+* @param u          u co-ordinate
+* @param v          v co-ordinate
+* @param z          pointer to resulting z co-ordinate
+* @param regularV   1 if the v axis is constantly spaced, otherwise 0
+* @param refZMode   1 if the reference line has z data, otherwise 0
+* @param bankMode   0 without banking, 1 for bank data, 2 for constant bank
+* @param gridMode   representation of the grid [dGridFloat, dGridQuant, dGridStream]
+* @return 1 if successful, otherwise 0
+*/
+static int evalSpecialized( const CrgEvalKernelStruct* kernel, CrgDataStruct *crgData, CrgOptionsStruct* optionList,
+                            CrgPerformanceStruct* perfStat, double u, double v, double* z,
+                            int regularV, int refZMode, int bankMode, int gridMode );
+
+/**
+* generic kernel of a contact point, calls crgDataEvaluv2z()
+*/
+static int evalGeneric( const CrgEvalKernelStruct* kernel, CrgDataStruct *crgData, CrgOptionsStruct* optionList,
+                        CrgPerformanceStruct* perfStat, double u, double v, double* z );
+
+/**
+* specialized kernels of a contact point, one per combination of the data set properties
+*/
+#define dCrgDefineEvalKernel( name, regularV, refZMode, bankMode, gridMode )                                        \
+static int name( const CrgEvalKernelStruct* kernel, CrgDataStruct *crgData, CrgOptionsStruct* optionList,            \
+                 CrgPerformanceStruct* perfStat, double u, double v, double* z )                                    \
+{                                                                                                                    \
+    return evalSpecialized( kernel, crgData, optionList, perfStat, u, v, z, regularV, refZMode, bankMode, gridMode ); \
+}
+
+dCrgDefineEvalKernel( evalFloatIrregNoRefZNoBank,  0, 0, 0, dGridFloat )
+dCrgDefineEvalKernel( evalFloatIrregNoRefZBank,    0, 0, 1, dGridFloat )
+dCrgDefineEvalKernel( evalFloatIrregNoRefZConstB,  0, 0, 2, dGridFloat )
+dCrgDefineEvalKernel( evalFloatIrregRefZNoBank,    0, 1, 0, dGridFloat )
+dCrgDefineEvalKernel( evalFloatIrregRefZBank,      0, 1, 1, dGridFloat )
+dCrgDefineEvalKernel( evalFloatIrregRefZConstB,    0, 1, 2, dGridFloat )
+dCrgDefineEvalKernel( evalFloatRegNoRefZNoBank,    1, 0, 0, dGridFloat )
+dCrgDefineEvalKernel( evalFloatRegNoRefZBank,      1, 0, 1, dGridFloat )
+dCrgDefineEvalKernel( evalFloatRegNoRefZConstB,    1, 0, 2, dGridFloat )
+dCrgDefineEvalKernel( evalFloatRegRefZNoBank,      1, 1, 0, dGridFloat )
+dCrgDefineEvalKernel( evalFloatRegRefZBank,        1, 1, 1, dGridFloat )
+dCrgDefineEvalKernel( evalFloatRegRefZConstB,      1, 1, 2, dGridFloat )
+dCrgDefineEvalKernel( evalQuantIrregNoRefZNoBank,  0, 0, 0, dGridQuant )
+dCrgDefineEvalKernel( evalQuantIrregNoRefZBank,    0, 0, 1, dGridQuant )
+dCrgDefineEvalKernel( evalQuantIrregNoRefZConstB,  0, 0, 2, dGridQuant )
+dCrgDefineEvalKernel( evalQuantIrregRefZNoBank,    0, 1, 0, dGridQuant )
+dCrgDefineEvalKernel( evalQuantIrregRefZBank,      0, 1, 1, dGridQuant )
+dCrgDefineEvalKernel( evalQuantIrregRefZConstB,    0, 1, 2, dGridQuant )
+dCrgDefineEvalKernel( evalQuantRegNoRefZNoBank,    1, 0, 0, dGridQuant )
+dCrgDefineEvalKernel( evalQuantRegNoRefZBank,      1, 0, 1, dGridQuant )
+dCrgDefineEvalKernel( evalQuantRegNoRefZConstB,    1, 0, 2, dGridQuant )
+dCrgDefineEvalKernel( evalQuantRegRefZNoBank,      1, 1, 0, dGridQuant )
+dCrgDefineEvalKernel( evalQuantRegRefZBank,        1, 1, 1, dGridQuant )
+dCrgDefineEvalKernel( evalQuantRegRefZConstB,      1, 1, 2, dGridQuant )
+dCrgDefineEvalKernel( evalStreamIrregNoRefZNoBank, 0, 0, 0, dGridStream )
+dCrgDefineEvalKernel( evalStreamIrregNoRefZBank,   0, 0, 1, dGridStream )
+dCrgDefineEvalKernel( evalStreamIrregNoRefZConstB, 0, 0, 2, dGridStream )
+dCrgDefineEvalKernel( evalStreamIrregRefZNoBank,   0, 1, 0, dGridStream )
+dCrgDefineEvalKernel( evalStreamIrregRefZBank,     0, 1, 1, dGridStream )
+dCrgDefineEvalKernel( evalStreamIrregRefZConstB,   0, 1, 2, dGridStream )
+dCrgDefineEvalKernel( evalStreamRegNoRefZNoBank,   1, 0, 0, dGridStream )
+dCrgDefineEvalKernel( evalStreamRegNoRefZBank,     1, 0, 1, dGridStream )
+dCrgDefineEvalKernel( evalStreamRegNoRefZConstB,   1, 0, 2, dGridStream )
+dCrgDefineEvalKernel( evalStreamRegRefZNoBank,     1, 1, 0, dGridStream )
+dCrgDefineEvalKernel( evalStreamRegRefZBank,       1, 1, 1, dGridStream )
+dCrgDefineEvalKernel( evalStreamRegRefZConstB,     1, 1, 2, dGridStream )
+
+/* ====== LOCAL VARIABLES ====== */
+static int ( * const sEvalKernels[3][2][2][3] )( const CrgEvalKernelStruct*, CrgDataStruct*, CrgOptionsStruct*, CrgPerformanceStruct*,
+                                                  double, double, double* ) =
+{
+    { { { evalFloatIrregNoRefZNoBank,  evalFloatIrregNoRefZBank,    evalFloatIrregNoRefZConstB  },
+        { evalFloatIrregRefZNoBank,    evalFloatIrregRefZBank,      evalFloatIrregRefZConstB    } },
+      { { evalFloatRegNoRefZNoBank,    evalFloatRegNoRefZBank,      evalFloatRegNoRefZConstB    },
+        { evalFloatRegRefZNoBank,      evalFloatRegRefZBank,        evalFloatRegRefZConstB      } } },
+    { { { evalQuantIrregNoRefZNoBank,  evalQuantIrregNoRefZBank,    evalQuantIrregNoRefZConstB  },
+        { evalQuantIrregRefZNoBank,    evalQuantIrregRefZBank,      evalQuantIrregRefZConstB    } },
+      { { evalQuantRegNoRefZNoBank,    evalQuantRegNoRefZBank,      evalQuantRegNoRefZConstB    },
+        { evalQuantRegRefZNoBank,      evalQuantRegRefZBank,        evalQuantRegRefZConstB      } } },
+    { { { evalStreamIrregNoRefZNoBank, evalStreamIrregNoRefZBank,   evalStreamIrregNoRefZConstB },
+        { evalStreamIrregRefZNoBank,   evalStreamIrregRefZBank,     evalStreamIrregRefZConstB   } },
+      { { evalStreamRegNoRefZNoBank,   evalStreamRegNoRefZBank,     evalStreamRegNoRefZConstB   },
+        { evalStreamRegRefZNoBank,     evalStreamRegRefZBank,       evalStreamRegRefZConstB     } } }
+};
+
+static BilinearKernel sBilinearKernel = NULL;
+static int            sKernelId       = dCrgKernelAuto;
 
 /* ====== IMPLEMENTATION ====== */
 int
@@ -60,7 +307,7 @@ int crgEvaluv2zPtr( CrgContactPointStruct *cp, double u, double v, double* z )
     cp->u = u;
     cp->v = v;
     
-    retVal = crgDataEvaluv2z( cp->crgData, &( cp->options ), cp->u, cp->v, &( cp->z ) );
+    retVal = cp->evalKernel.func( &( cp->evalKernel ), cp->crgData, &( cp->options ), &( cp->perfStat ), cp->u, cp->v, &( cp->z ) );
     
     /* --- transfer the result --- */
     *z = cp->z;
@@ -68,9 +315,107 @@ int crgEvaluv2zPtr( CrgContactPointStruct *cp, double u, double v, double* z )
     return retVal;
 }
 
+void
+crgEvalzSelectCpKernel( CrgContactPointStruct* cp )
+{
+    CrgDataStruct*       crgData;
+    CrgOptionsStruct*    optionList;
+    CrgEvalKernelStruct* kernel;
+    int                  bankMode = 0;
+    int                  gridMode = dGridFloat;
+    
+    if ( !cp )
+        return;
+    
+    crgData    = cp->crgData;
+    optionList = &( cp->options );
+    kernel     = &( cp->evalKernel );
+    
+    /* --- fallback: everything is handled by the generic path --- */
+    kernel->func = evalGeneric;
+    
+    if ( !crgData || !optionList->entry || crgData->channelU.info.size < 2 || crgData->channelV.info.size < 2 || !crgData->channelZ )
+        return;
+    
+    /* --- the specialized path covers the core area outside the smoothing zones --- */
+    kernel->uMin = crgData->channelU.info.first;
+    kernel->uMax = crgData->channelU.info.last;
+    kernel->vMin = crgData->channelV.info.first;
+    kernel->vMax = crgData->channelV.info.last;
+    
+    /* --- keep off the edges of the zones, where rounding might decide differently --- */
+    if ( optionList->entry[dCrgCpOptionSmoothUBegin].valid )
+        kernel->uMin += optionList->entry[dCrgCpOptionSmoothUBegin].dValue + dMaxBorderError;
+    
+    if ( optionList->entry[dCrgCpOptionSmoothUEnd].valid )
+        kernel->uMax -= optionList->entry[dCrgCpOptionSmoothUEnd].dValue + dMaxBorderError;
+    
+    /* --- u values which would be wrapped on a closed track --- */
+    if ( crgData->util.uIsClosed && crgOptionHasValueInt( optionList, dCrgCpOptionRefLineContinue, dCrgRefLineCloseTrack ) )
+    {
+        if ( kernel->uMin < crgData->util.uCloseMin )
+            kernel->uMin = crgData->util.uCloseMin;
+        
+        if ( kernel->uMax > crgData->util.uCloseMax )
+            kernel->uMax = crgData->util.uCloseMax;
+    }
+    
+    if ( kernel->uMin > kernel->uMax )
+        return;
+    
+    if ( crgData->util.hasBank )
+        bankMode = crgData->channelBank.info.valid ? 1 : 2;
+    
+    if ( crgData->gridQuant.valid )
+        gridMode = dGridQuant;
+    else if ( crgData->gridStream.valid )
+        gridMode = dGridStream;
+    
+    kernel->func = sEvalKernels[gridMode][( crgData->admin.defMask & dCrgDataDefVIndex ) ? 1 : 0][crgData->channelRefZ.info.valid ? 1 : 0][bankMode];
+}
+
+int
+crgEvaluv2zBatch( int cpId, int n, const double* u, const double* v, double* z, int* status )
+{
+    CrgContactPointStruct* cp;
+
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+    
+    return crgEvaluv2zBatchPtr( cp, n, u, v, z, status );
+}
+
+int
+crgEvaluv2zBatchPtr( CrgContactPointStruct *cp, int n, const double* u, const double* v, double* z, int* status )
+{
+    int retVal = 0;
+    
+    if ( !cp )
+        return 0;
+    
+    retVal = crgDataEvaluv2zBatch( cp->crgData, &( cp->options ), &( cp->perfStat ), n, u, v, z, status );
+    
+    /* --- keep the contact point consistent with the last query of the batch --- */
+    if ( n > 0 )
+    {
+        cp->u = u[n-1];
+        cp->v = v[n-1];
+        cp->z = z[n-1];
+    }
+    
+    return retVal;
+}
+
+
+int
+crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, CrgPerformanceStruct* perfStat, double u, double v, double* z )
+{
+    return crgDataEvaluv2zGrad( crgData, optionList, perfStat, u, v, z, NULL, NULL );
+}
 
 int
-crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u, double v, double* z )
+crgDataEvaluv2zGrad( CrgDataStruct *crgData, CrgOptionsStruct* optionList, CrgPerformanceStruct* perfStat, double u, double v, double* z,
+                     double* dzdu, double* dzdv )
 {
     size_t indexU         = 0;
     size_t indexV         = 0;
@@ -87,11 +432,21 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
     double z01;
     double z10;
     double z11;
+    double c[4];
     double bank;
     double zOffset        = 0.0;
     double smoothScale    = 1.0;   /* scale from smoothing option        */
     double smoothZone     = 0.0;   /* length of smoothing zone           */
     double smoothBase     = 0.0;   /* base value against which to smooth */
+    double smoothSlope    = 0.0;   /* derivative of smoothScale by u     */
+    double uMapScale      = 1.0;   /* derivative of mapped u by u        */
+    double vMapScale      = 1.0;   /* derivative of mapped v by v        */
+    double uGridScale     = 1.0;   /* derivative of grid position by u   */
+    double vGridScale     = 1.0;   /* derivative of grid position by v   */
+    double vCell          = 0.0;   /* width of the v interval            */
+    double gradU          = 0.0;
+    double gradV          = 0.0;
+    int    calcGrad       = ( dzdu != NULL ) || ( dzdv != NULL );
 
     int borderModeU       = dCrgBorderModeNone;
     int borderModeV       = dCrgBorderModeExKeep;
@@ -99,13 +454,19 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
     /* --- compute the fallback solution --- */
     *z = 0.0;
     
+    if ( dzdu )
+        *dzdu = 0.0;
+    
+    if ( dzdv )
+        *dzdv = 0.0;
+    
     if ( !crgData )
         return 0;
     
     /* --- doing performance measurements? --- */
 #ifdef dCrgEnableStats
-    if ( crgData->perfStat.active )
-        crgData->perfStat.noTotalQueries++;
+    if ( perfStat && perfStat->active )
+        perfStat->noTotalQueries++;
 #endif
     
     /* --- incoming u value might have to be clipped to correct range --- */
@@ -122,8 +483,8 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
     {
         
 #ifdef dCrgEnableStats
-        if ( crgData->perfStat.active )
-            crgData->perfStat.noCallsBorderU++;
+        if ( perfStat && perfStat->active )
+            perfStat->noCallsBorderU++;
 #endif
         
         /* --- leaving the core area --- */
@@ -141,6 +502,9 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
         }
         else if ( borderModeU == dCrgBorderModeExKeep )
         {
+            /* --- the border values are kept, z does not depend on u --- */
+            uGridScale = 0.0;
+            
             if ( fracU < 0.0 )
             {
                 fracU      = 0.0;
@@ -187,11 +551,19 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
             int    repSeq  = ( int ) ( ( u - crgData->channelU.info.first ) / uSize );
             int    revert  = abs( repSeq ) % 2;
             
+            if ( fracU < 0.0 )
+                uMapScale = -uMapScale;
+            
             fracU = fabs( fracU );
             fracU -= abs( repSeq ) * maxFrac;
         
             if ( revert )
-                fracU = maxFrac - fracU;
+            {
+                fracU     = maxFrac - fracU;
+                uMapScale = -uMapScale;
+            }
+            
+            uGridScale = uMapScale;
             
             /* we're back to the core area */
             inCoreAreaU = 1;
@@ -249,6 +621,9 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
             }
             else if ( borderModeV == dCrgBorderModeExKeep )
             {
+                /* --- the border values are kept, z does not depend on v --- */
+                vGridScale = 0.0;
+                
                 if ( fracV < 0.0 )
                 {
                     inCoreAreaV = 0;
@@ -287,11 +662,19 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
                 int    repSeq  = ( int ) ( ( v - crgData->channelV.info.first ) / vSize );
                 int    revert  = abs( repSeq ) % 2;
                 
+                if ( fracV < 0.0 )
+                    vMapScale = -vMapScale;
+                
                 fracV = fabs( fracV );
                 fracV -= abs( repSeq ) * maxFrac;        /* was vSize, debugged 29.09.2009 by Marius */
             
                 if ( revert )
-                    fracV = maxFrac - fracV;
+                {
+                    fracV     = maxFrac - fracV;
+                    vMapScale = -vMapScale;
+                }
+                
+                vGridScale = vMapScale;
                 
                 /* --- clamp v to the valid range --- */
 
@@ -322,15 +705,13 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
             else
                 fracV -= indexV;
         }
+        
+        vCell = crgData->channelV.info.inc;
     }
     else
     /* find v interval in variably spaced v axis */
     {
-        size_t indexCtr;
-        size_t index0     = crgData->channelV.info.size - 1;
         double vPos       = v;
-        
-        indexV = 0;
 
         /* --- is a border mode active? --- */
         if ( ( vPos < crgData->channelV.info.first ) || ( vPos > crgData->channelV.info.last ) )
@@ -342,8 +723,8 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
             borderModeV = dCrgBorderModeExKeep;
         
 #ifdef dCrgEnableStats
-            if ( crgData->perfStat.active )
-                crgData->perfStat.noCallsBorderV++;
+            if ( perfStat && perfStat->active )
+                perfStat->noCallsBorderV++;
 #endif
  
             /* --- compensate for numeric inaccuracies at the original borders --- */
@@ -402,7 +783,10 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
                     revert    = !( abs( repSeq ) % 2 );
                     
                     if ( revert ) 
-                        vPos = crgData->channelV.info.last - remainder;
+                    {
+                        vPos       = crgData->channelV.info.last - remainder;
+                        vGridScale = -1.0;
+                    }
                     else
                         vPos = crgData->channelV.info.first + remainder;
                 }
@@ -415,7 +799,10 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
                     if ( revert ) 
                         vPos = crgData->channelV.info.last + remainder;
                     else
-                        vPos = crgData->channelV.info.first - remainder;
+                    {
+                        vPos       = crgData->channelV.info.first - remainder;
+                        vGridScale = -1.0;
+                    }
                 }
 
                 /* we're back to the core area */
@@ -429,82 +816,37 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
         }
 
         if ( calcIndex )
-        {
-            /* --- make a better first guess for the v index based on a pre-computed index table --- */
-            if ( crgData->indexTableV.valid )
-            {
-                size_t lookUpIdx = 0;
-                if(vPos > crgData->indexTableV.minVal)
-                    lookUpIdx = ( size_t ) ( ( vPos - crgData->indexTableV.minVal ) / crgData->indexTableV.range * ( crgData->indexTableV.size - 1 ) );
-                if ( lookUpIdx > ( crgData->indexTableV.size - 1 ) )
-                    lookUpIdx = crgData->indexTableV.size - 1;
-                
-                indexCtr = crgData->indexTableV.refIdx[lookUpIdx];
-                
-                /* --- round-off error? --- */
-                if ( crgData->channelV.data[indexCtr] <= vPos )
-                    indexCtr++;
-                
-                if ( indexCtr > crgData->indexTableV.size - 1 )
-                    indexCtr = crgData->indexTableV.size - 1;
-                
-                if ( lookUpIdx > 0 )
-                {
-                    indexV = crgData->indexTableV.refIdx[lookUpIdx-1];
-                    
-                    if ( ( indexV >= indexCtr ) && ( indexV > 0 ) )
-                        indexV--;
-                }
-                
-                if ( lookUpIdx < crgData->indexTableV.size - 1 )
-                {
-                    index0 = crgData->indexTableV.refIdx[lookUpIdx+1];
-
-                    if ( ( index0 <= indexCtr ) && ( index0 < crgData->channelV.info.size - 1 ) )
-                        index0++;
-                }
-            }
-            
-            while ( 1 )
-            {
-#ifdef dCrgEnableStats
-                if ( crgData->perfStat.active )
-                    crgData->perfStat.noCallsLoopV1++;
-#endif
-                
-                indexCtr = ( index0 + indexV ) / 2;
-                
-                if ( indexCtr <= indexV )
-                    break;
-                
-                if ( vPos < crgData->channelV.data[indexCtr] )
-                    index0 = indexCtr;
-                else
-                    indexV = indexCtr;
-            }
-            fracV = ( vPos - crgData->channelV.data[indexV] ) / ( crgData->channelV.data[indexV+1] - crgData->channelV.data[indexV] );
-
-            /* correct v interval depending on evaluation options */
-            if ( fracV > 1.0 )
-                fracV = 1.0;
-            else if ( fracV < 0.0 )
-                fracV = 0.0;
-        }
+            findIndexVIrregular( crgData, perfStat, vPos, &indexV, &fracV );
+        
+        /* --- positions beyond the borders are clamped to the border values --- */
+        if ( ( vPos < crgData->channelV.info.first ) || ( vPos > crgData->channelV.info.last ) )
+            vGridScale = 0.0;
+        
+        vCell = crgData->channelV.data[indexV+1] - crgData->channelV.data[indexV];
     }
     
     if ( calcValue )
     {
         /* evaluate z(u, v) by bilinear interpolation */
-        z00  = crgData->channelZ[indexV].data[indexU];
-        z10  = crgData->channelZ[indexV].data[indexU+1] - z00;
-        z01  = crgData->channelZ[indexV+1].data[indexU];
-        z11  = crgData->channelZ[indexV+1].data[indexU+1] - ( z10 + z01 );
+        dCrgCellCorners( crgData, indexU, indexV, c );
+        
+        z00  = c[0];
+        z10  = c[1] - z00;
+        z01  = c[2];
+        z11  = c[3] - ( z10 + z01 );
         z01 -= z00;
         
         *z = ( z11 * fracV + z10 ) * fracU + z01 * fracV + z00;
         
         /* add mean value which was subtracted during normalization of channel values */
         *z += crgData->channelZ[indexV].info.mean;
+        
+        /* --- analytic derivatives of the bilinear interpolation --- */
+        if ( calcGrad )
+        {
+            gradU = ( z11 * fracV + z10 ) / crgData->channelU.info.inc * uGridScale;
+            gradV = ( z11 * fracU + z01 ) / vCell * vGridScale;
+        }
     }
     
     /* --- is a transition (smooth) option set? --- */
@@ -525,7 +867,10 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
                                             if ( u < crgData->channelU.info.first )
                                                 smoothScale = 0.0;
                                             else
+                                            {
                                                 smoothScale = ( u - crgData->channelU.info.first ) / smoothZone;
+                                                smoothSlope = uMapScale / smoothZone;
+                                            }
                                             calcSmoothBase = 1;
                                             calcSmooth     = 1;
                                         }
@@ -537,9 +882,15 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
                                     if ( (crgData->channelU.info.last - u) <= smoothZone )
                                         {
                                             if ( u > crgData->channelU.info.last )
+                                            {
                                                 smoothScale = 0.0;
+                                                smoothSlope = 0.0;
+                                            }
                                             else
+                                            {
                                                 smoothScale = ( crgData->channelU.info.last - u ) / smoothZone;
+                                                smoothSlope = -uMapScale / smoothZone;
+                                            }
                                             calcSmoothBase = 2;
                                             calcSmooth     = 1;
                                         }
@@ -576,7 +927,12 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
     /* --- add slope, banking, offsets and smoothing --- */
     /* add z displacement from reference line z data */
     if ( crgData->channelRefZ.info.valid )
+    {
        *z += crgData->channelRefZ.data[indexU] + fracU * ( crgData->channelRefZ.data[indexU+1] - crgData->channelRefZ.data[indexU] );
+       
+       if ( calcGrad )
+           gradU += ( crgData->channelRefZ.data[indexU+1] - crgData->channelRefZ.data[indexU] ) / crgData->channelU.info.inc * uGridScale;
+    }
     else
         *z += crgData->channelRefZ.info.first;
 
@@ -590,99 +946,1073 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
         
         /* --- clip v for banking to vmin/vmax --- */
         if ( v < crgData->channelV.info.first )
-            v = crgData->channelV.info.first;
+        {
+            v         = crgData->channelV.info.first;
+            vMapScale = 0.0;
+        }
         else if ( v > crgData->channelV.info.last )
-            v = crgData->channelV.info.last;
+        {
+            v         = crgData->channelV.info.last;
+            vMapScale = 0.0;
+        }
         
         *z += bank * v;
+        
+        if ( calcGrad )
+        {
+            if ( crgData->channelBank.info.valid )
+                gradU += ( crgData->channelBank.data[indexU+1] - crgData->channelBank.data[indexU] ) / crgData->channelU.info.inc * uGridScale * v;
+            
+            gradV += bank * vMapScale;
+        }
     }
 
     /* add any additional offset caused by options etc. */
     if (!inCoreAreaU) {
         if (borderModeU == dCrgBorderModeExZero )
-            *z = zOffset;
+        {
+            *z    = zOffset;
+            gradU = 0.0;
+            gradV = 0.0;
+        }
         else if(borderModeU == dCrgBorderModeExKeep )
             *z += zOffset;
         
     }
     else if (!inCoreAreaV) {
         if (borderModeV == dCrgBorderModeExZero )
-            *z = zOffset;
+        {
+            *z    = zOffset;
+            gradU = 0.0;
+            gradV = 0.0;
+        }
         else if(borderModeV == dCrgBorderModeExKeep )
             *z += zOffset;
     }
 
     if ( calcSmooth ){
         /* overall scale may be influenced by the smoothing zone */
+        if ( calcGrad )
+        {
+            gradU = gradU * smoothScale + ( *z - smoothBase ) * smoothSlope;
+            gradV = gradV * smoothScale;
+        }
+        
         *z = smoothBase + ( *z - smoothBase ) * smoothScale;
     }
 
+    if ( dzdu )
+        *dzdu = gradU;
+    
+    if ( dzdv )
+        *dzdv = gradV;
+    
     return 1;
 }
 
-int
-crgEvalxy2z( int cpId, double x, double y, double* z )
+static int
+evalGeneric( const CrgEvalKernelStruct* kernel, CrgDataStruct *crgData, CrgOptionsStruct* optionList,
+             CrgPerformanceStruct* perfStat, double u, double v, double* z )
 {
-    double u;
-    double v;
-    CrgContactPointStruct* cp = NULL;
+    /* --- the generic path does not need the bounds of the kernel --- */
+    ( void ) kernel;
     
-#ifdef dCrgEnableDebug2
-    if ( crgIsNan( &x ) || crgIsNan( &y ) || x !=x || y !=y )
+    return crgDataEvaluv2z( crgData, optionList, perfStat, u, v, z );
+}
+
+static int
+evalSpecialized( const CrgEvalKernelStruct* kernel, CrgDataStruct *crgData, CrgOptionsStruct* optionList,
+                 CrgPerformanceStruct* perfStat, double u, double v, double* z,
+                 int regularV, int refZMode, int bankMode, int gridMode )
+{
+    size_t indexU;
+    size_t indexV;
+    double fracU;
+    double fracV;
+    double z00;
+    double z01;
+    double z10;
+    double z11;
+    double c[4];
+    
+    /* --- the bounds check is the only decision of the common case --- */
+    if ( !( u >= kernel->uMin && u <= kernel->uMax && v >= kernel->vMin && v <= kernel->vMax ) )
+        return crgDataEvaluv2z( crgData, optionList, perfStat, u, v, z );
+    
+#ifdef dCrgEnableStats
+    if ( perfStat && perfStat->active )
+        perfStat->noTotalQueries++;
+#endif
+    
+    fracU  = ( u - crgData->channelU.info.first ) / crgData->channelU.info.inc;
+    indexU = ( size_t ) fracU;
+    
+    /* --- the last grid line belongs to the last interval --- */
+    if ( indexU >= crgData->channelU.info.size - 1 )
     {
-        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalxy2z: got NaN for x and/or y position. Refusing evaluation.\n" );
-        return 0;
+        indexU = crgData->channelU.info.size - 2;
+        fracU  = 1.0;
     }
     else
+        fracU -= indexU;
+    
+    if ( regularV )
     {
-        crgMsgPrint( dCrgMsgLevelNotice, "crgEvalxy2z: cpId = %d, x = %.6f, y = %.6f\n", cpId, x, y );
+        fracV  = ( v - crgData->channelV.info.first ) / crgData->channelV.info.inc;
+        indexV = ( size_t ) fracV;
+        
+        if ( indexV >= crgData->channelV.info.size - 1 )
+        {
+            indexV = crgData->channelV.info.size - 2;
+            fracV  = 1.0;
+        }
+        else
+            fracV -= indexV;
     }
-#endif
-
-    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
-        return 0;
+    else
+        findIndexVIrregular( crgData, perfStat, v, &indexV, &fracV );
     
-    if ( !crgEvalxy2uvPtr( cp, x, y, &u, &v ) )
-        return 0;
+    /* evaluate z(u, v) by bilinear interpolation; the grid representation is a constant of the kernel */
+    if ( gridMode == dGridQuant )
+        quantCorners( crgData, indexU, indexV, c );
+    else if ( gridMode == dGridStream )
+        crgDataGridStreamCorners( crgData, 1, &indexU, &indexV, c );
+    else
+        dCrgCellCornersFloat( crgData, indexU, indexV, c );
     
-    return crgEvaluv2zPtr( cp, u, v, z );
+    z00  = c[0];
+    z10  = c[1] - z00;
+    z01  = c[2];
+    z11  = c[3] - ( z10 + z01 );
+    z01 -= z00;
+    
+    *z = ( z11 * fracV + z10 ) * fracU + z01 * fracV + z00;
+    
+    /* add mean value which was subtracted during normalization of channel values */
+    *z += crgData->channelZ[indexV].info.mean;
+    
+    /* add z displacement from reference line z data */
+    if ( refZMode )
+       *z += crgData->channelRefZ.data[indexU] + fracU * ( crgData->channelRefZ.data[indexU+1] - crgData->channelRefZ.data[indexU] );
+    else
+        *z += crgData->channelRefZ.info.first;
+    
+    /* add z displacement from banking */
+    if ( bankMode == 1 )
+        *z += ( crgData->channelBank.data[indexU] + fracU * ( crgData->channelBank.data[indexU+1] - crgData->channelBank.data[indexU] ) ) * v;
+    else if ( bankMode == 2 )
+        *z += crgData->channelBank.info.first * v;
+    
+    return 1;
 }
 
-
 int
-crgDataEvalu2Refz( CrgDataStruct *crgData, double u, double* z )
+crgDataEvaluv2zCore( CrgDataStruct *crgData, CrgPerformanceStruct* perfStat, size_t indexU, double fracU, double v, double* z )
 {
-    double fracU;
-    size_t index = 0;
+    size_t indexV;
+    double fracV;
+    double z00;
+    double z01;
+    double z10;
+    double z11;
+    double c[4];
+    double bank;
     
-    if ( !crgData )
-        return 0;
+#ifdef dCrgEnableStats
+    if ( perfStat && perfStat->active )
+        perfStat->noTotalQueries++;
+#endif
     
-    /* --- set fallback solution --- */
-    *z = 0.0;
+    /* --- same arithmetic as crgDataEvaluv2z() without the border handling --- */
+    if ( crgData->admin.defMask & dCrgDataDefVIndex )
+    {
+        fracV  = ( v - crgData->channelV.info.first ) / crgData->channelV.info.inc;
+        indexV = ( size_t ) fracV;
+        
+        if ( indexV >= crgData->channelV.info.size - 1 )
+        {
+            indexV = crgData->channelV.info.size - 2;
+            fracV  = 1.0;
+        }
+        else
+            fracV -= indexV;
+    }
+    else
+        findIndexVIrregular( crgData, perfStat, v, &indexV, &fracV );
     
-    /* --- get elevation on reference line --- */
+    /* evaluate z(u, v) by bilinear interpolation */
+    dCrgCellCorners( crgData, indexU, indexV, c );
+    
+    z00  = c[0];
+    z10  = c[1] - z00;
+    z01  = c[2];
+    z11  = c[3] - ( z10 + z01 );
+    z01 -= z00;
+    
+    *z = ( z11 * fracV + z10 ) * fracU + z01 * fracV + z00;
+    
+    /* add mean value which was subtracted during normalization of channel values */
+    *z += crgData->channelZ[indexV].info.mean;
+    
+    /* add z displacement from reference line z data */
     if ( crgData->channelRefZ.info.valid )
+       *z += crgData->channelRefZ.data[indexU] + fracU * ( crgData->channelRefZ.data[indexU+1] - crgData->channelRefZ.data[indexU] );
+    else
+        *z += crgData->channelRefZ.info.first;
+    
+    /* add z displacement from banking; v is within range, no clipping required */
+    if ( crgData->util.hasBank )
     {
-        if ( u < crgData->channelU.info.first )
-            u = crgData->channelU.info.first;
-        else if ( u > crgData->channelU.info.last )
-            u = crgData->channelU.info.last;
-        
-        fracU = ( u - crgData->channelU.info.first ) / crgData->channelU.info.inc;
-        
-        if ( fracU >= 0. )
-            index = ( size_t ) fracU;
-        
-        if ( index >= crgData->channelRefZ.info.size - 1 )
-           index = crgData->channelRefZ.info.size - 2;
-        
-        fracU -= index;
+        if ( crgData->channelBank.info.valid )
+            bank = crgData->channelBank.data[indexU] + fracU * ( crgData->channelBank.data[indexU+1] - crgData->channelBank.data[indexU] );
+        else
+            bank = crgData->channelBank.info.first;
         
-        *z = crgData->channelRefZ.data[index] + fracU * ( crgData->channelRefZ.data[index + 1] - crgData->channelRefZ.data[index] );
+        *z += bank * v;
     }
     
     return 1;
 }
 
+void
+crgDataGridCellCorners( CrgDataStruct *crgData, size_t indexU, size_t indexV, double* c )
+{
+    dCrgCellCorners( crgData, indexU, indexV, c );
+}
 
+int
+crgDataEvaluv2zBatch( CrgDataStruct *crgData, CrgOptionsStruct* optionList, CrgPerformanceStruct* perfStat, int n, const double* u, const double* v, double* z, int* status )
+{
+    int    i;
+    int    k;
+    int    noCore;
+    int    retVal     = 1;
+    int    pointOk;
+    int    regularV;
+    int    hasSmoothBeg;
+    int    hasSmoothEnd;
+    int    hasBank;
+    size_t maxIndexU;
+    size_t maxIndexV;
+    double uFirst;
+    double uLast;
+    double uInc;
+    double vFirst;
+    double vLast;
+    double vInc;
+    double smoothZoneBeg = 0.0;
+    double smoothZoneEnd = 0.0;
+    double uPos;
+    double zVal;
+    double bank;
+    int    coreIdx[dBatchChunkSize];   /* position index of core area points in chunk */
+    size_t indexU[dBatchChunkSize];
+    size_t indexV[dBatchChunkSize];
+    double fracU[dBatchChunkSize];
+    double fracV[dBatchChunkSize];
+    double zCore[dBatchChunkSize];
+    
+    if ( !crgData || n < 0 || ( n && ( !u || !v || !z ) ) )
+        return 0;
+    
+    if ( !sBilinearKernel )
+        crgEvalzInitKernel();
+    
+    /* --- resolve everything that is constant for the whole batch --- */
+    uFirst    = crgData->channelU.info.first;
+    uLast     = crgData->channelU.info.last;
+    uInc      = crgData->channelU.info.inc;
+    vFirst    = crgData->channelV.info.first;
+    vLast     = crgData->channelV.info.last;
+    vInc      = crgData->channelV.info.inc;
+    maxIndexU = crgData->channelU.info.size - 1;
+    maxIndexV = crgData->channelV.info.size - 1;
+    regularV  = ( crgData->admin.defMask & dCrgDataDefVIndex ) != 0;
+    hasBank   = crgData->util.hasBank;
+    
+    hasSmoothBeg = optionList && optionList->entry[dCrgCpOptionSmoothUBegin].valid;
+    hasSmoothEnd = optionList && optionList->entry[dCrgCpOptionSmoothUEnd].valid;
+    
+    if ( hasSmoothBeg )
+        smoothZoneBeg = optionList->entry[dCrgCpOptionSmoothUBegin].dValue;
+    
+    if ( hasSmoothEnd )
+        smoothZoneEnd = optionList->entry[dCrgCpOptionSmoothUEnd].dValue;
+    
+    i = 0;
+    
+    while ( i < n )
+    {
+        /* --- collect a chunk of core area points, evaluate all others directly --- */
+        for ( noCore = 0; ( i < n ) && ( noCore < dBatchChunkSize ); i++ )
+        {
+            uPos = u[i];
+            
+            if ( crgData->util.uIsClosed )
+                crgEvalu2uvalid( crgData, optionList, &uPos );
+            
+            /* --- points outside the core area or within a smoothing zone take the full path --- */
+            if ( ( uPos < uFirst ) || ( uPos > uLast ) || ( v[i] < vFirst ) || ( v[i] > vLast ) ||
+                 ( hasSmoothBeg && ( ( uPos - uFirst ) <= smoothZoneBeg ) ) ||
+                 ( hasSmoothEnd && ( ( uLast - uPos ) <= smoothZoneEnd ) ) )
+            {
+                pointOk = crgDataEvaluv2z( crgData, optionList, perfStat, u[i], v[i], &( z[i] ) );
+                
+                if ( status )
+                    status[i] = pointOk;
+                
+                if ( !pointOk )
+                    retVal = 0;
+                
+                continue;
+            }
+            
+#ifdef dCrgEnableStats
+            if ( perfStat && perfStat->active )
+                perfStat->noTotalQueries++;
+#endif
+            
+            /* --- core area: same arithmetic as crgDataEvaluv2z() without the border handling --- */
+            fracU[noCore]  = ( uPos - uFirst ) / uInc;
+            indexU[noCore] = ( size_t ) fracU[noCore];
+            
+            if ( indexU[noCore] >= maxIndexU )
+            {
+                indexU[noCore] = maxIndexU - 1;
+                fracU[noCore]  = 1.0;
+            }
+            else
+                fracU[noCore] -= indexU[noCore];
+            
+            if ( regularV )
+            {
+                fracV[noCore]  = ( v[i] - vFirst ) / vInc;
+                indexV[noCore] = ( size_t ) fracV[noCore];
+                
+                if ( indexV[noCore] >= maxIndexV )
+                {
+                    indexV[noCore] = maxIndexV - 1;
+                    fracV[noCore]  = 1.0;
+                }
+                else
+                    fracV[noCore] -= indexV[noCore];
+            }
+            else
+                findIndexVIrregular( crgData, perfStat, v[i], &( indexV[noCore] ), &( fracV[noCore] ) );
+            
+            coreIdx[noCore++] = i;
+        }
+        
+        if ( !noCore )
+            continue;
+        
+        /* evaluate z(u, v) by bilinear interpolation; the vector kernels work on float channels only */
+        if ( crgData->gridQuant.valid )
+            bilinearQuant( crgData, noCore, indexU, indexV, fracU, fracV, zCore );
+        else if ( crgData->gridStream.valid )
+            bilinearStream( crgData, noCore, indexU, indexV, fracU, fracV, zCore );
+        else
+            sBilinearKernel( crgData, noCore, indexU, indexV, fracU, fracV, zCore );
+        
+        for ( k = 0; k < noCore; k++ )
+        {
+            zVal = zCore[k];
+            
+            /* add z displacement from reference line z data */
+            if ( crgData->channelRefZ.info.valid )
+                zVal += crgData->channelRefZ.data[indexU[k]] + fracU[k] * ( crgData->channelRefZ.data[indexU[k]+1] - crgData->channelRefZ.data[indexU[k]] );
+            else
+                zVal += crgData->channelRefZ.info.first;
+            
+            /* add z displacement from banking; v is within range, no clipping required */
+            if ( hasBank )
+            {
+                if ( crgData->channelBank.info.valid )
+                    bank = crgData->channelBank.data[indexU[k]] + fracU[k] * ( crgData->channelBank.data[indexU[k]+1] - crgData->channelBank.data[indexU[k]] );
+                else
+                    bank = crgData->channelBank.info.first;
+                
+                zVal += bank * v[coreIdx[k]];
+            }
+            
+            z[coreIdx[k]] = zVal;
+            
+            if ( status )
+                status[coreIdx[k]] = 1;
+        }
+    }
+    
+    return retVal;
+}
+
+int
+crgEvalzSetKernel( int kernel )
+{
+    int retVal;
+    
+    crgPortLock( dCrgLockKernel );
+    retVal = selectKernel( kernel );
+    crgPortUnlock( dCrgLockKernel );
+    
+    return retVal;
+}
+
+void
+crgEvalzInitKernel( void )
+{
+    crgPortLock( dCrgLockKernel );
+    
+    if ( !sBilinearKernel )
+        selectKernel( dCrgKernelAuto );
+    
+    crgPortUnlock( dCrgLockKernel );
+}
+
+const char*
+crgEvalzGetKernelName( void )
+{
+    if ( !sBilinearKernel )
+        crgEvalzInitKernel();
+    
+    if ( sKernelId == dCrgKernelAVX2 )
+        return "AVX2";
+    
+    if ( sKernelId == dCrgKernelSSE2 )
+        return "SSE2";
+    
+    return "scalar";
+}
+
+int
+crgEvalxy2z( int cpId, double x, double y, double* z )
+{
+    double u;
+    double v;
+    CrgContactPointStruct* cp = NULL;
+    
+#ifdef dCrgEnableDebug2
+    if ( crgIsNan( &x ) || crgIsNan( &y ) || x !=x || y !=y )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalxy2z: got NaN for x and/or y position. Refusing evaluation.\n" );
+        return 0;
+    }
+    else
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgEvalxy2z: cpId = %d, x = %.6f, y = %.6f\n", cpId, x, y );
+    }
+#endif
+
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+    
+    if ( !crgEvalxy2uvPtr( cp, x, y, &u, &v ) )
+        return 0;
+    
+    return crgEvaluv2zPtr( cp, u, v, z );
+}
+
+
+int
+crgEvaluv2zn( int cpId, double u, double v, double* z, double* dzdu, double* dzdv, double* nrm )
+{
+    CrgContactPointStruct* cp;
+
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+    
+    return crgEvaluv2znPtr( cp, u, v, z, dzdu, dzdv, nrm );
+}
+
+int
+crgEvaluv2znPtr( CrgContactPointStruct *cp, double u, double v, double* z, double* dzdu, double* dzdv, double* nrm )
+{
+    int    retVal;
+    double gradU;
+    double gradV;
+    
+    if ( !cp )
+        return 0;
+    
+    /* --- compute the fallback solution --- */
+    cp->u = u;
+    cp->v = v;
+    
+    retVal = crgDataEvaluv2zGrad( cp->crgData, &( cp->options ), &( cp->perfStat ), cp->u, cp->v, &( cp->z ), &gradU, &gradV );
+    
+    /* --- transfer the result --- */
+    *z = cp->z;
+    
+    if ( dzdu )
+        *dzdu = gradU;
+    
+    if ( dzdv )
+        *dzdv = gradV;
+    
+    if ( nrm )
+        surfaceNormal( cp->crgData, &( cp->options ), u, v, gradU, gradV, nrm );
+    
+    return retVal;
+}
+
+int
+crgEvaluv2znBatch( int cpId, int n, const double* u, const double* v, double* z, double* dzdu, double* dzdv, double* nrm, int* status )
+{
+    CrgContactPointStruct* cp;
+    int i;
+    int pointOk;
+    int retVal = 1;
+
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+    
+    if ( n < 0 || ( n && ( !u || !v || !z ) ) )
+        return 0;
+    
+    for ( i = 0; i < n; i++ )
+    {
+        pointOk = crgEvaluv2znPtr( cp, u[i], v[i], &( z[i] ), dzdu ? &( dzdu[i] ) : NULL, dzdv ? &( dzdv[i] ) : NULL, nrm ? &( nrm[3*i] ) : NULL );
+        
+        if ( status )
+            status[i] = pointOk;
+        
+        if ( !pointOk )
+            retVal = 0;
+    }
+    
+    return retVal;
+}
+
+int
+crgEvalxy2zn( int cpId, double x, double y, double* z, double* dzdu, double* dzdv, double* nrm )
+{
+    double u;
+    double v;
+    CrgContactPointStruct* cp;
+    
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+    
+    if ( !crgEvalxy2uvPtr( cp, x, y, &u, &v ) )
+        return 0;
+    
+    return crgEvaluv2znPtr( cp, u, v, z, dzdu, dzdv, nrm );
+}
+
+int
+crgEvalxy2znBatch( int cpId, int n, const double* x, const double* y, double* z, double* dzdu, double* dzdv, double* nrm )
+{
+    CrgContactPointStruct* cp;
+    int    i;
+    int    k;
+    int    noPts;
+    int    retVal = 1;
+    double u[dBatchChunkSize];
+    double v[dBatchChunkSize];
+
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        return 0;
+    
+    if ( n < 0 || ( n && ( !x || !y || !z ) ) )
+        return 0;
+    
+    /* --- positions take the batch search in chunks, so no buffers need to be allocated --- */
+    for ( i = 0; i < n; i += noPts )
+    {
+        noPts = n - i;
+        
+        if ( noPts > dBatchChunkSize )
+            noPts = dBatchChunkSize;
+        
+        if ( !crgEvalxy2uvBatchPtr( cp, noPts, &( x[i] ), &( y[i] ), u, v ) )
+            return 0;
+        
+        for ( k = 0; k < noPts; k++ )
+            if ( !crgEvaluv2znPtr( cp, u[k], v[k], &( z[i+k] ), dzdu ? &( dzdu[i+k] ) : NULL, dzdv ? &( dzdv[i+k] ) : NULL,
+                                   nrm ? &( nrm[3*(i+k)] ) : NULL ) )
+                retVal = 0;
+    }
+    
+    return retVal;
+}
+
+int
+crgDataEvalu2Refz( CrgDataStruct *crgData, double u, double* z )
+{
+    double fracU;
+    size_t index = 0;
+    
+    if ( !crgData )
+        return 0;
+    
+    /* --- set fallback solution --- */
+    *z = 0.0;
+    
+    /* --- get elevation on reference line --- */
+    if ( crgData->channelRefZ.info.valid )
+    {
+        if ( u < crgData->channelU.info.first )
+            u = crgData->channelU.info.first;
+        else if ( u > crgData->channelU.info.last )
+            u = crgData->channelU.info.last;
+        
+        fracU = ( u - crgData->channelU.info.first ) / crgData->channelU.info.inc;
+        
+        if ( fracU >= 0. )
+            index = ( size_t ) fracU;
+        
+        if ( index >= crgData->channelRefZ.info.size - 1 )
+           index = crgData->channelRefZ.info.size - 2;
+        
+        fracU -= index;
+        
+        *z = crgData->channelRefZ.data[index] + fracU * ( crgData->channelRefZ.data[index + 1] - crgData->channelRefZ.data[index] );
+    }
+    
+    return 1;
+}
+
+static void
+findIndexVIrregular( CrgDataStruct *crgData, CrgPerformanceStruct* perfStat, double vPos, size_t* indexV, double* fracV )
+{
+    size_t indexCtr;
+    size_t index0 = crgData->channelV.info.size - 1;
+    
+    /* --- the statistics are only collected with dCrgEnableStats --- */
+    ( void ) perfStat;
+    
+    *indexV = 0;
+    
+    /* --- make a better first guess for the v index based on a pre-computed index table --- */
+    if ( crgData->indexTableV.valid )
+    {
+        size_t lookUpIdx = 0;
+        if(vPos > crgData->indexTableV.minVal)
+            lookUpIdx = ( size_t ) ( ( vPos - crgData->indexTableV.minVal ) / crgData->indexTableV.range * ( crgData->indexTableV.size - 1 ) );
+        if ( lookUpIdx > ( crgData->indexTableV.size - 1 ) )
+            lookUpIdx = crgData->indexTableV.size - 1;
+        
+        indexCtr = crgData->indexTableV.refIdx[lookUpIdx];
+        
+        /* --- round-off error? --- */
+        if ( crgData->channelV.data[indexCtr] <= vPos )
+            indexCtr++;
+        
+        if ( indexCtr > crgData->indexTableV.size - 1 )
+            indexCtr = crgData->indexTableV.size - 1;
+        
+        if ( lookUpIdx > 0 )
+        {
+            *indexV = crgData->indexTableV.refIdx[lookUpIdx-1];
+            
+            if ( ( *indexV >= indexCtr ) && ( *indexV > 0 ) )
+                ( *indexV )--;
+        }
+        
+        if ( lookUpIdx < crgData->indexTableV.size - 1 )
+        {
+            index0 = crgData->indexTableV.refIdx[lookUpIdx+1];
+
+            if ( ( index0 <= indexCtr ) && ( index0 < crgData->channelV.info.size - 1 ) )
+                index0++;
+        }
+    }
+    
+    while ( 1 )
+    {
+#ifdef dCrgEnableStats
+        if ( perfStat && perfStat->active )
+            perfStat->noCallsLoopV1++;
+#endif
+        
+        indexCtr = ( index0 + *indexV ) / 2;
+        
+        if ( indexCtr <= *indexV )
+            break;
+        
+        if ( vPos < crgData->channelV.data[indexCtr] )
+            index0 = indexCtr;
+        else
+            *indexV = indexCtr;
+    }
+    *fracV = ( vPos - crgData->channelV.data[*indexV] ) / ( crgData->channelV.data[*indexV+1] - crgData->channelV.data[*indexV] );
+
+
+    /* correct v interval depending on evaluation options */
+    if ( *fracV > 1.0 )
+        *fracV = 1.0;
+    else if ( *fracV < 0.0 )
+        *fracV = 0.0;
+}
+
+static int
+selectKernel( int kernel )
+{
+    if ( kernel == dCrgKernelAuto )
+    {
+        if ( kernelIsSupported( dCrgKernelAVX2 ) )
+            kernel = dCrgKernelAVX2;
+        else if ( kernelIsSupported( dCrgKernelSSE2 ) )
+            kernel = dCrgKernelSSE2;
+        else
+            kernel = dCrgKernelScalar;
+    }
+    
+    if ( !kernelIsSupported( kernel ) )
+        return 0;
+    
+    switch ( kernel )
+    {
+#ifdef dCrgUseAVX2
+        case dCrgKernelAVX2:
+            sBilinearKernel = bilinearAVX2;
+            break;
+#endif
+#ifdef dCrgUseSSE2
+        case dCrgKernelSSE2:
+            sBilinearKernel = bilinearSSE2;
+            break;
+#endif
+        default:
+            sBilinearKernel = bilinearScalar;
+            break;
+    }
+    
+    sKernelId = kernel;
+    
+    return 1;
+}
+
+static int
+kernelIsSupported( int kernel )
+{
+    if ( kernel == dCrgKernelScalar )
+        return 1;
+    
+#ifdef dCrgUseSSE2
+    if ( kernel == dCrgKernelSSE2 )
+        return 1;
+#endif
+    
+#ifdef dCrgUseAVX2
+    if ( kernel == dCrgKernelAVX2 )
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports( "avx2" ) != 0;
+    }
+#endif
+    
+    return 0;
+}
+
+static void
+quantCorners( CrgDataStruct *crgData, size_t indexU, size_t indexV, double* c )
+{
+    CrgGridQuantStruct* quant;
+    const short* q;
+    size_t block[4];
+    int    i;
+    
+    quant    = &( crgData->gridQuant );
+    q        = quant->data + indexV * quant->sizeU + indexU;
+    block[0] = ( indexV >> dCrgQuantBlockBits ) * quant->noBlocksU + ( indexU >> dCrgQuantBlockBits );
+    
+    /* --- the corners of a cell may belong to up to four blocks, mostly they share one --- */
+    if ( ( ( indexU + 1 ) & ( dCrgQuantBlockSize - 1 ) ) && ( ( indexV + 1 ) & ( dCrgQuantBlockSize - 1 ) ) )
+    {
+        c[0] = quant->offset[block[0]] + quant->scale[block[0]] * q[0];
+        c[1] = quant->offset[block[0]] + quant->scale[block[0]] * q[1];
+        c[2] = quant->offset[block[0]] + quant->scale[block[0]] * q[quant->sizeU];
+        c[3] = quant->offset[block[0]] + quant->scale[block[0]] * q[quant->sizeU+1];
+    }
+    else
+    {
+        block[1] = ( indexV >> dCrgQuantBlockBits ) * quant->noBlocksU + ( ( indexU + 1 ) >> dCrgQuantBlockBits );
+        block[2] = ( ( indexV + 1 ) >> dCrgQuantBlockBits ) * quant->noBlocksU + ( indexU >> dCrgQuantBlockBits );
+        block[3] = ( ( indexV + 1 ) >> dCrgQuantBlockBits ) * quant->noBlocksU + ( ( indexU + 1 ) >> dCrgQuantBlockBits );
+        
+        c[0] = quant->offset[block[0]] + quant->scale[block[0]] * q[0];
+        c[1] = quant->offset[block[1]] + quant->scale[block[1]] * q[1];
+        c[2] = quant->offset[block[2]] + quant->scale[block[2]] * q[quant->sizeU];
+        c[3] = quant->offset[block[3]] + quant->scale[block[3]] * q[quant->sizeU+1];
+    }
+    
+    if ( q[0] == dCrgQuantNaN || q[1] == dCrgQuantNaN || q[quant->sizeU] == dCrgQuantNaN || q[quant->sizeU+1] == dCrgQuantNaN )
+    {
+        for ( i = 0; i < 4; i++ )
+            if ( q[( i & 1 ) + ( i >> 1 ) * quant->sizeU] == dCrgQuantNaN )
+                crgSetNan( &( c[i] ) );
+    }
+}
+
+static void
+bilinearScalar( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+                const double* fracU, const double* fracV, double* z )
+{
+    int    k;
+    double z00;
+    double z01;
+    double z10;
+    double z11;
+    
+    for ( k = 0; k < n; k++ )
+    {
+        z00  = crgData->channelZ[indexV[k]].data[indexU[k]];
+        z10  = crgData->channelZ[indexV[k]].data[indexU[k]+1] - z00;
+        z01  = crgData->channelZ[indexV[k]+1].data[indexU[k]];
+        z11  = crgData->channelZ[indexV[k]+1].data[indexU[k]+1] - ( z10 + z01 );
+        z01 -= z00;
+        
+        z[k]  = ( z11 * fracV[k] + z10 ) * fracU[k] + z01 * fracV[k] + z00;
+        z[k] += crgData->channelZ[indexV[k]].info.mean;
+    }
+}
+
+static void
+bilinearQuant( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+               const double* fracU, const double* fracV, double* z )
+{
+    CrgGridQuantStruct* quant = &( crgData->gridQuant );
+    const short* q;
+    int    k;
+    size_t block;
+    double z00;
+    double z01;
+    double z10;
+    double z11;
+    double c[4];
+    
+    for ( k = 0; k < n; k++ )
+    {
+        q = quant->data + indexV[k] * quant->sizeU + indexU[k];
+        
+        /* --- within a block, the quantized values are interpolated and scaled once --- */
+        if ( ( ( indexU[k] + 1 ) & ( dCrgQuantBlockSize - 1 ) ) && ( ( indexV[k] + 1 ) & ( dCrgQuantBlockSize - 1 ) ) &&
+             q[0] != dCrgQuantNaN && q[1] != dCrgQuantNaN && q[quant->sizeU] != dCrgQuantNaN && q[quant->sizeU+1] != dCrgQuantNaN )
+        {
+            block = ( indexV[k] >> dCrgQuantBlockBits ) * quant->noBlocksU + ( indexU[k] >> dCrgQuantBlockBits );
+            
+            z00  = q[0];
+            z10  = q[1] - z00;
+            z01  = q[quant->sizeU];
+            z11  = q[quant->sizeU+1] - ( z10 + z01 );
+            z01 -= z00;
+            
+            z[k] = quant->offset[block] + quant->scale[block] * ( ( z11 * fracV[k] + z10 ) * fracU[k] + z01 * fracV[k] + z00 );
+        }
+        else
+        {
+            quantCorners( crgData, indexU[k], indexV[k], c );
+            
+            z00  = c[0];
+            z10  = c[1] - z00;
+            z01  = c[2];
+            z11  = c[3] - ( z10 + z01 );
+            z01 -= z00;
+            
+            z[k] = ( z11 * fracV[k] + z10 ) * fracU[k] + z01 * fracV[k] + z00;
+        }
+        
+        z[k] += crgData->channelZ[indexV[k]].info.mean;
+    }
+}
+
+static void
+bilinearStream( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+                const double* fracU, const double* fracV, double* z )
+{
+    int    k;
+    double z00;
+    double z01;
+    double z10;
+    double z11;
+    double c[4*dBatchChunkSize];
+    
+    crgDataGridStreamCorners( crgData, n, indexU, indexV, c );
+    
+    for ( k = 0; k < n; k++ )
+    {
+        z00  = c[4*k];
+        z10  = c[4*k+1] - z00;
+        z01  = c[4*k+2];
+        z11  = c[4*k+3] - ( z10 + z01 );
+        z01 -= z00;
+        
+        z[k]  = ( z11 * fracV[k] + z10 ) * fracU[k] + z01 * fracV[k] + z00;
+        z[k] += crgData->channelZ[indexV[k]].info.mean;
+    }
+}
+
+#ifdef dCrgUseSSE2
+static void
+bilinearSSE2( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+              const double* fracU, const double* fracV, double* z )
+{
+    int     k;
+    float*  row0a;
+    float*  row1a;
+    float*  row0b;
+    float*  row1b;
+    __m128d z00;
+    __m128d z01;
+    __m128d z10;
+    __m128d z11;
+    __m128d fU;
+    __m128d fV;
+    __m128d res;
+    
+    /* --- two positions per instruction; the grid values are gathered from the rows --- */
+    for ( k = 0; k + 1 < n; k += 2 )
+    {
+        row0a = crgData->channelZ[indexV[k]].data + indexU[k];
+        row1a = crgData->channelZ[indexV[k]+1].data + indexU[k];
+        row0b = crgData->channelZ[indexV[k+1]].data + indexU[k+1];
+        row1b = crgData->channelZ[indexV[k+1]+1].data + indexU[k+1];
+        
+        z00 = _mm_set_pd( row0b[0], row0a[0] );
+        z10 = _mm_sub_pd( _mm_set_pd( row0b[1], row0a[1] ), z00 );
+        z01 = _mm_set_pd( row1b[0], row1a[0] );
+        z11 = _mm_sub_pd( _mm_set_pd( row1b[1], row1a[1] ), _mm_add_pd( z10, z01 ) );
+        z01 = _mm_sub_pd( z01, z00 );
+        
+        fU = _mm_loadu_pd( fracU + k );
+        fV = _mm_loadu_pd( fracV + k );
+        
+        res = _mm_mul_pd( _mm_add_pd( _mm_mul_pd( z11, fV ), z10 ), fU );
+        res = _mm_add_pd( _mm_add_pd( res, _mm_mul_pd( z01, fV ) ), z00 );
+        res = _mm_add_pd( res, _mm_set_pd( crgData->channelZ[indexV[k+1]].info.mean, crgData->channelZ[indexV[k]].info.mean ) );
+        
+        _mm_storeu_pd( z + k, res );
+    }
+    
+    if ( k < n )
+        bilinearScalar( crgData, n - k, indexU + k, indexV + k, fracU + k, fracV + k, z + k );
+}
+#endif
+
+#ifdef dCrgUseAVX2
+static void
+bilinearAVX2( CrgDataStruct *crgData, int n, const size_t* indexU, const size_t* indexV,
+              const double* fracU, const double* fracV, double* z )
+{
+    int     k;
+    int     j;
+    float*  row0[4];
+    float*  row1[4];
+    __m256d z00;
+    __m256d z01;
+    __m256d z10;
+    __m256d z11;
+    __m256d fU;
+    __m256d fV;
+    __m256d res;
+    
+    /* --- four positions per instruction; the grid values are gathered from the rows --- */
+    for ( k = 0; k + 3 < n; k += 4 )
+    {
+        for ( j = 0; j < 4; j++ )
+        {
+            row0[j] = crgData->channelZ[indexV[k+j]].data + indexU[k+j];
+            row1[j] = crgData->channelZ[indexV[k+j]+1].data + indexU[k+j];
+        }
+        
+        z00 = _mm256_set_pd( row0[3][0], row0[2][0], row0[1][0], row0[0][0] );
+        z10 = _mm256_sub_pd( _mm256_set_pd( row0[3][1], row0[2][1], row0[1][1], row0[0][1] ), z00 );
+        z01 = _mm256_set_pd( row1[3][0], row1[2][0], row1[1][0], row1[0][0] );
+        z11 = _mm256_sub_pd( _mm256_set_pd( row1[3][1], row1[2][1], row1[1][1], row1[0][1] ), _mm256_add_pd( z10, z01 ) );
+        z01 = _mm256_sub_pd( z01, z00 );
+        
+        fU = _mm256_loadu_pd( fracU + k );
+        fV = _mm256_loadu_pd( fracV + k );
+        
+        res = _mm256_mul_pd( _mm256_add_pd( _mm256_mul_pd( z11, fV ), z10 ), fU );
+        res = _mm256_add_pd( _mm256_add_pd( res, _mm256_mul_pd( z01, fV ) ), z00 );
+        res = _mm256_add_pd( res, _mm256_set_pd( crgData->channelZ[indexV[k+3]].info.mean, crgData->channelZ[indexV[k+2]].info.mean,
+                                                 crgData->channelZ[indexV[k+1]].info.mean, crgData->channelZ[indexV[k]].info.mean ) );
+        
+        _mm256_storeu_pd( z + k, res );
+    }
+    
+    if ( k < n )
+        bilinearScalar( crgData, n - k, indexU + k, indexV + k, fracU + k, fracV + k, z + k );
+}
+#endif
+
+static void
+surfaceNormal( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u, double v, double dzdu, double dzdv, double* nrm )
+{
+    CrgRefLineGeomStruct* geom;
+    double fracU;
+    double tu[2];
+    double tv[2];
+    double len;
+    size_t indexU;
+    
+    /* --- fallback: horizontal surface --- */
+    nrm[0] = 0.0;
+    nrm[1] = 0.0;
+    nrm[2] = 1.0;
+    
+    if ( !crgData )
+        return;
+    
+    geom = &( crgData->refLineGeom );
+    
+    if ( crgData->util.uIsClosed )
+        crgEvalu2uvalid( crgData, optionList, &u );
+    
+    fracU = ( u - crgData->channelU.info.first ) / crgData->channelU.info.inc;
+    
+    /* --- horizontal directions of u and v, i.e. the derivatives of crgDataEvaluv2xy() --- */
+    if ( fracU < 0.0 || !geom->valid )
+    {
+        tu[0] =  crgData->util.phiFirstCos;
+        tu[1] =  crgData->util.phiFirstSin;
+        tv[0] = -crgData->util.phiFirstSin;
+        tv[1] =  crgData->util.phiFirstCos;
+    }
+    else if ( fracU > geom->size - 1 )
+    {
+        tu[0] =  crgData->util.phiLastCos;
+        tu[1] =  crgData->util.phiLastSin;
+        tv[0] = -crgData->util.phiLastSin;
+        tv[1] =  crgData->util.phiLastCos;
+    }
+    else
+    {
+        indexU = ( size_t ) fracU;
+        
+        if ( indexU >= geom->size - 1 )
+            indexU = geom->size - 2;
+        
+        fracU -= indexU;
+        
+        /* --- P1 + v * N1 + frac * ( P2 + v * N2 - P1 - v * N1 ) --- */
+        tu[0] = ( crgData->channelX.data[indexU+1] - crgData->channelX.data[indexU] + v * ( geom->endNormX[indexU] - geom->begNormX[indexU] ) ) / crgData->channelU.info.inc;
+        tu[1] = ( crgData->channelY.data[indexU+1] - crgData->channelY.data[indexU] + v * ( geom->endNormY[indexU] - geom->begNormY[indexU] ) ) / crgData->channelU.info.inc;
+        tv[0] = geom->begNormX[indexU] + fracU * ( geom->endNormX[indexU] - geom->begNormX[indexU] );
+        tv[1] = geom->begNormY[indexU] + fracU * ( geom->endNormY[indexU] - geom->begNormY[indexU] );
+    }
+    
+    /* --- cross product of the tangents (tu, dz/du) and (tv, dz/dv) --- */
+    nrm[0] = tu[1] * dzdv - dzdu * tv[1];
+    nrm[1] = dzdu * tv[0] - tu[0] * dzdv;
+    nrm[2] = tu[0] * tv[1] - tu[1] * tv[0];
+    
+    len = sqrt( nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2] );
+    
+    /* --- beyond the center of curvature the mapping is folded, keep the normal pointing upwards --- */
+    if ( nrm[2] < 0.0 )
+        len = -len;
+    
+    if ( fabs( len ) < 1.0e-10 )
+    {
+        nrm[0] = 0.0;
+        nrm[1] = 0.0;
+        nrm[2] = 1.0;
+        return;
+    }
+    
+    nrm[0] /= len;
+    nrm[1] /= len;
+    nrm[2] /= len;
+}
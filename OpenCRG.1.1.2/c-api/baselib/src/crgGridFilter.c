@@ -0,0 +1,559 @@
+/* ===================================================
+ *  file:       crgGridFilter.c
+ * ---------------------------------------------------
+ *  purpose:	filter the elevation grid with a mask,
+ *              C port of crg_filter.m
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include <math.h>
+#include <string.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dFilterTileU        1024    /* number of u samples filtered as one tile                */
+#define dFilterBlockV       32      /* number of v channels filtered as one block              */
+#define dFilterMaxTasks     64      /* maximum number of tasks filtering a grid               */
+#define dFilterTaskMinRows  8       /* minimum number of v channels filtered by a task         */
+#define dFilterTaskMinSize  65536   /* minimum number of samples filtered by a task            */
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* a filter pass over a range of the grid, split into tasks of adjacent v channels
+*/
+typedef struct
+{
+    CrgDataStruct* crgData;
+    size_t  iuBeg;          /* index of the first sample of the range in u direction          [-] */
+    size_t  ivBeg;          /* index of the first v channel of the range                      [-] */
+    size_t  nu;             /* number of samples of the range in u direction                  [-] */
+    size_t  nv;             /* number of v channels of the range                              [-] */
+    int     sizeU;          /* size of the mask in u direction                                [-] */
+    int     sizeV;          /* size of the mask in v direction                                [-] */
+    int     offU;           /* position of the filtered sample within the mask in u direction [-] */
+    int     offV;           /* position of the filtered sample within the mask in v direction [-] */
+    float*  maskU;          /* mirrored mask in u direction of a separable filter             [-] */
+    float*  maskV;          /* mirrored mask in v direction of a separable filter             [-] */
+    float*  mask;           /* mirrored sizeV x sizeU mask, NULL for a separable filter       [-] */
+    float   identity;       /* coefficient of the sample itself, added to a separable mask    [-] */
+    float   weight;         /* weight of the mask                                             [-] */
+    float*  src;            /* samples of the range before the pass, nv rows of nu values     [m] */
+    int     noTasks;        /* number of tasks                                                [-] */
+    float** buffer;         /* work buffer of each task                                       [-] */
+} CrgFilterJobStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* build a binomial mask of size n with k derivatives, see binf() of crg_filter.m
+* @param mask    resulting n coefficients, mirrored
+* @param n       size of the mask
+* @param k       order of the derivative
+* @return 1 if successful, 0 if the mask is too small for the derivative
+*/
+static int binomialMask( float* mask, int n, int k );
+
+/**
+* filter the v channels of a single task
+* @param data    pointer to the job
+* @param taskId  index of the task
+*/
+static void filterTask( void* data, int taskId );
+
+/**
+* accumulate the product of a coefficient and a row of samples
+* @param acc     the accumulated values
+* @param coef    the coefficient
+* @param src     the samples
+* @param n       number of values
+*/
+static void accumulateRow( float* acc, float coef, const float* src, size_t n );
+
+/**
+* write the filtered values of a tile to a v channel; samples whose mask
+* covers a NaN keep their value
+* @param job     pointer to the job
+* @param row     index of the output row within the range
+* @param u0      index of the first output sample within the tile
+* @param acc     the filtered values
+* @param n       number of values
+*/
+static void writeRow( CrgFilterJobStruct* job, size_t row, size_t u0, float* acc, size_t n );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataGridFilter( CrgDataStruct* crgData, double* gain )
+{
+    CrgFilterJobStruct job;
+    int    mode;
+    int    repeat = 1;
+    int    pass;
+    int    i;
+    int    j;
+    int    retCode = 0;
+    double weight  = 1.0;
+    double sumU    = 0.0;
+    double sumV    = 0.0;
+    double passGain;
+    size_t iuEnd;
+    size_t ivEnd;
+    size_t nvOut;
+    size_t k;
+
+    if ( gain )
+        *gain = 1.0;
+
+    if ( !crgData || !crgOptionGetInt( &( crgData->modifiers ), dCrgModFilterMode, &mode ) || mode == dCrgFilterNone )
+        return 0;
+
+    if ( crgData->gridStream.valid || crgData->gridQuant.valid || !crgData->channelZ )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: the grid cannot be filtered, it is not held as float values.\n" );
+        return 0;
+    }
+
+    memset( &job, 0, sizeof( job ) );
+
+    job.crgData = crgData;
+    job.sizeU   = 3;
+    job.sizeV   = 3;
+
+    crgOptionGetInt(    &( crgData->modifiers ), dCrgModFilterSizeU,  &( job.sizeU ) );
+    crgOptionGetInt(    &( crgData->modifiers ), dCrgModFilterSizeV,  &( job.sizeV ) );
+    crgOptionGetInt(    &( crgData->modifiers ), dCrgModFilterRepeat, &repeat );
+    crgOptionGetDouble( &( crgData->modifiers ), dCrgModFilterWeight, &weight );
+
+    if ( mode == dCrgFilterMask )
+    {
+        job.sizeU = crgData->gridFilter.sizeU;
+        job.sizeV = crgData->gridFilter.sizeV;
+
+        if ( !crgData->gridFilter.mask )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: no filter mask has been set.\n" );
+            return 0;
+        }
+    }
+
+    if ( job.sizeU < 1 || job.sizeV < 1 || repeat < 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: illegal mask size %d x %d or repetition %d.\n", job.sizeU, job.sizeV, repeat );
+        return 0;
+    }
+
+    if ( !crgDataGridGetRange( crgData, dCrgModFilterUBegin, dCrgModFilterUEnd, dCrgModFilterVBegin, dCrgModFilterVEnd,
+                               &( job.iuBeg ), &iuEnd, &( job.ivBeg ), &ivEnd ) )
+        return 0;
+
+    if ( iuEnd - job.iuBeg + 1 < ( size_t ) job.sizeU || ivEnd - job.ivBeg + 1 < ( size_t ) job.sizeV )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: range of %ld x %ld samples is smaller than the %d x %d mask.\n",
+                     ( long ) ( iuEnd - job.iuBeg + 1 ), ( long ) ( ivEnd - job.ivBeg + 1 ), job.sizeU, job.sizeV );
+        return 0;
+    }
+
+    job.nu = iuEnd - job.iuBeg + 1;
+    job.nv = ivEnd - job.ivBeg + 1;
+
+    /* --- the filtered sample is at position round( size / 2 ) of the mask, as in crg_filter.m --- */
+    job.offU   = ( job.sizeU + 1 ) / 2 - 1;
+    job.offV   = ( job.sizeV + 1 ) / 2 - 1;
+    job.weight = ( float ) weight;
+
+    job.maskU = ( float* ) crgCalloc( job.sizeU, sizeof( float ) );
+    job.maskV = ( float* ) crgCalloc( job.sizeV, sizeof( float ) );
+
+    if ( mode == dCrgFilterMask )
+        job.mask = ( float* ) crgCalloc( job.sizeU * job.sizeV, sizeof( float ) );
+
+    if ( !job.maskU || !job.maskV || ( mode == dCrgFilterMask && !job.mask ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: could not allocate filter mask.\n" );
+        goto cleanup;
+    }
+
+    /* --- the masks of crg_filter.m are separable; derivatives are added to the sample itself --- */
+    switch ( mode )
+    {
+        case dCrgFilterMean:
+            for ( i = 0; i < job.sizeU; i++ )
+                job.maskU[i] = 1.0f / job.sizeU;
+            for ( i = 0; i < job.sizeV; i++ )
+                job.maskV[i] = 1.0f / job.sizeV;
+            break;
+
+        case dCrgFilterGauss:
+            binomialMask( job.maskU, job.sizeU, 0 );
+            binomialMask( job.maskV, job.sizeV, 0 );
+            break;
+
+        case dCrgFilterSobel:
+        case dCrgFilter2Diff:
+        case dCrgFilterLaplace:
+            if ( !binomialMask( job.maskU, job.sizeU, ( mode == dCrgFilterSobel ) ? 1 : 2 ) ||
+                 !binomialMask( job.maskV, job.sizeV, ( mode == dCrgFilterLaplace ) ? 2 : 0 ) )
+            {
+                crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: mask size %d x %d is too small for filter mode %d.\n",
+                             job.sizeU, job.sizeV, mode );
+                goto cleanup;
+            }
+            job.identity = 1.0f;
+            break;
+
+        case dCrgFilterMask:
+            for ( j = 0; j < job.sizeV; j++ )
+                for ( i = 0; i < job.sizeU; i++ )
+                    job.mask[j * job.sizeU + i] = ( float ) crgData->gridFilter.mask[( job.sizeV - 1 - j ) * job.sizeU + job.sizeU - 1 - i];
+            break;
+
+        default:
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: unknown filter mode %d.\n", mode );
+            goto cleanup;
+    }
+
+    /* --- amplification of deviations of the samples by a single pass --- */
+    if ( job.mask )
+    {
+        for ( i = 0; i < job.sizeU * job.sizeV; i++ )
+            sumU += fabs( job.mask[i] );
+        passGain = fabs( weight ) * sumU;
+    }
+    else
+    {
+        for ( i = 0; i < job.sizeU; i++ )
+            sumU += fabs( job.maskU[i] );
+        for ( i = 0; i < job.sizeV; i++ )
+            sumV += fabs( job.maskV[i] );
+        passGain = fabs( weight ) * ( sumU * sumV + job.identity );
+    }
+
+    /* --- split the v channels into tasks, small grids are not worth additional threads --- */
+    nvOut       = job.nv - job.sizeV + 1;
+    job.noTasks = crgLoaderGetNoThreads();
+
+    if ( job.noTasks > dFilterMaxTasks )
+        job.noTasks = dFilterMaxTasks;
+
+    if ( ( size_t ) job.noTasks > nvOut / dFilterTaskMinRows )
+        job.noTasks = ( int ) ( nvOut / dFilterTaskMinRows );
+
+    if ( ( size_t ) job.noTasks > nvOut * job.nu / dFilterTaskMinSize )
+        job.noTasks = ( int ) ( nvOut * job.nu / dFilterTaskMinSize );
+
+    if ( job.noTasks < 1 )
+        job.noTasks = 1;
+
+    job.src    = ( float* )  crgCalloc( job.nu * job.nv, sizeof( float ) );
+    job.buffer = ( float** ) crgCalloc( job.noTasks, sizeof( float* ) );
+
+    if ( !job.src || !job.buffer )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: could not allocate work buffer.\n" );
+        goto cleanup;
+    }
+
+    /* --- a task holds the u filtered rows of a tile for a block of channels and the accumulated values --- */
+    for ( i = 0; i < job.noTasks; i++ )
+    {
+        if ( !( job.buffer[i] = ( float* ) crgCalloc( ( dFilterBlockV + job.sizeV + 1 ) * dFilterTileU, sizeof( float ) ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilter: could not allocate work buffer.\n" );
+            goto cleanup;
+        }
+    }
+
+    /* --- each pass filters the result of the previous one --- */
+    for ( pass = 0; pass < repeat; pass++ )
+    {
+        for ( k = 0; k < job.nv; k++ )
+            memcpy( job.src + k * job.nu, crgData->channelZ[job.ivBeg + k].data + job.iuBeg, job.nu * sizeof( float ) );
+
+        crgPortRunTasks( filterTask, &job, job.noTasks );
+
+        if ( gain )
+            *gain *= passGain;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataGridFilter: filter mode %d with %d x %d mask applied %d times to %ld x %ld samples, %d tasks.\n",
+                 mode, job.sizeU, job.sizeV, repeat, job.nu, job.nv, job.noTasks );
+
+    retCode = 1;
+
+cleanup:
+    if ( job.buffer )
+    {
+        for ( i = 0; i < job.noTasks; i++ )
+            if ( job.buffer[i] )
+                crgFree( job.buffer[i] );
+
+        crgFree( job.buffer );
+    }
+
+    if ( job.src )
+        crgFree( job.src );
+
+    if ( job.mask )
+        crgFree( job.mask );
+
+    if ( job.maskV )
+        crgFree( job.maskV );
+
+    if ( job.maskU )
+        crgFree( job.maskU );
+
+    return retCode;
+}
+
+int
+crgDataGridGetRange( CrgDataStruct* crgData, unsigned int uBeginId, unsigned int uEndId, unsigned int vBeginId, unsigned int vEndId,
+                     size_t* iuBeg, size_t* iuEnd, size_t* ivBeg, size_t* ivEnd )
+{
+    double uBegin;
+    double uEnd;
+    double vBegin;
+    double vEnd;
+    size_t k;
+
+    if ( !crgData || !crgData->channelZ || !crgData->channelV.data || crgData->channelU.info.size < 1 || crgData->channelV.info.size < 1 ||
+         !( crgData->channelU.info.inc > 0.0 ) )
+        return 0;
+
+    /* --- the range defaults to the complete grid --- */
+    uBegin = crgData->channelU.info.first;
+    uEnd   = crgData->channelU.info.last;
+    vBegin = crgData->channelV.data[0];
+    vEnd   = crgData->channelV.data[crgData->channelV.info.size - 1];
+
+    crgOptionGetDouble( &( crgData->modifiers ), uBeginId, &uBegin );
+    crgOptionGetDouble( &( crgData->modifiers ), uEndId,   &uEnd );
+    crgOptionGetDouble( &( crgData->modifiers ), vBeginId, &vBegin );
+    crgOptionGetDouble( &( crgData->modifiers ), vEndId,   &vEnd );
+
+    /* --- u is equidistant, v channels may be spaced irregularly --- */
+    *iuBeg = 0;
+    *iuEnd = crgData->channelU.info.size - 1;
+
+    if ( uBegin > crgData->channelU.info.first )
+        *iuBeg = ( size_t ) floor( ( uBegin - crgData->channelU.info.first ) / crgData->channelU.info.inc + 0.5 );
+
+    if ( uEnd < crgData->channelU.info.last )
+        *iuEnd = ( uEnd < crgData->channelU.info.first ) ? 0 : ( size_t ) floor( ( uEnd - crgData->channelU.info.first ) / crgData->channelU.info.inc + 0.5 );
+
+    if ( *iuEnd > crgData->channelU.info.size - 1 )
+        *iuEnd = crgData->channelU.info.size - 1;
+
+    *ivBeg = 0;
+    *ivEnd = 0;
+
+    for ( k = 0; k < crgData->channelV.info.size; k++ )
+    {
+        if ( fabs( crgData->channelV.data[k] - vBegin ) < fabs( crgData->channelV.data[*ivBeg] - vBegin ) )
+            *ivBeg = k;
+
+        if ( fabs( crgData->channelV.data[k] - vEnd ) < fabs( crgData->channelV.data[*ivEnd] - vEnd ) )
+            *ivEnd = k;
+    }
+
+    if ( *iuBeg > *iuEnd || *ivBeg > *ivEnd )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridGetRange: empty range [%.3f, %.3f] x [%.3f, %.3f].\n", uBegin, uEnd, vBegin, vEnd );
+        return 0;
+    }
+
+    for ( k = *ivBeg; k <= *ivEnd; k++ )
+    {
+        if ( !crgData->channelZ[k].data || crgData->channelZ[k].info.size < *iuEnd + 1 )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridGetRange: z channel %ld is not complete.\n", ( long ) k );
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int
+crgDataGridFilterSetMask( CrgDataStruct* crgData, const double* mask, int sizeU, int sizeV )
+{
+    double* copy;
+
+    if ( !crgData || !mask || sizeU < 1 || sizeV < 1 )
+        return 0;
+
+    if ( !( copy = ( double* ) crgCalloc( sizeU * sizeV, sizeof( double ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridFilterSetMask: could not allocate filter mask.\n" );
+        return 0;
+    }
+
+    memcpy( copy, mask, sizeU * sizeV * sizeof( double ) );
+
+    crgDataGridFilterRelease( crgData );
+
+    crgData->gridFilter.mask  = copy;
+    crgData->gridFilter.sizeU = sizeU;
+    crgData->gridFilter.sizeV = sizeV;
+
+    return 1;
+}
+
+void
+crgDataGridFilterRelease( CrgDataStruct* crgData )
+{
+    if ( !crgData )
+        return;
+
+    if ( crgData->gridFilter.mask )
+        crgFree( crgData->gridFilter.mask );
+
+    memset( &( crgData->gridFilter ), 0, sizeof( CrgGridFilterStruct ) );
+}
+
+static int
+binomialMask( float* mask, int n, int k )
+{
+    double coef[64];
+    int    m = 1;
+    int    i;
+    int    j;
+
+    if ( n < k + 1 || n > 64 )
+        return 0;
+
+    coef[0] = 1.0;
+
+    /* --- ( n - k - 1 ) convolutions with [1 1], k convolutions with [-1 1] --- */
+    for ( j = 0; j < n - 1; j++ )
+    {
+        coef[m] = coef[m-1];
+
+        for ( i = m - 1; i > 0; i-- )
+            coef[i] = ( j < n - k - 1 ) ? coef[i-1] + coef[i] : coef[i-1] - coef[i];
+
+        if ( j >= n - k - 1 )
+            coef[0] = -coef[0];
+
+        m++;
+    }
+
+    /* --- normalized with 2^-( n - k - 1 ) and mirrored --- */
+    for ( i = 0; i < n; i++ )
+        mask[i] = ( float ) ( ldexp( coef[n - 1 - i], -( n - k - 1 ) ) );
+
+    return 1;
+}
+
+static void
+filterTask( void* data, int taskId )
+{
+    CrgFilterJobStruct* job = ( CrgFilterJobStruct* ) data;
+    size_t nvOut  = job->nv - job->sizeV + 1;
+    size_t nuOut  = job->nu - job->sizeU + 1;
+    size_t rowBeg = nvOut * taskId / job->noTasks;
+    size_t rowEnd = nvOut * ( taskId + 1 ) / job->noTasks;
+    size_t blockBeg;
+    size_t blockEnd;
+    size_t u0;
+    size_t n;
+    size_t row;
+    float* tmp    = job->buffer[taskId];
+    float* acc    = tmp + ( dFilterBlockV + job->sizeV ) * dFilterTileU;
+    int    i;
+    int    j;
+
+    /* --- cache blocking: the u filtered rows of a block stay in the buffer while the v mask is applied --- */
+    for ( blockBeg = rowBeg; blockBeg < rowEnd; blockBeg = blockEnd )
+    {
+        blockEnd = blockBeg + dFilterBlockV;
+
+        if ( blockEnd > rowEnd )
+            blockEnd = rowEnd;
+
+        for ( u0 = 0; u0 < nuOut; u0 += dFilterTileU )
+        {
+            n = nuOut - u0;
+
+            if ( n > dFilterTileU )
+                n = dFilterTileU;
+
+            if ( job->mask )
+            {
+                for ( row = blockBeg; row < blockEnd; row++ )
+                {
+                    memset( acc, 0, n * sizeof( float ) );
+
+                    for ( j = 0; j < job->sizeV; j++ )
+                        for ( i = 0; i < job->sizeU; i++ )
+                            accumulateRow( acc, job->mask[j * job->sizeU + i], job->src + ( row + j ) * job->nu + u0 + i, n );
+
+                    writeRow( job, row, u0, acc, n );
+                }
+                continue;
+            }
+
+            /* --- u direction, for all rows covered by the v mask --- */
+            for ( row = blockBeg; row < blockEnd + job->sizeV - 1; row++ )
+            {
+                float* dst = tmp + ( row - blockBeg ) * dFilterTileU;
+
+                memset( dst, 0, n * sizeof( float ) );
+
+                for ( i = 0; i < job->sizeU; i++ )
+                    accumulateRow( dst, job->maskU[i], job->src + row * job->nu + u0 + i, n );
+            }
+
+            /* --- v direction --- */
+            for ( row = blockBeg; row < blockEnd; row++ )
+            {
+                memset( acc, 0, n * sizeof( float ) );
+
+                for ( j = 0; j < job->sizeV; j++ )
+                    accumulateRow( acc, job->maskV[j], tmp + ( row - blockBeg + j ) * dFilterTileU, n );
+
+                if ( job->identity != 0.0f )
+                    accumulateRow( acc, job->identity, job->src + ( row + job->offV ) * job->nu + u0 + job->offU, n );
+
+                writeRow( job, row, u0, acc, n );
+            }
+        }
+    }
+}
+
+static void
+accumulateRow( float* acc, float coef, const float* src, size_t n )
+{
+    size_t i;
+
+    /* --- simple enough for the compiler to vectorize --- */
+    for ( i = 0; i < n; i++ )
+        acc[i] += coef * src[i];
+}
+
+static void
+writeRow( CrgFilterJobStruct* job, size_t row, size_t u0, float* acc, size_t n )
+{
+    float* dst = job->crgData->channelZ[job->ivBeg + row + job->offV].data + job->iuBeg + u0 + job->offU;
+    size_t i;
+
+    for ( i = 0; i < n; i++ )
+        acc[i] *= job->weight;
+
+    /* --- NaN is the only value not equal to itself --- */
+    for ( i = 0; i < n; i++ )
+        if ( acc[i] == acc[i] )
+            dst[i] = acc[i];
+}
@@ -0,0 +1,663 @@
+/* ===================================================
+ *  file:       crgGridPeak.c
+ * ---------------------------------------------------
+ *  purpose:	detect and limit peaks of the elevation grid,
+ *              C port of crg_peakfinder.m and crg_limiter.m
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include <math.h>
+#include <string.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dPeakTileU          1024    /* number of u samples scanned as one tile                 */
+#define dPeakMaxTasks       64      /* maximum number of tasks scanning a grid                 */
+#define dPeakTaskMinRows    8       /* minimum number of v channels scanned by a task          */
+#define dPeakTaskMinSize    65536   /* minimum number of samples scanned by a task             */
+#define dPeakMinMedian      0.05f   /* lower bound of the median of a window, see crg_peakfinder.m  [m] */
+#define dPeakDefaultRadius  3       /* default radius of the window, see crg_peakfinder.m     */
+
+#define dPeakPhaseDetect    0       /* find the candidates by the laplacian                    */
+#define dPeakPhaseMark      1       /* mark the peaks within the windows of the candidates     */
+#define dPeakPhaseLimit     2       /* limit the samples of the grid                           */
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* a scan over a range of the grid, split into tasks of adjacent v channels
+*/
+typedef struct
+{
+    CrgDataStruct*  crgData;
+    size_t          iuBeg;      /* index of the first sample of the range in u direction        [-] */
+    size_t          ivBeg;      /* index of the first v channel of the range                    [-] */
+    size_t          nu;         /* number of samples of the range in u direction                [-] */
+    size_t          nv;         /* number of v channels of the range                            [-] */
+    double          threshold;  /* threshold of the laplacian of the absolute values            [-] */
+    size_t          radius;     /* radius of the window around a candidate                      [-] */
+    size_t          winU;       /* size of the window in u direction, at most the range         [-] */
+    size_t          winV;       /* size of the window in v direction, at most the range         [-] */
+    unsigned char*  cand;       /* nv rows of nu flags of the candidates                        [-] */
+    float*          limit;      /* nv rows of nu limits of the absolute values, 0 if no peak    [m] */
+    int             useZMin;    /* lower limit of the values is applied                       [0/1] */
+    int             useZMax;    /* upper limit of the values is applied                       [0/1] */
+    float           zMin;       /* lower limit of the values                                    [m] */
+    float           zMax;       /* upper limit of the values                                    [m] */
+    int             phase;      /* phase of the scan, see dPeakPhaseXXX                         [-] */
+    int             noTasks;    /* number of tasks                                              [-] */
+    double**        sum;        /* column sums of a tile of each task                           [m] */
+    float**         window;     /* samples of a window of each task                             [m] */
+    size_t*         count;      /* candidates or limited samples of each task                   [-] */
+    size_t*         noPeaks;    /* peaks of each task                                           [-] */
+} CrgPeakJobStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* set up a scan of the range given by the modifiers dCrgModLimitXXX
+* @param job        pointer to the job
+* @param crgData    pointer to the data set
+* @param threshold  threshold of the laplacian of the absolute values
+* @param radius     radius of the window around a candidate
+* @return 1 if successful, otherwise 0
+*/
+static int setupJob( CrgPeakJobStruct* job, CrgDataStruct* crgData, double threshold, int radius );
+
+/**
+* release the buffers of a job
+* @param job        pointer to the job
+*/
+static void releaseJob( CrgPeakJobStruct* job );
+
+/**
+* detect the peaks of the range, the result is job->limit
+* @param job        pointer to the job
+* @return 1 if successful, otherwise 0
+*/
+static int detectPeaks( CrgPeakJobStruct* job );
+
+/**
+* run the current phase for the v channels of a single task
+* @param data       pointer to the job
+* @param taskId     index of the task
+*/
+static void peakTask( void* data, int taskId );
+
+/**
+* flag the candidates of a v channel whose laplacian of the absolute values
+* exceeds the threshold, see crg_peakfinder_laplacian() of crg_peakfinder.m
+* @param job        pointer to the job
+* @param row        index of the v channel within the range, 1 <= row < nv - 1
+* @param sum        work buffer of dPeakTileU + 2 values
+* @return number of candidates
+*/
+static size_t detectRow( CrgPeakJobStruct* job, size_t row, double* sum );
+
+/**
+* mark the peaks in the window of a candidate within the v channels of a task,
+* see crg_peakfinder_peak() of crg_peakfinder.m
+* @param job        pointer to the job
+* @param u0         index of the first sample of the window in u direction
+* @param v0         index of the first v channel of the window
+* @param rowBeg     index of the first v channel of the task
+* @param rowEnd     index behind the last v channel of the task
+* @param window     work buffer of winU * winV values
+*/
+static void markWindow( CrgPeakJobStruct* job, size_t u0, size_t v0, size_t rowBeg, size_t rowEnd, float* window );
+
+/**
+* get the start of the window around a candidate, the window is kept within the range
+* @param c          index of the candidate
+* @param radius     radius of the window
+* @param n          size of the range
+* @param w          size of the window
+* @return index of the first sample of the window
+*/
+static size_t windowStart( size_t c, size_t radius, size_t n, size_t w );
+
+/**
+* get the median of a number of values, the values are re-ordered
+* @param x          the values
+* @param n          number of values
+* @return the median
+*/
+static float medianOf( float* x, size_t n );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataGridLimit( CrgDataStruct* crgData )
+{
+    CrgPeakJobStruct job;
+    int    usePeak;
+    int    radius    = dPeakDefaultRadius;
+    int    retCode   = 0;
+    int    i;
+    double threshold = 0.0;
+    double zMin      = 0.0;
+    double zMax      = 0.0;
+    size_t noLimited = 0;
+    size_t noPeaks   = 0;
+
+    if ( !crgData )
+        return 0;
+
+    usePeak = crgOptionGetDouble( &( crgData->modifiers ), dCrgModPeakLimit, &threshold );
+    crgOptionGetInt( &( crgData->modifiers ), dCrgModPeakRadius, &radius );
+
+    memset( &job, 0, sizeof( job ) );
+
+    job.useZMin = crgOptionGetDouble( &( crgData->modifiers ), dCrgModLimitZMin, &zMin );
+    job.useZMax = crgOptionGetDouble( &( crgData->modifiers ), dCrgModLimitZMax, &zMax );
+
+    if ( !usePeak && !job.useZMin && !job.useZMax )
+        return 0;
+
+    if ( !setupJob( &job, crgData, threshold, radius ) )
+        return 0;
+
+    job.zMin = ( float ) zMin;
+    job.zMax = ( float ) zMax;
+
+    if ( usePeak && !detectPeaks( &job ) )
+        goto cleanup;
+
+    /* --- the samples are limited only after all windows have been evaluated --- */
+    job.phase = dPeakPhaseLimit;
+    crgPortRunTasks( peakTask, &job, job.noTasks );
+
+    for ( i = 0; i < job.noTasks; i++ )
+    {
+        noLimited += job.count[i];
+        noPeaks   += job.noPeaks[i];
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataGridLimit: %ld of %ld x %ld samples limited, %ld peaks detected, %d tasks.\n",
+                 ( long ) noLimited, ( long ) job.nu, ( long ) job.nv, ( long ) noPeaks, job.noTasks );
+
+    retCode = 1;
+
+cleanup:
+    releaseJob( &job );
+
+    return retCode;
+}
+
+int
+crgDataGridGetPeaks( CrgDataStruct* crgData, double threshold, int radius, double* u, double* v, double* z, int maxPeaks )
+{
+    CrgPeakJobStruct job;
+    unsigned char* column;
+    const float*   lim;
+    size_t i;
+    size_t j;
+    int    noPeaks = 0;
+
+    if ( !crgData )
+        return -1;
+
+    memset( &job, 0, sizeof( job ) );
+
+    if ( !setupJob( &job, crgData, threshold, radius ) )
+        return -1;
+
+    if ( !detectPeaks( &job ) || !( column = ( unsigned char* ) crgCalloc( job.nu, sizeof( unsigned char ) ) ) )
+    {
+        releaseJob( &job );
+        return -1;
+    }
+
+    /* --- the peaks are reported in the order of crg_peakfinder.m, i.e. by u and then by v --- */
+    for ( j = 0; j < job.nv; j++ )
+    {
+        lim = job.limit + j * job.nu;
+
+        for ( i = 0; i < job.nu; i++ )
+            column[i] |= ( lim[i] > 0.0f );
+    }
+
+    for ( i = 0; i < job.nu; i++ )
+    {
+        if ( !column[i] )
+            continue;
+
+        for ( j = 0; j < job.nv; j++ )
+        {
+            if ( !( job.limit[j * job.nu + i] > 0.0f ) )
+                continue;
+
+            if ( noPeaks < maxPeaks )
+            {
+                if ( u )
+                    u[noPeaks] = crgData->channelU.info.first + ( job.iuBeg + i ) * crgData->channelU.info.inc;
+                if ( v )
+                    v[noPeaks] = crgData->channelV.data[job.ivBeg + j];
+                if ( z )
+                    z[noPeaks] = crgData->channelZ[job.ivBeg + j].data[job.iuBeg + i];
+            }
+            noPeaks++;
+        }
+    }
+
+    crgFree( column );
+    releaseJob( &job );
+
+    return noPeaks;
+}
+
+static int
+setupJob( CrgPeakJobStruct* job, CrgDataStruct* crgData, double threshold, int radius )
+{
+    size_t iuEnd;
+    size_t ivEnd;
+    int    i;
+
+    if ( crgData->gridStream.valid || crgData->gridQuant.valid || !crgData->channelZ )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridLimit: the grid cannot be scanned, it is not held as float values.\n" );
+        return 0;
+    }
+
+    if ( radius < 1 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridLimit: illegal peak radius %d.\n", radius );
+        return 0;
+    }
+
+    if ( !crgDataGridGetRange( crgData, dCrgModLimitUBegin, dCrgModLimitUEnd, dCrgModLimitVBegin, dCrgModLimitVEnd,
+                               &( job->iuBeg ), &iuEnd, &( job->ivBeg ), &ivEnd ) )
+        return 0;
+
+    job->crgData   = crgData;
+    job->nu        = iuEnd - job->iuBeg + 1;
+    job->nv        = ivEnd - job->ivBeg + 1;
+    job->threshold = threshold;
+    job->radius    = ( size_t ) radius;
+    job->winU      = ( 2 * job->radius + 1 < job->nu ) ? 2 * job->radius + 1 : job->nu;
+    job->winV      = ( 2 * job->radius + 1 < job->nv ) ? 2 * job->radius + 1 : job->nv;
+
+    /* --- split the v channels into tasks, small grids are not worth additional threads --- */
+    job->noTasks = crgLoaderGetNoThreads();
+
+    if ( job->noTasks > dPeakMaxTasks )
+        job->noTasks = dPeakMaxTasks;
+
+    if ( ( size_t ) job->noTasks > job->nv / dPeakTaskMinRows )
+        job->noTasks = ( int ) ( job->nv / dPeakTaskMinRows );
+
+    if ( ( size_t ) job->noTasks > job->nv * job->nu / dPeakTaskMinSize )
+        job->noTasks = ( int ) ( job->nv * job->nu / dPeakTaskMinSize );
+
+    if ( job->noTasks < 1 )
+        job->noTasks = 1;
+
+    job->sum     = ( double** ) crgCalloc( job->noTasks, sizeof( double* ) );
+    job->window  = ( float** )  crgCalloc( job->noTasks, sizeof( float* ) );
+    job->count   = ( size_t* )  crgCalloc( job->noTasks, sizeof( size_t ) );
+    job->noPeaks = ( size_t* )  crgCalloc( job->noTasks, sizeof( size_t ) );
+
+    if ( !job->sum || !job->window || !job->count || !job->noPeaks )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridLimit: could not allocate work buffer.\n" );
+        releaseJob( job );
+        return 0;
+    }
+
+    for ( i = 0; i < job->noTasks; i++ )
+    {
+        job->sum[i]    = ( double* ) crgCalloc( dPeakTileU + 2, sizeof( double ) );
+        job->window[i] = ( float* )  crgCalloc( job->winU * job->winV, sizeof( float ) );
+
+        if ( !job->sum[i] || !job->window[i] )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridLimit: could not allocate work buffer.\n" );
+            releaseJob( job );
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static void
+releaseJob( CrgPeakJobStruct* job )
+{
+    int i;
+
+    for ( i = 0; i < job->noTasks; i++ )
+    {
+        if ( job->sum && job->sum[i] )
+            crgFree( job->sum[i] );
+
+        if ( job->window && job->window[i] )
+            crgFree( job->window[i] );
+    }
+
+    if ( job->sum )
+        crgFree( job->sum );
+
+    if ( job->window )
+        crgFree( job->window );
+
+    if ( job->count )
+        crgFree( job->count );
+
+    if ( job->noPeaks )
+        crgFree( job->noPeaks );
+
+    if ( job->cand )
+        crgFree( job->cand );
+
+    if ( job->limit )
+        crgFree( job->limit );
+
+    job->sum     = NULL;
+    job->window  = NULL;
+    job->count   = NULL;
+    job->noPeaks = NULL;
+    job->cand    = NULL;
+    job->limit   = NULL;
+}
+
+static int
+detectPeaks( CrgPeakJobStruct* job )
+{
+    int    i;
+    size_t noCand = 0;
+
+    job->cand  = ( unsigned char* ) crgCalloc( job->nu * job->nv, sizeof( unsigned char ) );
+    job->limit = ( float* )         crgCalloc( job->nu * job->nv, sizeof( float ) );
+
+    if ( !job->cand || !job->limit )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridLimit: could not allocate peak buffer.\n" );
+        return 0;
+    }
+
+    /* --- the windows of the candidates reach into the v channels of neighbouring tasks --- */
+    job->phase = dPeakPhaseDetect;
+    crgPortRunTasks( peakTask, job, job->noTasks );
+
+    for ( i = 0; i < job->noTasks; i++ )
+        noCand += job->count[i];
+
+    if ( noCand )
+    {
+        job->phase = dPeakPhaseMark;
+        crgPortRunTasks( peakTask, job, job->noTasks );
+    }
+
+    return 1;
+}
+
+static void
+peakTask( void* data, int taskId )
+{
+    CrgPeakJobStruct* job = ( CrgPeakJobStruct* ) data;
+    const unsigned char* cand;
+    const unsigned char* next;
+    const float* lim;
+    float*  z;
+    float   x;
+    float   l;
+    size_t  rowBeg = job->nv * taskId / job->noTasks;
+    size_t  rowEnd = job->nv * ( taskId + 1 ) / job->noTasks;
+    size_t  count  = 0;
+    size_t  peaks  = 0;
+    size_t  i;
+    size_t  j;
+    size_t  v0;
+
+    switch ( job->phase )
+    {
+        case dPeakPhaseDetect:
+            /* --- the outermost samples of the range are no candidates, as in crg_peakfinder.m --- */
+            for ( j = ( rowBeg > 1 ) ? rowBeg : 1; j < rowEnd && j + 1 < job->nv; j++ )
+                count += detectRow( job, j, job->sum[taskId] );
+            break;
+
+        case dPeakPhaseMark:
+            j = ( rowBeg > job->radius + job->winV ) ? rowBeg - job->radius - job->winV : 0;
+
+            for ( ; j < job->nv; j++ )
+            {
+                v0 = windowStart( j, job->radius, job->nv, job->winV );
+
+                if ( v0 >= rowEnd )
+                    break;
+
+                if ( v0 + job->winV <= rowBeg )
+                    continue;
+
+                cand = job->cand + j * job->nu;
+
+                for ( i = 0; i < job->nu; i = next - cand + 1 )
+                {
+                    if ( !( next = ( const unsigned char* ) memchr( cand + i, 1, job->nu - i ) ) )
+                        break;
+
+                    markWindow( job, windowStart( next - cand, job->radius, job->nu, job->winU ), v0, rowBeg, rowEnd, job->window[taskId] );
+                }
+            }
+            break;
+
+        case dPeakPhaseLimit:
+            for ( j = rowBeg; j < rowEnd; j++ )
+            {
+                z = job->crgData->channelZ[job->ivBeg + j].data + job->iuBeg;
+
+                if ( job->limit )
+                {
+                    lim = job->limit + j * job->nu;
+
+                    for ( i = 0; i < job->nu; i++ )
+                    {
+                        x = z[i];
+                        l = lim[i];
+
+                        peaks += ( l > 0.0f );
+                        count += ( l > 0.0f && ( x > l || x < -l ) );
+                        x      = ( l > 0.0f && x > l ) ? l : x;
+                        z[i]   = ( l > 0.0f && x < -l ) ? -l : x;
+                    }
+                }
+
+                if ( job->useZMin )
+                {
+                    for ( i = 0; i < job->nu; i++ )
+                    {
+                        x = z[i];
+                        count += ( x < job->zMin );
+                        z[i] = ( x < job->zMin ) ? job->zMin : x;
+                    }
+                }
+
+                if ( job->useZMax )
+                {
+                    for ( i = 0; i < job->nu; i++ )
+                    {
+                        x = z[i];
+                        count += ( x > job->zMax );
+                        z[i] = ( x > job->zMax ) ? job->zMax : x;
+                    }
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    job->count[taskId]   = count;
+    job->noPeaks[taskId] = peaks;
+}
+
+static size_t
+detectRow( CrgPeakJobStruct* job, size_t row, double* sum )
+{
+    const float*   a = job->crgData->channelZ[job->ivBeg + row - 1].data + job->iuBeg;
+    const float*   b = job->crgData->channelZ[job->ivBeg + row].data + job->iuBeg;
+    const float*   c = job->crgData->channelZ[job->ivBeg + row + 1].data + job->iuBeg;
+    unsigned char* cand = job->cand + row * job->nu;
+    size_t noCand = 0;
+    size_t t0;
+    size_t n;
+    size_t i;
+
+    /* --- the mask 10 * [ -1 -1 -1; -1 8 -1; -1 -1 -1 ] is 10 * ( 9 * center - sum of the 3 x 3 samples ) --- */
+    for ( t0 = 1; t0 + 1 < job->nu; t0 += n )
+    {
+        n = job->nu - 1 - t0;
+
+        if ( n > dPeakTileU )
+            n = dPeakTileU;
+
+        for ( i = 0; i < n + 2; i++ )
+            sum[i] = fabs( a[t0 - 1 + i] ) + fabs( b[t0 - 1 + i] ) + fabs( c[t0 - 1 + i] );
+
+        /* --- NaNs fail the comparison and are no candidates --- */
+        for ( i = 0; i < n; i++ )
+            cand[t0 + i] = ( unsigned char ) ( 10.0 * ( 9.0 * fabs( b[t0 + i] ) - sum[i] - sum[i + 1] - sum[i + 2] ) > job->threshold );
+
+        for ( i = 0; i < n; i++ )
+            noCand += cand[t0 + i];
+    }
+
+    return noCand;
+}
+
+static void
+markWindow( CrgPeakJobStruct* job, size_t u0, size_t v0, size_t rowBeg, size_t rowEnd, float* window )
+{
+    const float* z;
+    float*  lim;
+    float   mv;
+    float   bound;
+    float   x;
+    size_t  n       = 0;
+    size_t  noSmall = 0;
+    size_t  i;
+    size_t  j;
+    int     hasNaN  = 0;
+
+    for ( j = v0; j < v0 + job->winV; j++ )
+    {
+        z = job->crgData->channelZ[job->ivBeg + j].data + job->iuBeg + u0;
+
+        for ( i = 0; i < job->winU; i++ )
+        {
+            x = z[i];
+            window[n++] = x;
+            noSmall += ( x <= dPeakMinMedian );
+            hasNaN  |= ( x != x );
+        }
+    }
+
+    /* --- the median is bounded below, a window holding a NaN has no median --- */
+    if ( hasNaN || noSmall > n / 2 )
+        mv = dPeakMinMedian;
+    else
+    {
+        mv = medianOf( window, n );
+
+        if ( mv < dPeakMinMedian )
+            mv = dPeakMinMedian;
+    }
+
+    bound = mv + mv;
+
+    /* --- a sample covered by several windows keeps the tightest limit --- */
+    for ( j = ( v0 > rowBeg ) ? v0 : rowBeg; j < v0 + job->winV && j < rowEnd; j++ )
+    {
+        z   = job->crgData->channelZ[job->ivBeg + j].data + job->iuBeg + u0;
+        lim = job->limit + j * job->nu + u0;
+
+        for ( i = 0; i < job->winU; i++ )
+        {
+            if ( ( z[i] > bound || z[i] < -bound ) && ( lim[i] == 0.0f || bound < lim[i] ) )
+                lim[i] = bound;
+        }
+    }
+}
+
+static size_t
+windowStart( size_t c, size_t radius, size_t n, size_t w )
+{
+    size_t start = ( c > radius ) ? c - radius : 0;
+
+    /* --- crg_peakfinder.m stops one sample short of the end of the range, the window here reaches it --- */
+    if ( start > n - w )
+        start = n - w;
+
+    return start;
+}
+
+static float
+medianOf( float* x, size_t n )
+{
+    long  k  = ( long ) ( n / 2 );
+    long  lo = 0;
+    long  hi = ( long ) n - 1;
+    long  i;
+    long  j;
+    float pivot;
+    float tmp;
+    float below;
+
+    /* --- partition around the k-th value (quickselect) --- */
+    while ( lo < hi )
+    {
+        pivot = x[( lo + hi ) / 2];
+        i     = lo;
+        j     = hi;
+
+        while ( i <= j )
+        {
+            while ( x[i] < pivot )
+                i++;
+            while ( x[j] > pivot )
+                j--;
+
+            if ( i <= j )
+            {
+                tmp  = x[i];
+                x[i] = x[j];
+                x[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+
+        if ( k <= j )
+            hi = j;
+        else if ( k >= i )
+            lo = i;
+        else
+            break;
+    }
+
+    if ( n % 2 )
+        return x[k];
+
+    /* --- an even number of values averages the two middle ones --- */
+    below = x[0];
+
+    for ( i = 1; i < k; i++ )
+        if ( x[i] > below )
+            below = x[i];
+
+    return 0.5f * ( below + x[k] );
+}
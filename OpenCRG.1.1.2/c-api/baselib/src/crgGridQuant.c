@@ -0,0 +1,279 @@
+/* ===================================================
+ *  file:       crgGridQuant.c
+ * ---------------------------------------------------
+ *  purpose:	store the elevation grid as 16 bit
+ *              integers with an offset and a scale
+ *              per block of cells
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+
+/* ====== TYPE DEFINITIONS ====== */
+
+/* ====== LOCAL METHODS ====== */
+/**
+* quantize the samples of a single block
+* @param crgData    pointer to the data set holding the float z channels
+* @param bu         index of the block in u direction
+* @param bv         index of the block in v direction
+* @return maximum deviation of a dequantized sample from its float value
+*/
+static double quantizeBlock( CrgDataStruct* crgData, size_t bu, size_t bv );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataGridQuantize( CrgDataStruct* crgData, double maxError )
+{
+    CrgGridQuantStruct* quant;
+    size_t noBlocks;
+    size_t bu;
+    size_t bv;
+    size_t i;
+    double error;
+    double blockError;
+
+    if ( !crgData || !crgData->channelZ || !( maxError > 0.0 ) )
+        return 0;
+
+    quant = &( crgData->gridQuant );
+
+    if ( quant->valid )
+        return 1;
+
+    /* --- the channels of a snapshot are shared with the snapshot buffer, a streamed grid has none --- */
+    if ( crgData->admin.snapshotBuffer || crgData->gridStream.valid || crgData->channelU.info.size < 2 || crgData->channelV.info.size < 2 )
+        return 0;
+
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    {
+        if ( !crgData->channelZ[i].data || crgData->channelZ[i].info.size != crgData->channelU.info.size )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridQuantize: z channel %ld is not complete, keeping float grid.\n", i );
+            return 0;
+        }
+    }
+
+    quant->sizeU     = crgData->channelU.info.size;
+    quant->noBlocksU = ( crgData->channelU.info.size + dCrgQuantBlockSize - 1 ) >> dCrgQuantBlockBits;
+    quant->noBlocksV = ( crgData->channelV.info.size + dCrgQuantBlockSize - 1 ) >> dCrgQuantBlockBits;
+    noBlocks         = quant->noBlocksU * quant->noBlocksV;
+
+    quant->data   = ( short* )  crgCalloc( crgData->channelV.info.size * quant->sizeU, sizeof( short ) );
+    quant->offset = ( double* ) crgCalloc( noBlocks, sizeof( double ) );
+    quant->scale  = ( double* ) crgCalloc( noBlocks, sizeof( double ) );
+
+    if ( !quant->data || !quant->offset || !quant->scale )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridQuantize: could not allocate quantized grid, keeping float grid.\n" );
+        crgDataGridReleaseQuant( crgData );
+        return 0;
+    }
+
+    error = 0.0;
+
+    for ( bv = 0; bv < quant->noBlocksV; bv++ )
+    {
+        for ( bu = 0; bu < quant->noBlocksU; bu++ )
+        {
+            if ( ( blockError = quantizeBlock( crgData, bu, bv ) ) > error )
+                error = blockError;
+        }
+    }
+
+    /* --- the bound is guaranteed, so a grid exceeding it keeps its float values --- */
+    if ( error > maxError )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridQuantize: maximum error %.3e m exceeds bound %.3e m, keeping float grid.\n",
+                     error, maxError );
+        crgDataGridReleaseQuant( crgData );
+        return 0;
+    }
+
+    quant->valid      = 1;
+    quant->errorBound = maxError;
+    quant->maxError   = error;
+
+    crgLoaderReleaseGrid( crgData );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataGridQuantize: %ld x %ld samples in %ld blocks, maximum error = %.3e m\n",
+                 quant->sizeU, crgData->channelV.info.size, noBlocks, error );
+
+    return 1;
+}
+
+int
+crgDataGridExpand( CrgDataStruct* crgData )
+{
+    CrgGridQuantStruct* quant;
+    size_t block;
+    size_t i;
+    size_t j;
+    short  q;
+    double zAbsMax = 0.0;
+
+    if ( !crgData || !crgData->gridQuant.valid )
+        return 1;
+
+    quant = &( crgData->gridQuant );
+
+    if ( !crgLoaderAllocateGrid( crgData ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridExpand: could not allocate float grid.\n" );
+        crgLoaderReleaseGrid( crgData );
+        return 0;
+    }
+
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    {
+        for ( j = 0; j < quant->sizeU; j++ )
+        {
+            block = ( i >> dCrgQuantBlockBits ) * quant->noBlocksU + ( j >> dCrgQuantBlockBits );
+            q     = quant->data[i * quant->sizeU + j];
+
+            if ( q == dCrgQuantNaN )
+                crgSetNanf( &( crgData->channelZ[i].data[j] ) );
+            else
+            {
+                crgData->channelZ[i].data[j] = ( float ) ( quant->offset[block] + quant->scale[block] * q );
+
+                if ( fabs( crgData->channelZ[i].data[j] ) > zAbsMax )
+                    zAbsMax = fabs( crgData->channelZ[i].data[j] );
+            }
+        }
+    }
+
+    /* --- keep the error information, the data is re-quantized after modification; the float --- */
+    /* --- values are rounded by the expansion and may round differently during modification  --- */
+    quant->maxError += FLT_EPSILON * zAbsMax;
+
+    crgFree( quant->data );
+    crgFree( quant->offset );
+    crgFree( quant->scale );
+
+    quant->data   = NULL;
+    quant->offset = NULL;
+    quant->scale  = NULL;
+    quant->valid  = 0;
+
+    return 1;
+}
+
+void
+crgDataGridReleaseQuant( CrgDataStruct* crgData )
+{
+    if ( !crgData )
+        return;
+
+    if ( crgData->gridQuant.data )
+        crgFree( crgData->gridQuant.data );
+
+    if ( crgData->gridQuant.offset )
+        crgFree( crgData->gridQuant.offset );
+
+    if ( crgData->gridQuant.scale )
+        crgFree( crgData->gridQuant.scale );
+
+    memset( &( crgData->gridQuant ), 0, sizeof( CrgGridQuantStruct ) );
+}
+
+static double
+quantizeBlock( CrgDataStruct* crgData, size_t bu, size_t bv )
+{
+    CrgGridQuantStruct* quant = &( crgData->gridQuant );
+    size_t block  = bv * quant->noBlocksU + bu;
+    size_t uBeg   = bu << dCrgQuantBlockBits;
+    size_t vBeg   = bv << dCrgQuantBlockBits;
+    size_t uEnd   = uBeg + dCrgQuantBlockSize;
+    size_t vEnd   = vBeg + dCrgQuantBlockSize;
+    size_t i;
+    size_t j;
+    int    noValues = 0;
+    double zMin     = 0.0;
+    double zMax     = 0.0;
+    double value;
+    double error    = 0.0;
+    float* row;
+    short* q;
+
+    if ( uEnd > quant->sizeU )
+        uEnd = quant->sizeU;
+
+    if ( vEnd > crgData->channelV.info.size )
+        vEnd = crgData->channelV.info.size;
+
+    /* --- range of the samples --- */
+    for ( i = vBeg; i < vEnd; i++ )
+    {
+        row = crgData->channelZ[i].data;
+
+        for ( j = uBeg; j < uEnd; j++ )
+        {
+            if ( crgIsNanf( &( row[j] ) ) )
+                continue;
+
+            if ( !noValues || row[j] < zMin )
+                zMin = row[j];
+
+            if ( !noValues || row[j] > zMax )
+                zMax = row[j];
+
+            noValues++;
+        }
+    }
+
+    quant->offset[block] = 0.5 * ( zMin + zMax );
+    quant->scale[block]  = ( zMax - zMin ) / ( 2.0 * dCrgQuantMax );
+
+    for ( i = vBeg; i < vEnd; i++ )
+    {
+        row = crgData->channelZ[i].data;
+        q   = quant->data + i * quant->sizeU;
+
+        for ( j = uBeg; j < uEnd; j++ )
+        {
+            if ( crgIsNanf( &( row[j] ) ) )
+            {
+                q[j] = dCrgQuantNaN;
+                continue;
+            }
+
+            value = quant->scale[block] > 0.0 ? floor( ( row[j] - quant->offset[block] ) / quant->scale[block] + 0.5 ) : 0.0;
+
+            if ( value > dCrgQuantMax )
+                value = dCrgQuantMax;
+            else if ( value < -dCrgQuantMax )
+                value = -dCrgQuantMax;
+
+            q[j] = ( short ) value;
+
+            /* --- the error is measured with the arithmetic of the evaluation --- */
+            value = fabs( quant->offset[block] + quant->scale[block] * q[j] - row[j] );
+
+            if ( value > error )
+                error = value;
+        }
+    }
+
+    return error;
+}
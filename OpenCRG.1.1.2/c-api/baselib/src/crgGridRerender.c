@@ -0,0 +1,565 @@
+/* ===================================================
+ *  file:       crgGridRerender.c
+ * ---------------------------------------------------
+ *  purpose:	re-render a data set with different u and v
+ *              increments, C port of crg_rerender.m
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include <math.h>
+#include <string.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dRerenderMaxTasks       64      /* maximum number of tasks filling the grid                */
+#define dRerenderTaskMinCols    8       /* minimum number of cross sections filled by a task       */
+#define dRerenderTaskMinSize    65536   /* minimum number of samples filled by a task              */
+#define dRerenderMinSpacing     1.e-6   /* minimum spacing of v positions, see crgLoader.c      [m] */
+#define dRerenderSizeTol        1.e-6   /* tolerance of the last position of a regular axis     [-] */
+
+/* a node of the source which is hit exactly takes its value, regardless of a NaN in the next section */
+#define dRerenderCorners( c, fu, fv )   \
+    if ( fu == 0.0 )                    \
+    {                                   \
+        c[1] = c[0];                    \
+        c[3] = c[2];                    \
+    }                                   \
+    if ( fv == 0.0 )                    \
+    {                                   \
+        c[2] = c[0];                    \
+        c[3] = c[1];                    \
+    }
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* the source positions of the new grid, filled by tasks of adjacent cross sections
+*/
+typedef struct
+{
+    CrgDataStruct*  src;        /* data set which is re-rendered                                [-] */
+    CrgDataStruct*  dst;        /* resulting data set                                           [-] */
+    size_t          nu;         /* number of cross sections of the result                       [-] */
+    size_t          nv;         /* number of long sections of the result                        [-] */
+    size_t*         indexU;     /* nu indices of the u intervals of the source                  [-] */
+    double*         fracU;      /* nu fractions within the u intervals of the source            [-] */
+    size_t*         indexV;     /* nv indices of the v intervals of the source                  [-] */
+    double*         fracV;      /* nv fractions within the v intervals of the source            [-] */
+    int             noTasks;    /* number of tasks                                              [-] */
+} CrgRerenderJobStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* set the long sections of the resulting data set
+* @param job    the job holding both data sets
+* @param vInc   increment of regular long sections, 0 to keep those of the source    [m]
+* @param v      explicit positions of the long sections, may be NULL                 [m]
+* @param noV    number of explicit positions
+* @return 1 if successful, otherwise 0
+*/
+static int setupV( CrgRerenderJobStruct* job, double vInc, const double* v, int noV );
+
+/**
+* find the source intervals of the cross and long sections of the result
+* @param job    the job holding both data sets
+* @return 1 if successful, otherwise 0
+*/
+static int locateSections( CrgRerenderJobStruct* job );
+
+/**
+* resample a channel of the reference line to the cross sections of the result
+* @param job    the job holding the source intervals
+* @param dst    the channel of the resulting data set
+* @param src    the channel of the source data set
+* @return 1 if successful, otherwise 0
+*/
+static int resampleChannel( CrgRerenderJobStruct* job, CrgChannelStruct* dst, const CrgChannelStruct* src );
+
+/**
+* set the reference line of the resulting data set
+* @param job    the job holding both data sets
+* @return 1 if successful, otherwise 0
+*/
+static int setupRefLine( CrgRerenderJobStruct* job );
+
+/**
+* fill the grid values of a range of cross sections of the result
+* @param data   pointer to the job
+* @param taskId index of the task
+*/
+static void rerenderTask( void* data, int taskId );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataSetRerender( int dataSetId, double uInc, double vInc, const double* v, int noV )
+{
+    CrgRerenderJobStruct job;
+    CrgDataStruct* src;
+    CrgDataStruct* dst;
+    double uRange;
+    size_t i;
+    int    id;
+    int    ok;
+
+    if ( !( src = crgDataSetAccess( dataSetId ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetRerender: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+
+    if ( src->admin.headerOnly )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetRerender: data of data set <%d> has not been read.\n", dataSetId );
+        return 0;
+    }
+
+    if ( !src->channelZ || !src->channelV.data || !src->channelX.data || !src->channelY.data ||
+         src->channelU.info.size < 2 || src->channelV.info.size < 2 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetRerender: data set <%d> is incomplete.\n", dataSetId );
+        return 0;
+    }
+
+    /* --- the new cross sections start with those of the source, see crg_rerender.m --- */
+    if ( !( uInc > 0.0 ) )
+        uInc = src->channelU.info.inc;
+
+    uRange = src->channelU.info.last - src->channelU.info.first;
+
+    if ( uRange / uInc + 1.0 < 2.0 - dRerenderSizeTol )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetRerender: u increment %.4f exceeds the length of data set <%d>.\n", uInc, dataSetId );
+        return 0;
+    }
+
+    memset( &job, 0, sizeof( CrgRerenderJobStruct ) );
+
+    job.src = src;
+    job.nu  = ( size_t ) ( uRange / uInc + dRerenderSizeTol ) + 1;
+
+    if ( !( dst = crgDataSetCreate() ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataSetRerender: could not create data set\n" );
+        return 0;
+    }
+
+    /* --- from here on, the data set is released as a whole if anything fails --- */
+    job.dst = dst;
+    id      = dst->admin.id;
+
+    dst->admin.dataFormat = src->admin.dataFormat;
+    dst->admin.defMask    = src->admin.defMask & ~( dCrgDataDefVPos | dCrgDataDefVIndex );
+    dst->admin.gridLayout = dCrgGridLayoutContiguous;
+    dst->util             = src->util;
+
+    dst->channelU.info       = src->channelU.info;
+    dst->channelU.info.size  = job.nu;
+    dst->channelU.info.inc   = uInc;
+    dst->channelU.info.last  = src->channelU.info.first + uInc * ( job.nu - 1 );
+
+    ok = setupV( &job, vInc, v, noV ) && locateSections( &job ) && setupRefLine( &job );
+
+    /* --- the grid; channel means of the source are part of the new values --- */
+    if ( ok )
+        ok = ( dst->channelZ = ( CrgChannelFStruct* ) crgCalloc( job.nv + 1, sizeof( CrgChannelFStruct ) ) ) != NULL;
+
+    for ( i = 0; ok && i < job.nv; i++ )
+    {
+        dst->channelZ[i].info.valid      = 1;
+        dst->channelZ[i].info.defined    = 1;
+        dst->channelZ[i].info.singlePrec = 1;
+        dst->channelZ[i].info.index      = i;
+        dst->channelZ[i].info.size       = job.nu;
+    }
+
+    if ( ok )
+        ok = crgLoaderAllocateGrid( dst );
+
+    if ( !ok )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetRerender: could not re-render data set <%d>.\n", dataSetId );
+        crgFree( job.indexU );
+        crgFree( job.fracU );
+        crgFree( job.indexV );
+        crgFree( job.fracV );
+        crgDataSetRelease( id );
+        return 0;
+    }
+
+    /* --- tasks of adjacent cross sections; the source is only read --- */
+    job.noTasks = crgLoaderGetNoThreads();
+
+    if ( job.noTasks > dRerenderMaxTasks )
+        job.noTasks = dRerenderMaxTasks;
+
+    if ( ( size_t ) job.noTasks > job.nu / dRerenderTaskMinCols )
+        job.noTasks = ( int ) ( job.nu / dRerenderTaskMinCols );
+
+    if ( ( size_t ) job.noTasks > job.nu * job.nv / dRerenderTaskMinSize )
+        job.noTasks = ( int ) ( job.nu * job.nv / dRerenderTaskMinSize );
+
+    if ( job.noTasks < 1 )
+        job.noTasks = 1;
+
+    crgPortRunTasks( rerenderTask, &job, job.noTasks );
+
+    crgFree( job.indexU );
+    crgFree( job.fracU );
+    crgFree( job.indexV );
+    crgFree( job.fracV );
+
+    /* --- settings of the source; modifiers which have been applied must not be applied again --- */
+    crgOptionCopyAll( &( dst->options ), &( src->options ) );
+
+    if ( src->admin.modsApplied )
+    {
+        crgOptionRemoveAll( &( dst->modifiers ) );
+        dst->admin.modsApplied = 1;
+    }
+    else
+        crgOptionCopyAll( &( dst->modifiers ), &( src->modifiers ) );
+
+    /* --- the remaining steps of crgLoaderPrepareData(), the reference line is complete --- */
+    crgCalcStatistics( dst );
+    crgCalcUtilityData( dst );
+    crgEvalxy2uvBuildIndex( dst );
+    crgCalcRefLineGeom( dst );
+
+    /* --- initialize data-set specific history --- */
+    crgDataSetHistory( id, dCrgHistoryStdSize );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetRerender: data set <%d> re-rendered as <%d> with %ld x %ld samples in %d tasks\n",
+                 dataSetId, id, ( long ) job.nu, ( long ) job.nv, job.noTasks );
+
+    return id;
+}
+
+static int
+setupV( CrgRerenderJobStruct* job, double vInc, const double* v, int noV )
+{
+    CrgDataStruct* src = job->src;
+    CrgDataStruct* dst = job->dst;
+    double vMin = src->channelV.data[0];
+    double vMax = src->channelV.data[src->channelV.info.size - 1];
+    size_t i;
+
+    if ( v && noV > 1 )
+        job->nv = ( size_t ) noV;
+    else if ( vInc > 0.0 )
+    {
+        if ( ( vMax - vMin ) / vInc + 1.0 < 2.0 - dRerenderSizeTol )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetRerender: v increment %.4f exceeds the width of the data set.\n", vInc );
+            return 0;
+        }
+
+        job->nv = ( size_t ) ( ( vMax - vMin ) / vInc + dRerenderSizeTol ) + 1;
+    }
+    else
+        job->nv = src->channelV.info.size;
+
+    if ( !( dst->channelV.data = ( double* ) crgCalloc( job->nv, sizeof( double ) ) ) )
+        return 0;
+
+    dst->channelV.info.valid   = 1;
+    dst->channelV.info.defined = 1;
+    dst->channelV.info.size    = job->nv;
+
+    if ( v && noV > 1 )
+    {
+        /* --- explicit positions, checked as the loader does --- */
+        for ( i = 0; i < job->nv; i++ )
+        {
+            if ( i && v[i] - v[i-1] < dRerenderMinSpacing )
+            {
+                crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetRerender: v positions must increase by at least %g m.\n", dRerenderMinSpacing );
+                return 0;
+            }
+
+            dst->channelV.data[i] = v[i];
+        }
+
+        dst->admin.defMask |= dCrgDataDefVPos;
+    }
+    else if ( vInc > 0.0 )
+    {
+        /* --- regular long sections across the source, e.g. from irregular ones --- */
+        for ( i = 0; i < job->nv; i++ )
+            dst->channelV.data[i] = vMin + vInc * i;
+
+        dst->channelV.info.inc  = vInc;
+        dst->admin.defMask     |= dCrgDataDefVIndex;
+    }
+    else
+    {
+        memcpy( dst->channelV.data, src->channelV.data, job->nv * sizeof( double ) );
+
+        dst->channelV.info.inc  = src->channelV.info.inc;
+        dst->admin.defMask     |= ( src->admin.defMask & dCrgDataDefVIndex ) ? dCrgDataDefVIndex : dCrgDataDefVPos;
+    }
+
+    dst->channelV.info.first = dst->channelV.data[0];
+    dst->channelV.info.last  = dst->channelV.data[job->nv - 1];
+
+    return 1;
+}
+
+static int
+locateSections( CrgRerenderJobStruct* job )
+{
+    CrgDataStruct* src = job->src;
+    size_t i;
+    size_t index;
+    size_t index0;
+    size_t indexCtr;
+    double frac;
+    double pos;
+
+    job->indexU = ( size_t* ) crgCalloc( job->nu, sizeof( size_t ) );
+    job->fracU  = ( double* ) crgCalloc( job->nu, sizeof( double ) );
+    job->indexV = ( size_t* ) crgCalloc( job->nv, sizeof( size_t ) );
+    job->fracV  = ( double* ) crgCalloc( job->nv, sizeof( double ) );
+
+    if ( !job->indexU || !job->fracU || !job->indexV || !job->fracV )
+        return 0;
+
+    /* --- u intervals, with the same arithmetic as crgDataEvaluv2zCore() --- */
+    for ( i = 0; i < job->nu; i++ )
+    {
+        pos = job->dst->channelU.info.first + job->dst->channelU.info.inc * i;
+
+        if ( pos < src->channelU.info.first )
+            pos = src->channelU.info.first;
+
+        frac  = ( pos - src->channelU.info.first ) / src->channelU.info.inc;
+        index = ( size_t ) frac;
+
+        if ( index >= src->channelU.info.size - 1 )
+        {
+            index = src->channelU.info.size - 2;
+            frac  = 1.0;
+        }
+        else
+            frac -= index;
+
+        job->indexU[i] = index;
+        job->fracU[i]  = frac;
+    }
+
+    /* --- v intervals; positions beyond the source take the values at its border --- */
+    for ( i = 0; i < job->nv; i++ )
+    {
+        pos = job->dst->channelV.data[i];
+
+        if ( pos < src->channelV.data[0] )
+            pos = src->channelV.data[0];
+        else if ( pos > src->channelV.data[src->channelV.info.size - 1] )
+            pos = src->channelV.data[src->channelV.info.size - 1];
+
+        if ( src->admin.defMask & dCrgDataDefVIndex )
+        {
+            frac  = ( pos - src->channelV.info.first ) / src->channelV.info.inc;
+            index = ( size_t ) frac;
+
+            if ( index >= src->channelV.info.size - 1 )
+            {
+                index = src->channelV.info.size - 2;
+                frac  = 1.0;
+            }
+            else
+                frac -= index;
+        }
+        else
+        {
+            index  = 0;
+            index0 = src->channelV.info.size - 1;
+
+            while ( 1 )
+            {
+                indexCtr = ( index0 + index ) / 2;
+
+                if ( indexCtr <= index )
+                    break;
+
+                if ( pos < src->channelV.data[indexCtr] )
+                    index0 = indexCtr;
+                else
+                    index = indexCtr;
+            }
+
+            frac = ( pos - src->channelV.data[index] ) / ( src->channelV.data[index+1] - src->channelV.data[index] );
+
+            if ( frac > 1.0 )
+                frac = 1.0;
+        }
+
+        job->indexV[i] = index;
+        job->fracV[i]  = frac;
+    }
+
+    return 1;
+}
+
+static int
+resampleChannel( CrgRerenderJobStruct* job, CrgChannelStruct* dst, const CrgChannelStruct* src )
+{
+    size_t i;
+
+    dst->info = src->info;
+
+    /* --- channels without data hold constants only --- */
+    if ( !src->data )
+        return 1;
+
+    dst->info.size = job->nu;
+
+    if ( !( dst->data = ( double* ) crgCalloc( job->nu, sizeof( double ) ) ) )
+        return 0;
+
+    for ( i = 0; i < job->nu; i++ )
+        dst->data[i] = src->data[job->indexU[i]] + job->fracU[i] * ( src->data[job->indexU[i]+1] - src->data[job->indexU[i]] );
+
+    return 1;
+}
+
+static int
+setupRefLine( CrgRerenderJobStruct* job )
+{
+    CrgDataStruct* src = job->src;
+    CrgDataStruct* dst = job->dst;
+    size_t i;
+
+    /* --- the new points lie on the polygon of the source, as evaluated at v = 0 --- */
+    if ( !resampleChannel( job, &( dst->channelX ),     &( src->channelX ) )     ||
+         !resampleChannel( job, &( dst->channelY ),     &( src->channelY ) )     ||
+         !resampleChannel( job, &( dst->channelSlope ), &( src->channelSlope ) ) ||
+         !resampleChannel( job, &( dst->channelBank ),  &( src->channelBank ) )  ||
+         !resampleChannel( job, &( dst->channelRefZ ),  &( src->channelRefZ ) ) )
+        return 0;
+
+    dst->channelX.info.first = dst->channelX.data[0];
+    dst->channelX.info.last  = dst->channelX.data[job->nu - 1];
+    dst->channelY.info.first = dst->channelY.data[0];
+    dst->channelY.info.last  = dst->channelY.data[job->nu - 1];
+    dst->admin.defMask      |= dCrgDataDefXEnd | dCrgDataDefYEnd;
+
+    if ( dst->channelRefZ.data )
+    {
+        dst->channelRefZ.info.first = dst->channelRefZ.data[0];
+        dst->channelRefZ.info.last  = dst->channelRefZ.data[job->nu - 1];
+    }
+
+    /* --- headings of the new polygon, so that calcRefLine() reproduces it --- */
+    dst->channelPhi.info = src->channelPhi.info;
+
+    if ( !src->channelPhi.data )
+        return 1;
+
+    dst->channelPhi.info.size = job->nu;
+
+    if ( !( dst->channelPhi.data = ( double* ) crgCalloc( job->nu, sizeof( double ) ) ) )
+        return 0;
+
+    dst->channelPhi.data[0] = src->channelPhi.data[0];
+
+    for ( i = 1; i < job->nu; i++ )
+        dst->channelPhi.data[i] = atan2( dst->channelY.data[i] - dst->channelY.data[i-1], dst->channelX.data[i] - dst->channelX.data[i-1] );
+
+    dst->channelPhi.info.last = dst->channelPhi.data[job->nu - 1];
+
+    return 1;
+}
+
+static void
+rerenderTask( void* data, int taskId )
+{
+    CrgRerenderJobStruct* job = ( CrgRerenderJobStruct* ) data;
+    CrgDataStruct* src = job->src;
+    size_t colBeg = job->nu * taskId / job->noTasks;
+    size_t colEnd = job->nu * ( taskId + 1 ) / job->noTasks;
+    int    direct = !src->gridQuant.valid && !src->gridStream.valid;
+    size_t i;
+    size_t k;
+    size_t iu;
+    size_t iv;
+    double fu;
+    double fv;
+    double mean;
+    double z00;
+    double z01;
+    double z10;
+    double z11;
+    double c[4];
+    float* out;
+    const float* row0;
+    const float* row1;
+
+    /* --- long section by long section, the bilinear interpolation of crgDataEvaluv2zCore() --- */
+    for ( i = 0; i < job->nv; i++ )
+    {
+        iv   = job->indexV[i];
+        fv   = job->fracV[i];
+        mean = src->channelZ[iv].info.mean;
+        out  = job->dst->channelZ[i].data;
+
+        if ( direct )
+        {
+            row0 = src->channelZ[iv].data;
+            row1 = src->channelZ[iv+1].data;
+
+            for ( k = colBeg; k < colEnd; k++ )
+            {
+                iu   = job->indexU[k];
+                fu   = job->fracU[k];
+                c[0] = row0[iu];
+                c[1] = row0[iu+1];
+                c[2] = row1[iu];
+                c[3] = row1[iu+1];
+
+                dRerenderCorners( c, fu, fv )
+
+                z00  = c[0];
+                z10  = c[1] - z00;
+                z01  = c[2];
+                z11  = c[3] - ( z10 + z01 );
+                z01 -= z00;
+
+                out[k] = ( float ) ( ( z11 * fv + z10 ) * fu + z01 * fv + z00 + mean );
+            }
+        }
+        else
+        {
+            for ( k = colBeg; k < colEnd; k++ )
+            {
+                iu = job->indexU[k];
+                fu = job->fracU[k];
+
+                crgDataGridCellCorners( src, iu, iv, c );
+
+                dRerenderCorners( c, fu, fv )
+
+                z00  = c[0];
+                z10  = c[1] - z00;
+                z01  = c[2];
+                z11  = c[3] - ( z10 + z01 );
+                z01 -= z00;
+
+                out[k] = ( float ) ( ( z11 * fv + z10 ) * fu + z01 * fv + z00 + mean );
+            }
+        }
+    }
+}
@@ -0,0 +1,901 @@
+/* ===================================================
+ *  file:       crgGridStream.c
+ * ---------------------------------------------------
+ *  purpose:	stream the elevation grid of long binary
+ *              files, keeping only a window of cross
+ *              sections around the evaluated positions
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include <math.h>
+#include <string.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dStreamMaxUseCount  0x40000000UL    /* the access counters are rebased at this value [-] */
+
+/* ====== TYPE DEFINITIONS ====== */
+
+/* ====== LOCAL METHODS ====== */
+/**
+* get a resident page, reading it if required; the mutex of the stream must be held
+* @param crgData    pointer to the data set
+* @param page       index of the page
+* @return the samples of the page
+*/
+static float* acquirePage( CrgDataStruct* crgData, size_t page );
+
+/**
+* read the samples of a cross section at two adjacent v channels without
+* taking the mutex of the stream; this succeeds only if the page is resident
+* and has been accessed since the start of the current prefetch cycle, i.e.
+* if acquiring it would neither read the file nor change the counters
+* @param stream     pointer to the streamed grid
+* @param page       index of the page
+* @param offset     index of the cross section within the page
+* @param indexV     index of the first v channel
+* @param z0         pointer to the resulting sample of the first v channel
+* @param z1         pointer to the resulting sample of the second v channel
+* @return 1 if the samples have been read, 0 if the page has to be acquired
+*/
+static int readResident( CrgGridStreamStruct* stream, size_t page, size_t offset, size_t indexV, double* z0, double* z1 );
+
+/**
+* get the samples of a cell from the resident pages, acquiring them under the
+* mutex of the stream where they cannot be read without it
+* @param crgData    pointer to the data set
+* @param indexU     index of the cross section at the start of the cell
+* @param indexV     index of the v channel at the right of the cell
+* @param c          resulting samples of the cell corners
+*/
+static void getCorners( CrgDataStruct* crgData, size_t indexU, size_t indexV, double* c );
+
+/**
+* read a page into a buffer; the mutex of the stream must be held, it is
+* released while the file is read
+* @param crgData    pointer to the data set
+* @param idx        index of the buffer
+* @param page       index of the page
+*/
+static void loadSlot( CrgDataStruct* crgData, int idx, size_t page );
+
+/**
+* read and decode the cross sections of a page; the file mutex of the stream must be held
+* @param crgData    pointer to the data set
+* @param page       index of the page
+* @param data       resulting samples
+* @param zScale     factor applied to the samples
+* @param nanMode    NaN handling applied to the samples
+* @param nanOffset  offset applied by the NaN handling [m]
+*/
+static void readPage( CrgDataStruct* crgData, size_t page, float* data, double zScale, int nanMode, double nanOffset );
+
+/**
+* collect the pages which have been accessed recently
+* @param stream     pointer to the streamed grid
+* @param active     resulting array of at most dCrgStreamMaxActive pages
+* @return number of active pages
+*/
+static int getActivePages( CrgGridStreamStruct* stream, size_t* active );
+
+/**
+* check whether a page lies within the window of an active page
+* @param stream     pointer to the streamed grid
+* @param active     array of active pages
+* @param noActive   number of active pages
+* @param page       index of the page
+* @return 1 if the page is within a window, otherwise 0
+*/
+static int inWindow( CrgGridStreamStruct* stream, const size_t* active, int noActive, size_t page );
+
+/**
+* find a buffer for a page to be read, preferring unused buffers and, among the
+* others, the least recently used one outside the windows of the active pages
+* @param stream     pointer to the streamed grid
+* @param active     array of active pages
+* @param noActive   number of active pages
+* @param any        buffers within a window may be used as well
+* @return index of the buffer, -1 if none is available
+*/
+static int findVictim( CrgGridStreamStruct* stream, const size_t* active, int noActive, int any );
+
+/**
+* register the first access to a page since it became inactive: derive the
+* direction of travel and request the prefetch thread to complete the window
+* @param stream     pointer to the streamed grid
+* @param page       index of the page
+*/
+static void enterPage( CrgGridStreamStruct* stream, size_t page );
+
+/**
+* find the next page to be read ahead: the pages ahead of the active pages
+* nearest first, then the pages behind them
+* @param stream     pointer to the streamed grid
+* @param active     array of active pages
+* @param noActive   number of active pages
+* @param page       pointer to the resulting page
+* @return 1 if a page has to be read, otherwise 0
+*/
+static int nextPrefetch( CrgGridStreamStruct* stream, const size_t* active, int noActive, size_t* page );
+
+/**
+* discard the resident pages, e.g. once the decoding of the samples has changed;
+* the mutex of the stream must be held
+* @param stream     pointer to the streamed grid
+*/
+static void discardPages( CrgGridStreamStruct* stream );
+
+/**
+* task of the prefetch thread
+* @param data       pointer to the data set
+*/
+static void prefetchTask( void* data );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataGridStreamInit( CrgDataStruct* crgData, const char* fileName, size_t dataOffset, double uBehind, double uAhead )
+{
+    CrgGridStreamStruct* stream;
+
+    if ( !crgData || !fileName || !crgData->admin.recordSize )
+        return 0;
+
+    stream = &( crgData->gridStream );
+
+    memset( stream, 0, sizeof( CrgGridStreamStruct ) );
+
+    if ( !( stream->fileName = ( char* ) crgCalloc( strlen( fileName ) + 1, sizeof( char ) ) ) )
+        return 0;
+
+    strcpy( stream->fileName, fileName );
+
+    stream->valid      = 1;
+    stream->dataOffset = dataOffset;
+    stream->recordSize = crgData->admin.recordSize;
+    stream->uBehind    = uBehind;
+    stream->uAhead     = uAhead;
+    stream->direction  = 1;
+    stream->zScale     = 1.0;
+    stream->nanMode    = dCrgGridNaNKeep;
+
+    return 1;
+}
+
+void
+crgDataGridStreamScan( CrgDataStruct* crgData, const double* record, size_t nRec )
+{
+    CrgGridStreamStruct* stream = &( crgData->gridStream );
+    size_t i;
+    double value;
+
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    {
+        value = record[crgData->channelZ[i].info.index];
+
+        if ( crgIsNan( &value ) )
+            continue;
+
+        /* --- the statistics refer to the samples as they are stored --- */
+        value = ( float ) value;
+
+        if ( !stream->noValues || value < stream->zMin )
+            stream->zMin = value;
+
+        if ( !stream->noValues || value > stream->zMax )
+            stream->zMax = value;
+
+        stream->noValues++;
+
+        if ( !nRec )
+        {
+            stream->zSumBeg += value;
+            stream->noBeg++;
+        }
+
+        if ( nRec + 1 == crgData->channelU.info.size )
+        {
+            stream->zSumEnd += value;
+            stream->noEnd++;
+        }
+    }
+}
+
+int
+crgDataGridStreamStart( CrgDataStruct* crgData )
+{
+    CrgGridStreamStruct* stream;
+    size_t sizeV;
+    size_t i;
+    double pageLength;
+
+    if ( !crgData || !crgData->gridStream.valid )
+        return 0;
+
+    stream        = &( crgData->gridStream );
+    sizeV         = crgData->channelV.info.size;
+    stream->sizeU = crgData->channelU.info.size;
+
+    if ( stream->sizeU < 2 || sizeV < 2 || !( crgData->channelU.info.inc > 0.0 ) )
+        return 0;
+
+    /* --- the window is kept in whole pages --- */
+    pageLength          = dCrgStreamPageSize * crgData->channelU.info.inc;
+    stream->noPages     = ( stream->sizeU + dCrgStreamPageSize - 1 ) >> dCrgStreamPageBits;
+    stream->pagesBehind = ( size_t ) ceil( stream->uBehind / pageLength );
+    stream->pagesAhead  = ( size_t ) ceil( stream->uAhead  / pageLength );
+
+    if ( stream->pagesBehind > stream->noPages )
+        stream->pagesBehind = stream->noPages;
+
+    if ( stream->pagesAhead > stream->noPages )
+        stream->pagesAhead = stream->noPages;
+
+    stream->noSlots = stream->pagesBehind + stream->pagesAhead + 1 + dCrgStreamSpareSlots;
+
+    if ( stream->noSlots > stream->noPages )
+        stream->noSlots = stream->noPages;
+
+    stream->slot         = ( CrgGridStreamSlotStruct* ) crgCalloc( stream->noSlots, sizeof( CrgGridStreamSlotStruct ) );
+    stream->pageSlot     = ( int* ) crgCalloc( stream->noPages, sizeof( int ) );
+    stream->readBuffer   = ( char* ) crgCalloc( dCrgStreamPageSize, stream->recordSize );
+    stream->record       = ( double* ) crgCalloc( crgData->noChannels, sizeof( double ) );
+    stream->pageChannels = ( CrgChannelFStruct* ) crgCalloc( sizeV, sizeof( CrgChannelFStruct ) );
+
+    if ( !stream->slot || !stream->pageSlot || !stream->readBuffer || !stream->record || !stream->pageChannels )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataGridStreamStart: could not allocate page buffers.\n" );
+        return 0;
+    }
+
+    for ( i = 0; i < stream->noSlots; i++ )
+    {
+        if ( !( stream->slot[i].data = ( float* ) crgCalloc( sizeV * dCrgStreamPageSize, sizeof( float ) ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgDataGridStreamStart: could not allocate page buffers.\n" );
+            return 0;
+        }
+    }
+
+    for ( i = 0; i < stream->noPages; i++ )
+        stream->pageSlot[i] = -1;
+
+    if ( !( stream->fPtr = fopen( stream->fileName, "rb" ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataGridStreamStart: could not open <%s>.\n", stream->fileName );
+        return 0;
+    }
+
+    stream->mutex     = crgPortMutexCreate();
+    stream->fileMutex = crgPortMutexCreate();
+    stream->cond      = crgPortCondCreate();
+
+    if ( !stream->mutex || !stream->fileMutex || !stream->cond )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataGridStreamStart: could not create synchronization objects.\n" );
+        return 0;
+    }
+
+    /* --- without a prefetch thread, the pages are read on demand only --- */
+    if ( !( stream->thread = crgPortThreadStart( prefetchTask, crgData ) ) )
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataGridStreamStart: could not start prefetch thread.\n" );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataGridStreamStart: %ld cross sections in %ld pages, at most %ld pages (%.1f MB) resident\n",
+                 stream->sizeU, stream->noPages, stream->noSlots,
+                 stream->noSlots * sizeV * dCrgStreamPageSize * sizeof( float ) / 1048576.0 );
+
+    return 1;
+}
+
+void
+crgDataGridStreamRelease( CrgDataStruct* crgData )
+{
+    CrgGridStreamStruct* stream;
+    size_t i;
+
+    if ( !crgData )
+        return;
+
+    stream = &( crgData->gridStream );
+
+    if ( stream->thread )
+    {
+        crgPortMutexLock( stream->mutex );
+        stream->stop = 1;
+        crgPortCondBroadcast( stream->cond );
+        crgPortMutexUnlock( stream->mutex );
+
+        crgPortThreadJoin( stream->thread );
+    }
+
+    if ( stream->slot )
+    {
+        for ( i = 0; i < stream->noSlots; i++ )
+            if ( stream->slot[i].data )
+                crgFree( stream->slot[i].data );
+
+        crgFree( stream->slot );
+    }
+
+    if ( stream->pageSlot )
+        crgFree( stream->pageSlot );
+
+    if ( stream->readBuffer )
+        crgFree( stream->readBuffer );
+
+    if ( stream->record )
+        crgFree( stream->record );
+
+    if ( stream->pageChannels )
+        crgFree( stream->pageChannels );
+
+    if ( stream->fileName )
+        crgFree( stream->fileName );
+
+    if ( stream->fPtr )
+        fclose( stream->fPtr );
+
+    crgPortMutexDelete( stream->mutex );
+    crgPortMutexDelete( stream->fileMutex );
+    crgPortCondDelete( stream->cond );
+
+    memset( stream, 0, sizeof( CrgGridStreamStruct ) );
+}
+
+void
+crgDataGridStreamCorners( CrgDataStruct* crgData, int n, const size_t* indexU, const size_t* indexV, double* c )
+{
+    CrgGridStreamStruct* stream = &( crgData->gridStream );
+    size_t page;
+    size_t offset;
+    int    k;
+
+    for ( k = 0; k < n; k++ )
+    {
+        page   = indexU[k] >> dCrgStreamPageBits;
+        offset = indexU[k] & ( dCrgStreamPageSize - 1 );
+
+        /* --- resident pages are read without a lock, the cell may extend to the next page --- */
+        if ( readResident( stream, page, offset, indexV[k], &c[4*k], &c[4*k+2] ) &&
+             ( offset + 1 < dCrgStreamPageSize ? readResident( stream, page, offset + 1, indexV[k], &c[4*k+1], &c[4*k+3] )
+                                                : readResident( stream, page + 1, 0, indexV[k], &c[4*k+1], &c[4*k+3] ) ) )
+            continue;
+
+        getCorners( crgData, indexU[k], indexV[k], &c[4*k] );
+    }
+}
+
+void
+crgDataGridStreamScale( CrgDataStruct* crgData, double factor )
+{
+    CrgGridStreamStruct* stream = &( crgData->gridStream );
+
+    if ( !stream->valid )
+        return;
+
+    crgPortMutexLock( stream->mutex );
+
+    stream->zScale *= factor;
+    stream->version++;
+    discardPages( stream );
+
+    crgPortMutexUnlock( stream->mutex );
+}
+
+void
+crgDataGridStreamSetNaNMode( CrgDataStruct* crgData, int mode, double offset )
+{
+    CrgGridStreamStruct* stream = &( crgData->gridStream );
+
+    if ( !stream->valid )
+        return;
+
+    crgPortMutexLock( stream->mutex );
+
+    /* --- a resident grid has no NaNs left once they have been replaced --- */
+    if ( stream->nanMode == dCrgGridNaNKeep && mode != dCrgGridNaNKeep )
+    {
+        stream->nanMode   = mode;
+        stream->nanOffset = offset;
+        stream->version++;
+        discardPages( stream );
+
+        crgMsgPrint( dCrgMsgLevelNotice, "crgDataGridStreamSetNaNMode: NaNs of the streamed grid are replaced while reading it.\n" );
+    }
+
+    crgPortMutexUnlock( stream->mutex );
+}
+
+void
+crgDataGridStreamGetStat( CrgDataStruct* crgData, double* zMeanBeg, double* zMeanEnd, double* zMin, double* zMax )
+{
+    CrgGridStreamStruct* stream = &( crgData->gridStream );
+    double zScale = stream->zScale;
+
+    *zMeanBeg = stream->noBeg ? zScale * stream->zSumBeg / stream->noBeg : 0.0;
+    *zMeanEnd = stream->noEnd ? zScale * stream->zSumEnd / stream->noEnd : 0.0;
+
+    if ( !stream->noValues )
+    {
+        *zMin = *zMeanBeg;
+        *zMax = *zMeanBeg;
+    }
+    else if ( zScale < 0.0 )
+    {
+        *zMin = zScale * stream->zMax;
+        *zMax = zScale * stream->zMin;
+    }
+    else
+    {
+        *zMin = zScale * stream->zMin;
+        *zMax = zScale * stream->zMax;
+    }
+}
+
+int
+crgDataSetGetStreamStat( int dataSetId, long* noMisses, long* noLoads )
+{
+    CrgDataStruct *crgData = crgDataSetAccess( dataSetId );
+
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetGetStreamStat: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+
+    if ( !crgData->gridStream.valid )
+        return 0;
+
+    crgPortMutexLock( crgData->gridStream.mutex );
+
+    if ( noMisses )
+        *noMisses = crgData->gridStream.noMisses;
+
+    if ( noLoads )
+        *noLoads = crgData->gridStream.noLoads;
+
+    crgPortMutexUnlock( crgData->gridStream.mutex );
+
+    return 1;
+}
+
+int
+crgDataSetResetStreamStat( int dataSetId )
+{
+    CrgDataStruct *crgData = crgDataSetAccess( dataSetId );
+
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetResetStreamStat: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+
+    if ( !crgData->gridStream.valid )
+        return 0;
+
+    crgPortMutexLock( crgData->gridStream.mutex );
+
+    crgData->gridStream.noMisses = 0;
+    crgData->gridStream.noLoads  = 0;
+
+    crgPortMutexUnlock( crgData->gridStream.mutex );
+
+    return 1;
+}
+
+static int
+readResident( CrgGridStreamStruct* stream, size_t page, size_t offset, size_t indexV, double* z0, double* z1 )
+{
+    CrgGridStreamSlotStruct* slot;
+    unsigned long stamp;
+    int    idx = stream->pageSlot[page];
+
+    if ( idx < 0 )
+        return 0;
+
+    slot  = &( stream->slot[idx] );
+    stamp = slot->stamp;
+
+    dCrgPortBarrierAcquire();
+
+    if ( ( stamp & 1 ) || slot->state != dCrgStreamSlotResident || slot->page != page || slot->lastUse <= stream->cycleCount )
+        return 0;
+
+    *z0 = slot->data[indexV * dCrgStreamPageSize + offset];
+    *z1 = slot->data[( indexV + 1 ) * dCrgStreamPageSize + offset];
+
+    /* --- the samples are valid unless the buffer has changed meanwhile --- */
+    dCrgPortBarrierAcquire();
+
+    return slot->stamp == stamp;
+}
+
+static void
+getCorners( CrgDataStruct* crgData, size_t indexU, size_t indexV, double* c )
+{
+    CrgGridStreamStruct* stream = &( crgData->gridStream );
+    const float* data;
+    size_t offset;
+
+    crgPortMutexLock( stream->mutex );
+
+    data   = acquirePage( crgData, indexU >> dCrgStreamPageBits );
+    offset = indexU & ( dCrgStreamPageSize - 1 );
+
+    c[0] = data[indexV * dCrgStreamPageSize + offset];
+    c[2] = data[( indexV + 1 ) * dCrgStreamPageSize + offset];
+
+    /* --- the cell may extend to the next page, the values at hand are kept --- */
+    if ( offset + 1 < dCrgStreamPageSize )
+        offset++;
+    else
+    {
+        data   = acquirePage( crgData, ( indexU >> dCrgStreamPageBits ) + 1 );
+        offset = 0;
+    }
+
+    c[1] = data[indexV * dCrgStreamPageSize + offset];
+    c[3] = data[( indexV + 1 ) * dCrgStreamPageSize + offset];
+
+    crgPortMutexUnlock( stream->mutex );
+}
+
+static float*
+acquirePage( CrgDataStruct* crgData, size_t page )
+{
+    CrgGridStreamStruct*     stream = &( crgData->gridStream );
+    CrgGridStreamSlotStruct* slot;
+    size_t active[dCrgStreamMaxActive];
+    int    noActive;
+    int    missed = 0;
+    int    idx;
+    size_t i;
+
+    while ( 1 )
+    {
+        idx = stream->pageSlot[page];
+
+        if ( idx >= 0 && stream->slot[idx].state == dCrgStreamSlotResident )
+            break;
+
+        if ( !missed )
+        {
+            stream->noMisses++;
+            missed = 1;
+        }
+
+        /* --- the page is being read by another thread --- */
+        if ( idx >= 0 )
+        {
+            crgPortCondWait( stream->cond, stream->mutex );
+            continue;
+        }
+
+        noActive = getActivePages( stream, active );
+
+        /* --- all buffers are being read by other threads --- */
+        if ( ( idx = findVictim( stream, active, noActive, 1 ) ) < 0 )
+        {
+            crgPortCondWait( stream->cond, stream->mutex );
+            continue;
+        }
+
+        loadSlot( crgData, idx, page );
+    }
+
+    slot = &( stream->slot[idx] );
+
+    if ( slot->lastUse <= stream->activeCount )
+        enterPage( stream, page );
+
+    /* --- keep the counters far from their limits, only their order matters --- */
+    if ( stream->useCount >= dStreamMaxUseCount )
+    {
+        for ( i = 0; i < stream->noSlots; i++ )
+            stream->slot[i].lastUse = ( stream->slot[i].lastUse > stream->activeCount ) ? stream->slot[i].lastUse - stream->activeCount : 0;
+
+        stream->useCount   -= stream->activeCount;
+        stream->cycleCount  = ( stream->cycleCount > stream->activeCount ) ? stream->cycleCount - stream->activeCount : 0;
+        stream->activeCount = 0;
+    }
+
+    slot->lastUse = ++stream->useCount;
+
+    return slot->data;
+}
+
+static void
+loadSlot( CrgDataStruct* crgData, int idx, size_t page )
+{
+    CrgGridStreamStruct*     stream = &( crgData->gridStream );
+    CrgGridStreamSlotStruct* slot   = &( stream->slot[idx] );
+    int    version   = stream->version;
+    double zScale    = stream->zScale;
+    int    nanMode   = stream->nanMode;
+    double nanOffset = stream->nanOffset;
+
+    /* --- readers without the mutex must not take the samples while the buffer changes --- */
+    slot->stamp++;
+    dCrgPortBarrierRelease();
+
+    if ( slot->state == dCrgStreamSlotResident )
+        stream->pageSlot[slot->page] = -1;
+
+    slot->page    = page;
+    slot->state   = dCrgStreamSlotLoading;
+    slot->lastUse = 0;
+
+    stream->pageSlot[page] = idx;
+
+    /* --- other threads may access the resident pages while the file is read --- */
+    crgPortMutexUnlock( stream->mutex );
+
+    crgPortMutexLock( stream->fileMutex );
+    readPage( crgData, page, slot->data, zScale, nanMode, nanOffset );
+    crgPortMutexUnlock( stream->fileMutex );
+
+    crgPortMutexLock( stream->mutex );
+
+    stream->noLoads++;
+
+    /* --- a page decoded with outdated settings is dropped --- */
+    if ( version == stream->version )
+        slot->state = dCrgStreamSlotResident;
+    else
+    {
+        slot->state            = dCrgStreamSlotFree;
+        stream->pageSlot[page] = -1;
+    }
+
+    dCrgPortBarrierRelease();
+    slot->stamp++;
+
+    crgPortCondBroadcast( stream->cond );
+}
+
+static void
+readPage( CrgDataStruct* crgData, size_t page, float* data, double zScale, int nanMode, double nanOffset )
+{
+    CrgGridStreamStruct* stream = &( crgData->gridStream );
+    size_t sizeV = crgData->channelV.info.size;
+    size_t first = page << dCrgStreamPageBits;
+    size_t noRecords;
+    size_t i;
+    size_t j;
+    int    offsetApplied = 0;
+
+    noRecords = stream->sizeU - first;
+
+    if ( noRecords > dCrgStreamPageSize )
+        noRecords = dCrgStreamPageSize;
+
+    for ( i = 0; i < sizeV; i++ )
+        stream->pageChannels[i].data = data + i * dCrgStreamPageSize;
+
+    if ( !crgPortFileSeek( stream->fPtr, stream->dataOffset + first * stream->recordSize ) ||
+         fread( stream->readBuffer, stream->recordSize, noRecords, stream->fPtr ) != noRecords ||
+         !crgLoaderDecodeZ( crgData, stream->readBuffer, noRecords, stream->record, stream->pageChannels ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "readPage: could not read cross sections %ld to %ld of <%s>.\n",
+                     first, first + noRecords - 1, stream->fileName );
+
+        for ( i = 0; i < sizeV * dCrgStreamPageSize; i++ )
+            crgSetNanf( &( data[i] ) );
+
+        return;
+    }
+
+    /* --- the modifiers are applied in the same order as to a resident grid --- */
+    if ( zScale != 1.0 )
+    {
+        for ( i = 0; i < sizeV; i++ )
+            for ( j = 0; j < noRecords; j++ )
+                if ( !crgIsNanf( &( stream->pageChannels[i].data[j] ) ) )
+                    stream->pageChannels[i].data[j] *= ( float ) zScale;
+    }
+
+    if ( nanMode != dCrgGridNaNKeep )
+    {
+        for ( j = 0; j < noRecords; j++ )
+            crgLoaderHandleNaNsSection( stream->pageChannels, sizeV, j, nanMode, nanOffset, &offsetApplied, NULL, NULL );
+    }
+}
+
+static int
+getActivePages( CrgGridStreamStruct* stream, size_t* active )
+{
+    int    noActive = 0;
+    size_t i;
+
+    for ( i = 0; i < stream->noSlots && noActive < dCrgStreamMaxActive; i++ )
+    {
+        if ( stream->slot[i].state == dCrgStreamSlotResident && stream->slot[i].lastUse > stream->activeCount )
+            active[noActive++] = stream->slot[i].page;
+    }
+
+    return noActive;
+}
+
+static int
+inWindow( CrgGridStreamStruct* stream, const size_t* active, int noActive, size_t page )
+{
+    size_t before = ( stream->direction > 0 ) ? stream->pagesBehind : stream->pagesAhead;
+    size_t after  = ( stream->direction > 0 ) ? stream->pagesAhead  : stream->pagesBehind;
+    int    i;
+
+    for ( i = 0; i < noActive; i++ )
+    {
+        if ( page + before >= active[i] && page <= active[i] + after )
+            return 1;
+    }
+
+    return 0;
+}
+
+static int
+findVictim( CrgGridStreamStruct* stream, const size_t* active, int noActive, int any )
+{
+    int    best = -1;
+    size_t i;
+
+    for ( i = 0; i < stream->noSlots; i++ )
+    {
+        if ( stream->slot[i].state == dCrgStreamSlotFree )
+            return ( int ) i;
+    }
+
+    for ( i = 0; i < stream->noSlots; i++ )
+    {
+        if ( stream->slot[i].state != dCrgStreamSlotResident || inWindow( stream, active, noActive, stream->slot[i].page ) )
+            continue;
+
+        if ( best < 0 || stream->slot[i].lastUse < stream->slot[best].lastUse )
+            best = ( int ) i;
+    }
+
+    if ( best >= 0 || !any )
+        return best;
+
+    for ( i = 0; i < stream->noSlots; i++ )
+    {
+        if ( stream->slot[i].state != dCrgStreamSlotResident )
+            continue;
+
+        if ( best < 0 || stream->slot[i].lastUse < stream->slot[best].lastUse )
+            best = ( int ) i;
+    }
+
+    return best;
+}
+
+static void
+enterPage( CrgGridStreamStruct* stream, size_t page )
+{
+    int idx;
+
+    /* --- a vehicle enters a page next to one it has been using --- */
+    if ( page > 0 && ( idx = stream->pageSlot[page-1] ) >= 0 && stream->slot[idx].lastUse > stream->activeCount )
+        stream->direction = 1;
+    else if ( page + 1 < stream->noPages && ( idx = stream->pageSlot[page+1] ) >= 0 && stream->slot[idx].lastUse > stream->activeCount )
+        stream->direction = -1;
+
+    if ( !stream->prefetch )
+    {
+        stream->prefetch = 1;
+        crgPortCondBroadcast( stream->cond );
+    }
+}
+
+static int
+nextPrefetch( CrgGridStreamStruct* stream, const size_t* active, int noActive, size_t* page )
+{
+    size_t d;
+    int    i;
+
+    for ( d = 1; d <= stream->pagesAhead; d++ )
+    {
+        for ( i = 0; i < noActive; i++ )
+        {
+            if ( stream->direction > 0 ? ( active[i] + d >= stream->noPages ) : ( active[i] < d ) )
+                continue;
+
+            *page = ( stream->direction > 0 ) ? active[i] + d : active[i] - d;
+
+            if ( stream->pageSlot[*page] < 0 )
+                return 1;
+        }
+    }
+
+    for ( d = 1; d <= stream->pagesBehind; d++ )
+    {
+        for ( i = 0; i < noActive; i++ )
+        {
+            if ( stream->direction > 0 ? ( active[i] < d ) : ( active[i] + d >= stream->noPages ) )
+                continue;
+
+            *page = ( stream->direction > 0 ) ? active[i] - d : active[i] + d;
+
+            if ( stream->pageSlot[*page] < 0 )
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void
+discardPages( CrgGridStreamStruct* stream )
+{
+    size_t i;
+
+    for ( i = 0; i < stream->noSlots; i++ )
+    {
+        if ( stream->slot[i].state != dCrgStreamSlotResident )
+            continue;
+
+        stream->slot[i].stamp++;
+        dCrgPortBarrierRelease();
+
+        stream->pageSlot[stream->slot[i].page] = -1;
+        stream->slot[i].state = dCrgStreamSlotFree;
+
+        dCrgPortBarrierRelease();
+        stream->slot[i].stamp++;
+    }
+}
+
+static void
+prefetchTask( void* data )
+{
+    CrgDataStruct*       crgData = ( CrgDataStruct* ) data;
+    CrgGridStreamStruct* stream  = &( crgData->gridStream );
+    size_t active[dCrgStreamMaxActive];
+    int    noActive;
+    int    idx;
+    size_t page;
+
+    crgPortMutexLock( stream->mutex );
+
+    while ( !stream->stop )
+    {
+        if ( !stream->prefetch )
+        {
+            crgPortCondWait( stream->cond, stream->mutex );
+            continue;
+        }
+
+        /* --- pages accessed since the start of the previous cycle are active --- */
+        stream->prefetch    = 0;
+        stream->activeCount = stream->cycleCount;
+        stream->cycleCount  = stream->useCount;
+
+        while ( !stream->stop )
+        {
+            noActive = getActivePages( stream, active );
+
+            if ( !nextPrefetch( stream, active, noActive, &page ) )
+                break;
+
+            if ( ( idx = findVictim( stream, active, noActive, 0 ) ) < 0 )
+                break;
+
+            loadSlot( crgData, idx, page );
+        }
+    }
+
+    crgPortMutexUnlock( stream->mutex );
+}
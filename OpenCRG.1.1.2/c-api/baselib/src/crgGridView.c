@@ -0,0 +1,596 @@
+/* ===================================================
+ *  file:       crgGridView.c
+ * ---------------------------------------------------
+ *  purpose:	views of a u/v index window of a data set
+ *              and concatenation of data sets, C port
+ *              of crg_cut_iuiv.m and crg_append.m
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include <math.h>
+#include <string.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dViewIncTol     1.e-9   /* relative tolerance of the u increments of appended data sets      [-] */
+#define dViewPosTol     1.e-6   /* tolerance of the v positions of appended data sets                [m] */
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* the data sets which are appended and the position of each within the result
+*/
+typedef struct
+{
+    CrgDataStruct**     src;        /* data sets which are appended, in order of u                  [-] */
+    int                 noSrc;      /* number of data sets                                          [-] */
+    CrgDataStruct*      dst;        /* resulting data set                                           [-] */
+    size_t*             pos;        /* index of the first cross section of each data set            [-] */
+    size_t              nu;         /* number of cross sections of the result                       [-] */
+    size_t              nv;         /* number of long sections of the result                        [-] */
+    CrgChannelStruct**  channels;   /* a channel of each data set, used by appendChannel()          [-] */
+} CrgAppendJobStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* check whether the grid of a data set may be referred to or copied
+* @param crgData    the data set
+* @param func       name of the calling method, for the messages
+* @return 1 if the grid is resident in single precision, otherwise 0
+*/
+static int checkGrid( CrgDataStruct* crgData, const char* func );
+
+/**
+* copy a window of a reference line channel; channels without data hold constants only
+* @param dst    the channel of the resulting data set
+* @param src    the channel of the source data set
+* @param beg    index of the first value of the window
+* @param size   number of values of the window
+* @return 1 if successful, otherwise 0
+*/
+static int copyChannel( CrgChannelStruct* dst, const CrgChannelStruct* src, size_t beg, size_t size );
+
+/**
+* complete a new data set whose reference line and grid have been set
+* @param dst    the resulting data set
+* @param src    the data set providing the options
+*/
+static void completeDataSet( CrgDataStruct* dst, CrgDataStruct* src );
+
+/**
+* set the reference line polygon and the headings of the appended data sets
+* @param job    the job holding all data sets
+* @return 1 if successful, otherwise 0
+*/
+static int appendRefLine( CrgAppendJobStruct* job );
+
+/**
+* append the channels held by job->channels
+* @param job        the job holding all data sets
+* @param dst        the channel of the resulting data set
+* @param continuous shift each channel so that it starts with the end value of its predecessor [0/1]
+* @return 1 if successful, otherwise 0
+*/
+static int appendChannel( CrgAppendJobStruct* job, CrgChannelStruct* dst, int continuous );
+
+/**
+* copy the grids of the appended data sets
+* @param job    the job holding all data sets
+*/
+static void appendGrid( CrgAppendJobStruct* job );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataSetCreateView( int dataSetId, int iuBeg, int iuEnd, int ivBeg, int ivEnd )
+{
+    CrgDataStruct* src;
+    CrgDataStruct* dst;
+    CrgDataStruct* owner;
+    size_t nu;
+    size_t nv;
+    size_t i;
+    int    id;
+    int    ok;
+
+    if ( !( src = crgDataSetAccess( dataSetId ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetCreateView: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+
+    if ( !checkGrid( src, "crgDataSetCreateView" ) )
+        return 0;
+
+    if ( iuBeg < 0 || iuEnd <= iuBeg || ( size_t ) iuEnd >= src->channelU.info.size ||
+         ivBeg < 0 || ivEnd <= ivBeg || ( size_t ) ivEnd >= src->channelV.info.size )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetCreateView: invalid window [%d, %d] x [%d, %d] of data set <%d> with %ld x %ld samples.\n",
+                     iuBeg, iuEnd, ivBeg, ivEnd, dataSetId, ( long ) src->channelU.info.size, ( long ) src->channelV.info.size );
+        return 0;
+    }
+
+    nu = ( size_t ) ( iuEnd - iuBeg + 1 );
+    nv = ( size_t ) ( ivEnd - ivBeg + 1 );
+
+    if ( !( dst = crgDataSetCreate() ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataSetCreateView: could not create data set\n" );
+        return 0;
+    }
+
+    /* --- from here on, the data set is released as a whole if anything fails --- */
+    id = dst->admin.id;
+
+    dst->admin.dataFormat = src->admin.dataFormat;
+    dst->admin.defMask    = src->admin.defMask | dCrgDataDefXEnd | dCrgDataDefYEnd;
+    dst->admin.gridLayout = src->admin.gridLayout;
+    dst->noChannels       = src->noChannels;
+    dst->util             = src->util;
+
+    dst->channelU.info       = src->channelU.info;
+    dst->channelU.info.size  = nu;
+    dst->channelU.info.first = src->channelU.info.first + src->channelU.info.inc * iuBeg;
+    dst->channelU.info.last  = src->channelU.info.first + src->channelU.info.inc * iuEnd;
+
+    /* --- the reference line and the long sections are copied, they are small compared to the grid --- */
+    ok = copyChannel( &( dst->channelV ),     &( src->channelV ),     ( size_t ) ivBeg, nv ) &&
+         copyChannel( &( dst->channelX ),     &( src->channelX ),     ( size_t ) iuBeg, nu ) &&
+         copyChannel( &( dst->channelY ),     &( src->channelY ),     ( size_t ) iuBeg, nu ) &&
+         copyChannel( &( dst->channelPhi ),   &( src->channelPhi ),   ( size_t ) iuBeg, nu ) &&
+         copyChannel( &( dst->channelSlope ), &( src->channelSlope ), ( size_t ) iuBeg, nu ) &&
+         copyChannel( &( dst->channelBank ),  &( src->channelBank ),  ( size_t ) iuBeg, nu ) &&
+         copyChannel( &( dst->channelRefZ ),  &( src->channelRefZ ),  ( size_t ) iuBeg, nu );
+
+    if ( ok )
+        ok = ( dst->channelZ = ( CrgChannelFStruct* ) crgCalloc( nv + 1, sizeof( CrgChannelFStruct ) ) ) != NULL;
+
+    if ( !ok )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetCreateView: could not create view of data set <%d>.\n", dataSetId );
+        crgDataSetRelease( id );
+        return 0;
+    }
+
+    /* --- phi data holds the heading of the segment ending at a point, the ends of the source keep their headings --- */
+    if ( dst->channelPhi.data && !iuBeg )
+        dst->channelPhi.info.first = src->channelPhi.info.first;
+
+    if ( dst->channelPhi.data && ( size_t ) iuEnd == src->channelU.info.size - 1 )
+        dst->channelPhi.info.last = src->channelPhi.info.last;
+
+    /* --- the rows refer to the grid of the data set owning it, also for a view of a view --- */
+    owner = src->admin.viewOwner ? src->admin.viewOwner : src;
+
+    for ( i = 0; i < nv; i++ )
+    {
+        dst->channelZ[i].info       = src->channelZ[ivBeg + i].info;
+        dst->channelZ[i].info.index = i;
+        dst->channelZ[i].info.size  = nu;
+        dst->channelZ[i].data       = src->channelZ[ivBeg + i].data + iuBeg;
+    }
+
+    crgPortLock( dCrgLockDataSets );
+
+    dst->admin.viewOwner = owner;
+    owner->admin.noViews++;
+
+    crgPortUnlock( dCrgLockDataSets );
+
+    completeDataSet( dst, src );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetCreateView: data set <%d> is a view of %ld x %ld samples of data set <%d>\n",
+                 id, ( long ) nu, ( long ) nv, dataSetId );
+
+    return id;
+}
+
+int
+crgDataSetAppend( const int* dataSetIds, int noDataSets )
+{
+    CrgAppendJobStruct job;
+    CrgDataStruct*  first;
+    CrgDataStruct*  dst;
+    size_t i;
+    int    k;
+    int    id;
+    int    ok;
+
+    if ( !dataSetIds || noDataSets < 1 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetAppend: no data sets given.\n" );
+        return 0;
+    }
+
+    memset( &job, 0, sizeof( CrgAppendJobStruct ) );
+
+    job.noSrc    = noDataSets;
+    job.src      = ( CrgDataStruct** ) crgCalloc( noDataSets, sizeof( CrgDataStruct* ) );
+    job.pos      = ( size_t* ) crgCalloc( noDataSets, sizeof( size_t ) );
+    job.channels = ( CrgChannelStruct** ) crgCalloc( noDataSets, sizeof( CrgChannelStruct* ) );
+
+    ok = job.src && job.pos && job.channels;
+
+    /* --- all data sets share the u increment and the long sections of the first one --- */
+    for ( k = 0; ok && k < noDataSets; k++ )
+    {
+        if ( !( job.src[k] = crgDataSetAccess( dataSetIds[k] ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetAppend: invalid data set id <%d>.\n", dataSetIds[k] );
+            ok = 0;
+            break;
+        }
+
+        if ( !checkGrid( job.src[k], "crgDataSetAppend" ) )
+        {
+            ok = 0;
+            break;
+        }
+
+        first = job.src[0];
+
+        if ( fabs( job.src[k]->channelU.info.inc - first->channelU.info.inc ) > dViewIncTol * first->channelU.info.inc )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetAppend: u increment of data set <%d> differs from that of data set <%d>.\n",
+                         dataSetIds[k], dataSetIds[0] );
+            ok = 0;
+            break;
+        }
+
+        ok = job.src[k]->channelV.info.size == first->channelV.info.size;
+
+        for ( i = 0; ok && i < first->channelV.info.size; i++ )
+            ok = fabs( job.src[k]->channelV.data[i] - first->channelV.data[i] ) <= dViewPosTol;
+
+        if ( !ok )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetAppend: long sections of data set <%d> differ from those of data set <%d>.\n",
+                         dataSetIds[k], dataSetIds[0] );
+            break;
+        }
+
+        /* --- the last cross section of a data set is the first one of its successor --- */
+        job.pos[k] = k ? job.pos[k-1] + job.src[k-1]->channelU.info.size - 1 : 0;
+    }
+
+    if ( !ok )
+    {
+        crgFree( job.src );
+        crgFree( job.pos );
+        crgFree( job.channels );
+        return 0;
+    }
+
+    first  = job.src[0];
+    job.nu = job.pos[noDataSets - 1] + job.src[noDataSets - 1]->channelU.info.size;
+    job.nv = first->channelV.info.size;
+
+    if ( !( dst = crgDataSetCreate() ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataSetAppend: could not create data set\n" );
+        crgFree( job.src );
+        crgFree( job.pos );
+        crgFree( job.channels );
+        return 0;
+    }
+
+    /* --- from here on, the data set is released as a whole if anything fails --- */
+    job.dst = dst;
+    id      = dst->admin.id;
+
+    dst->admin.dataFormat = first->admin.dataFormat;
+    dst->admin.defMask    = ( first->admin.defMask & ~( dCrgDataDefSlopeEnd | dCrgDataDefBankEnd | dCrgDataDefZEnd ) ) |
+                            dCrgDataDefXEnd | dCrgDataDefYEnd;
+    dst->admin.gridLayout = dCrgGridLayoutContiguous;
+    dst->noChannels       = first->noChannels;
+    dst->util             = first->util;
+
+    for ( k = 1; k < noDataSets; k++ )
+        dst->util.hasBank = dst->util.hasBank || job.src[k]->util.hasBank;
+
+    dst->channelU.info      = first->channelU.info;
+    dst->channelU.info.size = job.nu;
+    dst->channelU.info.last = first->channelU.info.first + first->channelU.info.inc * ( job.nu - 1 );
+
+    ok = copyChannel( &( dst->channelV ), &( first->channelV ), 0, job.nv ) && appendRefLine( &job );
+
+    /* --- slope and banking as they are, the reference line elevation without steps --- */
+    for ( k = 0; k < noDataSets; k++ )
+        job.channels[k] = &( job.src[k]->channelSlope );
+
+    ok = ok && appendChannel( &job, &( dst->channelSlope ), 0 );
+
+    for ( k = 0; k < noDataSets; k++ )
+        job.channels[k] = &( job.src[k]->channelBank );
+
+    ok = ok && appendChannel( &job, &( dst->channelBank ), 0 );
+
+    for ( k = 0; k < noDataSets; k++ )
+        job.channels[k] = &( job.src[k]->channelRefZ );
+
+    ok = ok && appendChannel( &job, &( dst->channelRefZ ), 1 );
+
+    if ( dst->channelSlope.data )
+        dst->admin.defMask |= dCrgDataDefSlopeEnd;
+
+    if ( dst->channelBank.data )
+        dst->admin.defMask |= dCrgDataDefBankEnd;
+
+    /* --- the grid; channel means of the sources are part of the new values --- */
+    if ( ok )
+        ok = ( dst->channelZ = ( CrgChannelFStruct* ) crgCalloc( job.nv + 1, sizeof( CrgChannelFStruct ) ) ) != NULL;
+
+    for ( i = 0; ok && i < job.nv; i++ )
+    {
+        dst->channelZ[i].info.valid      = 1;
+        dst->channelZ[i].info.defined    = 1;
+        dst->channelZ[i].info.singlePrec = 1;
+        dst->channelZ[i].info.index      = i;
+        dst->channelZ[i].info.size       = job.nu;
+    }
+
+    if ( ok )
+        ok = crgLoaderAllocateGrid( dst );
+
+    if ( !ok )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetAppend: could not append %d data sets.\n", noDataSets );
+        crgFree( job.src );
+        crgFree( job.pos );
+        crgFree( job.channels );
+        crgDataSetRelease( id );
+        return 0;
+    }
+
+    appendGrid( &job );
+
+    completeDataSet( dst, first );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetAppend: data set <%d> appended from %d data sets with %ld x %ld samples\n",
+                 id, noDataSets, ( long ) job.nu, ( long ) job.nv );
+
+    crgFree( job.src );
+    crgFree( job.pos );
+    crgFree( job.channels );
+
+    return id;
+}
+
+static int
+checkGrid( CrgDataStruct* crgData, const char* func )
+{
+    if ( crgData->admin.headerOnly )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "%s: data of data set <%d> has not been read.\n", func, crgData->admin.id );
+        return 0;
+    }
+
+    if ( crgData->gridQuant.valid || crgData->gridStream.valid )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "%s: grid of data set <%d> is quantized or streamed.\n", func, crgData->admin.id );
+        return 0;
+    }
+
+    if ( !crgData->channelZ || !crgData->channelV.data || !crgData->channelX.data || !crgData->channelY.data ||
+         crgData->channelU.info.size < 2 || crgData->channelV.info.size < 2 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "%s: data set <%d> is incomplete.\n", func, crgData->admin.id );
+        return 0;
+    }
+
+    return 1;
+}
+
+static int
+copyChannel( CrgChannelStruct* dst, const CrgChannelStruct* src, size_t beg, size_t size )
+{
+    dst->info = src->info;
+
+    if ( !src->data )
+        return 1;
+
+    if ( !( dst->data = ( double* ) crgCalloc( size, sizeof( double ) ) ) )
+        return 0;
+
+    memcpy( dst->data, src->data + beg, size * sizeof( double ) );
+
+    dst->info.size  = size;
+    dst->info.first = dst->data[0];
+    dst->info.last  = dst->data[size - 1];
+
+    return 1;
+}
+
+static void
+completeDataSet( CrgDataStruct* dst, CrgDataStruct* src )
+{
+    /* --- settings of the source; modifiers which have been applied must not be applied again --- */
+    crgOptionCopyAll( &( dst->options ), &( src->options ) );
+    crgOptionRemoveAll( &( dst->modifiers ) );
+
+    dst->admin.modsApplied = 1;
+
+    /* --- the remaining steps of crgLoaderPrepareData(), the reference line is complete --- */
+    crgCalcStatistics( dst );
+    crgCalcUtilityData( dst );
+    crgEvalxy2uvBuildIndex( dst );
+    crgCalcRefLineGeom( dst );
+
+    /* --- initialize data-set specific history --- */
+    crgDataSetHistory( dst->admin.id, dCrgHistoryStdSize );
+}
+
+static int
+appendRefLine( CrgAppendJobStruct* job )
+{
+    CrgDataStruct* dst = job->dst;
+    CrgDataStruct* src;
+    double* x;
+    double* y;
+    double* phi = NULL;
+    double  angle = 0.0;
+    double  cosA;
+    double  sinA;
+    double  dx;
+    double  dy;
+    size_t  i;
+    size_t  p;
+    int     k;
+    int     hasPhi = 0;
+
+    for ( k = 0; k < job->noSrc; k++ )
+        hasPhi = hasPhi || job->src[k]->channelPhi.data;
+
+    dst->channelX.info   = job->src[0]->channelX.info;
+    dst->channelY.info   = job->src[0]->channelY.info;
+    dst->channelPhi.info = job->src[0]->channelPhi.info;
+
+    x = dst->channelX.data = ( double* ) crgCalloc( job->nu, sizeof( double ) );
+    y = dst->channelY.data = ( double* ) crgCalloc( job->nu, sizeof( double ) );
+
+    if ( hasPhi )
+        phi = dst->channelPhi.data = ( double* ) crgCalloc( job->nu, sizeof( double ) );
+
+    if ( !x || !y || ( hasPhi && !phi ) )
+        return 0;
+
+    /* --- each polygon is moved to the end of its predecessor and turned to continue its end heading --- */
+    for ( k = 0; k < job->noSrc; k++ )
+    {
+        src = job->src[k];
+        p   = job->pos[k];
+
+        if ( k )
+            angle += job->src[k-1]->channelPhi.info.last - src->channelPhi.info.first;
+
+        cosA = cos( angle );
+        sinA = sin( angle );
+
+        for ( i = k ? 1 : 0; i < src->channelU.info.size; i++ )
+        {
+            dx = src->channelX.data[i] - src->channelX.data[0];
+            dy = src->channelY.data[i] - src->channelY.data[0];
+
+            x[p + i] = k ? x[p] + cosA * dx - sinA * dy : src->channelX.data[i];
+            y[p + i] = k ? y[p] + sinA * dx + cosA * dy : src->channelY.data[i];
+
+            if ( phi )
+                phi[p + i] = ( src->channelPhi.data ? src->channelPhi.data[i] : src->channelPhi.info.first ) + angle;
+        }
+    }
+
+    dst->channelX.info.size  = job->nu;
+    dst->channelX.info.first = x[0];
+    dst->channelX.info.last  = x[job->nu - 1];
+    dst->channelY.info.size  = job->nu;
+    dst->channelY.info.first = y[0];
+    dst->channelY.info.last  = y[job->nu - 1];
+
+    /* --- the end heading of the last data set, in its new direction --- */
+    dst->channelPhi.info.last = job->src[job->noSrc - 1]->channelPhi.info.last + angle;
+
+    if ( !phi )
+    {
+        /* --- the file defines a curved polygon by its points --- */
+        dst->channelX.info.defined = 1;
+        dst->channelY.info.defined = 1;
+        return 1;
+    }
+
+    dst->channelPhi.info.valid   = 1;
+    dst->channelPhi.info.defined = 1;
+    dst->channelPhi.info.size    = job->nu;
+
+    return 1;
+}
+
+static int
+appendChannel( CrgAppendJobStruct* job, CrgChannelStruct* dst, int continuous )
+{
+    CrgChannelStruct* src;
+    double offset = 0.0;
+    double end    = 0.0;
+    size_t i;
+    int    k;
+    int    hasData = 0;
+
+    /* --- channels without data hold constants; data is needed if any channel has data or the constants differ --- */
+    for ( k = 0; k < job->noSrc; k++ )
+        hasData = hasData || job->channels[k]->data || ( !continuous && job->channels[k]->info.first != job->channels[0]->info.first );
+
+    dst->info = job->channels[0]->info;
+
+    if ( !hasData )
+        return 1;
+
+    if ( !( dst->data = ( double* ) crgCalloc( job->nu, sizeof( double ) ) ) )
+        return 0;
+
+    for ( k = 0; k < job->noSrc; k++ )
+    {
+        src = job->channels[k];
+
+        if ( continuous && k )
+            offset = end - ( src->data ? src->data[0] : src->info.first );
+
+        for ( i = k ? 1 : 0; i < job->src[k]->channelU.info.size; i++ )
+            dst->data[job->pos[k] + i] = ( src->data ? src->data[i] : src->info.first ) + offset;
+
+        end = dst->data[job->pos[k] + job->src[k]->channelU.info.size - 1];
+    }
+
+    dst->info.valid   = 1;
+    dst->info.defined = !continuous;
+    dst->info.size    = job->nu;
+    dst->info.first   = dst->data[0];
+    dst->info.last    = dst->data[job->nu - 1];
+
+    return 1;
+}
+
+static void
+appendGrid( CrgAppendJobStruct* job )
+{
+    CrgDataStruct* src;
+    size_t i;
+    size_t j;
+    size_t beg;
+    size_t size;
+    float* out;
+    const float* row;
+    double mean;
+    int    k;
+
+    for ( i = 0; i < job->nv; i++ )
+    {
+        out = job->dst->channelZ[i].data;
+
+        for ( k = 0; k < job->noSrc; k++ )
+        {
+            src  = job->src[k];
+            beg  = k ? 1 : 0;
+            size = src->channelU.info.size - beg;
+            row  = src->channelZ[i].data + beg;
+            mean = src->channelZ[i].info.mean;
+
+            if ( mean == 0.0 )
+                memcpy( out + job->pos[k] + beg, row, size * sizeof( float ) );
+            else
+                for ( j = 0; j < size; j++ )
+                    out[job->pos[k] + beg + j] = ( float ) ( row[j] + mean );
+        }
+    }
+}
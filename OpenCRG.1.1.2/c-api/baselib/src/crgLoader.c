@@ -34,9 +34,17 @@
 #include <ctype.h>
 #include <math.h>
 
+#if defined( __unix__ ) || defined( __APPLE__ )
+#    define dCrgLoaderUseMmap
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
 /* ====== DEFINITIONS ====== */
 #define dCrgLoaderMaxTagLen           128
 #define dCrgLoaderBufferLen          1024
+#define dCrgLoaderMaxPathLen         1024
+#define dCrgLoaderMaxEnvLen           256
 
 #define dOpcodeNone                     0
 #define dOpcodeRefLineStartU            1
@@ -77,6 +85,19 @@
 #define dDataFormatASCII           0x0010
 #define dDataFormatBinary          0x0020
 
+#define dMapReleaseChunk         0x100000   /* bytes of decoded file data to be unmapped at once */
+#define dHeaderReadChunk          0x10000   /* initial number of bytes read for parsing a header only */
+
+#define dAsciiTaskMinSize        0x400000   /* minimum size of ASCII data decoded by a single task   */
+#define dAsciiMaxTasks                 64   /* maximum number of concurrent ASCII decoding tasks      */
+#define dAsciiMaxFastDigits   ( ( sizeof( size_t ) < 8 ) ? 9 : 15 )   /* significant digits kept exact in the mantissa */
+#define dAsciiMaxFastExp               22   /* largest power of 10 which is exact in a double         */
+
+/* --- exact rounding of the fast number conversion requires evaluation in double precision --- */
+#if defined( __FLT_EVAL_METHOD__ ) && ( __FLT_EVAL_METHOD__ != 0 )
+#    define dAsciiNoFastConversion
+#endif
+
 #ifdef _WIN64
 #    define stat _stat64
 #elif _WIN32
@@ -93,12 +114,81 @@ typedef struct
     int  opcode;
 } CrgReaderCallbackStruct;
 
+typedef struct
+{
+    size_t nRec;
+    double uLast;
+    double duMin;
+    double duMax;
+    double xLast;
+    double yLast;
+    double dsMin;
+    double dsMax;
+    double sLast;
+} CrgCenterLineStatStruct;
+
+/**
+* cached positions of characters which end a search for a line break in ASCII data
+*/
+typedef struct
+{
+    char* dataEnd;      /* end of the data section                                    */
+    char* crFrom;       /* there is no '\r' in the range [crFrom, crPos)              */
+    char* crPos;        /* next '\r' or dataEnd                                       */
+    char* nulFrom;      /* there is no '\0' in the range [nulFrom, nulPos)            */
+    char* nulPos;       /* next '\0' or dataEnd                                       */
+} CrgLineScanStruct;
+
+/**
+* a record aligned part of the ASCII data section, decoded by a single task
+*/
+typedef struct
+{
+    char*  dataPtr;     /* first record of the chunk                                [-] */
+    size_t nBytesLeft;  /* bytes left in the data section at the first record       [-] */
+    size_t firstRec;    /* index of the first record                                [-] */
+    size_t noRecords;   /* number of records in the chunk                           [-] */
+    double* record;     /* record buffer of the task                                [-] */
+} CrgAsciiChunkStruct;
+
+/**
+* the job of decoding the ASCII data section, shared by all tasks
+*/
+typedef struct
+{
+    CrgDataStruct*       crgData;   /* the data set being read                     */
+    CrgAsciiChunkStruct* chunk;     /* one chunk per task                          */
+    double*              uData;     /* u values of all records, if u is defined    */
+} CrgAsciiJobStruct;
+
+/**
+* state of a single load operation, shared by the primary file and its include files
+*/
+typedef struct CrgLoaderContextStruct
+{
+    int  fileLevel;                             /* level at which current file is being read (for include files) */
+    int  optLevel;                              /* level at which current options have been defined              */
+    int  modLevel;                              /* level at which current modifiers have been defined            */
+    char includeFile[dCrgLoaderMaxPathLen];     /* name of the include file being composed                        */
+    char envVar[dCrgLoaderMaxEnvLen];           /* environment variable within the include file name              */
+    int  headerOnly;                            /* read the header of the primary file only                       */
+    int  needsData;                             /* the header alone does not describe the data set                */
+    size_t unreadBytes;                         /* bytes of the file beyond the buffer passed to the parser       */
+    int    gridLayout;                          /* memory layout of the elevation grid                            */
+    int    fileAccess;                          /* access method for the file data                                */
+    int    noThreads;                           /* threads for decoding ASCII data                                */
+    double gridQuantError;                      /* maximum error of the quantized grid, 0 = float grid            */
+    double streamBehind;                        /* road kept behind the active positions of streamed grids        */
+    double streamAhead;                         /* road read ahead of the active positions of streamed grids      */
+} CrgLoaderContextStruct;
+
 /* ====== LOCAL METHODS ====== */
 /**
 * initialize a data structure
 * @param crgData    pointer to the CRG data set which is to be initialized
+* @param ctx        context of the load operation
 */
-static void initData( CrgDataStruct* crgData );
+static void initData( CrgDataStruct* crgData, const CrgLoaderContextStruct* ctx );
 
 /**
 * clear temporary data
@@ -266,42 +356,72 @@ static size_t getLineFromData( char* dstBuffer, int dstSize, char* srcBuffer, si
 */
 static int parseFileHeader( CrgDataStruct* crgData, char **dataPtr, size_t* nBytesLeft );
 
+/**
+* initialize the cached search positions for line breaks in the data section
+* @param  scan        pointer to the search positions
+* @param  dataPtr     pointer to the data
+* @param  nBytesLeft  number of bytes in the data
+*/
+static void initLineScan( CrgLineScanStruct* scan, char* dataPtr, size_t nBytesLeft );
+
+/**
+* find the first occurrence of a character within a range of the data section,
+* re-using the result of previous searches while the range start has not passed it
+* @param  from        start of the cached range (will be altered)
+* @param  pos         cached position (will be altered)
+* @param  dataEnd     end of the data section
+* @param  ch          the character to search for
+* @param  startPtr    start of the range
+* @param  endPtr      end of the range
+* @return pointer to the character or NULL if it is not within the range
+*/
+static char* findCached( char** from, char** pos, char* dataEnd, int ch, char* startPtr, char* endPtr );
+
 /**
 * get pointer to the next data record from the input file
+* @param  scan        cached search positions for line breaks in the data section
 * @param  recordSize  size of a single record
 * @param  dataFormat  formatting of a single record
 * @param  dataPtr     pointer to the file data
 * @param  nBytesLeft  number of bytes left for interpretation
 * @return pointer to the data record
 */
-static char* getNextRecord( size_t recordSize, int dataFormat, char *dataPtr, size_t nBytesLeft );
+static char* getNextRecord( CrgLineScanStruct* scan, size_t recordSize, int dataFormat, char *dataPtr, size_t nBytesLeft );
+
+/**
+* convert a fixed width ASCII field into a number; the result is identical to atof()
+* in the "C" locale, fields which are not numbers result in NaN
+* @param  fieldPtr    pointer to the field
+* @param  length      width of the field
+* @return the value of the field
+*/
+static double decodeAsciiValue( const char* fieldPtr, size_t length );
 
 /**
 * decode a single data record
 * @param  crgData     pointer to the CRG data set which is to be altered
 * @param  dataPtr     pointer to the record data
 * @param  length      number of bytes in the record
+* @param  record      buffer for the decoded values (one per channel), NULL for checking the record only
 * @return 1 upon success, otherwise 0
 */
-static int decodeRecord( CrgDataStruct* crgData, char *dataPtr, size_t length );
+static int decodeRecord( CrgDataStruct* crgData, char *dataPtr, size_t length, double* record );
 
 /**
-* get the next data record and decode it
+* add the reference line information of a decoded record to the center line statistics
 * @param  crgData     pointer to the CRG data set which is to be altered
-* @param  dataPtr     pointer to the current record data (will be altered)
-* @param  length      number of bytes left for decoding (will be altered)
-* @return 1 upon success, otherwise 0
+* @param  record      the decoded record
+* @param  stat        pointer to the center line statistics
 */
-static int decodeNextRecord( CrgDataStruct* crgData, char **dataPtr, size_t *nBytesLeft );
+static void addCenterLineRecord( CrgDataStruct* crgData, double* record, CrgCenterLineStatStruct* stat );
 
 /**
-* parse the data section of the file for information about the center line
+* check the center line statistics and derive the reference line dimensions
 * @param  crgData     pointer to the CRG data set which is to be altered
-* @param  dataPtr     pointer to the file data
-* @param  nBytesLeft  number of bytes left for interpretation
+* @param  stat        pointer to the center line statistics
 * @return 1 upon success, otherwise 0
 */
-static int parseCenterLine( CrgDataStruct* crgData, char *dataPtr, size_t nBytesLeft );
+static int finishCenterLine( CrgDataStruct* crgData, CrgCenterLineStatStruct* stat );
 
 /**
 * allocate space for the actual channel data
@@ -310,10 +430,58 @@ static int parseCenterLine( CrgDataStruct* crgData, char *dataPtr, size_t nBytes
 static int allocateChannels( CrgDataStruct* crgData );
 
 /**
-* read the actual CRG data
+* copy the contents of a decoded record into the channels
+* @param  crgData     pointer to the CRG data set which is to be altered
+* @param  record      the decoded record
+* @param  nRec        index of the record
+*/
+static void storeRecord( CrgDataStruct* crgData, double* record, size_t nRec );
+
+/**
+* read ASCII CRG data: split the data section into record aligned chunks,
+* decode the chunks concurrently and derive the center line afterwards
+* @param  crgData     pointer to the CRG data set which is to be altered
+* @return 1 upon success, otherwise 0
+*/
+static int readAsciiData( CrgDataStruct* crgData );
+
+/**
+* decode one chunk of ASCII data into the channels
+* @param  data        the decoding job
+* @param  taskId      index of the chunk
+*/
+static void decodeAsciiChunk( void* data, int taskId );
+
+/**
+* read binary CRG data in a single pass, allocating the channels from the known record count;
+* the grid of a streamed data set is scanned only
+* @param  crgData     pointer to the CRG data set which is to be altered
+* @param  filename    name of the file holding the data section
+* @return 1 upon success, otherwise 0
+*/
+static int readBinaryData( CrgDataStruct* crgData, const char* filename );
+
+/**
+* map the file into memory (read-only private mapping)
+* @param  crgData     pointer to the CRG data set which is to be altered
+* @param  filename    name of the file
+* @param  size        size of the file
+* @return 1 if the file has been mapped, otherwise 0
+*/
+static int mapFile( CrgDataStruct* crgData, const char* filename, size_t size );
+
+/**
+* release the leading part of a mapped file up to the page containing the given position
+* @param  crgData     pointer to the CRG data set which is to be altered
+* @param  endPtr      pointer to the first byte which is still needed
+*/
+static void releaseFileRange( CrgDataStruct* crgData, const char* endPtr );
+
+/**
+* release the file data, regardless whether it is mapped or buffered
 * @param  crgData     pointer to the CRG data set which is to be altered
 */
-static void readData( CrgDataStruct* crgData );
+static void releaseFileBuffer( CrgDataStruct* crgData );
 
 /**
 * calculate the CRG reference line
@@ -378,9 +546,10 @@ static int isLittleEndian( void );
 static int crgStrBeginsWithStrNoCase( const char* str1, const char* str2 );
 
 /**
-* initialize the loader before reading the first file
+* initialize the context of a load operation with the current loader settings
+* @param ctx        context which is to be initialized
 */
-static void crgLoaderInit( void );
+static void initContext( CrgLoaderContextStruct* ctx );
 
 /**
 * decode a reference to an include file
@@ -395,9 +564,29 @@ static int decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int co
 * add data from a given file to existing data
 * @param filename   full filename of the CRG input file including path
 * @param crgData    pointer to the CRG data set which is to be allocated or altered
+* @param ctx        state of the running load operation
 * @return 1 if successful, otherwise 0 or error code
 */
-static int crgLoaderAddFile( const char* filename, CrgDataStruct** crgData );
+static int crgLoaderAddFile( const char* filename, CrgDataStruct** crgData, CrgLoaderContextStruct* ctx );
+
+/**
+* read and parse the header of a file without reading its data section
+* @param crgData    pointer to the CRG data set which is to be altered
+* @param fPtr       the open file
+* @param fileSize   size of the file                                         [byte]
+* @param dataPtr    pointer to the start of the data section in the file buffer
+* @param nBytesLeft size of the data section                                 [byte]
+* @return 1 if a data section was found, 0 if not, -1 upon errors
+*/
+static int readFileHeader( CrgDataStruct* crgData, FILE* fPtr, size_t fileSize, char** dataPtr, size_t* nBytesLeft );
+
+/**
+* derive the extent of the data section of a file whose header only has been read
+* @param crgData    pointer to the CRG data set which is to be altered
+* @param filename   full filename of the CRG input file including path
+* @return 1 if successful, otherwise 0
+*/
+static int readDataBounds( CrgDataStruct* crgData, const char* filename );
 
 /* ====== LOCAL VARIABLES ====== */
 
@@ -482,6 +671,23 @@ static CrgReaderCallbackStruct	sLoaderCallbacksMods[] =
    { "scale_curvature",      decodeHdrOpMod, dCrgModScaleCurvature          },
    { "grid_nan_mode",        decodeHdrOpMod, dCrgModGridNaNMode             },
    { "grid_nan_offset",      decodeHdrOpMod, dCrgModGridNaNOffset           },
+   { "grid_filter_mode",     decodeHdrOpMod, dCrgModFilterMode              },
+   { "grid_filter_size_u",   decodeHdrOpMod, dCrgModFilterSizeU             },
+   { "grid_filter_size_v",   decodeHdrOpMod, dCrgModFilterSizeV             },
+   { "grid_filter_weight",   decodeHdrOpMod, dCrgModFilterWeight            },
+   { "grid_filter_repeat",   decodeHdrOpMod, dCrgModFilterRepeat            },
+   { "grid_filter_u_begin",  decodeHdrOpMod, dCrgModFilterUBegin            },
+   { "grid_filter_u_end",    decodeHdrOpMod, dCrgModFilterUEnd              },
+   { "grid_filter_v_begin",  decodeHdrOpMod, dCrgModFilterVBegin            },
+   { "grid_filter_v_end",    decodeHdrOpMod, dCrgModFilterVEnd              },
+   { "grid_limit_z_min",     decodeHdrOpMod, dCrgModLimitZMin               },
+   { "grid_limit_z_max",     decodeHdrOpMod, dCrgModLimitZMax               },
+   { "grid_peak_limit",      decodeHdrOpMod, dCrgModPeakLimit               },
+   { "grid_peak_radius",     decodeHdrOpMod, dCrgModPeakRadius              },
+   { "grid_limit_u_begin",   decodeHdrOpMod, dCrgModLimitUBegin             },
+   { "grid_limit_u_end",     decodeHdrOpMod, dCrgModLimitUEnd               },
+   { "grid_limit_v_begin",   decodeHdrOpMod, dCrgModLimitVBegin             },
+   { "grid_limit_v_end",     decodeHdrOpMod, dCrgModLimitVEnd               },
    { "refline_rotcenter_x",  decodeHdrOpMod, dCrgModRefLineRotCenterX       },
    { "refline_rotcenter_y",  decodeHdrOpMod, dCrgModRefLineRotCenterY       },
    { "refline_offset_phi",   decodeHdrOpMod, dCrgModRefLineOffsetPhi        },
@@ -518,16 +724,24 @@ static CrgReaderCallbackStruct	sLoaderCallbacksFile[] =
 };
 
 /* ====== GLOBAL VARIABLES ====== */
-int mCrgBigEndian =  0;             /* internal data format is little endian per default */
+const CrgEndianUnion mCrgEndianTest = { 1 };   /* first byte is 0 on big endian machines */
 
 /* ====== LOCAL VARIABLES ====== */
-static int mFileLevel =  0;      /* level at which current file is being read (for include files) */
-static int mOptLevel  = -1;      /* level at which current options have been defined              */
-static int mModLevel  = -1;      /* level at which current modifiers have been defined            */
+/* --- settings for subsequent loads, copied into each load context under dCrgLockLoader --- */
+static int mGridLayout = dCrgGridLayoutRows;   /* memory layout of the elevation grid of new data sets */
+static int mFileAccess = dCrgFileAccessMapped; /* access method for the file data                      */
+static int mNoThreads  = 0;                    /* threads for decoding ASCII data, 0 = one per processor */
+static double mGridQuantError = 0.0;           /* maximum error of the quantized grid, 0 = float grid  */
+static double mStreamBehind   = 0.0;           /* road kept behind the active positions of streamed grids */
+static double mStreamAhead    = 0.0;           /* road read ahead of the active positions of streamed grids */
+
+static const double mPow10[dAsciiMaxFastExp + 1] = { 1.0e0,  1.0e1,  1.0e2,  1.0e3,  1.0e4,  1.0e5,  1.0e6,  1.0e7,
+                                                     1.0e8,  1.0e9,  1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15,
+                                                     1.0e16, 1.0e17, 1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22 };
 
 /* ====== IMPLEMENTATION ====== */
 static void
-initData( CrgDataStruct* crgData )
+initData( CrgDataStruct* crgData, const CrgLoaderContextStruct* ctx )
 {
     if ( !crgData )
         return;
@@ -537,6 +751,30 @@ initData( CrgDataStruct* crgData )
     crgData->channelV.info.inc = 0.01;
     
     crgData->admin.dataFormat = dDataFormatUndefined;
+    crgData->admin.gridLayout = ctx->gridLayout;
+}
+
+static void
+initContext( CrgLoaderContextStruct* ctx )
+{
+    memset( ctx, 0, sizeof( CrgLoaderContextStruct ) );
+    
+    /* --- set file level to base level (reading primary file ) --- */
+    ctx->fileLevel = 0;
+    ctx->optLevel  = -1;
+    ctx->modLevel  = -1;
+    
+    /* --- the settings apply to the complete load, even if they are changed meanwhile --- */
+    crgPortLock( dCrgLockLoader );
+    
+    ctx->gridLayout     = mGridLayout;
+    ctx->fileAccess     = mFileAccess;
+    ctx->noThreads      = mNoThreads ? mNoThreads : crgPortGetNoProcessors();
+    ctx->gridQuantError = mGridQuantError;
+    ctx->streamBehind   = mStreamBehind;
+    ctx->streamAhead    = mStreamAhead;
+    
+    crgPortUnlock( dCrgLockLoader );
 }
 
 static void
@@ -579,6 +817,8 @@ clearChannels( CrgDataStruct *crgData )
     clearChannel( ( CrgChannelBaseStruct* ) &( crgData->channelBank ) );
     
     /* clear the actual data channels */
+    crgLoaderReleaseGrid( crgData );
+    
     for ( i = 0; i < crgData->channelV.info.size; i++ )
         clearChannel( ( CrgChannelBaseStruct* ) &( crgData->channelZ[i] ) );
 
@@ -592,11 +832,10 @@ terminateReader( CrgDataStruct *crgData, int retCode )
         return retCode;
     
     clearTmpData( crgData );
+    releaseFileBuffer( crgData );
     
-    if ( crgData->admin.fileBuffer )
-        crgFree( crgData->admin.fileBuffer );
-    
-    crgData->admin.fileBuffer = NULL;
+    /* --- the context belongs to the load operation, not to the data set --- */
+    crgData->admin.loaderCtx = NULL;
     
     /* --- if return code is fail code, then delete all data, otherwise keep the channels --- */
     if ( retCode )
@@ -767,8 +1006,9 @@ decodeHdrOpMod( CrgDataStruct* crgData, const char* buffer, int opcode )
     char* bufPtr = ( char* ) strchr( buffer, '=' );
     
     /* --- is decoding of options and modifiers allowed at current level? --- */
-    int optionEnabled   = ( mFileLevel == 0 ) || ( mOptLevel == mFileLevel );
-    int modifierEnabled = ( mFileLevel == 0 ) || ( mModLevel == mFileLevel );
+    CrgLoaderContextStruct* ctx = crgData->admin.loaderCtx;
+    int optionEnabled   = ( ctx->fileLevel == 0 ) || ( ctx->optLevel == ctx->fileLevel );
+    int modifierEnabled = ( ctx->fileLevel == 0 ) || ( ctx->modLevel == ctx->fileLevel );
     
    crgMsgPrint( dCrgMsgLevelDebug, "decodeHdrOpMod: extracting option/modifier <%s> from <%s>\n", crgOptionGetName( opcode ), buffer );
    
@@ -869,6 +1109,18 @@ decodeHdrOpMod( CrgDataStruct* crgData, const char* buffer, int opcode )
         case dCrgModRefPointY:
         case dCrgModRefPointZ:
         case dCrgModRefPointPhi:
+        case dCrgModFilterWeight:
+        case dCrgModFilterUBegin:
+        case dCrgModFilterUEnd:
+        case dCrgModFilterVBegin:
+        case dCrgModFilterVEnd:
+        case dCrgModLimitZMin:
+        case dCrgModLimitZMax:
+        case dCrgModPeakLimit:
+        case dCrgModLimitUBegin:
+        case dCrgModLimitUEnd:
+        case dCrgModLimitVBegin:
+        case dCrgModLimitVEnd:
             if ( !modifierEnabled )
                 break;
             {
@@ -877,6 +1129,34 @@ decodeHdrOpMod( CrgDataStruct* crgData, const char* buffer, int opcode )
             }
             break;
             
+        case dCrgModFilterSizeU:
+        case dCrgModFilterSizeV:
+        case dCrgModFilterRepeat:
+        case dCrgModPeakRadius:
+            if ( !modifierEnabled )
+                break;
+            {
+                int iValue = atoi( ++bufPtr );
+                crgOptionSetInt( &( crgData->modifiers ), opcode, iValue );
+            }
+            break;
+            
+        case dCrgModFilterMode:
+            if ( !modifierEnabled )
+                break;
+            {
+                int iValue = atoi( ++bufPtr );
+                
+                /* --- a mask set by the API cannot be given in a file --- */
+                if ( iValue < dCrgFilterNone || iValue > dCrgFilterLaplace )
+                {
+                    crgMsgPrint( dCrgMsgLevelWarn, "decodeHdrOpMod: unhandled value for modifier <%s>\n", crgOptionGetName( opcode ) );
+                    return 0;
+                }
+                crgOptionSetInt( &( crgData->modifiers ), opcode, iValue );
+            }
+            break;
+            
         case dCrgModGridNaNMode:
             if ( !modifierEnabled )
                 break;
@@ -924,6 +1204,8 @@ decodeHdrOpMod( CrgDataStruct* crgData, const char* buffer, int opcode )
 static int
 setSection( CrgDataStruct* crgData, const char* buffer, int newSection )
 {
+    CrgLoaderContextStruct* ctx = crgData->admin.loaderCtx;
+    
    /* --- changing from none or to none? --- */
     if ( ( crgData->admin.sectionType == dFileSectionNone ) || ( newSection == dFileSectionNone ) )
     {
@@ -938,10 +1220,10 @@ setSection( CrgDataStruct* crgData, const char* buffer, int newSection )
                 
                 /* options may always be defined by the top level file; they may be defined by lower
                    level files only if no options have yet been defined by top level file            */
-                if ( mFileLevel == 0 || mOptLevel < 0 )
+                if ( ctx->fileLevel == 0 || ctx->optLevel < 0 )
                 {
                     crgOptionSetDefaultOptions( &( crgData->options ) );
-                    mOptLevel = mFileLevel;
+                    ctx->optLevel = ctx->fileLevel;
                 }
                 break;
                 
@@ -950,12 +1232,12 @@ setSection( CrgDataStruct* crgData, const char* buffer, int newSection )
                 crgMsgPrint( dCrgMsgLevelDebug, "setSection: restoring default modifiers\n" );
                 /* modifiers may always be defined by the top level file; they may be defined by lower
                    level files only if no modifiers have yet been defined by top level file            */
-                if ( mFileLevel == 0 || mModLevel < 0 )
+                if ( ctx->fileLevel == 0 || ctx->modLevel < 0 )
                 {
                     /* new policy: clear all options upon first occurence of option block and don't define any default options */
                     /* crgOptionSetDefaultModifiers( &( crgData->modifiers ) ); */
                     crgOptionRemoveAll( &( crgData->modifiers ) );
-                    mModLevel = mFileLevel;
+                    ctx->modLevel = ctx->fileLevel;
                 }
                 break;
                 
@@ -1304,11 +1586,18 @@ calcRecordSize( CrgDataStruct* crgData )
 static size_t
 getLineFromData( char* dstBuffer, int dstSize, char* srcBuffer, size_t srcSize ) 
 {
-    char *tgtPtr  = strchr( srcBuffer, '\n' );
-    char *testPtr = strchr( srcBuffer, '\r' );
+    char   *nulPtr     = ( char* ) memchr( srcBuffer, '\0', dstSize );
+    size_t searchSize = nulPtr ? ( size_t ) ( nulPtr - srcBuffer ) : ( size_t ) dstSize;
+    char   *tgtPtr     = ( char* ) memchr( srcBuffer, '\n', searchSize );
+    char   *testPtr    = ( char* ) memchr( srcBuffer, '\r', searchSize );
     
     size_t  xferSize; 
     
+    /* --- line breaks beyond the destination size cannot change the result, so the search is limited to it;   --- */
+    /* --- only a '\r' without any '\n' up to the end of the data needs to look further                        --- */
+    if ( !tgtPtr && testPtr && !nulPtr )
+        tgtPtr = strchr( srcBuffer + searchSize, '\n' );
+    
     tgtPtr = ( testPtr && ( testPtr < tgtPtr ) ) ? testPtr : tgtPtr;
     
     if ( tgtPtr )
@@ -1342,12 +1631,12 @@ parseFileHeader( CrgDataStruct* crgData, char **dataPtr, size_t* nBytesLeft )
     int    (*func)( CrgDataStruct*, const char *, int );
     int    opcode;
     size_t bytesRead;
+    size_t fileBytesLeft;
     int    lineOfFile = 0;
     CrgReaderCallbackStruct *cbs = sLoaderCallbacksCommon;
+    CrgLoaderContextStruct  *ctx = crgData->admin.loaderCtx;
 
-    /* --- initialize the section indicator --- */
-    crgData->admin.sectionType = dFileSectionNone;
-    
+    /* --- the section indicator is initialized by the caller, so the parser may resume at any line --- */
     while ( srcBytesLeft )
     {
         bytesRead = getLineFromData( buffer, sizeof( buffer ), srcPtr, srcBytesLeft );
@@ -1425,21 +1714,27 @@ parseFileHeader( CrgDataStruct* crgData, char **dataPtr, size_t* nBytesLeft )
                     {
                         calcRecordSize( crgData );
                         
+                        /* --- the file may continue beyond the parsed buffer if the header only has been read --- */
+                        fileBytesLeft = srcBytesLeft + ctx->unreadBytes;
+                        
                         /* --- the number of bytes to be read may differ from the remaining file size due to alignment issues --- */
                         /* --- therefore, calculate the maximum size which is to be read                                      --- */
                         if ( crgData->admin.dataFormat & dDataFormatBinary )
                         {
                             *nBytesLeft = crgData->admin.recordSize * ( ( size_t ) ( ( crgData->channelU.info.last - crgData->channelU.info.first ) / crgData->channelU.info.inc + 0.5 ) + 1 );
                             
-                            if ( *nBytesLeft > srcBytesLeft )
+                            if ( *nBytesLeft > fileBytesLeft )
+                            {
                                 crgMsgPrint( dCrgMsgLevelWarn, "parseFileHeader: data section seems too small! Expecting %ld bytes but only have %ld bytes. Reading available data only.\n",
-                                                                *nBytesLeft, srcBytesLeft );
+                                                                *nBytesLeft, fileBytesLeft );
+                                *nBytesLeft = fileBytesLeft;
+                            }
                         }
                         else
-                            *nBytesLeft = srcBytesLeft;
+                            *nBytesLeft = fileBytesLeft;
                         
 
-                        crgMsgPrint( dCrgMsgLevelInfo, "parseFileHeader: (max.) nBytesLeft = %ld, srcBytesLeft = %ld\n", *nBytesLeft, srcBytesLeft );
+                        crgMsgPrint( dCrgMsgLevelInfo, "parseFileHeader: (max.) nBytesLeft = %ld, srcBytesLeft = %ld\n", *nBytesLeft, fileBytesLeft );
                         /* --- reading the data section is business of another method --- */
                         *dataPtr = srcPtr;
                         return 1;
@@ -1455,8 +1750,34 @@ parseFileHeader( CrgDataStruct* crgData, char **dataPtr, size_t* nBytesLeft )
     return 0;
 }
 
+static void
+initLineScan( CrgLineScanStruct* scan, char* dataPtr, size_t nBytesLeft )
+{
+    scan->dataEnd = dataPtr + nBytesLeft;
+    scan->crFrom  = NULL;
+    scan->crPos   = NULL;
+    scan->nulFrom = NULL;
+    scan->nulPos  = NULL;
+}
+
+static char*
+findCached( char** from, char** pos, char* dataEnd, int ch, char* startPtr, char* endPtr )
+{
+    /* --- a single search up to the end of the data serves all ranges starting before the match --- */
+    if ( !*pos || startPtr < *from || startPtr > *pos )
+    {
+        *from = startPtr;
+        *pos  = ( startPtr < dataEnd ) ? ( char* ) memchr( startPtr, ch, dataEnd - startPtr ) : NULL;
+        
+        if ( !*pos )
+            *pos = dataEnd;
+    }
+    
+    return ( *pos < endPtr && *pos < dataEnd ) ? *pos : NULL;
+}
+
 static char* 
-getNextRecord( size_t recordSize, int dataFormat, char *dataPtr, size_t nBytesLeft )
+getNextRecord( CrgLineScanStruct* scan, size_t recordSize, int dataFormat, char *dataPtr, size_t nBytesLeft )
 {
     size_t i;
     
@@ -1492,20 +1813,16 @@ getNextRecord( size_t recordSize, int dataFormat, char *dataPtr, size_t nBytesLe
         for ( i = 0; i < noLines && dataPtr && nBytesLeft; i++ )
         {
             char *oldDataPtr = dataPtr;
-            char *termPtr    = ( nBytesLeft > ( size_t ) ( 2 * recordSize ) ) ? ( dataPtr + 2 * recordSize ) : NULL;
-            char termChar    = 0;
+            char *termPtr    = ( nBytesLeft > ( size_t ) ( 2 * recordSize ) ) ? ( dataPtr + 2 * recordSize ) : scan->dataEnd;
             char *testPtr    = NULL;
             
-            /* --- search for line termination in data set; temporarily terminate data set in order to increase search speed --- */
-            /* --- otherwise - in long data sets - strchr() will be very slow                                                --- */
-            if ( termPtr )
-            {
-                termChar = *termPtr;
-                *termPtr = '\0';
-            }
-                
-            dataPtr = strchr( oldDataPtr, '\n' );
-            testPtr = strchr( oldDataPtr, '\r' );
+            /* --- search for line termination within twice the record size or up to the end of the data; --- */
+            /* --- the data is not altered, so concurrent readers may share it                            --- */
+            if ( ( testPtr = findCached( &scan->nulFrom, &scan->nulPos, scan->dataEnd, '\0', oldDataPtr, termPtr ) ) )
+                termPtr = testPtr;
+            
+            dataPtr = ( char* ) memchr( oldDataPtr, '\n', termPtr - oldDataPtr );
+            testPtr = findCached( &scan->crFrom, &scan->crPos, scan->dataEnd, '\r', oldDataPtr, termPtr );
     
             if ( testPtr )
                 dataPtr = ( testPtr < dataPtr ) ? dataPtr : testPtr;
@@ -1515,10 +1832,6 @@ getNextRecord( size_t recordSize, int dataFormat, char *dataPtr, size_t nBytesLe
                 dataPtr++;
                 nBytesLeft -= dataPtr - oldDataPtr;
             }
-            
-            /* --- restore terminated string --- */
-            if ( termPtr )
-                *termPtr = termChar;
         }
         return dataPtr;
     }
@@ -1529,14 +1842,144 @@ getNextRecord( size_t recordSize, int dataFormat, char *dataPtr, size_t nBytesLe
     return NULL;
 }
 
+static double
+decodeAsciiValue( const char* fieldPtr, size_t length )
+{
+    const char* ptr        = fieldPtr;
+    const char* endPtr     = fieldPtr + length;
+    const char* expPtr;
+    char        tmpStr[32];
+    double      value;
+    size_t      mantissa   = 0;
+    int         noDigits   = 0;     /* significant digits contained in mantissa        */
+    int         noZeros    = 0;     /* zeros not yet applied to the mantissa           */
+    int         exp10      = 0;
+    int         expValue   = 0;
+    int         expSign    = 1;
+    int         negative   = 0;
+    int         isNumber   = 0;
+    int         isExact    = 1;
+    int         isFraction = 0;
+    
+    /* --- the number follows the syntax of strtod(), parsing stops at the first character not matching --- */
+    while ( ptr < endPtr && *ptr == ' ' )
+        ptr++;
+    
+    if ( ptr < endPtr && ( *ptr == '+' || *ptr == '-' ) )
+        negative = ( *ptr++ == '-' );
+    
+    /* --- digits are collected in an exact integer mantissa, trailing zeros go to the exponent --- */
+    for ( ; ptr < endPtr; ptr++ )
+    {
+        if ( *ptr >= '0' && *ptr <= '9' )
+        {
+            isNumber = 1;
+            exp10   -= isFraction;
+            
+            if ( *ptr == '0' )
+            {
+                if ( noDigits )
+                    noZeros++;
+            }
+            else if ( noDigits + noZeros < dAsciiMaxFastDigits )
+            {
+                for ( ; noZeros; noZeros-- )
+                {
+                    mantissa *= 10;
+                    noDigits++;
+                }
+                mantissa = 10 * mantissa + ( *ptr - '0' );
+                noDigits++;
+            }
+            else
+                isExact = 0;
+        }
+        else if ( *ptr == '.' && !isFraction )
+            isFraction = 1;
+        else
+            break;
+    }
+    
+    /* --- an exponent is only valid with at least one digit --- */
+    if ( isNumber && ptr < endPtr && ( *ptr == 'e' || *ptr == 'E' ) )
+    {
+        expPtr = ptr + 1;
+        
+        if ( expPtr < endPtr && ( *expPtr == '+' || *expPtr == '-' ) )
+            expSign = ( *expPtr++ == '-' ) ? -1 : 1;
+        
+        if ( expPtr < endPtr && *expPtr >= '0' && *expPtr <= '9' )
+        {
+            for ( ; expPtr < endPtr && *expPtr >= '0' && *expPtr <= '9'; expPtr++ )
+                if ( expValue < 10000 )
+                    expValue = 10 * expValue + *expPtr - '0';
+            
+            exp10 += expSign * expValue;
+            ptr    = expPtr;
+        }
+    }
+    
+    /* --- check for missing values or NaNs; like a string, the field ends at a '\0' --- */
+    for ( ; ptr < endPtr && *ptr; ptr++ )
+    {
+        if ( ( *ptr >= '0' && *ptr <= '9' ) || *ptr == ' ' || *ptr == '.' || *ptr == '+' || *ptr == '-' ||
+               *ptr == 'e' || *ptr == 'E' || *ptr == 'd' || *ptr == 'D' )
+            continue;
+        
+        while ( ptr < endPtr && *ptr )
+            ptr++;
+        
+        if ( ( ptr - fieldPtr == 10 ) && !strncmp( fieldPtr, "**unused**", 10 ) )
+            return 0.0;
+        
+        crgSetNan( &value );
+        return value;
+    }
+    
+    /* --- no conversion at all --- */
+    if ( !isNumber )
+        return 0.0;
+    
+    exp10 += noZeros;
+    
+#ifdef dAsciiNoFastConversion
+    isExact = 0;
+#endif
+    
+    /* --- an exact mantissa scaled by an exact power of 10 is rounded only once, which --- */
+    /* --- yields the correctly rounded result of the C library's conversion            --- */
+    if ( isExact )
+    {
+        value = ( double ) mantissa;
+        
+        if ( !mantissa )
+            value = 0.0;
+        else if ( exp10 >= 0 && exp10 <= dAsciiMaxFastExp )
+            value *= mPow10[exp10];
+        else if ( exp10 < 0 && exp10 >= -dAsciiMaxFastExp )
+            value /= mPow10[-exp10];
+        else
+            isExact = 0;
+    }
+    
+    if ( !isExact )
+    {
+        memcpy( tmpStr, fieldPtr, length );
+        tmpStr[length] = '\0';
+        
+        return atof( tmpStr );
+    }
+    
+    return negative ? -value : value;
+}
+
 static int
-decodeRecord( CrgDataStruct* crgData, char* dataPtr, size_t nBytes )
+decodeRecord( CrgDataStruct* crgData, char* dataPtr, size_t nBytes, double* record )
 {
     size_t i;
     double value;
     float  fValue;
     size_t nBytesLeft = nBytes;
-    char   tmpStr[32];
     size_t length;
     
     if ( crgData->admin.dataFormat & dDataFormatASCII )
@@ -1568,19 +2011,12 @@ decodeRecord( CrgDataStruct* crgData, char* dataPtr, size_t nBytes )
                     return 0;
             }
             
-            strncpy( tmpStr, dataPtr, length );
-            tmpStr[length] = '\0';
-            
-            /* check for missing values or NaNs */
-            if ( strspn( tmpStr, "0123456789+-.eEdD " ) != strlen( tmpStr ) )
-            {
-                if ( !strcmp( tmpStr, "**unused**" ) )
-                    value = 0.0;
-                else
-                    crgSetNan( &value );
-            }
-            else
-                value = atof( tmpStr );
+            if ( record )
+                value = decodeAsciiValue( dataPtr, length );
+        }
+        else if ( !record )
+        {
+            /* --- binary values need no checking --- */
         }
         else if ( crgData->admin.dataFormat & dDataFormatPrecisionDouble )
         {
@@ -1595,7 +2031,8 @@ decodeRecord( CrgDataStruct* crgData, char* dataPtr, size_t nBytes )
                 value = fValue;
         }
         
-        memcpy( &( crgData->admin.recordBuffer[i] ), &value, sizeof( value ) );
+        if ( record )
+            memcpy( &( record[i] ), &value, sizeof( value ) );
         
         dataPtr    += length;
         nBytesLeft -= length;
@@ -1603,102 +2040,55 @@ decodeRecord( CrgDataStruct* crgData, char* dataPtr, size_t nBytes )
     return 1;
 }
 
-static int 
-decodeNextRecord( CrgDataStruct* crgData, char **dataPtr, size_t *nBytesLeft )
+static void
+addCenterLineRecord( CrgDataStruct* crgData, double* record, CrgCenterLineStatStruct* stat )
 {
-    char   *recPtr    = *dataPtr;        /* pointer to begin of record */
-    size_t nBytesRead = 0;
-    
-    if ( ! ( recPtr = getNextRecord( crgData->admin.recordSize, crgData->admin.dataFormat, *dataPtr, *nBytesLeft ) ) )
-        return 0;
-   
-    nBytesRead = recPtr - *dataPtr;
-
-    /* --- decode the record --- */
-    if ( !decodeRecord( crgData, *dataPtr, nBytesRead ) )
-    {
-        crgMsgPrint( dCrgMsgLevelDebug, "decodeNextRecord: error parsing data record.\n" );
-        return 0;
-    }
-        
-    /* --- go to the next frame --- */
-    *dataPtr     = recPtr;
-    *nBytesLeft -= nBytesRead;
-        
-    /* this cannot happen */
-    /*
-    if ( *nBytesLeft < 0 )
-    {
-        crgMsgPrint( dCrgMsgLevelFatal, "decodeNextRecord: data access error.\n" );
-        return 0;
-    }
-    */
-    return 1;
-}
-
-static int 
-parseCenterLine( CrgDataStruct* crgData, char *dataPtr, size_t nBytesLeft )
-{
-    char   *recPtr      = dataPtr;        /* pointer to begin of record */
-    size_t srcBytesLeft = nBytesLeft;
-    size_t nRec = 0;
-    double uLast = 0.0;
-    double duMin = 0.0;
-    double duMax = 0.0;
     double du;
-    double xLast = 0.0;
-    double yLast = 0.0;
     double dx;
     double dy;
     double ds;
-    double dsMin = 0.0;
-    double dsMax = 0.0;
-    double sLast = 0.0;
     
-    /* --- parse through all records --- */
-    while ( decodeNextRecord( crgData, &recPtr, &srcBytesLeft ) )
+    stat->nRec++;
+    
+    if ( crgData->channelU.info.defined )
     {
-        nRec++;
-        
-        if ( crgData->channelU.info.defined )
+        if ( stat->nRec == 1 )
+            crgData->channelU.info.first = record[crgData->channelU.info.index];
+        else
         {
-            if ( nRec == 1 )
-                crgData->channelU.info.first = crgData->admin.recordBuffer[crgData->channelU.info.index];
-            else
-            {
-                du = crgData->admin.recordBuffer[crgData->channelU.info.index] - uLast;
-                if ( nRec == 2 || du < duMin ) 
-                    duMin = du;
-                if ( nRec == 2 || du > duMax )
-                    duMax = du;
-            }
-            uLast = crgData->admin.recordBuffer[crgData->channelU.info.index];
+            du = record[crgData->channelU.info.index] - stat->uLast;
+            if ( stat->nRec == 2 || du < stat->duMin ) 
+                stat->duMin = du;
+            if ( stat->nRec == 2 || du > stat->duMax )
+                stat->duMax = du;
         }
-        
-        if ( crgData->channelX.info.defined )
+        stat->uLast = record[crgData->channelU.info.index];
+    }
+    
+    if ( crgData->channelX.info.defined )
+    {
+        if ( stat->nRec > 1 )
         {
-            if ( nRec > 1 )
-            {
-                dx = crgData->admin.recordBuffer[crgData->channelX.info.index] - xLast;
-                dy = crgData->admin.recordBuffer[crgData->channelY.info.index] - yLast;
-                ds = sqrt( dx * dx + dy * dy );
-                
-                if ( nRec == 2 || ds < dsMin ) 
-                    dsMin = ds;
-                if ( nRec == 2 || ds > dsMax )
-                    dsMax = ds;
-                
-                sLast += ds;
-            }
-            xLast = crgData->admin.recordBuffer[crgData->channelX.info.index];
-            yLast = crgData->admin.recordBuffer[crgData->channelY.info.index];
+            dx = record[crgData->channelX.info.index] - stat->xLast;
+            dy = record[crgData->channelY.info.index] - stat->yLast;
+            ds = sqrt( dx * dx + dy * dy );
+            
+            if ( stat->nRec == 2 || ds < stat->dsMin ) 
+                stat->dsMin = ds;
+            if ( stat->nRec == 2 || ds > stat->dsMax )
+                stat->dsMax = ds;
+            
+            stat->sLast += ds;
         }
-        
-        /*
-        if ( nBytesLeft )
-            crgMsgPrint( dCrgMsgLevelNotice, "MMM: parseCenterLine: read %.3f %% of data\n", ( 100.0f * ( nBytesLeft - srcBytesLeft ) ) / nBytesLeft );
-        */
+        stat->xLast = record[crgData->channelX.info.index];
+        stat->yLast = record[crgData->channelY.info.index];
     }
+}
+
+static int
+finishCenterLine( CrgDataStruct* crgData, CrgCenterLineStatStruct* stat )
+{
+    size_t nRec = stat->nRec;
     
     /* --- check (x, y) channel consistency --- */
     if ( crgData->channelX.info.defined )
@@ -1708,22 +2098,22 @@ parseCenterLine( CrgDataStruct* crgData, char *dataPtr, size_t nBytesLeft )
         crgData->channelY.info.size = nRec;
         
         /* --- minimum s spacing must be larger than 1.e-6m --- */
-        if ( dsMin < 1.0e-6 )
+        if ( stat->dsMin < 1.0e-6 )
         {
             crgMsgPrint( dCrgMsgLevelFatal, "parseCenterLine: reference line s spacing too small.\n" );
             return 0;
         }
         
         /* --- relative spacing tolerance must be smaller than 3.e-2 --- */
-        if ( ( dsMax - dsMin ) / dsMin > 3.e-2 )
+        if ( ( stat->dsMax - stat->dsMin ) / stat->dsMin > 3.e-2 )
         {
             crgMsgPrint( dCrgMsgLevelFatal, "parseCenterLine: non-constant reference line s spacing.\n" );
             return 0;
         }
         
         /* --- set u spacing --- */
-        crgData->channelU.info.inc  = sLast / ( crgData->channelX.info.size - 1 );
-        crgData->channelU.info.last = sLast;
+        crgData->channelU.info.inc  = stat->sLast / ( crgData->channelX.info.size - 1 );
+        crgData->channelU.info.last = stat->sLast;
         crgData->channelU.info.size = crgData->channelX.info.size;
     }
     /* --- check u channel consistency --- */
@@ -1733,22 +2123,22 @@ parseCenterLine( CrgDataStruct* crgData, char *dataPtr, size_t nBytesLeft )
         crgData->channelU.info.size = nRec;
         
         /* --- minimum u spacing must be larger than 1.e-6m --- */
-        if ( duMin < 1.0e-6 )
+        if ( stat->duMin < 1.0e-6 )
         {
             crgMsgPrint( dCrgMsgLevelFatal, "parseCenterLine: reference line u spacing too small.\n" );
             return 0;
         }
         
         /* --- relative spacing tolerance must be smaller than 3.e-2 --- */
-        if ( ( duMax - duMin ) / duMin > 3.e-2 )
+        if ( ( stat->duMax - stat->duMin ) / stat->duMin > 3.e-2 )
         {
             crgMsgPrint( dCrgMsgLevelFatal, "parseCenterLine: non-constant reference line u spacing.\n" );
             return 0;
         }
         
         /* --- calculate u increment --- */
-        crgData->channelU.info.last = uLast;
-        crgData->channelU.info.inc  = ( crgData->channelU.info.last - crgData->channelU.info.first ) / duMax;
+        crgData->channelU.info.last = stat->uLast;
+        crgData->channelU.info.inc  = ( crgData->channelU.info.last - crgData->channelU.info.first ) / stat->duMax;
     }
     else
     {
@@ -1778,16 +2168,10 @@ allocateChannels( CrgDataStruct* crgData )
     
     crgMsgPrint( dCrgMsgLevelDebug, "allocateChannels: crgData->channelU.info.size = %ld\n", crgData->channelU.info.size );
     
-    /* --- the z channels --- */
-    for( i = 0; i < crgData->channelV.info.size; i++ )
-    {        
-        /* copy size information */
-        crgData->channelZ[i].info.size = crgData->channelU.info.size;
-        
-        if ( !( crgData->channelZ[i].data = ( float* ) crgCalloc( crgData->channelZ[i].info.size, sizeof( float ) ) ) )
-            return 0;
-    }
-            
+    /* --- the z channels, unless they are streamed from the file --- */
+    if ( !crgData->gridStream.valid && !crgLoaderAllocateGrid( crgData ) )
+        return 0;
+    
     /* --- print some debug information --- */
     for ( i = 0; i < crgData->channelV.info.size; i++ )
         crgMsgPrint( dCrgMsgLevelDebug, "allocateChannels: channelZ[%ld].info.index = %ld, channelZ[%ld].info.size = %ld\n",
@@ -1843,147 +2227,378 @@ allocateChannels( CrgDataStruct* crgData )
 }
 
 static void
-readData( CrgDataStruct* crgData )
+storeRecord( CrgDataStruct* crgData, double* record, size_t nRec )
 {
-    char   *recPtr      = crgData->admin.dataSection;        /* pointer to begin of record */
-    size_t srcBytesLeft = crgData->admin.dataSize;
     size_t i;
-    size_t nRec = 0;
     
-    /* --- parse through all records --- */
-    while ( decodeNextRecord( crgData, &recPtr, &srcBytesLeft ) )
+    if ( crgData->gridStream.valid )
+        crgDataGridStreamScan( crgData, record, nRec );
+    else
     {
-        /* crgMsgPrint( dCrgMsgLevelNotice, "readData: channelZ at cross section no. %ld\n", nRec ); */
         for ( i = 0; i < crgData->channelV.info.size; i++ )
         {
-            if ( crgIsNan( &( crgData->admin.recordBuffer[crgData->channelZ[i].info.index] ) ) )
+            if ( crgIsNan( &( record[crgData->channelZ[i].info.index] ) ) )
                 crgSetNanf( &( crgData->channelZ[i].data[nRec] ) );
             else
-                crgData->channelZ[i].data[nRec] = ( float ) crgData->admin.recordBuffer[crgData->channelZ[i].info.index];
-        }
-        /* crgMsgPrint( dCrgMsgLevelNotice, "readData: channelZ at cross section no. %ld finished.\n", nRec ); */
-        
-        if ( crgData->channelX.info.defined )
-        {
-            crgData->channelX.data[nRec] = crgData->admin.recordBuffer[crgData->channelX.info.index];
-            crgData->channelY.data[nRec] = crgData->admin.recordBuffer[crgData->channelY.info.index];
-        }
-            
-        if ( crgData->channelPhi.info.defined )
-        {
-            if ( !nRec )
-                crgData->channelPhi.data[nRec] = crgData->channelPhi.info.first;
-            else
-                crgData->channelPhi.data[nRec] = crgData->admin.recordBuffer[crgData->channelPhi.info.index];
-            crgMsgPrint( dCrgMsgLevelDebug, "readData: channelPhi.data[%ld] = %.3f\n", nRec, crgData->channelPhi.data[nRec] );
+                crgData->channelZ[i].data[nRec] = ( float ) record[crgData->channelZ[i].info.index];
         }
-            
-        if ( crgData->channelBank.info.defined )
-            crgData->channelBank.data[nRec] = crgData->admin.recordBuffer[crgData->channelBank.info.index];
-            
-        if ( crgData->channelSlope.info.defined )
-            crgData->channelSlope.data[nRec] = crgData->admin.recordBuffer[crgData->channelSlope.info.index];
-            
-        nRec++;
-        
-        /*
-        if ( crgData->admin.dataSize )
-            crgMsgPrint( dCrgMsgLevelNotice, "MMM: readData: read %.2f %% of data\n", ( 100.0f * ( crgData->admin.dataSize - srcBytesLeft ) ) / crgData->admin.dataSize );
-        */
     }
     
-    /* --- ok, file data copy is no longer needed, get rid of it --- */
-    if ( crgData->admin.fileBuffer )
-        free ( crgData->admin.fileBuffer );
-    
-    crgData->admin.fileBuffer = NULL;
+    if ( crgData->channelX.info.defined )
+    {
+        crgData->channelX.data[nRec] = record[crgData->channelX.info.index];
+        crgData->channelY.data[nRec] = record[crgData->channelY.info.index];
+    }
+        
+    if ( crgData->channelPhi.info.defined )
+    {
+        if ( !nRec )
+            crgData->channelPhi.data[nRec] = crgData->channelPhi.info.first;
+        else
+            crgData->channelPhi.data[nRec] = record[crgData->channelPhi.info.index];
+        crgMsgPrint( dCrgMsgLevelDebug, "storeRecord: channelPhi.data[%ld] = %.3f\n", nRec, crgData->channelPhi.data[nRec] );
+    }
+        
+    if ( crgData->channelBank.info.defined )
+        crgData->channelBank.data[nRec] = record[crgData->channelBank.info.index];
+        
+    if ( crgData->channelSlope.info.defined )
+        crgData->channelSlope.data[nRec] = record[crgData->channelSlope.info.index];
 }
 
-void
-crgLoaderHandleNaNs( CrgDataStruct* crgData, int mode, double offset )
+static int
+readBinaryData( CrgDataStruct* crgData, const char* filename )
 {
-    int totalNaN   = 0;
-    size_t minIndexLR = crgData->channelV.info.size;
-    size_t maxIndexRL = 0;
-    size_t i;
-    size_t v;
-    int offsetApplied = 0;
-
+    CrgLoaderContextStruct* ctx = crgData->admin.loaderCtx;
+    char   *recPtr     = crgData->admin.dataSection;
+    size_t recordSize  = crgData->admin.recordSize;
+    size_t noRecords   = recordSize ? crgData->admin.dataSize / recordSize : 0;
+    char   *releasePtr = recPtr + dMapReleaseChunk;
+    size_t nRec;
+    CrgCenterLineStatStruct stat;
     
-    /* --- at least, NaNs need to be counted, so don't exit --- */
-    /* --- even if mode is dCrgGridNaNKeep                  --- */
+    memset( &stat, 0, sizeof( stat ) );
     
-    for ( i = 0; i < crgData->channelU.info.size; i++ )
+    /* --- the record count follows from the data size, so the channels may be allocated before decoding --- */
+    crgData->channelU.info.size = noRecords;
+    crgData->channelX.info.size = noRecords;
+    crgData->channelY.info.size = noRecords;
+    
+    if ( crgData->channelPhi.info.defined )
+        crgData->channelPhi.info.size = noRecords;
+    
+    /* --- the records have a fixed size, so the grid may be read from the file on demand --- */
+    if ( ( ctx->streamBehind > 0.0 || ctx->streamAhead > 0.0 ) && !crgData->gridStream.valid )
+    {
+        if ( !crgDataGridStreamInit( crgData, filename, ( size_t ) ( recPtr - crgData->admin.fileBuffer ), ctx->streamBehind, ctx->streamAhead ) )
+            crgMsgPrint( dCrgMsgLevelWarn, "readBinaryData: cannot stream the grid of <%s>, reading it completely.\n", filename );
+    }
+    
+    crgMsgPrint( dCrgMsgLevelDebug, "readBinaryData: allocating channels for %ld records\n", noRecords );
+    if ( !allocateChannels( crgData ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal,  "readBinaryData: could not allocate data.\n" );
+        return 0;
+    }
+    
+    /* --- decode each record once, directly from the file data --- */
+    for ( nRec = 0; nRec < noRecords; nRec++ )
     {
-        size_t nan     = 0;
-        size_t indexLR = 0;
-        size_t indexRL = crgData->channelV.info.size-1;
+        if ( !decodeRecord( crgData, recPtr, recordSize, crgData->admin.recordBuffer ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "readBinaryData: error parsing data record %ld.\n", nRec );
+            return 0;
+        }
+        
+        addCenterLineRecord( crgData, crgData->admin.recordBuffer, &stat );
+        storeRecord( crgData, crgData->admin.recordBuffer, nRec );
+        
+        recPtr += recordSize;
         
-        /* --- right to left --- */
-        for ( v = 1; v < crgData->channelV.info.size; v++ )
+        /* --- decoded pages of a mapped file are no longer needed --- */
+        if ( recPtr >= releasePtr )
         {
-            
-            if ( crgIsNanf( &( crgData->channelZ[v].data[i] ) ) )
-            {
-                nan++;
-                
-                switch ( mode )
-                {
-                    case dCrgGridNaNSetZero:
-                        crgData->channelZ[v].data[i] = ( float ) offset;
-                        break;
-                        
-                    case dCrgGridNaNKeepLast:
-                        /* --- copy data from right neighbor --- */
-                        memcpy( &( crgData->channelZ[v].data[i] ), &( crgData->channelZ[v-1].data[i] ), sizeof( crgData->channelZ[v].data[0] ) );
-                        if ( !crgIsNanf( &( crgData->channelZ[v].data[i] ) ) && !offsetApplied )
-                        {
-                            crgData->channelZ[v].data[i] += ( float ) offset;
-                            offsetApplied = 1;
-                        }
-                        break;
-                        
-                    default:
-                        break;
-                }
-            }
-            else
-                indexLR = v;
+            releaseFileRange( crgData, recPtr );
+            releasePtr = recPtr + dMapReleaseChunk;
         }
+    }
+    
+    releaseFileBuffer( crgData );
+    
+    return finishCenterLine( crgData, &stat );
+}
 
-        /* --- left to right --- */
-        offsetApplied = 0;
-        for ( v = crgData->channelV.info.size-1; v > 0; v-- )
+static int
+readAsciiData( CrgDataStruct* crgData )
+{
+    char   *recPtr      = crgData->admin.dataSection;
+    char   *nextPtr;
+    size_t nBytesLeft   = crgData->admin.dataSize;
+    size_t noRecords    = 0;
+    size_t chunkSize;
+    size_t nRec;
+    int    noTasks      = crgData->admin.loaderCtx->noThreads;
+    int    noChunks     = 0;
+    int    i;
+    int    retCode      = 0;
+    double* record      = crgData->admin.recordBuffer;
+    CrgLineScanStruct       scan;
+    CrgCenterLineStatStruct stat;
+    CrgAsciiJobStruct       job;
+    
+    memset( &stat, 0, sizeof( stat ) );
+    memset( &job,  0, sizeof( job ) );
+    
+    /* --- small data sections are not worth additional threads --- */
+    if ( noTasks > dAsciiMaxTasks )
+        noTasks = dAsciiMaxTasks;
+    
+    if ( ( size_t ) noTasks > crgData->admin.dataSize / dAsciiTaskMinSize )
+        noTasks = ( int ) ( crgData->admin.dataSize / dAsciiTaskMinSize );
+    
+    if ( noTasks < 1 )
+        noTasks = 1;
+    
+    job.crgData = crgData;
+    job.chunk   = ( CrgAsciiChunkStruct* ) crgCalloc( noTasks, sizeof( CrgAsciiChunkStruct ) );
+    
+    if ( !job.chunk )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal,  "readAsciiData: could not allocate data.\n" );
+        return 0;
+    }
+    
+    /* --- find the records, starting a new chunk whenever the previous one has reached its share of the data --- */
+    chunkSize = crgData->admin.dataSize / noTasks;
+    
+    initLineScan( &scan, crgData->admin.dataSection, crgData->admin.dataSize );
+    
+    while ( ( nextPtr = getNextRecord( &scan, crgData->admin.recordSize, crgData->admin.dataFormat, recPtr, nBytesLeft ) ) )
+    {
+        if ( !decodeRecord( crgData, recPtr, nextPtr - recPtr, NULL ) )
+            break;
+        
+        if ( noChunks < noTasks && ( size_t ) ( recPtr - crgData->admin.dataSection ) >= noChunks * chunkSize )
+        {
+            job.chunk[noChunks].dataPtr    = recPtr;
+            job.chunk[noChunks].nBytesLeft = nBytesLeft;
+            job.chunk[noChunks].firstRec   = noRecords;
+            noChunks++;
+        }
+        
+        nBytesLeft -= nextPtr - recPtr;
+        recPtr      = nextPtr;
+        noRecords++;
+    }
+    
+    for ( i = 0; i < noChunks; i++ )
+        job.chunk[i].noRecords = ( ( i + 1 < noChunks ) ? job.chunk[i + 1].firstRec : noRecords ) - job.chunk[i].firstRec;
+    
+    crgMsgPrint( dCrgMsgLevelDebug, "readAsciiData: %ld records in %d chunks\n", noRecords, noChunks );
+    
+    /* --- the record count is known now, so the channels may be allocated before decoding --- */
+    crgData->channelU.info.size = noRecords;
+    crgData->channelX.info.size = noRecords;
+    crgData->channelY.info.size = noRecords;
+    
+    if ( crgData->channelPhi.info.defined )
+        crgData->channelPhi.info.size = noRecords;
+    
+    if ( !allocateChannels( crgData ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal,  "readAsciiData: could not allocate data.\n" );
+        crgFree( job.chunk );
+        return 0;
+    }
+    
+    /* --- each task gets a record buffer of its own, u values are kept for the center line --- */
+    for ( i = 0; i < noChunks; i++ )
+        if ( !( job.chunk[i].record = ( double* ) crgCalloc( crgData->noChannels, sizeof( double ) ) ) )
+            break;
+    
+    if ( crgData->channelU.info.defined && noRecords )
+        job.uData = ( double* ) crgCalloc( noRecords, sizeof( double ) );
+    
+    if ( i == noChunks && ( job.uData || !crgData->channelU.info.defined || !noRecords ) )
+    {
+        crgPortRunTasks( decodeAsciiChunk, &job, noChunks );
+        
+        /* --- the center line depends on the order of the records --- */
+        for ( nRec = 0; nRec < noRecords; nRec++ )
         {
-            if ( crgIsNanf( &( crgData->channelZ[v-1].data[i] ) ) && !crgIsNanf( &( crgData->channelZ[v].data[i] ) ) )
+            if ( crgData->channelU.info.defined )
+                record[crgData->channelU.info.index] = job.uData[nRec];
+            
+            if ( crgData->channelX.info.defined )
             {
-                nan++;
-                
-                switch ( mode )
-                {
-                    case dCrgGridNaNSetZero:
-                        crgData->channelZ[v-1].data[i] = ( float ) offset;
-                        break;
-                        
-                    case dCrgGridNaNKeepLast:
-                        /* --- copy data from right neighbor --- */
-                        memcpy( &( crgData->channelZ[v-1].data[i] ), &( crgData->channelZ[v].data[i] ), sizeof( crgData->channelZ[v-1].data[0] ) );
-                        
-                        if ( !crgIsNanf( &( crgData->channelZ[v-1].data[i] ) ) && !offsetApplied )
-                        {
-                            crgData->channelZ[v-1].data[i] += ( float ) offset;
-                            offsetApplied = 1;
-                        }
-                        break;
-                        
-                    default:
-                        break;
-                }
+                record[crgData->channelX.info.index] = crgData->channelX.data[nRec];
+                record[crgData->channelY.info.index] = crgData->channelY.data[nRec];
             }
-            else
-                indexRL = v-1;
+            
+            addCenterLineRecord( crgData, record, &stat );
         }
         
+        retCode = 1;
+    }
+    else
+        crgMsgPrint( dCrgMsgLevelFatal,  "readAsciiData: could not allocate data.\n" );
+    
+    for ( i = 0; i < noChunks; i++ )
+        if ( job.chunk[i].record )
+            crgFree( job.chunk[i].record );
+    
+    if ( job.uData )
+        crgFree( job.uData );
+    
+    crgFree( job.chunk );
+    
+    /* --- ok, file data copy is no longer needed, get rid of it --- */
+    releaseFileBuffer( crgData );
+    
+    if ( !retCode )
+        return 0;
+    
+    return finishCenterLine( crgData, &stat );
+}
+
+static void
+decodeAsciiChunk( void* data, int taskId )
+{
+    CrgAsciiJobStruct*   job     = ( CrgAsciiJobStruct* ) data;
+    CrgAsciiChunkStruct* chunk   = &( job->chunk[taskId] );
+    CrgDataStruct*       crgData = job->crgData;
+    char                 *recPtr    = chunk->dataPtr;
+    char                 *nextPtr;
+    size_t               nBytesLeft = chunk->nBytesLeft;
+    size_t               nRec;
+    CrgLineScanStruct    scan;
+    
+    /* --- the records have been checked while splitting the data, so decoding cannot fail --- */
+    initLineScan( &scan, crgData->admin.dataSection, crgData->admin.dataSize );
+    
+    for ( nRec = chunk->firstRec; nRec < chunk->firstRec + chunk->noRecords; nRec++ )
+    {
+        nextPtr = getNextRecord( &scan, crgData->admin.recordSize, crgData->admin.dataFormat, recPtr, nBytesLeft );
+        
+        decodeRecord( crgData, recPtr, nextPtr - recPtr, chunk->record );
+        storeRecord( crgData, chunk->record, nRec );
+        
+        if ( job->uData )
+            job->uData[nRec] = chunk->record[crgData->channelU.info.index];
+        
+        nBytesLeft -= nextPtr - recPtr;
+        recPtr      = nextPtr;
+    }
+}
+
+static int
+mapFile( CrgDataStruct* crgData, const char* filename, size_t size )
+{
+#ifdef dCrgLoaderUseMmap
+    int   fd;
+    void* addr;
+    long  pageSize = sysconf( _SC_PAGESIZE );
+    
+    if ( crgData->admin.loaderCtx->fileAccess != dCrgFileAccessMapped || !size )
+        return 0;
+    
+    /* --- the header parser relies on the zero padding of the last page --- */
+    if ( pageSize <= 0 || !( size % ( size_t ) pageSize ) )
+        return 0;
+    
+    if ( ( fd = open( filename, O_RDONLY ) ) < 0 )
+        return 0;
+    
+    /* --- the parser does not alter the file data, so read access is sufficient --- */
+    addr = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    
+    if ( addr == MAP_FAILED )
+    {
+        crgMsgPrint( dCrgMsgLevelInfo, "mapFile: cannot map <%s>, reading it instead.\n", filename );
+        return 0;
+    }
+    
+    crgData->admin.fileBuffer  = ( char* ) addr;
+    crgData->admin.fileMapSize = size;
+    crgData->admin.fileMapDone = 0;
+    
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static void
+releaseFileRange( CrgDataStruct* crgData, const char* endPtr )
+{
+#ifdef dCrgLoaderUseMmap
+    size_t pageSize = ( size_t ) sysconf( _SC_PAGESIZE );
+    size_t endPos;
+    
+    if ( !crgData->admin.fileBuffer || !crgData->admin.fileMapSize )
+        return;
+    
+    endPos = ( ( size_t ) ( endPtr - crgData->admin.fileBuffer ) / pageSize ) * pageSize;
+    
+    if ( endPos > crgData->admin.fileMapSize )
+        endPos = crgData->admin.fileMapSize;
+    
+    if ( endPos <= crgData->admin.fileMapDone )
+        return;
+    
+    munmap( crgData->admin.fileBuffer + crgData->admin.fileMapDone, endPos - crgData->admin.fileMapDone );
+    crgData->admin.fileMapDone = endPos;
+#endif
+}
+
+static void
+releaseFileBuffer( CrgDataStruct* crgData )
+{
+    if ( !crgData->admin.fileBuffer )
+        return;
+    
+#ifdef dCrgLoaderUseMmap
+    if ( crgData->admin.fileMapSize )
+    {
+        if ( crgData->admin.fileMapSize > crgData->admin.fileMapDone )
+            munmap( crgData->admin.fileBuffer + crgData->admin.fileMapDone, crgData->admin.fileMapSize - crgData->admin.fileMapDone );
+    }
+    else
+#endif
+        crgFree( crgData->admin.fileBuffer );
+    
+    crgData->admin.fileBuffer  = NULL;
+    crgData->admin.fileMapSize = 0;
+    crgData->admin.fileMapDone = 0;
+}
+
+void
+crgLoaderHandleNaNs( CrgDataStruct* crgData, int mode, double offset )
+{
+    int totalNaN   = 0;
+    size_t minIndexLR = crgData->channelV.info.size;
+    size_t maxIndexRL = 0;
+    size_t i;
+    size_t nan;
+    size_t indexLR;
+    size_t indexRL;
+    int offsetApplied = 0;
+
+    /* --- the samples of a streamed grid are handled while they are read --- */
+    if ( crgData->gridStream.valid )
+    {
+        crgDataGridStreamSetNaNMode( crgData, mode, offset );
+        return;
+    }
+    
+    /* --- at least, NaNs need to be counted, so don't exit --- */
+    /* --- even if mode is dCrgGridNaNKeep                  --- */
+    
+    for ( i = 0; i < crgData->channelU.info.size; i++ )
+    {
+        nan = crgLoaderHandleNaNsSection( crgData->channelZ, crgData->channelV.info.size, i, mode, offset, &offsetApplied, &indexLR, &indexRL );
+        
         if ( nan > 0 )
         {
             crgMsgPrint( dCrgMsgLevelInfo, "crgLoaderHandleNaNs: cross section %ld: NaNs total: %4ld, left: %4ld, right %4ld\n",
@@ -2012,6 +2627,89 @@ crgLoaderHandleNaNs( CrgDataStruct* crgData, int mode, double offset )
     crgMsgPrint( dCrgMsgLevelNotice, "                     max. NaN count from right [-]: %ld\n", maxIndexRL );
 }
 
+size_t
+crgLoaderHandleNaNsSection( CrgChannelFStruct* channelZ, size_t noChannels, size_t index, int mode, double offset,
+                            int* offsetApplied, size_t* indexLR, size_t* indexRL )
+{
+    size_t nan     = 0;
+    size_t idxLR   = 0;
+    size_t idxRL   = noChannels-1;
+    size_t v;
+    
+    /* --- right to left --- */
+    for ( v = 1; v < noChannels; v++ )
+    {
+        
+        if ( crgIsNanf( &( channelZ[v].data[index] ) ) )
+        {
+            nan++;
+            
+            switch ( mode )
+            {
+                case dCrgGridNaNSetZero:
+                    channelZ[v].data[index] = ( float ) offset;
+                    break;
+                    
+                case dCrgGridNaNKeepLast:
+                    /* --- copy data from right neighbor --- */
+                    memcpy( &( channelZ[v].data[index] ), &( channelZ[v-1].data[index] ), sizeof( channelZ[v].data[0] ) );
+                    if ( !crgIsNanf( &( channelZ[v].data[index] ) ) && !*offsetApplied )
+                    {
+                        channelZ[v].data[index] += ( float ) offset;
+                        *offsetApplied = 1;
+                    }
+                    break;
+                    
+                default:
+                    break;
+            }
+        }
+        else
+            idxLR = v;
+    }
+
+    /* --- left to right --- */
+    *offsetApplied = 0;
+    for ( v = noChannels-1; v > 0; v-- )
+    {
+        if ( crgIsNanf( &( channelZ[v-1].data[index] ) ) && !crgIsNanf( &( channelZ[v].data[index] ) ) )
+        {
+            nan++;
+            
+            switch ( mode )
+            {
+                case dCrgGridNaNSetZero:
+                    channelZ[v-1].data[index] = ( float ) offset;
+                    break;
+                    
+                case dCrgGridNaNKeepLast:
+                    /* --- copy data from right neighbor --- */
+                    memcpy( &( channelZ[v-1].data[index] ), &( channelZ[v].data[index] ), sizeof( channelZ[v-1].data[0] ) );
+                    
+                    if ( !crgIsNanf( &( channelZ[v-1].data[index] ) ) && !*offsetApplied )
+                    {
+                        channelZ[v-1].data[index] += ( float ) offset;
+                        *offsetApplied = 1;
+                    }
+                    break;
+                    
+                default:
+                    break;
+            }
+        }
+        else
+            idxRL = v-1;
+    }
+    
+    if ( indexLR )
+        *indexLR = idxLR;
+    
+    if ( indexRL )
+        *indexRL = idxRL;
+    
+    return nan;
+}
+
 static void
 calcRefLine( CrgDataStruct* crgData )
 {
@@ -2258,6 +2956,10 @@ normalizeZ( CrgDataStruct* crgData )
     size_t i, j;
     size_t nValues = 0;
 
+    /* the samples of a streamed grid are not resident, its mean values are added during the evaluation */
+    if ( crgData->gridStream.valid )
+        return;
+
     /* make mean elevation at first cross section = 0.0 */
     /* note: prepare may be called multiple times, so take old mean value into account */
     /* only use values not being NaNs! */
@@ -2436,6 +3138,14 @@ crgLoaderPrepareData( CrgDataStruct* crgData )
     /* --- prepare some data for higher performance of evaluations --- */
     crgCalcUtilityData( crgData );
     crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: crgCalcUtilityData() done.\n" );
+    
+    /* --- spatial index for the search of x/y positions on the reference line --- */
+    crgEvalxy2uvBuildIndex( crgData );
+    crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: crgEvalxy2uvBuildIndex() done.\n" );
+    
+    /* --- per interval geometry of the reference line --- */
+    crgCalcRefLineGeom( crgData );
+    crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: crgCalcRefLineGeom() done.\n" );
 }
 
 
@@ -2450,6 +3160,12 @@ crgCheck( int dataSetId )
         return 0;
     }
 
+    if ( crgData->admin.headerOnly )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgCheck: data of data set <%d> has not been read.\n", dataSetId );
+        return 0;
+    }
+
     /* @todo: move to one of the following sub check routines */
     /* --- check if closed refline option is valid --- */
     if( crgData->util.uIsClosed && crgOptionHasValueInt( &( crgData->options ), dCrgRefLineCloseTrack, 1 ) )
@@ -2470,6 +3186,19 @@ crgCheck( int dataSetId )
         return 0;
     }
 
+    /* --- report the accuracy of a quantized grid --- */
+    if ( crgData->gridQuant.valid )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgCheck: quantized grid, maximum error = %.3e m, bound = %.3e m\n",
+                     crgData->gridQuant.maxError, crgData->gridQuant.errorBound );
+
+        if ( crgData->gridQuant.maxError > crgData->gridQuant.errorBound )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgCheck: error of quantized grid exceeds its bound.\n" );
+            return 0;
+        }
+    }
+
     return 1;
 }
 
@@ -2626,6 +3355,7 @@ crgCheckMods( CrgDataStruct* crgData )
     int    byoff    = 0;
     int    byref    = 0;
     double modAsDouble;
+    double modAsDouble2;
 
     /* --- check singular value ranges */
 
@@ -2671,30 +3401,78 @@ crgCheckMods( CrgDataStruct* crgData )
         }
     }
 
-    /* CRG re-positioning: refline by offset (default: "by refpoint") */
-    byoff |= crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetPhi );
-    byoff |= crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetX );
-    byoff |= crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetY );
-    byoff |= crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetZ );
+    /* CRG elevation grid filter */
+    if ( crgOptionGetInt( &crgData->modifiers, dCrgModFilterMode, &modAsInt ) )
+    {
+        if ( modAsInt < dCrgFilterNone || modAsInt > dCrgFilterMask )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgCheckMods: illegal modifier \"grid_filter_mode\": %d\n", modAsInt );
+            return 0;
+        }
+    }
 
-    if( byoff )
+    if ( crgOptionGetInt( &crgData->modifiers, dCrgModFilterSizeU, &modAsInt ) && modAsInt < 1 )
     {
-        if( !crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetPhi ) )
-            crgOptionSetDouble( &crgData->modifiers, dCrgModRefLineOffsetPhi, 0. );
-        if( !crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetX ) )
-            crgOptionSetDouble( &crgData->modifiers, dCrgModRefLineOffsetX, 0. );
-        if( !crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetY ) )
-            crgOptionSetDouble( &crgData->modifiers, dCrgModRefLineOffsetY, 0. );
-        if( !crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetZ ) )
-            crgOptionSetDouble( &crgData->modifiers, dCrgModRefLineOffsetZ, 0. );
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCheckMods: illegal modifier \"grid_filter_size_u\": %d\n", modAsInt );
+        return 0;
     }
 
-    /* CRG re-positioning: refline by refpoint (overwrites "by offset") */
-    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointUFrac );
-    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointU );
-    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointVFrac );
-    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointV );
-    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointX );
+    if ( crgOptionGetInt( &crgData->modifiers, dCrgModFilterSizeV, &modAsInt ) && modAsInt < 1 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCheckMods: illegal modifier \"grid_filter_size_v\": %d\n", modAsInt );
+        return 0;
+    }
+
+    if ( crgOptionGetInt( &crgData->modifiers, dCrgModFilterRepeat, &modAsInt ) && modAsInt < 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCheckMods: illegal modifier \"grid_filter_repeat\": %d\n", modAsInt );
+        return 0;
+    }
+
+    /* CRG elevation grid peaks and limits */
+    if ( crgOptionGetDouble( &crgData->modifiers, dCrgModPeakLimit, &modAsDouble ) && modAsDouble < 0.0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCheckMods: illegal modifier \"grid_peak_limit\": %f\n", modAsDouble );
+        return 0;
+    }
+
+    if ( crgOptionGetInt( &crgData->modifiers, dCrgModPeakRadius, &modAsInt ) && modAsInt < 1 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCheckMods: illegal modifier \"grid_peak_radius\": %d\n", modAsInt );
+        return 0;
+    }
+
+    if ( crgOptionGetDouble( &crgData->modifiers, dCrgModLimitZMin, &modAsDouble ) &&
+         crgOptionGetDouble( &crgData->modifiers, dCrgModLimitZMax, &modAsDouble2 ) && modAsDouble > modAsDouble2 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCheckMods: inconsistent grid_limit_z_min=%f with grid_limit_z_max=%f\n", modAsDouble, modAsDouble2 );
+        return 0;
+    }
+
+    /* CRG re-positioning: refline by offset (default: "by refpoint") */
+    byoff |= crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetPhi );
+    byoff |= crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetX );
+    byoff |= crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetY );
+    byoff |= crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetZ );
+
+    if( byoff )
+    {
+        if( !crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetPhi ) )
+            crgOptionSetDouble( &crgData->modifiers, dCrgModRefLineOffsetPhi, 0. );
+        if( !crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetX ) )
+            crgOptionSetDouble( &crgData->modifiers, dCrgModRefLineOffsetX, 0. );
+        if( !crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetY ) )
+            crgOptionSetDouble( &crgData->modifiers, dCrgModRefLineOffsetY, 0. );
+        if( !crgOptionIsSet( &crgData->modifiers, dCrgModRefLineOffsetZ ) )
+            crgOptionSetDouble( &crgData->modifiers, dCrgModRefLineOffsetZ, 0. );
+    }
+
+    /* CRG re-positioning: refline by refpoint (overwrites "by offset") */
+    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointUFrac );
+    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointU );
+    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointVFrac );
+    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointV );
+    byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointX );
     byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointY );
     byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointZ );
     byref |= crgOptionIsSet( &crgData->modifiers, dCrgModRefPointPhi );
@@ -2758,7 +3536,7 @@ readDouble( char* dataPtr, double* tgt )
     if ( !dataPtr || !tgt )
         return 0;
     
-    if ( mCrgBigEndian )
+    if ( dCrgBigEndian )
         memcpy( valPtr, dataPtr, 8 * sizeof( char ) );
     else
         for ( j = 0; j < 8; j++ )
@@ -2767,7 +3545,7 @@ readDouble( char* dataPtr, double* tgt )
     /* check for NaN and make sure it can be identified later-on */
     memcpy( compValue, tgt, sizeof( double ) );
     
-    if ( mCrgBigEndian )
+    if ( dCrgBigEndian )
     {
         if ( compValue[0] >= 0x7ff80000 )
             return -1;
@@ -2788,7 +3566,7 @@ readFloat( char* dataPtr, float* tgt )
     if ( !dataPtr || !valPtr )
         return 0;
     
-    if ( mCrgBigEndian )
+    if ( dCrgBigEndian )
         memcpy( valPtr, dataPtr, 4 * sizeof( char ) );
     else
         for ( j = 0; j < 4; j++ )
@@ -2817,14 +3595,12 @@ int
 crgLoaderReadFile( const char* filename )
 {
     CrgDataStruct *crgData = NULL;
+    CrgLoaderContextStruct ctx;
     
-    /* --- initialize the loader before reading the file --- */
-    crgLoaderInit();
+    /* --- all parser state and settings live in the context, so files may be loaded concurrently --- */
+    initContext( &ctx );
     
-    /* --- set file level to base level (reading primary file ) --- */
-    mFileLevel = 0;
-    
-    if ( !crgLoaderAddFile( filename, &crgData ) )
+    if ( !crgLoaderAddFile( filename, &crgData, &ctx ) )
     {
         crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderReadFile: error loading <%s>\n", filename );
         terminateReader( crgData, 0 );
@@ -2845,22 +3621,309 @@ crgLoaderReadFile( const char* filename )
     /* --- initialize data-set specific history --- */
     crgDataSetHistory( crgData->admin.id, dCrgHistoryStdSize );
     
+    /* --- remember the source of the data, e.g. for snapshots --- */
+    if ( ( crgData->admin.sourceFile = ( char* ) crgCalloc( strlen( filename ) + 1, sizeof( char ) ) ) )
+        strcpy( crgData->admin.sourceFile, filename );
+    
     crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderReadFile: finished reading file <%s>\n", filename );
     
     /* --- clear temporary data and declare success --- */
+    if ( !terminateReader( crgData, 1 ) )
+        return 0;
+    
+    /* --- a streamed grid is read on demand from now on --- */
+    if ( crgData->gridStream.valid && !crgDataGridStreamStart( crgData ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgLoaderReadFile: cannot stream the grid of <%s>\n", filename );
+        crgDataSetRelease( crgData->admin.id );
+        return 0;
+    }
+    
+    /* --- quantize the grid once the file data has been released --- */
+    if ( ctx.gridQuantError > 0.0 && !crgData->gridStream.valid )
+        crgDataGridQuantize( crgData, ctx.gridQuantError );
+    
+    return crgData->admin.id;
+}
+
+int
+crgLoaderReadHeader( const char* filename )
+{
+    CrgDataStruct *crgData = NULL;
+    CrgLoaderContextStruct ctx;
+    
+    initContext( &ctx );
+    
+    ctx.headerOnly = 1;
+    
+    if ( !crgLoaderAddFile( filename, &crgData, &ctx ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderReadHeader: error loading <%s>\n", filename );
+        terminateReader( crgData, 0 );
+        
+        if ( crgData )
+            crgDataSetRelease( crgData->admin.id );
+        
+        return 0;
+    }
+    
+    /* --- some files cannot be described by their header only --- */
+    if ( ctx.needsData )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderReadHeader: header of <%s> is not sufficient, reading complete file\n", filename );
+        terminateReader( crgData, 0 );
+        crgDataSetRelease( crgData->admin.id );
+        
+        return crgLoaderReadFile( filename );
+    }
+    
+    /* --- data available? --- */
+    if ( !crgData->channelV.info.size )
+    {
+        crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderReadHeader: no data available. Terminating reader\n" );
+        return terminateReader( crgData, 0 );
+    }
+    
+    crgData->admin.headerOnly = 1;
+    
+    /* --- the source of the data is required for reading it later on --- */
+    if ( ( crgData->admin.sourceFile = ( char* ) crgCalloc( strlen( filename ) + 1, sizeof( char ) ) ) )
+        strcpy( crgData->admin.sourceFile, filename );
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderReadHeader: finished reading header of file <%s>\n", filename );
+    
     if ( !terminateReader( crgData, 1 ) )
         return 0;
     
     return crgData->admin.id;
 }
 
+int
+crgLoaderReadData( int dataSetId )
+{
+    int fullId;
+    CrgDataStruct *crgData = crgDataSetAccess( dataSetId );
+    
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgLoaderReadData: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+    
+    /* --- nothing to be done if the data has already been read --- */
+    if ( !crgData->admin.headerOnly )
+        return 1;
+    
+    if ( !crgData->admin.sourceFile )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgLoaderReadData: data set <%d> does not refer to a file.\n", dataSetId );
+        return 0;
+    }
+    
+    if ( !( fullId = crgLoaderReadFile( crgData->admin.sourceFile ) ) )
+        return 0;
+    
+    /* --- the complete data set takes over the ID of the header --- */
+    if ( !crgDataSetReplace( dataSetId, fullId ) )
+    {
+        crgDataSetRelease( fullId );
+        return 0;
+    }
+    
+    return 1;
+}
+
+int
+crgLoaderSetGridLayout( int layout )
+{
+    if ( ( layout != dCrgGridLayoutRows ) && ( layout != dCrgGridLayoutContiguous ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgLoaderSetGridLayout: invalid grid layout <%d>.\n", layout );
+        return 0;
+    }
+    
+    crgPortLock( dCrgLockLoader );
+    mGridLayout = layout;
+    crgPortUnlock( dCrgLockLoader );
+    
+    return 1;
+}
+
+int
+crgLoaderSetFileAccess( int mode )
+{
+    if ( ( mode != dCrgFileAccessBuffered ) && ( mode != dCrgFileAccessMapped ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgLoaderSetFileAccess: invalid access mode <%d>.\n", mode );
+        return 0;
+    }
+    
+    crgPortLock( dCrgLockLoader );
+    mFileAccess = mode;
+    crgPortUnlock( dCrgLockLoader );
+    
+    return 1;
+}
+
+int
+crgLoaderSetGridQuantization( double maxError )
+{
+    if ( !( maxError >= 0.0 ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgLoaderSetGridQuantization: invalid maximum error <%.3e>.\n", maxError );
+        return 0;
+    }
+    
+    crgPortLock( dCrgLockLoader );
+    mGridQuantError = maxError;
+    crgPortUnlock( dCrgLockLoader );
+    
+    return 1;
+}
+
+int
+crgLoaderSetStreaming( double uBehind, double uAhead )
+{
+    if ( !( uBehind >= 0.0 ) || !( uAhead >= 0.0 ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgLoaderSetStreaming: invalid window <%.3f, %.3f>.\n", uBehind, uAhead );
+        return 0;
+    }
+    
+    crgPortLock( dCrgLockLoader );
+    mStreamBehind = uBehind;
+    mStreamAhead  = uAhead;
+    crgPortUnlock( dCrgLockLoader );
+    
+    return 1;
+}
+
+int
+crgLoaderSetNoThreads( int noThreads )
+{
+    if ( noThreads < 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgLoaderSetNoThreads: invalid number of threads <%d>.\n", noThreads );
+        return 0;
+    }
+    
+    crgPortLock( dCrgLockLoader );
+    mNoThreads = noThreads;
+    crgPortUnlock( dCrgLockLoader );
+    
+    return 1;
+}
+
+int
+crgLoaderGetNoThreads( void )
+{
+    int noThreads;
+    
+    crgPortLock( dCrgLockLoader );
+    noThreads = mNoThreads;
+    crgPortUnlock( dCrgLockLoader );
+    
+    return noThreads ? noThreads : crgPortGetNoProcessors();
+}
+
+int
+crgLoaderAllocateGrid( CrgDataStruct* crgData )
+{
+    size_t i;
+    
+    if ( !crgData || !crgData->channelZ )
+        return 0;
+    
+    if ( crgData->admin.gridLayout == dCrgGridLayoutContiguous )
+    {
+        size_t alignSize = dCrgGridAlign / sizeof( float );
+        size_t rowSize   = ( ( crgData->channelU.info.size + alignSize - 1 ) / alignSize ) * alignSize;
+        float* gridStart;
+        
+        /* --- one block for all channels; each channel starts at an aligned address --- */
+        if ( !( crgData->admin.gridBuffer = ( float* ) crgCalloc( crgData->channelV.info.size * rowSize + alignSize, sizeof( float ) ) ) )
+            return 0;
+        
+        gridStart = ( float* ) ( ( ( size_t ) crgData->admin.gridBuffer + dCrgGridAlign - 1 ) & ~( ( size_t ) dCrgGridAlign - 1 ) );
+        
+        for( i = 0; i < crgData->channelV.info.size; i++ )
+        {
+            crgData->channelZ[i].info.size = crgData->channelU.info.size;
+            crgData->channelZ[i].data      = gridStart + i * rowSize;
+        }
+        
+        crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderAllocateGrid: contiguous grid with %ld bytes per channel\n", rowSize * sizeof( float ) );
+    }
+    else
+    {
+        for( i = 0; i < crgData->channelV.info.size; i++ )
+        {        
+            /* copy size information */
+            crgData->channelZ[i].info.size = crgData->channelU.info.size;
+            
+            if ( !( crgData->channelZ[i].data = ( float* ) crgCalloc( crgData->channelZ[i].info.size, sizeof( float ) ) ) )
+                return 0;
+        }
+    }
+    
+    return 1;
+}
+
+int
+crgLoaderDecodeZ( CrgDataStruct* crgData, char* dataPtr, size_t noRecords, double* record, CrgChannelFStruct* channelZ )
+{
+    size_t nRec;
+    size_t i;
+    
+    for ( nRec = 0; nRec < noRecords; nRec++ )
+    {
+        if ( !decodeRecord( crgData, dataPtr, crgData->admin.recordSize, record ) )
+            return 0;
+        
+        for ( i = 0; i < crgData->channelV.info.size; i++ )
+        {
+            if ( crgIsNan( &( record[crgData->channelZ[i].info.index] ) ) )
+                crgSetNanf( &( channelZ[i].data[nRec] ) );
+            else
+                channelZ[i].data[nRec] = ( float ) record[crgData->channelZ[i].info.index];
+        }
+        
+        dataPtr += crgData->admin.recordSize;
+    }
+    
+    return 1;
+}
+
+void
+crgLoaderReleaseGrid( CrgDataStruct* crgData )
+{
+    size_t i;
+    
+    if ( !crgData || !crgData->channelZ )
+        return;
+    
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    {
+        if ( crgData->channelZ[i].data && !crgData->admin.gridBuffer && !crgData->admin.viewOwner )
+            crgFree( crgData->channelZ[i].data );
+        
+        crgData->channelZ[i].data = NULL;
+    }
+    
+    if ( crgData->admin.gridBuffer )
+        crgFree( crgData->admin.gridBuffer );
+    
+    crgData->admin.gridBuffer = NULL;
+}
+
 static int 
-crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
+crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData, CrgLoaderContextStruct* ctx )
 {
     size_t        noBytesRead;
     struct stat fileStat;
     char*         bufPtr;
     size_t        nBytesLeft;
+    int           found;
 	FILE*         fPtr = NULL;
     CrgDataStruct *crgData = *crgRetData;
    
@@ -2875,10 +3938,7 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
     if ( isLittleEndian() )
         crgMsgPrint( dCrgMsgLevelInfo, "crgLoaderAddFile: reading little endian encoding\n" );
     else
-    {
         crgMsgPrint( dCrgMsgLevelInfo, "crgLoaderAddFile: reading big endian encoding\n" );
-        mCrgBigEndian = 1;
-    }   
      
     /* --- get a new data structure and initialize it --- */
     if ( !crgData )
@@ -2891,36 +3951,56 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
         }
         
         *crgRetData = crgData;
-        initData( crgData );
+        initData( crgData, ctx );
     }
     
-    /* --- memory map the file for faster access --- */
+    crgData->admin.loaderCtx   = ctx;
+    crgData->admin.sectionType = dFileSectionNone;
+    
     stat( filename, &fileStat );
-	crgData->admin.fileBuffer = ( char * ) crgCalloc( 1, fileStat.st_size + 1 );
     
-    if ( !crgData->admin.fileBuffer )
+    /* --- for the header only, the data section is not read --- */
+    if ( ctx->headerOnly )
+        found = readFileHeader( crgData, fPtr, fileStat.st_size, &bufPtr, &nBytesLeft );
+    else
     {
-        crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: cannot allocate memory for file data\n" );
-        fclose(fPtr);
-        return 0;
+        /* --- memory map the file for faster access, otherwise read it into a buffer --- */
+        if ( mapFile( crgData, filename, fileStat.st_size ) )
+            noBytesRead = fileStat.st_size;
+        else
+        {
+            crgData->admin.fileBuffer = ( char * ) crgCalloc( 1, fileStat.st_size + 1 );
+            
+            if ( !crgData->admin.fileBuffer )
+            {
+                crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: cannot allocate memory for file data\n" );
+                fclose(fPtr);
+                return 0;
+            }
+            
+            noBytesRead = fread( crgData->admin.fileBuffer, 1, fileStat.st_size, fPtr );
+        }
+        
+        if ( noBytesRead < ( size_t ) fileStat.st_size )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: read error: only got %lld of %lld bytes\n", noBytesRead, fileStat.st_size );
+            fclose( fPtr );
+            return 0;
+        }
+        
+        /* --- copy basic file parameters for subsequent alteration --- */
+        bufPtr     = crgData->admin.fileBuffer;
+        nBytesLeft = noBytesRead;
+        
+        /* --- parse the header of the file --- */
+        found = parseFileHeader( crgData, &bufPtr, &nBytesLeft );
     }
-    
-	noBytesRead = fread( crgData->admin.fileBuffer, 1, fileStat.st_size, fPtr );
  	fclose( fPtr );
-   
-    if ( noBytesRead < ( size_t ) fileStat.st_size )
-    {
-        crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: read error: only got %lld of %lld bytes\n", noBytesRead, fileStat.st_size );
-        return 0;
-    }
-    
-    /* --- copy basic file parameters for subsequent alteration --- */
-    bufPtr     = crgData->admin.fileBuffer;
-    nBytesLeft = noBytesRead;
     
+    if ( found < 0 )
+        return 0;
     
-    /* --- parse the header of the file --- */
-    if ( !parseFileHeader( crgData, &bufPtr, &nBytesLeft ) )
+    if ( !found )
     {
         crgMsgPrint( dCrgMsgLevelNotice,  "crgLoaderAddFile: this file contains no data section.\n" );
         return 1;
@@ -2947,25 +4027,165 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
     crgData->admin.dataSection = bufPtr;
     crgData->admin.dataSize    = nBytesLeft;
     
+    if ( ctx->headerOnly )
+        return readDataBounds( crgData, filename );
+    
+    /* --- binary data is decoded in a single pass --- */
+    if ( crgData->admin.dataFormat & dDataFormatBinary )
+    {
+        crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderAddFile: reading binary data\n" );
+        return readBinaryData( crgData, filename );
+    }
+    
+    if ( ctx->streamBehind > 0.0 || ctx->streamAhead > 0.0 )
+        crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderAddFile: records of ASCII data vary in size, reading the grid of <%s> completely.\n", filename );
+    
     /* --- the header seems to be ok, now let's start reading the actual data  --- */
-    crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderAddFile: parsing center line\n" );
-    if ( !parseCenterLine( crgData, bufPtr, nBytesLeft ) )
+    crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderAddFile: reading ASCII data\n" );
+    return readAsciiData( crgData );
+}
+
+static int
+readFileHeader( CrgDataStruct* crgData, FILE* fPtr, size_t fileSize, char** dataPtr, size_t* nBytesLeft )
+{
+    CrgLoaderContextStruct* ctx = crgData->admin.loaderCtx;
+    size_t chunkSize = dHeaderReadChunk;
+    size_t bufSize   = 0;
+    size_t parsed    = 0;
+    size_t end;
+    char*  buffer;
+    
+    /* --- read the file in growing chunks until the header has been parsed completely --- */
+    while ( 1 )
+    {
+        if ( chunkSize > fileSize )
+            chunkSize = fileSize;
+        
+        if ( !( buffer = ( char* ) crgRealloc( crgData->admin.fileBuffer, chunkSize + 1 ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal,  "readFileHeader: cannot allocate memory for file header\n" );
+            return -1;
+        }
+        
+        crgData->admin.fileBuffer = buffer;
+        
+        bufSize += fread( buffer + bufSize, 1, chunkSize - bufSize, fPtr );
+        buffer[bufSize] = '\0';
+        
+        if ( bufSize < chunkSize )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal,  "readFileHeader: read error: only got %ld of %ld bytes\n", bufSize, chunkSize );
+            return -1;
+        }
+        
+        /* --- pass complete lines only, including all of their line break characters --- */
+        end = bufSize;
+        
+        if ( bufSize < fileSize )
+            while ( end > parsed && ( buffer[end-1] != '\n' || end == bufSize || buffer[end] == '\n' || buffer[end] == '\r' ) )
+                end--;
+        
+        ctx->unreadBytes = fileSize - end;
+        *dataPtr         = buffer + parsed;
+        *nBytesLeft      = end - parsed;
+        
+        if ( parseFileHeader( crgData, dataPtr, nBytesLeft ) )
+            return 1;
+        
+        if ( bufSize == fileSize )
+            return 0;
+        
+        /* --- resume parsing after the last complete line --- */
+        parsed     = end;
+        chunkSize *= 2;
+    }
+}
+
+static int
+readDataBounds( CrgDataStruct* crgData, const char* filename )
+{
+    CrgLoaderContextStruct* ctx = crgData->admin.loaderCtx;
+    size_t recordSize = crgData->admin.recordSize;
+    size_t noRecords;
+    size_t dataOffset = ( size_t ) ( crgData->admin.dataSection - crgData->admin.fileBuffer );
+    double first;
+    char*  recBuffer;
+    FILE*  fPtr;
+    int    ok;
+    CrgCenterLineStatStruct stat;
+    
+    memset( &stat, 0, sizeof( stat ) );
+    
+    /* --- an arc length requires the complete reference line --- */
+    if ( crgData->channelX.info.defined )
+    {
+        ctx->needsData = 1;
+        return 1;
+    }
+    
+    /* --- the size of ASCII records varies, so the record count follows from the header --- */
+    if ( !( crgData->admin.dataFormat & dDataFormatBinary ) )
+    {
+        if ( crgData->channelU.info.defined || !( crgData->channelU.info.last > crgData->channelU.info.first ) )
+        {
+            ctx->needsData = 1;
+            return 1;
+        }
+        
+        stat.nRec = ( size_t ) ( ( crgData->channelU.info.last - crgData->channelU.info.first ) / crgData->channelU.info.inc + 0.5 ) + 1;
+        
+        return finishCenterLine( crgData, &stat );
+    }
+    
+    /* --- binary records have a fixed size, so the record count follows from the data size --- */
+    noRecords = recordSize ? crgData->admin.dataSize / recordSize : 0;
+    stat.nRec = noRecords;
+    
+    crgData->channelU.info.size = noRecords;
+    
+    if ( !crgData->channelU.info.defined )
+        return finishCenterLine( crgData, &stat );
+    
+    if ( noRecords < 2 )
+    {
+        ctx->needsData = 1;
+        return 1;
+    }
+    
+    /* --- the u range is given by the first and the last record --- */
+    if ( !( recBuffer = ( char* ) crgCalloc( 1, recordSize ) ) )
         return 0;
     
-    /* --- allocate space for actual crg data --- */
-    crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderAddFile: allocating channels\n" );
-    if ( !allocateChannels( crgData ) )
+    if ( !( fPtr = fopen( filename, "rb" ) ) )
     {
-        crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: could not allocate data.\n" );
+        crgFree( recBuffer );
         return 0;
     }
     
-    /* --- read the actual CRG data --- */
-    crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderAddFile: reading actual data\n" );
-    readData( crgData );
-
-    /* --- clear temporary data and declare success --- */
-    return 1;
+    ok = crgPortFileSeek( fPtr, dataOffset ) && fread( recBuffer, 1, recordSize, fPtr ) == recordSize &&
+         decodeRecord( crgData, recBuffer, recordSize, crgData->admin.recordBuffer );
+    
+    first = crgData->admin.recordBuffer[crgData->channelU.info.index];
+    
+    ok = ok && crgPortFileSeek( fPtr, dataOffset + ( noRecords - 1 ) * recordSize ) && fread( recBuffer, 1, recordSize, fPtr ) == recordSize &&
+         decodeRecord( crgData, recBuffer, recordSize, crgData->admin.recordBuffer );
+    
+    fclose( fPtr );
+    crgFree( recBuffer );
+    
+    if ( !ok )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "readDataBounds: cannot read the first and last record of <%s>.\n", filename );
+        return 0;
+    }
+    
+    /* --- the spacing of the records is assumed to be constant --- */
+    crgData->channelU.info.first = first;
+    stat.uLast = crgData->admin.recordBuffer[crgData->channelU.info.index];
+    stat.duMin = ( stat.uLast - first ) / ( noRecords - 1 );
+    stat.duMax = stat.duMin;
+    
+    return finishCenterLine( crgData, &stat );
 }
 
 static int 
@@ -2992,31 +4212,14 @@ crgStrBeginsWithStrNoCase( const char* str1, const char* str2 )
 	return 1;
 }
 
-static void
-crgLoaderInit( void )
-{
-    static int firstTime = 1;
-    
-    /* --- do this only once! --- */
-    if ( !firstTime )
-        return;
-}
-
 static int 
 decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int code )
 {
-    static char filename[1024];
-    static char envVar[256];
-    static int firstTime = 1;
+    CrgLoaderContextStruct* ctx = crgData->admin.loaderCtx;
+    char* filename = ctx->includeFile;
+    char* envVar   = ctx->envVar;
     int result;
     
-    /* --- initialize the structures? --- */
-    if ( firstTime )
-    {
-        firstTime = 0;
-        memset( filename, 0, 1024 * sizeof( char ) );
-    }
-    
     switch ( code )
     {
         case dOpcodeIncludeItem:
@@ -3072,7 +4275,7 @@ decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int code )
                             bufPtrEnvEnd++;
                         }
                             
-                        memset( envVar, 0,  256 * sizeof( char ) );
+                        memset( envVar, 0, dCrgLoaderMaxEnvLen * sizeof( char ) );
                         
                         strncpy( envVar, bufPtrEnv, ( bufPtrEnvEnd - bufPtrEnv ) );
                         
@@ -3099,6 +4302,15 @@ decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int code )
             {
                 CrgAdminStruct adminBackup;
                 
+                /* --- the data of a composed file may reside in any of its parts --- */
+                if ( ctx->headerOnly )
+                {
+                    crgMsgPrint( dCrgMsgLevelInfo, "decodeIncludeFile: not reading header only of include file <%s>\n", filename );
+                    memset( filename, 0, dCrgLoaderMaxPathLen * sizeof( char ) );
+                    ctx->needsData = 1;
+                    return 1;
+                }
+                
                 crgMsgPrint( dCrgMsgLevelNotice, "--------------------------------------\n", filename );
                 crgMsgPrint( dCrgMsgLevelNotice, "decodeIncludeFile: importing file <%s>\n", filename );
                 
@@ -3107,11 +4319,14 @@ decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int code )
                 crgData->admin.sectionType = dFileSectionNone;
                 
                 /* load the include file and set the file level accordingly */
-                mFileLevel++;
+                ctx->fileLevel++;
+                
+                result = crgLoaderAddFile( filename, &crgData, ctx );
                 
-                result = crgLoaderAddFile( filename, &crgData );
+                ctx->fileLevel--;
                 
-                mFileLevel--;
+                /* the grid may have been allocated by the include file */
+                adminBackup.gridBuffer = crgData->admin.gridBuffer;
                 
                 if ( !result )
                     return 0;
@@ -3123,7 +4338,7 @@ decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int code )
                 crgMsgPrint( dCrgMsgLevelNotice, "decodeIncludeFile: continuing with previous file\n" );
                 
                 /* reset the filename for successive read operations */
-                memset( filename, 0, sizeof( filename ) );
+                memset( filename, 0, dCrgLoaderMaxPathLen * sizeof( char ) );
                 
                 return 1;
                 
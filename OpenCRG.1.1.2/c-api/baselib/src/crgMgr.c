@@ -27,7 +27,7 @@
 #include <math.h>
 
 /* ====== LOCAL VARIABLES ====== */
-static CrgDataStruct** sDataSetList = NULL;
+static CrgDataStruct** sDataSetList = NULL;     /* guarded by dCrgLockDataSets */
 static int             sNoDataSets  = 0;
 
 /* ====== LOCAL METHODS ====== */
@@ -62,6 +62,12 @@ static void crgDataApplyTransformations( CrgDataStruct *crgData );
 */
 static void rotatePoint( double* x, double* y, double ctrX, double ctrY, double angle );
 
+/**
+* release all dynamically allocated data of a data set and the data set itself
+* @param crgData    pointer to data set which is to be released
+*/
+static void releaseData( CrgDataStruct* crgData );
+
 /* ====== IMPLEMENTATION ====== */
 int
 crgDataSetRelease( int dataSet )
@@ -73,13 +79,110 @@ crgDataSetRelease( int dataSet )
     if ( !crgData )
         return 0;
     
+    /* --- the grid is shared with the views of the data set --- */
+    if ( crgData->admin.noViews )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetRelease: data set <%d> is referenced by %d view(s).\n", dataSet, crgData->admin.noViews );
+        return 0;
+    }
+    
     /* --- release all contact points referring to this data set --- */
     crgContactPointDeleteAll( dataSet );
     
+    /* --- invalidate the data set in the master list --- */
+    crgPortLock( dCrgLockDataSets );
+    
+    for ( i = 0; i < (size_t)sNoDataSets; i++ )
+        if ( sDataSetList[i] == crgData )
+        {
+            sDataSetList[i] = NULL;
+            break;
+        }
+    
+    crgPortUnlock( dCrgLockDataSets );
+        
+    /* --- finally: free the data --- */
+    releaseData( crgData );
+     
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetRelease: released data set no. %d\n", dataSet );
+
+    return 1;
+}
+
+int
+crgDataSetReplace( int dataSetId, int sourceId )
+{
+    size_t i;
+    int    found = 0;
+    CrgOptionsStruct list;
+    CrgDataStruct*   crgData = crgDataSetAccess( dataSetId );
+    CrgDataStruct*   srcData = crgDataSetAccess( sourceId );
+    
+    if ( !crgData || !srcData || crgData == srcData )
+        return 0;
+    
+    if ( crgData->admin.noViews )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetReplace: data set <%d> is referenced by %d view(s).\n", dataSetId, crgData->admin.noViews );
+        return 0;
+    }
+    
+    /* --- contact points refer to the data of the replaced data set --- */
+    crgContactPointDeleteAll( dataSetId );
+    
+    /* --- the settings of the replaced data set remain valid --- */
+    memcpy( &list, &( srcData->options ), sizeof( CrgOptionsStruct ) );
+    memcpy( &( srcData->options ), &( crgData->options ), sizeof( CrgOptionsStruct ) );
+    memcpy( &( crgData->options ), &list, sizeof( CrgOptionsStruct ) );
+    
+    memcpy( &list, &( srcData->modifiers ), sizeof( CrgOptionsStruct ) );
+    memcpy( &( srcData->modifiers ), &( crgData->modifiers ), sizeof( CrgOptionsStruct ) );
+    memcpy( &( crgData->modifiers ), &list, sizeof( CrgOptionsStruct ) );
+    
+    /* --- the source takes the slot and the ID of the target; pointers to the source remain valid --- */
+    crgPortLock( dCrgLockDataSets );
+    
+    for ( i = 0; i < (size_t)sNoDataSets; i++ )
+    {
+        if ( sDataSetList[i] == srcData )
+            sDataSetList[i] = NULL;
+        else if ( sDataSetList[i] == crgData )
+        {
+            sDataSetList[i] = srcData;
+            found           = 1;
+        }
+    }
+    
+    srcData->admin.id = dataSetId;
+    
+    crgPortUnlock( dCrgLockDataSets );
+    
+    releaseData( crgData );
+    
+    crgMsgPrint( dCrgMsgLevelInfo, "crgDataSetReplace: replaced data set no. %d by no. %d\n", dataSetId, sourceId );
+
+    return found;
+}
+
+static void
+releaseData( CrgDataStruct* crgData )
+{
+    /* --- a view refers to the grid of its owner --- */
+    if ( crgData->admin.viewOwner )
+    {
+        crgPortLock( dCrgLockDataSets );
+        crgData->admin.viewOwner->admin.noViews--;
+        crgPortUnlock( dCrgLockDataSets );
+    }
+    
     /* --- release all dynamically allocated data of the data set --- */
-    for( i = 0; i < crgData->channelV.info.size; i++ )
-        if ( crgData->channelZ[i].data )
-            crgFree( crgData->channelZ[i].data );
+    crgSnapshotRelease( crgData );
+    crgLoaderReleaseGrid( crgData );
+    crgEvalxy2uvReleaseIndex( crgData );
+    crgReleaseRefLineGeom( crgData );
+    crgDataGridReleaseQuant( crgData );
+    crgDataGridStreamRelease( crgData );
+    crgDataGridFilterRelease( crgData );
     
     crgFree( crgData->channelZ );
     
@@ -110,22 +213,12 @@ crgDataSetRelease( int dataSet )
     
     if ( crgData->options.entry )
         crgFree( crgData->options.entry );
+    
+    if ( crgData->admin.sourceFile )
+        crgFree( crgData->admin.sourceFile );
 
-    /* --- invalidate the data set in the master list --- */
-    for ( i = 0; i < (size_t)sNoDataSets; i++ )
-        if ( sDataSetList[i] == crgData )
-        {
-            sDataSetList[i] = NULL;
-            break;
-        }
-        
-   /* --- finally: free the crgData struct --- */
-   crgFree( crgData ); 
-     
-   crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetRelease: released data set no. %d\n", dataSet );
-
-        
-    return 1;
+    /* --- finally: free the crgData struct --- */
+    crgFree( crgData ); 
 }
 
 CrgDataStruct* 
@@ -134,6 +227,11 @@ crgDataSetCreate( void )
     int i;
     int maxId = 0;
     int tgtId = -1;
+    CrgDataStruct*  crgData;
+    CrgDataStruct** newList;
+    
+    /* --- ID assignment and registration must not be interrupted by other threads --- */
+    crgPortLock( dCrgLockDataSets );
     
     /* --- get the maximum ID of existing data sets --- */
     for ( i = 0; i < sNoDataSets; i++ )
@@ -148,46 +246,70 @@ crgDataSetCreate( void )
     /* --- next available ID is maximum ID plus one --- */
     maxId++;
     
-    crgMsgPrint( dCrgMsgLevelInfo, "crgDataSetCreate: creating data set with id %d\n", maxId );
+    /* --- now allocate the space for the dataset itself --- */
+    if ( !( crgData = ( CrgDataStruct* ) crgCalloc( 1, sizeof( CrgDataStruct ) ) ) )
+    {
+        crgPortUnlock( dCrgLockDataSets );
+        return NULL;
+    }
+    
+    crgData->admin.id = maxId;
     
     /* --- any unused ID available or do we need to exend the data management list? --- */
     if ( tgtId < 0 )
     {
-        sDataSetList = ( CrgDataStruct** ) crgRealloc( sDataSetList, ( sNoDataSets + 1 ) * sizeof( CrgDataStruct* ) );
+        if ( !( newList = ( CrgDataStruct** ) crgRealloc( sDataSetList, ( sNoDataSets + 1 ) * sizeof( CrgDataStruct* ) ) ) )
+        {
+            crgPortUnlock( dCrgLockDataSets );
+            crgFree( crgData );
+            return NULL;
+        }
+        
+        sDataSetList = newList;
         tgtId        = sNoDataSets;
         sNoDataSets++;
     }
     
-    /* --- now allocate the space for the dataset itself --- */
-    sDataSetList[tgtId]           = ( CrgDataStruct* ) crgCalloc( 1, sizeof( CrgDataStruct ) );
-    sDataSetList[tgtId]->admin.id = maxId;
+    sDataSetList[tgtId] = crgData;
+    
+    crgPortUnlock( dCrgLockDataSets );
+    
+    crgMsgPrint( dCrgMsgLevelInfo, "crgDataSetCreate: creating data set with id %d\n", maxId );
     
     /* --- allocate the memory for the options and modifiers --- */
-    crgOptionCreateList( &( sDataSetList[tgtId]->options   ) );
-    crgOptionCreateList( &( sDataSetList[tgtId]->modifiers ) );
+    crgOptionCreateList( &( crgData->options   ) );
+    crgOptionCreateList( &( crgData->modifiers ) );
     
     /* --- set the default options of the data set --- */
     crgDataSetModifierSetDefault( maxId );
     crgDataSetOptionSetDefault( maxId );
     
-    return sDataSetList[tgtId];
+    return crgData;
 }
     
 CrgDataStruct*
 crgDataSetAccess( int id )
 {
     int i;
+    CrgDataStruct* crgData = NULL;
+    
+    crgPortLock( dCrgLockDataSets );
     
     for ( i = 0; i < sNoDataSets; i++ )
     {
         if( sDataSetList[i] )
         {
             if ( sDataSetList[i]->admin.id == id )
-                return sDataSetList[i];
+            {
+                crgData = sDataSetList[i];
+                break;
+            }
         }
     }
+    
+    crgPortUnlock( dCrgLockDataSets );
 
-    return NULL;
+    return crgData;
 }
 
 void
@@ -506,6 +628,8 @@ crgDataSetModifiersApply( int dataSetId )
     int    iValue;
     size_t i;
     int    needPrepare = 0; /* per default, data doesn't have to be re-prepared */
+    double quantBound  = 0.0;
+    double quantError  = 0.0;
     
     CrgDataStruct *crgData = crgDataSetAccess( dataSetId );
     
@@ -515,6 +639,43 @@ crgDataSetModifiersApply( int dataSetId )
         return;
     }
     
+    /* --- modifiers are applied once the data has been read --- */
+    if ( crgData->admin.headerOnly )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetModifiersApply: data of data set <%d> has not been read.\n", dataSetId );
+        return;
+    }
+    
+    /* --- the grid of a view is shared with its owner --- */
+    if ( crgData->admin.viewOwner || crgData->admin.noViews )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetModifiersApply: grid of data set <%d> is shared by a view.\n", dataSetId );
+        return;
+    }
+    
+    /* --- a quantized grid is expanded for the modifiers which re-prepare the data --- */
+    if ( crgData->gridQuant.valid &&
+         ( crgOptionIsSet( &( crgData->modifiers ), dCrgModScaleZ )         ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModScaleSlope )     ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModScaleLength )    ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModScaleWidth )     ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModScaleCurvature ) ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModGridNaNMode )    ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModPeakLimit )      ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModLimitZMin )      ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModLimitZMax )      ||
+           crgOptionIsSet( &( crgData->modifiers ), dCrgModFilterMode ) ) )
+    {
+        quantBound = crgData->gridQuant.errorBound;
+        quantError = crgData->gridQuant.maxError;
+        
+        if ( !crgDataGridExpand( crgData ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetModifiersApply: cannot expand quantized grid of data set <%d>.\n", dataSetId );
+            return;
+        }
+    }
+    
     /* --- is z scaling defined? --- */
     if ( crgOptionGetDouble( &( crgData->modifiers ), dCrgModScaleZ, &dValue ) )
     {
@@ -522,6 +683,12 @@ crgDataSetModifiersApply( int dataSetId )
         
         for ( i = 0; i < crgData->channelV.info.size; i++ )
             crgDataScaleChannel( ( CrgChannelBaseStruct* ) &( crgData->channelZ[i] ), dValue, 0 );
+        
+        /* --- a streamed grid is scaled while its pages are read --- */
+        crgDataGridStreamScale( crgData, dValue );
+        
+        /* --- the deviations of a formerly quantized grid are scaled as well --- */
+        quantError *= fabs( dValue );
     }
     
     /* --- is slope scaling defined? --- */
@@ -612,13 +779,55 @@ crgDataSetModifiersApply( int dataSetId )
         crgLoaderHandleNaNs( crgData, iValue, dValue );
     }
     
+    /* --- limit peaks and values of the grid --- */
+    if ( crgOptionIsSet( &( crgData->modifiers ), dCrgModPeakLimit ) ||
+         crgOptionIsSet( &( crgData->modifiers ), dCrgModLimitZMin ) ||
+         crgOptionIsSet( &( crgData->modifiers ), dCrgModLimitZMax ) )
+    {
+        if ( crgDataGridLimit( crgData ) )
+            needPrepare = 1;
+        else
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetModifiersApply: grid of data set <%d> has not been limited.\n", dataSetId );
+    }
+    
+    /* --- filter the grid --- */
+    if ( crgOptionGetInt( &( crgData->modifiers ), dCrgModFilterMode, &iValue ) && iValue != dCrgFilterNone )
+    {
+        if ( crgDataGridFilter( crgData, &dValue ) )
+        {
+            needPrepare = 1;
+            
+            /* --- the deviations of a formerly quantized grid pass the filter as well --- */
+            quantError *= dValue;
+        }
+        else
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetModifiersApply: grid of data set <%d> has not been filtered.\n", dataSetId );
+    }
+    
     /* --- does the data prepare stage need to be re-called? --- */
     if ( needPrepare )
         crgLoaderPrepareData( crgData );
+    
+    /* --- re-quantize within the error budget left by the previous quantization --- */
+    if ( quantBound > 0.0 )
+    {
+        if ( crgDataGridQuantize( crgData, quantBound - quantError ) )
+        {
+            crgData->gridQuant.errorBound  = quantBound;
+            crgData->gridQuant.maxError   += quantError;
+        }
+        else
+            crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetModifiersApply: data set <%d> keeps its float grid.\n", dataSetId );
+    }
 
     
     /* --- transform data to a different location? --- */
     crgDataApplyTransformations( crgData );
+    
+    crgData->admin.modsApplied = 1;
+    
+    /* --- existing contact points must not keep kernels chosen for the unmodified data --- */
+    crgContactPointSelectKernelForDataSet( crgData );
 }
 
 static void
@@ -685,6 +894,45 @@ crgDataSetModifierSetDefault( int dataSetId )
     crgOptionSetDefaultModifiers( &( crgData->modifiers ) );
 }
 
+int
+crgDataSetModifierSetFilterMask( int dataSetId, const double* mask, int sizeU, int sizeV )
+{
+    CrgDataStruct *crgData = crgDataSetAccess( dataSetId );
+    
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetModifierSetFilterMask: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+    
+    if ( !mask || sizeU < 1 || sizeV < 1 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetModifierSetFilterMask: invalid mask of size %d x %d.\n", sizeU, sizeV );
+        return 0;
+    }
+    
+    if ( !crgDataGridFilterSetMask( crgData, mask, sizeU, sizeV ) )
+        return 0;
+    
+    return crgOptionSetInt( &( crgData->modifiers ), dCrgModFilterMode,  dCrgFilterMask ) &&
+           crgOptionSetInt( &( crgData->modifiers ), dCrgModFilterSizeU, sizeU )          &&
+           crgOptionSetInt( &( crgData->modifiers ), dCrgModFilterSizeV, sizeV );
+}
+
+int
+crgDataSetGetPeaks( int dataSetId, double threshold, int radius, double* u, double* v, double* z, int maxPeaks )
+{
+    CrgDataStruct *crgData = crgDataSetAccess( dataSetId );
+    
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetGetPeaks: invalid data set id <%d>.\n", dataSetId );
+        return -1;
+    }
+    
+    return crgDataGridGetPeaks( crgData, threshold, radius, u, v, z, maxPeaks );
+}
+
 void
 crgDataSetOptionSetDefault( int dataSetId )
 {
@@ -704,7 +952,13 @@ crgMemRelease( void )
 {
     int i;
 
-    /* --- delete all data sets --- */
+    /* --- delete all data sets, views before the data sets they refer to --- */
+    for ( i = 0; i < sNoDataSets; i++ )
+    {
+        if ( sDataSetList[i] && sDataSetList[i]->admin.viewOwner )
+            crgDataSetRelease( sDataSetList[i]->admin.id );
+    }
+    
     for ( i = 0; i < sNoDataSets; i++ )
     {
         if ( sDataSetList[i] )
@@ -712,10 +966,14 @@ crgMemRelease( void )
     }
     
     /* --- finally: release the list holding all data sets --- */
+    crgPortLock( dCrgLockDataSets );
+    
     crgFree( sDataSetList );
 
     sDataSetList = NULL;
     sNoDataSets  = 0;
+    
+    crgPortUnlock( dCrgLockDataSets );
 }
 
 const char*
@@ -735,7 +993,7 @@ crgIsNan( double *dValue )
     /* --- assign the value that is to be checked --- */
     memcpy( &checkVal.dVal, dValue, sizeof( double ) );
     
-    if ( mCrgBigEndian )
+    if ( dCrgBigEndian )
         return ( checkVal.iVal[0] & 0x7ff80000 ) >= 0x7ff80000;
     
     return ( checkVal.iVal[1] & 0x7ff80000 ) >= 0x7ff80000;
@@ -749,7 +1007,7 @@ crgSetNan( double* dValue )
     if ( !dValue )
         return;
     
-    if ( mCrgBigEndian )
+    if ( dCrgBigEndian )
     {
         int myNan[2] = { 0x7ff80000, 0x00000000 };
         memcpy( dValue, myNan, sizeof( double ) );
@@ -942,7 +1200,7 @@ crgDataApplyTransformations( CrgDataStruct *crgData )
     {
         /* --- compute FROM point --- */
         crgDataEvaluv2xy( crgData, &( crgData->options ), uPos, vPos, &( fromXYZ[0] ), &( fromXYZ[1] ) );
-        crgDataEvaluv2z( crgData, &( crgData->options ), uPos, vPos, &( fromXYZ[2] ) );
+        crgDataEvaluv2z( crgData, &( crgData->options ), NULL, uPos, vPos, &( fromXYZ[2] ) );
         crgDataEvaluv2pk( crgData, &( crgData->options ), uPos, vPos, &( fromPhi ), &( fromCurv ) );
         
         /* correct rotation angle */
@@ -976,7 +1234,7 @@ crgDataApplyTransformations( CrgDataStruct *crgData )
         transform |= crgOptionGetDouble( &( crgData->modifiers ), dCrgModRefLineOffsetZ,    &( toXYZ[2] ) );
         transform |= crgOptionGetDouble( &( crgData->modifiers ), dCrgModRefLineOffsetPhi,  &rotAngle );
 
-        crgDataEvaluv2z( crgData, NULL, 0.0, 0.0, &( fromXYZ[2] ) );
+        crgDataEvaluv2z( crgData, NULL, NULL, 0.0, 0.0, &( fromXYZ[2] ) );
 
         toXYZ[0] += fromXYZ[0];
         toXYZ[1] += fromXYZ[1];
@@ -1045,6 +1303,10 @@ crgDataApplyTransformations( CrgDataStruct *crgData )
                 crgData->channelZ[i].info.last  += toXYZ[2] - fromXYZ[2];
             }
         }
+        
+        /* --- the reference line has moved --- */
+        crgEvalxy2uvBuildIndex( crgData );
+        crgCalcRefLineGeom( crgData );
     }
 }
 
@@ -108,6 +108,10 @@ crgOptionGetName( unsigned int optionId )
             return "expected abs. tolerance";
             break;
 
+        case dCrgCpOptionRefLinePredict:
+            return "refline search prediction";
+            break;
+
         case dCrgModScaleZ:
             return "modifier z scale";
             break;
@@ -204,6 +208,74 @@ crgOptionGetName( unsigned int optionId )
             return "modifier reference line offset z";
             break;
 
+        case dCrgModFilterMode:
+            return "modifier filter mode";
+            break;
+
+        case dCrgModFilterSizeU:
+            return "modifier filter size u";
+            break;
+
+        case dCrgModFilterSizeV:
+            return "modifier filter size v";
+            break;
+
+        case dCrgModFilterWeight:
+            return "modifier filter weight";
+            break;
+
+        case dCrgModFilterRepeat:
+            return "modifier filter repeat";
+            break;
+
+        case dCrgModFilterUBegin:
+            return "modifier filter u begin";
+            break;
+
+        case dCrgModFilterUEnd:
+            return "modifier filter u end";
+            break;
+
+        case dCrgModFilterVBegin:
+            return "modifier filter v begin";
+            break;
+
+        case dCrgModFilterVEnd:
+            return "modifier filter v end";
+            break;
+
+        case dCrgModLimitZMin:
+            return "modifier limit z min";
+            break;
+
+        case dCrgModLimitZMax:
+            return "modifier limit z max";
+            break;
+
+        case dCrgModPeakLimit:
+            return "modifier peak limit";
+            break;
+
+        case dCrgModPeakRadius:
+            return "modifier peak radius";
+            break;
+
+        case dCrgModLimitUBegin:
+            return "modifier limit u begin";
+            break;
+
+        case dCrgModLimitUEnd:
+            return "modifier limit u end";
+            break;
+
+        case dCrgModLimitVBegin:
+            return "modifier limit v begin";
+            break;
+
+        case dCrgModLimitVEnd:
+            return "modifier limit v end";
+            break;
+
         default:
             return "unknown";
             break;
@@ -255,6 +327,18 @@ crgOptionGetType( unsigned int optionId )
         case dCrgModRefLineOffsetX:
         case dCrgModRefLineOffsetY:
         case dCrgModRefLineOffsetZ:
+        case dCrgModFilterWeight:
+        case dCrgModFilterUBegin:
+        case dCrgModFilterUEnd:
+        case dCrgModFilterVBegin:
+        case dCrgModFilterVEnd:
+        case dCrgModLimitZMin:
+        case dCrgModLimitZMax:
+        case dCrgModPeakLimit:
+        case dCrgModLimitUBegin:
+        case dCrgModLimitUEnd:
+        case dCrgModLimitVBegin:
+        case dCrgModLimitVEnd:
             return dCrgOptionDataTypeDouble;
             break;
             
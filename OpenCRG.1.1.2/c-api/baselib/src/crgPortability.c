@@ -26,6 +26,15 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#if defined( _WIN32 )
+#    define dCrgPortWin32
+#    include <windows.h>
+#elif defined( __unix__ ) || defined( __APPLE__ )
+#    define dCrgPortPthread
+#    include <pthread.h>
+#    include <unistd.h>
+#endif
+
 /*
 * try to stay compatible with older MSM compilers
 */
@@ -33,6 +42,30 @@
 #define vsnprintf _vsnprintf
 #endif
 
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    void ( *task )( void* data, int taskId );   /* function executing the task  */
+    void*  data;                                /* data shared by all tasks     */
+    int    taskId;                              /* index of this task           */
+} CrgPortTaskStruct;
+
+#if defined( dCrgPortPthread )
+typedef struct
+{
+    pthread_t thread;                           /* the thread                   */
+    void ( *task )( void* data );               /* function run by the thread   */
+    void*     data;                             /* data passed to the function  */
+} CrgPortThreadStruct;
+#elif defined( dCrgPortWin32 )
+typedef struct
+{
+    HANDLE    thread;                           /* the thread                   */
+    void ( *task )( void* data );               /* function run by the thread   */
+    void*     data;                             /* data passed to the function  */
+} CrgPortThreadStruct;
+#endif
+
 /* ====== LOCAL VARIABLES ====== */
 static int mMsgLevel    = dCrgMsgLevelNotice;
 static int mMaxWarnMsgs = -1;
@@ -43,6 +76,14 @@ static void* ( *mReallocCallback ) ( void* ptr, size_t size ) = NULL;
 static void ( *mFreeCallback ) ( void* ptr ) = NULL;
 static int ( *mMsgCallback ) ( int level, char* message ) = NULL;
 
+#if defined( dCrgPortPthread )
+static pthread_mutex_t mLocks[dCrgNoLocks] = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+                                               PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+                                               PTHREAD_MUTEX_INITIALIZER };
+#elif defined( dCrgPortWin32 )
+static volatile LONG   mLocks[dCrgNoLocks] = { 0 };
+#endif
+
 void 
 crgMsgPrint( int level, const char *format, ...)
 {
@@ -72,9 +113,15 @@ crgMsgPrint( int level, const char *format, ...)
         return;
     }
 
+    /* --- message counter and output are shared by all threads --- */
+    crgPortLock( dCrgLockMessages );
+    
     /** @todo: this is just a temporary solution and should be completed until 1.0 */
     if ( !mMaxWarnMsgs )
+    {
+        crgPortUnlock( dCrgLockMessages );
         return;
+    }
     
     if ( mMaxWarnMsgs > 0 )
         mMaxWarnMsgs--;
@@ -87,6 +134,8 @@ crgMsgPrint( int level, const char *format, ...)
 
     if ( ret <= 0 )
         fprintf( stderr, "crgMsgPrint: Cannot create message.\n" );
+    
+    crgPortUnlock( dCrgLockMessages );
 }
     
 void
@@ -144,7 +193,9 @@ crgFreeSetCallback( void ( *func ) ( void* ptr ) )
 void
 crgPortSetMaxWarnMsgs( int maxNo )
 {
+    crgPortLock( dCrgLockMessages );
     mMaxWarnMsgs = maxNo;
+    crgPortUnlock( dCrgLockMessages );
 }
 
 void
@@ -156,7 +207,13 @@ crgPortSetMaxLogMsgs( int maxNo )
 int
 crgPortMsgIsPrintable( int level )
 {
-    return mMaxWarnMsgs != 0;
+    int printable;
+    
+    crgPortLock( dCrgLockMessages );
+    printable = ( mMaxWarnMsgs != 0 );
+    crgPortUnlock( dCrgLockMessages );
+    
+    return printable;
 }
 
 void
@@ -164,3 +221,401 @@ crgMsgSetCallback( int ( *func ) ( int level, char* message ) )
 {
     mMsgCallback = func;
 }
+
+void
+crgPortLock( int lockId )
+{
+    if ( lockId < 0 || lockId >= dCrgNoLocks )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_mutex_lock( &mLocks[lockId] );
+#elif defined( dCrgPortWin32 )
+    /* --- locks are held for short operations only, so spinning is sufficient --- */
+    while ( InterlockedCompareExchange( &mLocks[lockId], 1, 0 ) )
+        SwitchToThread();
+#endif
+}
+
+void
+crgPortUnlock( int lockId )
+{
+    if ( lockId < 0 || lockId >= dCrgNoLocks )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_mutex_unlock( &mLocks[lockId] );
+#elif defined( dCrgPortWin32 )
+    InterlockedExchange( &mLocks[lockId], 0 );
+#endif
+}
+
+#if defined( dCrgPortPthread )
+static void*
+runTask( void* arg )
+{
+    CrgPortTaskStruct* task = ( CrgPortTaskStruct* ) arg;
+    
+    task->task( task->data, task->taskId );
+    
+    return NULL;
+}
+#elif defined( dCrgPortWin32 )
+static DWORD WINAPI
+runTask( LPVOID arg )
+{
+    CrgPortTaskStruct* task = ( CrgPortTaskStruct* ) arg;
+    
+    task->task( task->data, task->taskId );
+    
+    return 0;
+}
+#endif
+
+void
+crgPortRunTasks( void ( *task )( void* data, int taskId ), void* data, int noTasks )
+{
+    CrgPortTaskStruct* tasks;
+    int                i;
+#if defined( dCrgPortPthread )
+    pthread_t*         threads;
+    char*              started;
+#elif defined( dCrgPortWin32 )
+    HANDLE*            threads;
+#endif
+    
+    if ( !task || noTasks < 1 )
+        return;
+    
+    tasks = ( CrgPortTaskStruct* ) crgCalloc( noTasks, sizeof( CrgPortTaskStruct ) );
+    
+#if defined( dCrgPortPthread )
+    threads = ( pthread_t* ) crgCalloc( noTasks, sizeof( pthread_t ) );
+    started = ( char* ) crgCalloc( noTasks, sizeof( char ) );
+    
+    if ( noTasks > 1 && tasks && threads && started )
+    {
+        for ( i = 0; i < noTasks; i++ )
+        {
+            tasks[i].task   = task;
+            tasks[i].data   = data;
+            tasks[i].taskId = i;
+        }
+        
+        /* --- the calling thread executes the first task itself --- */
+        for ( i = 1; i < noTasks; i++ )
+            started[i] = !pthread_create( &threads[i], NULL, runTask, &tasks[i] );
+        
+        task( data, 0 );
+        
+        /* --- tasks which could not get a thread of their own are run here --- */
+        for ( i = 1; i < noTasks; i++ )
+        {
+            if ( started[i] )
+                pthread_join( threads[i], NULL );
+            else
+                task( data, i );
+        }
+        
+        crgFree( started );
+        crgFree( threads );
+        crgFree( tasks );
+        return;
+    }
+    
+    if ( started )
+        crgFree( started );
+    
+    if ( threads )
+        crgFree( threads );
+#elif defined( dCrgPortWin32 )
+    threads = ( HANDLE* ) crgCalloc( noTasks, sizeof( HANDLE ) );
+    
+    if ( noTasks > 1 && tasks && threads )
+    {
+        for ( i = 0; i < noTasks; i++ )
+        {
+            tasks[i].task   = task;
+            tasks[i].data   = data;
+            tasks[i].taskId = i;
+        }
+        
+        for ( i = 1; i < noTasks; i++ )
+            threads[i] = CreateThread( NULL, 0, runTask, &tasks[i], 0, NULL );
+        
+        task( data, 0 );
+        
+        for ( i = 1; i < noTasks; i++ )
+        {
+            if ( threads[i] )
+            {
+                WaitForSingleObject( threads[i], INFINITE );
+                CloseHandle( threads[i] );
+            }
+            else
+                task( data, i );
+        }
+        
+        crgFree( threads );
+        crgFree( tasks );
+        return;
+    }
+    
+    if ( threads )
+        crgFree( threads );
+#endif
+    
+    if ( tasks )
+        crgFree( tasks );
+    
+    /* --- no threads available, run the tasks one after another --- */
+    for ( i = 0; i < noTasks; i++ )
+        task( data, i );
+}
+
+void*
+crgPortMutexCreate( void )
+{
+#if defined( dCrgPortPthread )
+    pthread_mutex_t* mutex = ( pthread_mutex_t* ) crgCalloc( 1, sizeof( pthread_mutex_t ) );
+    
+    if ( mutex && pthread_mutex_init( mutex, NULL ) )
+    {
+        crgFree( mutex );
+        return NULL;
+    }
+    
+    return mutex;
+#elif defined( dCrgPortWin32 )
+    CRITICAL_SECTION* mutex = ( CRITICAL_SECTION* ) crgCalloc( 1, sizeof( CRITICAL_SECTION ) );
+    
+    if ( mutex )
+        InitializeCriticalSection( mutex );
+    
+    return mutex;
+#else
+    return NULL;
+#endif
+}
+
+void
+crgPortMutexDelete( void* mutex )
+{
+    if ( !mutex )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_mutex_destroy( ( pthread_mutex_t* ) mutex );
+#elif defined( dCrgPortWin32 )
+    DeleteCriticalSection( ( CRITICAL_SECTION* ) mutex );
+#endif
+    
+    crgFree( mutex );
+}
+
+void
+crgPortMutexLock( void* mutex )
+{
+    if ( !mutex )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_mutex_lock( ( pthread_mutex_t* ) mutex );
+#elif defined( dCrgPortWin32 )
+    EnterCriticalSection( ( CRITICAL_SECTION* ) mutex );
+#endif
+}
+
+void
+crgPortMutexUnlock( void* mutex )
+{
+    if ( !mutex )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_mutex_unlock( ( pthread_mutex_t* ) mutex );
+#elif defined( dCrgPortWin32 )
+    LeaveCriticalSection( ( CRITICAL_SECTION* ) mutex );
+#endif
+}
+
+void*
+crgPortCondCreate( void )
+{
+#if defined( dCrgPortPthread )
+    pthread_cond_t* cond = ( pthread_cond_t* ) crgCalloc( 1, sizeof( pthread_cond_t ) );
+    
+    if ( cond && pthread_cond_init( cond, NULL ) )
+    {
+        crgFree( cond );
+        return NULL;
+    }
+    
+    return cond;
+#elif defined( dCrgPortWin32 )
+    CONDITION_VARIABLE* cond = ( CONDITION_VARIABLE* ) crgCalloc( 1, sizeof( CONDITION_VARIABLE ) );
+    
+    if ( cond )
+        InitializeConditionVariable( cond );
+    
+    return cond;
+#else
+    return NULL;
+#endif
+}
+
+void
+crgPortCondDelete( void* cond )
+{
+    if ( !cond )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_cond_destroy( ( pthread_cond_t* ) cond );
+#endif
+    
+    crgFree( cond );
+}
+
+void
+crgPortCondWait( void* cond, void* mutex )
+{
+    if ( !cond || !mutex )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_cond_wait( ( pthread_cond_t* ) cond, ( pthread_mutex_t* ) mutex );
+#elif defined( dCrgPortWin32 )
+    SleepConditionVariableCS( ( CONDITION_VARIABLE* ) cond, ( CRITICAL_SECTION* ) mutex, INFINITE );
+#endif
+}
+
+void
+crgPortCondBroadcast( void* cond )
+{
+    if ( !cond )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_cond_broadcast( ( pthread_cond_t* ) cond );
+#elif defined( dCrgPortWin32 )
+    WakeAllConditionVariable( ( CONDITION_VARIABLE* ) cond );
+#endif
+}
+
+#if defined( dCrgPortPthread )
+static void*
+runThread( void* arg )
+{
+    CrgPortThreadStruct* thread = ( CrgPortThreadStruct* ) arg;
+    
+    thread->task( thread->data );
+    
+    return NULL;
+}
+#elif defined( dCrgPortWin32 )
+static DWORD WINAPI
+runThread( LPVOID arg )
+{
+    CrgPortThreadStruct* thread = ( CrgPortThreadStruct* ) arg;
+    
+    thread->task( thread->data );
+    
+    return 0;
+}
+#endif
+
+void*
+crgPortThreadStart( void ( *task )( void* data ), void* data )
+{
+#if defined( dCrgPortPthread ) || defined( dCrgPortWin32 )
+    CrgPortThreadStruct* thread;
+    
+    if ( !task || !( thread = ( CrgPortThreadStruct* ) crgCalloc( 1, sizeof( CrgPortThreadStruct ) ) ) )
+        return NULL;
+    
+    thread->task = task;
+    thread->data = data;
+    
+#if defined( dCrgPortPthread )
+    if ( pthread_create( &( thread->thread ), NULL, runThread, thread ) )
+#else
+    if ( !( thread->thread = CreateThread( NULL, 0, runThread, thread, 0, NULL ) ) )
+#endif
+    {
+        crgFree( thread );
+        return NULL;
+    }
+    
+    return thread;
+#else
+    return NULL;
+#endif
+}
+
+void
+crgPortThreadJoin( void* thread )
+{
+    if ( !thread )
+        return;
+    
+#if defined( dCrgPortPthread )
+    pthread_join( ( ( CrgPortThreadStruct* ) thread )->thread, NULL );
+#elif defined( dCrgPortWin32 )
+    WaitForSingleObject( ( ( CrgPortThreadStruct* ) thread )->thread, INFINITE );
+    CloseHandle( ( ( CrgPortThreadStruct* ) thread )->thread );
+#endif
+    
+    crgFree( thread );
+}
+
+int
+crgPortFileSeek( FILE* fPtr, size_t offset )
+{
+    if ( !fPtr )
+        return 0;
+    
+    /* --- the data of long files may start beyond the range of a 32 bit long --- */
+#if defined( _WIN32 )
+    return !_fseeki64( fPtr, ( __int64 ) offset, SEEK_SET );
+#else
+    if ( offset > ( size_t ) ( ( ( unsigned long ) -1 ) >> 1 ) )
+        return 0;
+    
+    return !fseek( fPtr, ( long ) offset, SEEK_SET );
+#endif
+}
+
+int
+crgPortGetNoProcessors( void )
+{
+#if defined( dCrgPortPthread ) && defined( _SC_NPROCESSORS_ONLN )
+    long noProcs = sysconf( _SC_NPROCESSORS_ONLN );
+    
+    return ( noProcs > 0 ) ? ( int ) noProcs : 1;
+#elif defined( dCrgPortWin32 )
+    SYSTEM_INFO info;
+    
+    GetSystemInfo( &info );
+    
+    return ( info.dwNumberOfProcessors > 0 ) ? ( int ) info.dwNumberOfProcessors : 1;
+#else
+    return 1;
+#endif
+}
+
+void
+crgPortMemoryBarrier( void )
+{
+#if defined( dCrgPortWin32 )
+    MemoryBarrier();
+#elif defined( __GNUC__ )
+    __sync_synchronize();
+#elif defined( dCrgPortPthread )
+    /* --- acquiring and releasing a mutex implies a full barrier --- */
+    static pthread_mutex_t barrier = PTHREAD_MUTEX_INITIALIZER;
+    
+    pthread_mutex_lock( &barrier );
+    pthread_mutex_unlock( &barrier );
+#endif
+}
@@ -0,0 +1,604 @@
+/* ===================================================
+ *  file:       crgSnapshot.c
+ * ---------------------------------------------------
+ *  purpose:	save and restore fully prepared data
+ *              sets as native binary snapshots
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include "crgBaseLibPrivate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#    define dCrgSnapshotUseMmap
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+/* ====== DEFINITIONS ====== */
+#define dSnapshotMagic       "CRGSNAP"
+#define dSnapshotEndianTag   0x01020304
+#define dSnapshotVersion     2
+#define dSnapshotMaxPath     1024
+#define dSnapshotHashBlock   0x10000
+
+#ifdef _WIN64
+#    define stat _stat64
+#endif
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* header of a snapshot file; magic, endian tag and version are at fixed offsets,
+* all other data is only interpreted if these match the running library
+*/
+typedef struct
+{
+    char         magic[8];                      /* file identifier                                   [-] */
+    unsigned int endianTag;                     /* dSnapshotEndianTag in writer's byte order         [-] */
+    unsigned int version;                       /* snapshot format version                           [-] */
+    unsigned int dataStructSize;                /* size of CrgDataStruct of the writer            [byte] */
+    unsigned int sourceHash;                    /* content hash of the primary CRG file              [-] */
+    size_t       sourceSize;                    /* size of the primary CRG file                   [byte] */
+    size_t       totalSize;                     /* size of the snapshot file                      [byte] */
+    char         sourceFile[dSnapshotMaxPath];  /* name of the primary CRG file                      [-] */
+} CrgSnapshotHeaderStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* calculate the content hash of a block of data (32bit, murmur3 mixing)
+* @param data     pointer to the data
+* @param size     size of the data
+* @param hash     hash value of preceding blocks (0 for the first block)
+* @return updated hash value
+*/
+static unsigned int calcHash( const unsigned char* data, size_t size, unsigned int hash );
+
+/**
+* calculate the content hash of a file
+* @param filename name of the file
+* @param hash     pointer to the resulting hash value
+* @param size     pointer to the resulting file size
+* @return 1 if successful, otherwise 0
+*/
+static int hashFile( const char* filename, unsigned int* hash, size_t* size );
+
+/**
+* round an offset up to the next section boundary
+* @param offset   offset within the snapshot
+* @return aligned offset
+*/
+static size_t alignOffset( size_t offset );
+
+/**
+* write a section of the snapshot, starting at the next section boundary
+* @param fPtr     output file
+* @param offset   pointer to the current offset within the snapshot
+* @param data     data to be written
+* @param size     size of the data
+* @return 1 if successful, otherwise 0
+*/
+static int writeSection( FILE* fPtr, size_t* offset, const void* data, size_t size );
+
+/**
+* get a section of a snapshot which has been loaded into memory
+* @param buffer   snapshot data
+* @param offset   pointer to the current offset within the snapshot
+* @param size     size of the section
+* @param total    total size of the snapshot
+* @return pointer to the section or NULL if the snapshot is too short
+*/
+static char* takeSection( char* buffer, size_t* offset, size_t size, size_t total );
+
+/**
+* get the double precision channels of a data set in snapshot order
+* @param crgData  pointer to the data set
+* @param channels array receiving the channel pointers
+* @return number of channels
+*/
+static int listChannels( CrgDataStruct* crgData, CrgChannelStruct** channels );
+
+/**
+* map or read a snapshot file into memory
+* @param filename name of the snapshot file
+* @param size     size of the file
+* @param mapped   pointer to flag whether the file has been mapped
+* @return pointer to the data or NULL if not successful
+*/
+static char* openSnapshot( const char* filename, size_t size, int* mapped );
+
+/**
+* release the memory of a snapshot file
+* @param buffer   snapshot data
+* @param size     size of the file
+* @param mapped   flag whether the file has been mapped
+*/
+static void closeSnapshot( char* buffer, size_t size, int mapped );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataSetSave( int dataSetId, const char* filename )
+{
+    CrgDataStruct*          crgData = crgDataSetAccess( dataSetId );
+    CrgDataStruct           image;
+    CrgSnapshotHeaderStruct header;
+    CrgChannelStruct*       channels[8];
+    int                     noChannels;
+    size_t                  offset = 0;
+    size_t                  i;
+    int                     ok;
+    FILE*                   fPtr;
+
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetSave: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+
+    if ( crgData->admin.headerOnly )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetSave: data of data set <%d> has not been read.\n", dataSetId );
+        return 0;
+    }
+
+    /* --- snapshots hold the float grid only --- */
+    if ( crgData->gridQuant.valid )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetSave: data set <%d> has a quantized grid.\n", dataSetId );
+        return 0;
+    }
+
+    if ( crgData->gridStream.valid )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetSave: data set <%d> has a streamed grid.\n", dataSetId );
+        return 0;
+    }
+
+    /* --- the snapshot is validated against the content of the primary CRG file --- */
+    memset( &header, 0, sizeof( header ) );
+
+    if ( !crgData->admin.sourceFile || strlen( crgData->admin.sourceFile ) >= dSnapshotMaxPath )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetSave: data set <%d> has no valid source file.\n", dataSetId );
+        return 0;
+    }
+
+    if ( !hashFile( crgData->admin.sourceFile, &header.sourceHash, &header.sourceSize ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetSave: cannot read source file <%s>.\n", crgData->admin.sourceFile );
+        return 0;
+    }
+
+    strcpy( header.magic, dSnapshotMagic );
+    strcpy( header.sourceFile, crgData->admin.sourceFile );
+    header.endianTag      = dSnapshotEndianTag;
+    header.version        = dSnapshotVersion;
+    header.dataStructSize = sizeof( CrgDataStruct );
+
+    /* --- the image of the data set; modifiers which have been applied must not be applied again --- */
+    memcpy( &image, crgData, sizeof( CrgDataStruct ) );
+
+    if ( image.admin.modsApplied )
+        image.modifiers.noEntries = 0;
+
+    noChannels = listChannels( crgData, channels );
+
+    if ( ( fPtr = fopen( filename, "wb" ) ) == NULL )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetSave: could not open <%s>.\n", filename );
+        return 0;
+    }
+
+    /* --- header first, total size is filled in after all sections are known --- */
+    ok = writeSection( fPtr, &offset, &header, sizeof( header ) );
+    ok = ok && writeSection( fPtr, &offset, &image, sizeof( image ) );
+    ok = ok && writeSection( fPtr, &offset, crgData->modifiers.entry, image.modifiers.noEntries * sizeof( CrgOptionEntryStruct ) );
+    ok = ok && writeSection( fPtr, &offset, crgData->options.entry, image.options.noEntries * sizeof( CrgOptionEntryStruct ) );
+    ok = ok && writeSection( fPtr, &offset, crgData->channelZ, crgData->channelV.info.size * sizeof( CrgChannelFStruct ) );
+
+    for ( i = 0; ok && i < ( size_t ) noChannels; i++ )
+        if ( channels[i]->data )
+            ok = writeSection( fPtr, &offset, channels[i]->data, channels[i]->info.size * sizeof( double ) );
+
+    /* --- the elevation grid, each row at an aligned offset --- */
+    for ( i = 0; ok && i < crgData->channelV.info.size; i++ )
+    {
+        ok = writeSection( fPtr, &offset, crgData->channelZ[i].data, crgData->channelZ[i].info.size * sizeof( float ) );
+
+        if ( crgData->channelZ[i].info.size != crgData->channelU.info.size )
+            ok = 0;
+    }
+
+    header.totalSize = alignOffset( offset );
+
+    ok = ok && writeSection( fPtr, &offset, NULL, 0 );
+    ok = ok && !fseek( fPtr, 0, SEEK_SET ) && ( fwrite( &header, sizeof( header ), 1, fPtr ) == 1 );
+    ok = !fclose( fPtr ) && ok;
+
+    if ( !ok )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetSave: error writing <%s>.\n", filename );
+        remove( filename );
+        return 0;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetSave: saved data set %d to <%s> (%ld bytes).\n", dataSetId, filename, header.totalSize );
+    return 1;
+}
+
+int
+crgDataSetLoadSnapshot( const char* filename )
+{
+    CrgSnapshotHeaderStruct header;
+    CrgDataStruct*          crgData;
+    CrgDataStruct*          image;
+    CrgOptionsStruct        srcOpts;
+    CrgOptionsStruct        modifiers;
+    CrgOptionsStruct        options;
+    CrgChannelStruct*       channels[8];
+    CrgChannelFStruct*      channelZ;
+    int                     noChannels;
+    int                     mapped = 0;
+    int                     id;
+    unsigned int            sourceHash;
+    size_t                  sourceSize;
+    size_t                  offset = 0;
+    size_t                  i;
+    char*                   buffer;
+    char*                   section;
+    FILE*                   fPtr;
+    struct stat             fileStat;
+
+    /* --- check the header before touching anything else --- */
+    if ( ( fPtr = fopen( filename, "rb" ) ) == NULL )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetLoadSnapshot: could not open <%s>.\n", filename );
+        return 0;
+    }
+
+    memset( &header, 0, sizeof( header ) );
+    i = fread( &header, 1, sizeof( header ), fPtr );
+    fclose( fPtr );
+
+    if ( i < 16 || strcmp( header.magic, dSnapshotMagic ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetLoadSnapshot: <%s> is no snapshot file.\n", filename );
+        return 0;
+    }
+
+    if ( header.endianTag != dSnapshotEndianTag )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetLoadSnapshot: <%s> has been written with different byte order.\n", filename );
+        return 0;
+    }
+
+    if ( header.version != dSnapshotVersion || i < sizeof( header ) || header.dataStructSize != sizeof( CrgDataStruct ) )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetLoadSnapshot: <%s> has an incompatible format version or layout.\n", filename );
+        return 0;
+    }
+
+    /* --- stale snapshot? --- */
+    header.sourceFile[dSnapshotMaxPath - 1] = '\0';
+
+    if ( !hashFile( header.sourceFile, &sourceHash, &sourceSize ) )
+        crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetLoadSnapshot: source file <%s> not available, using snapshot as is.\n", header.sourceFile );
+    else if ( sourceHash != header.sourceHash || sourceSize != header.sourceSize )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetLoadSnapshot: <%s> is out of date with respect to <%s>.\n", filename, header.sourceFile );
+        return 0;
+    }
+
+    if ( stat( filename, &fileStat ) || ( size_t ) fileStat.st_size != header.totalSize )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetLoadSnapshot: <%s> is truncated.\n", filename );
+        return 0;
+    }
+
+    if ( !( buffer = openSnapshot( filename, header.totalSize, &mapped ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetLoadSnapshot: could not read <%s>.\n", filename );
+        return 0;
+    }
+
+    takeSection( buffer, &offset, sizeof( header ), header.totalSize );
+    image = ( CrgDataStruct* ) takeSection( buffer, &offset, sizeof( CrgDataStruct ), header.totalSize );
+
+    if ( !( crgData = crgDataSetCreate() ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataSetLoadSnapshot: could not create data set\n" );
+        closeSnapshot( buffer, header.totalSize, mapped );
+        return 0;
+    }
+
+    /* --- take over the image, keeping the identity and the option lists of the new data set --- */
+    id        = crgData->admin.id;
+    modifiers = crgData->modifiers;
+    options   = crgData->options;
+
+    memcpy( crgData, image, sizeof( CrgDataStruct ) );
+    memset( &( crgData->admin ), 0, sizeof( CrgAdminStruct ) );
+    memset( &( crgData->refLineIndex ), 0, sizeof( CrgRefLineIndexStruct ) );
+    memset( &( crgData->refLineGeom ), 0, sizeof( CrgRefLineGeomStruct ) );
+    memset( &( crgData->gridFilter ), 0, sizeof( CrgGridFilterStruct ) );
+
+    crgData->modifiers         = modifiers;
+    crgData->options           = options;
+    crgData->channelZ          = NULL;
+    crgData->admin.id          = id;
+    crgData->admin.dataFormat  = image->admin.dataFormat;
+    crgData->admin.defMask     = image->admin.defMask;
+    crgData->admin.gridLayout  = dCrgGridLayoutContiguous;
+    crgData->admin.modsApplied = image->admin.modsApplied;
+
+    /* --- from here on, the data set is released as a whole if anything fails --- */
+    crgData->admin.snapshotBuffer = buffer;
+    crgData->admin.snapshotSize   = header.totalSize;
+    crgData->admin.snapshotMapped = mapped;
+
+    /* --- option lists are copied since they may grow later-on --- */
+    srcOpts.noEntries = image->modifiers.noEntries;
+    srcOpts.entry     = ( CrgOptionEntryStruct* ) takeSection( buffer, &offset, srcOpts.noEntries * sizeof( CrgOptionEntryStruct ), header.totalSize );
+
+    if ( srcOpts.noEntries && srcOpts.entry )
+        crgOptionCopyAll( &( crgData->modifiers ), &srcOpts );
+    else
+        crgOptionRemoveAll( &( crgData->modifiers ) );
+
+    srcOpts.noEntries = image->options.noEntries;
+    srcOpts.entry     = ( CrgOptionEntryStruct* ) takeSection( buffer, &offset, srcOpts.noEntries * sizeof( CrgOptionEntryStruct ), header.totalSize );
+
+    if ( srcOpts.noEntries && srcOpts.entry )
+        crgOptionCopyAll( &( crgData->options ), &srcOpts );
+
+    /* --- channel administration, the data itself stays in the snapshot --- */
+    channelZ = ( CrgChannelFStruct* ) takeSection( buffer, &offset, crgData->channelV.info.size * sizeof( CrgChannelFStruct ), header.totalSize );
+
+    if ( channelZ && ( crgData->channelZ = ( CrgChannelFStruct* ) crgCalloc( crgData->channelV.info.size + 1, sizeof( CrgChannelFStruct ) ) ) )
+        memcpy( crgData->channelZ, channelZ, crgData->channelV.info.size * sizeof( CrgChannelFStruct ) );
+
+    noChannels = listChannels( crgData, channels );
+    section    = ( char* ) crgData->channelZ;
+
+    for ( i = 0; section && i < ( size_t ) noChannels; i++ )
+        if ( channels[i]->data )
+            section = ( char* ) ( channels[i]->data = ( double* ) takeSection( buffer, &offset, channels[i]->info.size * sizeof( double ), header.totalSize ) );
+
+    for ( i = 0; section && i < crgData->channelV.info.size; i++ )
+        section = ( char* ) ( crgData->channelZ[i].data = ( float* ) takeSection( buffer, &offset, crgData->channelZ[i].info.size * sizeof( float ), header.totalSize ) );
+
+    if ( !section || !crgData->options.entry )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetLoadSnapshot: <%s> is inconsistent.\n", filename );
+        crgDataSetRelease( id );
+        return 0;
+    }
+
+    /* --- the spatial index and the geometry tables are not part of the snapshot, they are cheap to rebuild --- */
+    crgEvalxy2uvBuildIndex( crgData );
+    crgCalcRefLineGeom( crgData );
+
+    /* --- remember where the data came from, so it may be saved again --- */
+    if ( ( crgData->admin.sourceFile = ( char* ) crgCalloc( strlen( header.sourceFile ) + 1, sizeof( char ) ) ) )
+        strcpy( crgData->admin.sourceFile, header.sourceFile );
+
+    /* --- initialize data-set specific history --- */
+    crgDataSetHistory( id, dCrgHistoryStdSize );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetLoadSnapshot: finished reading snapshot <%s>\n", filename );
+
+    return id;
+}
+
+void
+crgSnapshotRelease( CrgDataStruct* crgData )
+{
+    CrgChannelStruct* channels[8];
+    int               noChannels;
+    size_t            i;
+
+    if ( !crgData || !crgData->admin.snapshotBuffer )
+        return;
+
+    /* --- all channel data is part of the snapshot --- */
+    noChannels = listChannels( crgData, channels );
+
+    for ( i = 0; i < ( size_t ) noChannels; i++ )
+        channels[i]->data = NULL;
+
+    if ( crgData->channelZ )
+        for ( i = 0; i < crgData->channelV.info.size; i++ )
+            crgData->channelZ[i].data = NULL;
+
+    closeSnapshot( crgData->admin.snapshotBuffer, crgData->admin.snapshotSize, crgData->admin.snapshotMapped );
+
+    crgData->admin.snapshotBuffer = NULL;
+    crgData->admin.snapshotSize   = 0;
+    crgData->admin.snapshotMapped = 0;
+}
+
+static unsigned int
+calcHash( const unsigned char* data, size_t size, unsigned int hash )
+{
+    unsigned int k;
+    size_t       i;
+
+    for ( i = 0; i + 4 <= size; i += 4 )
+    {
+        memcpy( &k, data + i, 4 );
+
+        k *= 0xcc9e2d51U;
+        k  = ( k << 15 ) | ( k >> 17 );
+        k *= 0x1b873593U;
+
+        hash ^= k;
+        hash  = ( hash << 13 ) | ( hash >> 19 );
+        hash  = hash * 5 + 0xe6546b64U;
+    }
+
+    /* --- remaining bytes --- */
+    for ( ; i < size; i++ )
+    {
+        hash ^= data[i];
+        hash *= 0x01000193U;
+    }
+
+    return hash;
+}
+
+static int
+hashFile( const char* filename, unsigned int* hash, size_t* size )
+{
+    unsigned char* block;
+    size_t         noBytesRead;
+    FILE*          fPtr;
+
+    *hash = 0;
+    *size = 0;
+
+    if ( !filename || !*filename || ( fPtr = fopen( filename, "rb" ) ) == NULL )
+        return 0;
+
+    if ( !( block = ( unsigned char* ) crgCalloc( dSnapshotHashBlock, sizeof( unsigned char ) ) ) )
+    {
+        fclose( fPtr );
+        return 0;
+    }
+
+    /* --- block size is a multiple of 4, so the hash does not depend on the block boundaries --- */
+    while ( ( noBytesRead = fread( block, 1, dSnapshotHashBlock, fPtr ) ) > 0 )
+    {
+        *hash  = calcHash( block, noBytesRead, *hash );
+        *size += noBytesRead;
+    }
+
+    crgFree( block );
+    fclose( fPtr );
+
+    return 1;
+}
+
+static size_t
+alignOffset( size_t offset )
+{
+    return ( ( offset + dCrgGridAlign - 1 ) / dCrgGridAlign ) * dCrgGridAlign;
+}
+
+static int
+writeSection( FILE* fPtr, size_t* offset, const void* data, size_t size )
+{
+    static const char padding[dCrgGridAlign] = { 0 };
+    size_t            start = alignOffset( *offset );
+
+    if ( start > *offset && fwrite( padding, 1, start - *offset, fPtr ) != start - *offset )
+        return 0;
+
+    *offset = start;
+
+    if ( size && fwrite( data, 1, size, fPtr ) != size )
+        return 0;
+
+    *offset += size;
+
+    return 1;
+}
+
+static char*
+takeSection( char* buffer, size_t* offset, size_t size, size_t total )
+{
+    size_t start = alignOffset( *offset );
+
+    if ( start + size > total )
+        return NULL;
+
+    *offset = start + size;
+
+    return buffer + start;
+}
+
+static int
+listChannels( CrgDataStruct* crgData, CrgChannelStruct** channels )
+{
+    channels[0] = &( crgData->channelV );
+    channels[1] = &( crgData->channelX );
+    channels[2] = &( crgData->channelY );
+    channels[3] = &( crgData->channelU );
+    channels[4] = &( crgData->channelPhi );
+    channels[5] = &( crgData->channelSlope );
+    channels[6] = &( crgData->channelBank );
+    channels[7] = &( crgData->channelRefZ );
+
+    return 8;
+}
+
+static char*
+openSnapshot( const char* filename, size_t size, int* mapped )
+{
+    char* buffer;
+    FILE* fPtr;
+
+#ifdef dCrgSnapshotUseMmap
+    int   fd;
+    void* addr;
+
+    /* --- private mapping: modifiers applied later-on alter copies of the pages only --- */
+    if ( ( fd = open( filename, O_RDONLY ) ) >= 0 )
+    {
+        addr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+        close( fd );
+
+        if ( addr != MAP_FAILED )
+        {
+            *mapped = 1;
+            return ( char* ) addr;
+        }
+    }
+#endif
+
+    *mapped = 0;
+
+    if ( ( fPtr = fopen( filename, "rb" ) ) == NULL )
+        return NULL;
+
+    if ( ( buffer = ( char* ) crgCalloc( size, sizeof( char ) ) ) && fread( buffer, 1, size, fPtr ) != size )
+    {
+        crgFree( buffer );
+        buffer = NULL;
+    }
+
+    fclose( fPtr );
+
+    return buffer;
+}
+
+static void
+closeSnapshot( char* buffer, size_t size, int mapped )
+{
+#ifdef dCrgSnapshotUseMmap
+    if ( mapped )
+    {
+        munmap( buffer, size );
+        return;
+    }
+#endif
+    crgFree( buffer );
+}
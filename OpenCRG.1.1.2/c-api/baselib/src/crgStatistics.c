@@ -27,12 +27,25 @@
 #include "crgBaseLibPrivate.h"
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 
 /* ====== DEFINITIONS ====== */
 
 /* ====== TYPE DEFINITIONS ====== */
 
 /* ====== LOCAL METHODS ====== */
+/**
+* normalize a 2d vector, vectors of (almost) zero length are left unchanged
+* @param vec    pointer to the co-ordinate array
+*/
+static void normalizeVector2( double* vec );
+
+/**
+* scale a normal so that it ends at unit distance from an interval
+* @param vec    pointer to the co-ordinate array of the normal
+* @param n12    unit normal of the interval
+*/
+static void scaleToInterval( double* vec, const double* n12 );
 
 /* ====== LOCAL VARIABLES ====== */
 
@@ -66,8 +79,12 @@ void crgCalcStatistics( CrgDataStruct *crgData )
     crgMsgPrint( dCrgMsgLevelNotice, "crgCalcStatistics: statistical information about data set:\n" );
     crgMsgPrint( dCrgMsgLevelNotice, "    road elevation:\n" );
     
+    /* --- the statistics of a streamed grid have been gathered while loading it --- */
+    if ( crgData->gridStream.valid )
+        crgDataGridStreamGetStat( crgData, &zMeanF, &zMeanL, &zMin, &zMax );
+    
     /* --- mean elevation at start and end of road --- */
-    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    for ( i = 0; i < crgData->channelV.info.size && !crgData->gridStream.valid; i++ )
     {
         if ( crgData->channelZ[i].data )
         {
@@ -113,10 +130,13 @@ void crgCalcStatistics( CrgDataStruct *crgData )
     crgMsgPrint( dCrgMsgLevelNotice, "        mean elevation at end   [m]: %10.4f\n", zMeanL );
     
     /* --- minimum and maximum elevation --- */
-    zMin = zMeanF;
-    zMax = zMin;
+    if ( !crgData->gridStream.valid )
+    {
+        zMin = zMeanF;
+        zMax = zMin;
+    }
     
-    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    for ( i = 0; i < crgData->channelV.info.size && !crgData->gridStream.valid; i++ )
     {
         for ( j = 0; j < crgData->channelZ[i].info.size; j++ )
         {
@@ -353,3 +373,147 @@ void crgCalcUtilityData( CrgDataStruct *crgData )
     
     crgMsgPrint( dCrgMsgLevelDebug, "crgCalcUtilityData: created hash table for v position.\n" );
 }
+
+int
+crgCalcRefLineGeom( CrgDataStruct *crgData )
+{
+    CrgRefLineGeomStruct* geom;
+    double* xData;
+    double* yData;
+    double* block;
+    double  n1[2];
+    double  n2[2];
+    double  n12[2];
+    double  dx;
+    double  dy;
+    double  hd;
+    size_t  size;
+    size_t  nU;
+    size_t  i;
+    
+    if ( !crgData )
+        return 0;
+    
+    crgReleaseRefLineGeom( crgData );
+    
+    geom  = &( crgData->refLineGeom );
+    size  = crgData->channelX.info.size;
+    xData = crgData->channelX.data;
+    yData = crgData->channelY.data;
+    
+    if ( !crgData->channelX.info.valid || !xData || !yData || size < 2 || !( crgData->channelU.info.inc > 0.0 ) )
+        return 0;
+    
+    /* --- one block for all tables: 5 values per interval, 1 value per point --- */
+    if ( !( block = ( double* ) crgCalloc( 6 * size - 5, sizeof( double ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgCalcRefLineGeom: could not allocate tables.\n" );
+        return 0;
+    }
+    
+    geom->size     = size;
+    geom->invLen   = block;
+    geom->begNormX = geom->invLen   + size - 1;
+    geom->begNormY = geom->begNormX + size - 1;
+    geom->endNormX = geom->begNormY + size - 1;
+    geom->endNormY = geom->endNormX + size - 1;
+    geom->curv     = geom->endNormY + size - 1;
+    
+    /* --- the same operations as the on-the-fly computation, so results are identical --- */
+    for ( i = 0; i < size - 1; i++ )
+    {
+        dx = xData[i+1] - xData[i];
+        dy = yData[i+1] - yData[i];
+        
+        geom->invLen[i] = 1.0 / sqrt( dx * dx + dy * dy );
+        
+        /* --- normal on P1P2 --- */
+        n12[0] = -dy;
+        n12[1] =  dx;
+        normalizeVector2( n12 );
+        
+        /* --- normal through P1 takes previous point P0 into account --- */
+        n1[0] = n12[0];
+        n1[1] = n12[1];
+        
+        if ( i > 0 )
+        {
+            n1[0] = - ( yData[i+1] - yData[i-1] );
+            n1[1] =     xData[i+1] - xData[i-1];
+            normalizeVector2( n1 );
+        }
+        
+        scaleToInterval( n1, n12 );
+        
+        /* --- normal through P2 takes next point P3 into account --- */
+        n2[0] = n12[0];
+        n2[1] = n12[1];
+        
+        if ( i < size - 2 )
+        {
+            n2[0] = - ( yData[i+2] - yData[i] );
+            n2[1] =     xData[i+2] - xData[i];
+            normalizeVector2( n2 );
+        }
+        
+        scaleToInterval( n2, n12 );
+        
+        geom->begNormX[i] = n1[0];
+        geom->begNormY[i] = n1[1];
+        geom->endNormX[i] = n2[0];
+        geom->endNormY[i] = n2[1];
+    }
+    
+    /* --- curvature on road sections of 0.5m length, zero where the window does not fit --- */
+    nU = ( size_t ) ( 0.5 / crgData->channelU.info.inc );
+    
+    if ( nU < 1 )
+        nU = 1;
+    
+    geom->curvWindow = nU;
+    hd = 1.0 / pow( crgData->channelU.info.inc * nU, 3.0 );
+    
+    for ( i = nU; i + nU < size; i++ )
+        geom->curv[i] = ( ( xData[i] - xData[i-nU] ) * ( yData[i+nU] - yData[i] ) -
+                          ( yData[i] - yData[i-nU] ) * ( xData[i+nU] - xData[i] ) ) * hd;
+    
+    geom->valid = 1;
+    
+    return 1;
+}
+
+void
+crgReleaseRefLineGeom( CrgDataStruct *crgData )
+{
+    if ( !crgData )
+        return;
+    
+    if ( crgData->refLineGeom.invLen )
+        crgFree( crgData->refLineGeom.invLen );
+    
+    memset( &( crgData->refLineGeom ), 0, sizeof( CrgRefLineGeomStruct ) );
+}
+
+static void
+normalizeVector2( double* vec )
+{
+    double length = sqrt( vec[0] * vec[0] + vec[1] * vec[1] );
+    
+    if ( length < 1.0e-10 )
+        return;
+    
+    vec[0] /= length;
+    vec[1] /= length;
+}
+
+static void
+scaleToInterval( double* vec, const double* n12 )
+{
+    double dotProd = ( vec[0] * n12[0] ) + ( vec[1] * n12[1] );
+    
+    if ( fabs( dotProd ) > 1.0e-10 )
+    {
+        vec[0] /= dotProd;
+        vec[1] /= dotProd;
+    }
+}
@@ -0,0 +1,596 @@
+/* ===================================================
+ *  file:       crgWriter.c
+ * ---------------------------------------------------
+ *  purpose:	write data sets as CRG files in the
+ *              formats understood by the loader
+ * ---------------------------------------------------
+ *  first edit:	17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2017 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+/* ====== INCLUSIONS ====== */
+#include "crgBaseLibPrivate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ====== DEFINITIONS ====== */
+#define dWriterChunkSize     0x100000   /* size of the output buffer for the data section */
+#define dWriterRecordLength  80         /* length of an IPL record                         */
+#define dWriterMaxChannels   6          /* maximum number of reference line channels       */
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* keyword of an option or modifier in the file header
+*/
+typedef struct
+{
+    const char*  tag;                   /* keyword in the file                                */
+    unsigned int id;                    /* identifier of the option or modifier               */
+} CrgWriterKeywordStruct;
+
+/**
+* buffered output of the data section
+*/
+typedef struct
+{
+    FILE*   fPtr;                       /* the file being written                             */
+    char*   buffer;                     /* chunk of data not yet written                      */
+    size_t  used;                       /* number of bytes used in the chunk            [byte] */
+    int     ok;                         /* no error has occurred so far                    [0/1] */
+} CrgWriterStreamStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+/**
+* options and modifiers which are stored by the loader, keywords as in crgLoader.c
+*/
+static CrgWriterKeywordStruct sWriterOpts[] =
+{
+   { "border_mode_u",        dCrgCpOptionBorderModeU        },
+   { "border_offset_u",      dCrgCpOptionBorderOffsetU      },
+   { "border_mode_v",        dCrgCpOptionBorderModeV        },
+   { "border_offset_v",      dCrgCpOptionBorderOffsetV      },
+   { "border_smooth_ubeg",   dCrgCpOptionSmoothUBegin       },
+   { "border_smooth_uend",   dCrgCpOptionSmoothUEnd         },
+   { "refline_continuation", dCrgCpOptionRefLineContinue    },
+   { "refline_search_far",   dCrgCpOptionRefLineFar         },
+   { "refline_search_close", dCrgCpOptionRefLineClose       },
+   { "refline_search_u",     dCrgCpOptionRefLineSearchU     },
+   { "refline_search_ufrac", dCrgCpOptionRefLineSearchUFrac },
+   { "check_eps",            dCrgCpOptionCheckEps           },
+   { "check_inc",            dCrgCpOptionCheckInc           },
+   { "check_tol",            dCrgCpOptionCheckTol           },
+   { NULL,                   0                              }
+};
+
+static CrgWriterKeywordStruct sWriterMods[] =
+{
+   { "scale_z_grid",         dCrgModScaleZ                  },
+   { "scale_slope",          dCrgModScaleSlope              },
+   { "scale_banking",        dCrgModScaleBank               },
+   { "scale_length",         dCrgModScaleLength             },
+   { "scale_width",          dCrgModScaleWidth              },
+   { "scale_curvature",      dCrgModScaleCurvature          },
+   { "grid_nan_mode",        dCrgModGridNaNMode             },
+   { "grid_nan_offset",      dCrgModGridNaNOffset           },
+   { "grid_filter_mode",     dCrgModFilterMode              },
+   { "grid_filter_size_u",   dCrgModFilterSizeU             },
+   { "grid_filter_size_v",   dCrgModFilterSizeV             },
+   { "grid_filter_weight",   dCrgModFilterWeight            },
+   { "grid_filter_repeat",   dCrgModFilterRepeat            },
+   { "grid_filter_u_begin",  dCrgModFilterUBegin            },
+   { "grid_filter_u_end",    dCrgModFilterUEnd              },
+   { "grid_filter_v_begin",  dCrgModFilterVBegin            },
+   { "grid_filter_v_end",    dCrgModFilterVEnd              },
+   { "grid_limit_z_min",     dCrgModLimitZMin               },
+   { "grid_limit_z_max",     dCrgModLimitZMax               },
+   { "grid_peak_limit",      dCrgModPeakLimit               },
+   { "grid_peak_radius",     dCrgModPeakRadius              },
+   { "grid_limit_u_begin",   dCrgModLimitUBegin             },
+   { "grid_limit_u_end",     dCrgModLimitUEnd               },
+   { "grid_limit_v_begin",   dCrgModLimitVBegin             },
+   { "grid_limit_v_end",     dCrgModLimitVEnd               },
+   { "refline_rotcenter_x",  dCrgModRefLineRotCenterX       },
+   { "refline_rotcenter_y",  dCrgModRefLineRotCenterY       },
+   { "refline_offset_phi",   dCrgModRefLineOffsetPhi        },
+   { "refline_offset_x",     dCrgModRefLineOffsetX          },
+   { "refline_offset_y",     dCrgModRefLineOffsetY          },
+   { "refline_offset_z",     dCrgModRefLineOffsetZ          },
+   { "refpoint_u_fraction",  dCrgModRefPointUFrac           },
+   { "refpoint_u_offset",    dCrgModRefPointUOffset         },
+   { "refpoint_u",           dCrgModRefPointU               },
+   { "refpoint_v_fraction",  dCrgModRefPointVFrac           },
+   { "refpoint_v_offset",    dCrgModRefPointVOffset         },
+   { "refpoint_v",           dCrgModRefPointV               },
+   { "refpoint_x",           dCrgModRefPointX               },
+   { "refpoint_y",           dCrgModRefPointY               },
+   { "refpoint_z",           dCrgModRefPointZ               },
+   { "refpoint_phi",         dCrgModRefPointPhi             },
+   { NULL,                   0                              }
+};
+
+static const char* sWriterSeparator = "$!**********************************************************************\n";
+
+/* ====== LOCAL METHODS ====== */
+/**
+* collect the reference line channels which are written to the data section
+* @param crgData    pointer to the data set
+* @param channels   resulting channels, in the order of the data records
+* @return number of reference line channels
+*/
+static int listChannels( CrgDataStruct* crgData, CrgChannelStruct** channels );
+
+/**
+* write the header of the file up to and including the separator of the data section
+* @param crgData    pointer to the data set
+* @param fPtr       the file being written
+* @param format     format of the data section [dCrgFileFormatxxx]
+* @param channels   reference line channels written to the data section
+* @param noChannels number of reference line channels
+* @return 1 if successful, otherwise 0
+*/
+static int writeHeader( CrgDataStruct* crgData, FILE* fPtr, int format, CrgChannelStruct** channels, int noChannels );
+
+/**
+* write the options or modifiers of a list which have a keyword in the file format
+* @param fPtr       the file being written
+* @param list       list of options or modifiers
+* @param keywords   keywords of the options or modifiers
+*/
+static void writeOptions( FILE* fPtr, CrgOptionsStruct* list, CrgWriterKeywordStruct* keywords );
+
+/**
+* reserve space in the output buffer, writing the buffer to the file if it is full
+* @param stream     the output stream
+* @param size       number of bytes to reserve, at most dWriterChunkSize
+* @return pointer to the reserved space
+*/
+static char* reserve( CrgWriterStreamStruct* stream, size_t size );
+
+/**
+* write a value as big endian IEEE number of 4 or 8 bytes
+* @param dst        target of the value
+* @param value      the value, NaN is written as quiet NaN
+* @param length     length of the value [byte]
+*/
+static void encodeBinary( char* dst, double value, size_t length );
+
+/**
+* write a single precision value as big endian IEEE number; the bits are copied
+* unchanged, so NaNs remain NaNs for the loader
+* @param dst        target of the value
+* @param value      pointer to the value
+*/
+static void encodeFloat( char* dst, const float* value );
+
+/**
+* write a value as right aligned ASCII field; the precision is reduced until the
+* number fits into the field with a leading blank
+* @param dst        target of the field, not terminated
+* @param value      the value, NaN is written as a placeholder of '*' characters
+* @param length     length of the field [byte]
+*/
+static void encodeAscii( char* dst, double value, size_t length );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataSetWrite( int dataSetId, const char* filename, int format )
+{
+    CrgDataStruct*        crgData = crgDataSetAccess( dataSetId );
+    CrgChannelStruct*     channels[dWriterMaxChannels];
+    CrgWriterStreamStruct stream;
+    double*               record;
+    double                nanValue;
+    size_t                noValues;
+    size_t                valueSize;
+    size_t                valuesPerLine;
+    size_t                noWritten = 0;
+    size_t                i;
+    size_t                j;
+    int                   noChannels;
+    int                   binary;
+    char*                 dst;
+
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetWrite: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+
+    if ( crgData->admin.headerOnly )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetWrite: data of data set <%d> has not been read.\n", dataSetId );
+        return 0;
+    }
+
+    /* --- the data section is written from the float grid --- */
+    if ( crgData->gridQuant.valid )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetWrite: data set <%d> has a quantized grid.\n", dataSetId );
+        return 0;
+    }
+
+    if ( crgData->gridStream.valid )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetWrite: data set <%d> has a streamed grid.\n", dataSetId );
+        return 0;
+    }
+
+    switch ( format )
+    {
+        case dCrgFileFormatBinarySingle:
+            valueSize = 4;
+            break;
+        case dCrgFileFormatBinaryDouble:
+            valueSize = 8;
+            break;
+        case dCrgFileFormatAsciiSingle:
+            valueSize = 10;
+            break;
+        case dCrgFileFormatAsciiDouble:
+            valueSize = 20;
+            break;
+        default:
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetWrite: unknown file format <%d>.\n", format );
+            return 0;
+    }
+
+    crgSetNan( &nanValue );
+
+    binary        = ( format == dCrgFileFormatBinarySingle ) || ( format == dCrgFileFormatBinaryDouble );
+    valuesPerLine = dWriterRecordLength / valueSize;
+    noChannels    = listChannels( crgData, channels );
+    noValues      = noChannels + crgData->channelV.info.size;
+
+    if ( !( record = ( double* ) crgCalloc( noValues, sizeof( double ) ) ) )
+        return 0;
+
+    memset( &stream, 0, sizeof( stream ) );
+
+    if ( !( stream.buffer = ( char* ) crgCalloc( dWriterChunkSize, sizeof( char ) ) ) )
+    {
+        crgFree( record );
+        return 0;
+    }
+
+    if ( ( stream.fPtr = fopen( filename, "wb" ) ) == NULL )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetWrite: could not open <%s>.\n", filename );
+        crgFree( stream.buffer );
+        crgFree( record );
+        return 0;
+    }
+
+    stream.ok = writeHeader( crgData, stream.fPtr, format, channels, noChannels );
+
+    /* --- the data section, one record per reference line point --- */
+    for ( i = 0; stream.ok && i < crgData->channelU.info.size; i++ )
+    {
+        if ( binary )
+        {
+            /* --- kernel format: the records are concatenated; the float grid is written as it is --- */
+            dst = reserve( &stream, noValues * valueSize );
+
+            for ( j = 0; j < ( size_t ) noChannels; j++, dst += valueSize )
+                encodeBinary( dst, channels[j]->data[i], valueSize );
+
+            for ( j = 0; j < crgData->channelV.info.size; j++, dst += valueSize )
+            {
+                if ( valueSize == 4 )
+                    encodeFloat( dst, &( crgData->channelZ[j].data[i] ) );
+                else if ( crgIsNanf( &( crgData->channelZ[j].data[i] ) ) )
+                    encodeBinary( dst, nanValue, valueSize );
+                else
+                    encodeBinary( dst, crgData->channelZ[j].data[i], valueSize );
+            }
+
+            noWritten += noValues;
+            continue;
+        }
+
+        for ( j = 0; j < ( size_t ) noChannels; j++ )
+            record[j] = channels[j]->data[i];
+
+        for ( j = 0; j < crgData->channelV.info.size; j++ )
+        {
+            if ( crgIsNanf( &( crgData->channelZ[j].data[i] ) ) )
+                crgSetNan( &( record[noChannels + j] ) );
+            else
+                record[noChannels + j] = crgData->channelZ[j].data[i];
+        }
+
+        /* --- long format: each record starts in a new line --- */
+        for ( j = 0; j < noValues; j++ )
+        {
+            encodeAscii( reserve( &stream, valueSize ), record[j], valueSize );
+
+            if ( !( ( j + 1 ) % valuesPerLine ) || ( j + 1 == noValues ) )
+                *reserve( &stream, 1 ) = '\n';
+        }
+    }
+
+    /* --- the last record of a kernel format is filled with NaNs --- */
+    if ( binary && ( noWritten % valuesPerLine ) )
+    {
+        for ( j = noWritten % valuesPerLine; j < valuesPerLine; j++ )
+            encodeBinary( reserve( &stream, valueSize ), nanValue, valueSize );
+    }
+
+    if ( stream.ok && stream.used )
+        stream.ok = ( fwrite( stream.buffer, 1, stream.used, stream.fPtr ) == stream.used );
+
+    if ( fclose( stream.fPtr ) )
+        stream.ok = 0;
+
+    crgFree( stream.buffer );
+    crgFree( record );
+
+    if ( !stream.ok )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetWrite: error writing <%s>.\n", filename );
+        remove( filename );
+        return 0;
+    }
+
+    crgMsgPrint( dCrgMsgLevelInfo, "crgDataSetWrite: data set <%d> written to <%s>.\n", dataSetId, filename );
+    return 1;
+}
+
+static int
+listChannels( CrgDataStruct* crgData, CrgChannelStruct** channels )
+{
+    int n = 0;
+
+    /* --- the reference line is defined either by its heading or by its positions --- */
+    if ( crgData->channelPhi.info.defined && crgData->channelPhi.data )
+        channels[n++] = &( crgData->channelPhi );
+    else if ( crgData->channelX.info.defined && crgData->channelX.data && crgData->channelY.data )
+    {
+        channels[n++] = &( crgData->channelX );
+        channels[n++] = &( crgData->channelY );
+    }
+
+    if ( crgData->channelBank.info.defined && crgData->channelBank.data )
+        channels[n++] = &( crgData->channelBank );
+
+    if ( crgData->channelSlope.info.defined && crgData->channelSlope.data )
+        channels[n++] = &( crgData->channelSlope );
+
+    return n;
+}
+
+static int
+writeHeader( CrgDataStruct* crgData, FILE* fPtr, int format, CrgChannelStruct** channels, int noChannels )
+{
+    static const char* formatTags[] = { "KRBI", "KDBI", "LRFI", "LDFI" };
+    int    defMask = crgData->admin.defMask;
+    size_t i;
+
+    /* --- comment block --- */
+    fprintf( fPtr, "$CT                                                 ! comment text block\n" );
+    fprintf( fPtr, "CRG file written by crgDataSetWrite()\n" );
+    if ( crgData->admin.sourceFile )
+        fprintf( fPtr, "data set loaded from %s\n", crgData->admin.sourceFile );
+    fprintf( fPtr, "%s", sWriterSeparator );
+
+    /* --- road parameters --- */
+    fprintf( fPtr, "$ROAD_CRG                                          ! crg road parameters\n" );
+    fprintf( fPtr, "reference_line_start_u   = %.17g\n", crgData->channelU.info.first );
+    fprintf( fPtr, "reference_line_end_u     = %.17g\n", crgData->channelU.info.last );
+    fprintf( fPtr, "reference_line_increment = %.17g\n", crgData->channelU.info.inc );
+    fprintf( fPtr, "reference_line_start_x   = %.17g\n", crgData->channelX.info.first );
+    fprintf( fPtr, "reference_line_start_y   = %.17g\n", crgData->channelY.info.first );
+    fprintf( fPtr, "reference_line_start_phi = %.17g\n", crgData->channelPhi.info.first );
+    fprintf( fPtr, "reference_line_end_phi   = %.17g\n", crgData->channelPhi.info.last );
+
+    if ( defMask & dCrgDataDefXEnd )
+        fprintf( fPtr, "reference_line_end_x     = %.17g\n", crgData->channelX.info.last );
+
+    if ( defMask & dCrgDataDefYEnd )
+        fprintf( fPtr, "reference_line_end_y     = %.17g\n", crgData->channelY.info.last );
+
+    if ( ( defMask & dCrgDataDefZStart ) || crgData->channelRefZ.info.first != 0.0 )
+        fprintf( fPtr, "reference_line_start_z   = %.17g\n", crgData->channelRefZ.info.first );
+
+    if ( defMask & dCrgDataDefZEnd )
+        fprintf( fPtr, "reference_line_end_z     = %.17g\n", crgData->channelRefZ.info.last );
+
+    fprintf( fPtr, "reference_line_start_s   = %.17g\n", crgData->channelSlope.info.first );
+
+    if ( defMask & dCrgDataDefSlopeEnd )
+        fprintf( fPtr, "reference_line_end_s     = %.17g\n", crgData->channelSlope.info.last );
+
+    fprintf( fPtr, "reference_line_start_b   = %.17g\n", crgData->channelBank.info.first );
+
+    if ( defMask & dCrgDataDefBankEnd )
+        fprintf( fPtr, "reference_line_end_b     = %.17g\n", crgData->channelBank.info.last );
+
+    fprintf( fPtr, "long_section_v_right     = %.17g\n", crgData->channelV.info.first );
+    fprintf( fPtr, "long_section_v_left      = %.17g\n", crgData->channelV.info.last );
+    fprintf( fPtr, "long_section_v_increment = %.17g\n", crgData->channelV.info.inc );
+    fprintf( fPtr, "%s", sWriterSeparator );
+
+    /* --- options and modifiers; an empty modifier block prevents modifiers which have been applied from being applied again --- */
+    fprintf( fPtr, "$ROAD_CRG_OPTS                                     ! crg runtime options\n" );
+    writeOptions( fPtr, &( crgData->options ), sWriterOpts );
+    fprintf( fPtr, "%s", sWriterSeparator );
+
+    fprintf( fPtr, "$ROAD_CRG_MODS                                     ! crg data modifiers\n" );
+    if ( !crgData->admin.modsApplied )
+        writeOptions( fPtr, &( crgData->modifiers ), sWriterMods );
+    fprintf( fPtr, "%s", sWriterSeparator );
+
+    /* --- data definition, the reference line channels precede the long sections --- */
+    fprintf( fPtr, "$KD_DEFINITION                                   ! data definition\n" );
+    fprintf( fPtr, "#:%s\n", formatTags[format] );
+    fprintf( fPtr, "U:reference line u,m,%.17g,%.17g\n", crgData->channelU.info.first, crgData->channelU.info.inc );
+
+    for ( i = 0; i < ( size_t ) noChannels; i++ )
+    {
+        if ( channels[i] == &( crgData->channelPhi ) )
+            fprintf( fPtr, "D:reference line phi,rad\n" );
+        else if ( channels[i] == &( crgData->channelX ) )
+            fprintf( fPtr, "D:reference line x,m\n" );
+        else if ( channels[i] == &( crgData->channelY ) )
+            fprintf( fPtr, "D:reference line y,m\n" );
+        else if ( channels[i] == &( crgData->channelBank ) )
+            fprintf( fPtr, "D:reference line banking,m/m\n" );
+        else
+            fprintf( fPtr, "D:reference line slope,m/m\n" );
+    }
+
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    {
+        if ( defMask & dCrgDataDefVIndex )
+            fprintf( fPtr, "D:long section %lu,m\n", ( unsigned long ) ( i + 1 ) );
+        else
+            fprintf( fPtr, "D:long section at v = %.17g,m\n", crgData->channelV.data[i] );
+    }
+
+    fprintf( fPtr, "%s", sWriterSeparator );
+    fprintf( fPtr, "$$$$$$$$10$$$$$$$$20$$$$$$$$30$$$$$$$$40$$$$$$$$50$$$$$$$$60$$$$$$$$70$$$$$$$$80\n" );
+
+    return !ferror( fPtr );
+}
+
+static void
+writeOptions( FILE* fPtr, CrgOptionsStruct* list, CrgWriterKeywordStruct* keywords )
+{
+    int    iValue;
+    double dValue;
+
+    for ( ; keywords->tag; keywords++ )
+    {
+        if ( !crgOptionIsSet( list, keywords->id ) )
+            continue;
+
+        if ( crgOptionGetType( keywords->id ) == dCrgOptionDataTypeInt )
+        {
+            crgOptionGetInt( list, keywords->id, &iValue );
+            fprintf( fPtr, "%-24s = %d\n", keywords->tag, iValue );
+        }
+        else
+        {
+            crgOptionGetDouble( list, keywords->id, &dValue );
+            fprintf( fPtr, "%-24s = %.17g\n", keywords->tag, dValue );
+        }
+    }
+}
+
+static char*
+reserve( CrgWriterStreamStruct* stream, size_t size )
+{
+    /* --- after an error, the data is discarded --- */
+    if ( stream->used + size > dWriterChunkSize )
+    {
+        if ( stream->ok )
+            stream->ok = ( fwrite( stream->buffer, 1, stream->used, stream->fPtr ) == stream->used );
+
+        stream->used = 0;
+    }
+
+    stream->used += size;
+
+    return stream->buffer + stream->used - size;
+}
+
+static void
+encodeBinary( char* dst, double value, size_t length )
+{
+    float  fValue;
+    char*  valPtr = ( char* ) &value;
+    size_t j;
+
+    if ( length == 4 )
+    {
+        if ( crgIsNan( &value ) )
+            crgSetNanf( &fValue );
+        else
+            fValue = ( float ) value;
+
+        encodeFloat( dst, &fValue );
+        return;
+    }
+
+    if ( dCrgBigEndian )
+        memcpy( dst, valPtr, 8 );
+    else
+        for ( j = 0; j < 8; j++ )
+            dst[j] = valPtr[7 - j];
+}
+
+static void
+encodeFloat( char* dst, const float* value )
+{
+    const char* valPtr = ( const char* ) value;
+
+    if ( dCrgBigEndian )
+        memcpy( dst, valPtr, 4 );
+    else
+    {
+        dst[0] = valPtr[3];
+        dst[1] = valPtr[2];
+        dst[2] = valPtr[1];
+        dst[3] = valPtr[0];
+    }
+}
+
+static void
+encodeAscii( char* dst, double value, size_t length )
+{
+    char   tmpStr[32];
+    char*  ptr;
+    size_t len = 0;
+    int    precision;
+
+    if ( crgIsNan( &value ) )
+    {
+        memset( dst, '*', length );
+        return;
+    }
+
+    for ( precision = ( length > 10 ) ? 17 : 9; precision > 0; precision-- )
+    {
+        sprintf( tmpStr, "%.*g", precision, value );
+
+        /* --- drop the sign and leading zeros of the exponent --- */
+        if ( ( ptr = strchr( tmpStr, 'e' ) ) )
+        {
+            char* expPtr = ptr + 1;
+
+            if ( *expPtr == '-' )
+                expPtr++;
+
+            ptr = expPtr;
+
+            while ( *ptr == '+' || ( *ptr == '0' && ptr[1] ) )
+                ptr++;
+
+            memmove( expPtr, ptr, strlen( ptr ) + 1 );
+        }
+
+        /* --- drop the zero in front of the decimal point --- */
+        ptr = ( tmpStr[0] == '-' ) ? tmpStr + 1 : tmpStr;
+
+        if ( ptr[0] == '0' && ptr[1] == '.' )
+            memmove( ptr, ptr + 1, strlen( ptr + 1 ) + 1 );
+
+        if ( ( len = strlen( tmpStr ) ) < length )
+            break;
+    }
+
+    memset( dst, ' ', length - len );
+    memcpy( dst + length - len, tmpStr, len );
+}
@@ -21,45 +21,81 @@ set COMP = 'gcc -O3'
 # compile all demos
 
 echo -n compiling crgEvalxyuv...
-$COMP -o demo/bin/crgEvalxyuv -I baselib/inc demo/EvalXYnUV/src/main.c   baselib/src/*.c -lm
+$COMP -o demo/bin/crgEvalxyuv -I baselib/inc demo/EvalXYnUV/src/main.c   baselib/src/*.c -lm -lpthread
 echo done
 
 echo -n compiling crgEvalOpts...
-$COMP -o demo/bin/crgEvalOpts -I baselib/inc demo/EvalOptions/src/main.c baselib/src/*.c -lm
+$COMP -o demo/bin/crgEvalOpts -I baselib/inc demo/EvalOptions/src/main.c baselib/src/*.c -lm -lpthread
 echo done
 
 echo -n compiling crgEvalz...
-$COMP -o demo/bin/crgEvalz    -I baselib/inc demo/EvalZ/src/main.c       baselib/src/*.c -lm
+$COMP -o demo/bin/crgEvalz    -I baselib/inc demo/EvalZ/src/main.c       baselib/src/*.c -lm -lpthread
 echo done 
 
 echo -n compiling crgReader...
-$COMP -o demo/bin/crgReader   -I baselib/inc demo/Reader/src/main.c      baselib/src/*.c -lm 
+$COMP -o demo/bin/crgReader   -I baselib/inc demo/Reader/src/main.c      baselib/src/*.c -lm -lpthread
 echo done
 
 echo -n compiling crgSimple...
-$COMP -o demo/bin/crgSimple   -I baselib/inc demo/Simple/src/main.c      baselib/src/*.c -lm 
+$COMP -o demo/bin/crgSimple   -I baselib/inc demo/Simple/src/main.c      baselib/src/*.c -lm -lpthread
 echo done
 
 
 # compile all tests
 
 echo -n compiling crgPerfTest...
-$COMP  -o test/bin/crgPerfTest -I baselib/inc test/PerfTest/src/main.c baselib/src/*.c -lm 
-#$COMP -m32 -O2 -Wall -fomit-frame-pointer -fno-strict-aliasing -fPIC -o test/bin/crgPerfTest -I baselib/inc test/PerfTest/src/main.c baselib/src/*.c -lm 
+$COMP  -o test/bin/crgPerfTest -I baselib/inc test/PerfTest/src/main.c baselib/src/*.c -lm -lpthread
+#$COMP -m32 -O2 -Wall -fomit-frame-pointer -fno-strict-aliasing -fPIC -o test/bin/crgPerfTest -I baselib/inc test/PerfTest/src/main.c baselib/src/*.c -lm -lpthread
 echo done
 
 echo -n compiling crgDump...
-$COMP -o test/bin/crgDump -I baselib/inc test/Dump/src/main.c baselib/src/*.c -lm 
+$COMP -o test/bin/crgDump -I baselib/inc test/Dump/src/main.c baselib/src/*.c -lm -lpthread
 echo done
 
 echo -n compiling crgMemTest...
-$COMP -o test/bin/crgMemTest -I baselib/inc test/MemTest/src/main.c baselib/src/*.c -lm 
+$COMP -o test/bin/crgMemTest -I baselib/inc test/MemTest/src/main.c baselib/src/*.c -lm -lpthread
 echo done
 
 echo -n compiling crgVerify...
-$COMP -o test/bin/crgVerify -I baselib/inc test/Verify/src/main.c baselib/src/*.c -lm 
+$COMP -o test/bin/crgVerify -I baselib/inc test/Verify/src/main.c baselib/src/*.c -lm -lpthread
 echo done
 
 echo -n compiling crScan...
-$COMP -o test/bin/crgScan -I baselib/inc test/Scan/src/main.c baselib/src/*.c -lm 
+$COMP -o test/bin/crgScan -I baselib/inc test/Scan/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgMultiThread...
+$COMP -o test/bin/crgMultiThread -I baselib/inc test/MultiThread/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgMultiLoad...
+$COMP -o test/bin/crgMultiLoad -I baselib/inc test/MultiLoad/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgRoundTrip...
+$COMP -o test/bin/crgRoundTrip -I baselib/inc test/RoundTrip/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgGridFilter...
+$COMP -o test/bin/crgGridFilter -I baselib/inc test/GridFilter/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgPeakLimit...
+$COMP -o test/bin/crgPeakLimit -I baselib/inc test/PeakLimit/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgRerender...
+$COMP -o test/bin/crgRerender -I baselib/inc test/Rerender/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgViewAppend...
+$COMP -o test/bin/crgViewAppend -I baselib/inc test/ViewAppend/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgEvalVariants...
+$COMP -o test/bin/crgEvalVariants -I baselib/inc test/EvalVariants/src/main.c baselib/src/*.c -lm -lpthread
+echo done
+
+echo -n compiling crgLoadVariants...
+$COMP -o test/bin/crgLoadVariants -I baselib/inc test/LoadVariants/src/main.c baselib/src/*.c -lm -lpthread
 echo done
@@ -0,0 +1,562 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              comparing the batch, fused and
+ *              specialized evaluations with the
+ *              single evaluation of positions
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoPositions    20000     /* positions per file                                    */
+#define dBlockSize      400       /* positions per batch, i.e. four wheels of 10 x 10 points */
+#define dNoColdStarts   2000      /* x/y searches without history                          */
+
+/* ====== LOCAL METHODS ====== */
+static int checkFile( const char* filename );
+static int checkBatch( int dataSetId, const double* x, const double* y, const double* u, const double* v, int n );
+static int checkFused( int dataSetId, const double* x, const double* y, int n );
+static int checkKernels( int dataSetId, const double* u, const double* v, int n );
+static int checkNormal( int dataSetId, const double* u, const double* v, int n );
+static int checkSpatialIndex( int dataSetId, const double* x, const double* y, int n );
+static int countDiffs( const double* a, const double* b, int n );
+static double* allocArray( int n );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgEvalVariants [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h    show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file(s) as input file(s)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    int noFiles  = 0;
+    int noFailed = 0;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        noFiles++;
+
+        if ( !checkFile( *argv ) )
+            noFailed++;
+    }
+
+    if ( !noFiles )
+        usage();
+
+    crgMemRelease();
+
+    if ( noFailed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: %d of %d files could NOT be evaluated identically.\n", noFailed, noFiles );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: all %d files have been evaluated identically.\n", noFiles );
+
+    return 0;
+}
+
+static int
+checkFile( const char* filename )
+{
+    int     dataSetId;
+    int     cpId;
+    int     i;
+    int     noDiffs = 0;
+    double  uMin;
+    double  uMax;
+    double  vMin;
+    double  vMax;
+    double  uc;
+    double  vc;
+    double* x;
+    double* y;
+    double* u;
+    double* v;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "checkFile: could not load <%s>.\n", filename );
+        return 0;
+    }
+
+    crgDataSetModifiersApply( dataSetId );
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    crgMsgPrint( dCrgMsgLevelNotice, "checkFile: file <%s>\n", filename );
+
+    x = allocArray( dNoPositions );
+    y = allocArray( dNoPositions );
+    u = allocArray( dNoPositions );
+    v = allocArray( dNoPositions );
+
+    crgDataSetGetURange( dataSetId, &uMin, &uMax );
+    crgDataSetGetVRange( dataSetId, &vMin, &vMax );
+
+    cpId = crgContactPointCreate( dataSetId );
+    crgContactPointSetDefaultOptions( cpId );
+
+    /* --- a drive along the road, u/v positions exceed the borders, x/y positions stay on the road --- */
+    srand( 1 );
+
+    for ( i = 0; i < dNoPositions; i++ )
+    {
+        u[i] = uMin + ( uMax - uMin ) * ( 1.1 * i / dNoPositions - 0.05 );
+        v[i] = vMin + ( vMax - vMin ) * ( 1.2 * rand() / RAND_MAX - 0.1 );
+
+        uc = u[i] < uMin ? uMin : ( u[i] > uMax ? uMax : u[i] );
+        vc = v[i] < vMin ? vMin : ( v[i] > vMax ? vMax : v[i] );
+
+        crgEvaluv2xy( cpId, uc, vc, &x[i], &y[i] );
+    }
+
+    crgContactPointDelete( cpId );
+
+    noDiffs += checkBatch( dataSetId, x, y, u, v, dNoPositions );
+    noDiffs += checkFused( dataSetId, x, y, dNoPositions );
+    noDiffs += checkKernels( dataSetId, u, v, dNoPositions );
+    noDiffs += checkNormal( dataSetId, u, v, dNoPositions );
+    noDiffs += checkSpatialIndex( dataSetId, x, y, dNoPositions );
+
+    crgDataSetRelease( dataSetId );
+
+    free( x );
+    free( y );
+    free( u );
+    free( v );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "checkFile:     %d differences\n", noDiffs );
+
+    return !noDiffs;
+}
+
+static int
+checkBatch( int dataSetId, const double* x, const double* y, const double* u, const double* v, int n )
+{
+    int     cpId[2];
+    int     i;
+    int     k;
+    int     noPts;
+    int     kernel;
+    int     noDiffs;
+    int     noTotal = 0;
+    int*    stat[2];
+    double* res[2][2];
+
+    for ( k = 0; k < 2; k++ )
+    {
+        res[k][0] = allocArray( n );
+        res[k][1] = allocArray( n );
+        stat[k]   = ( int* ) calloc( n, sizeof( int ) );
+
+        if ( !stat[k] )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "checkBatch: could not allocate memory.\n" );
+            exit( -1 );
+        }
+
+        /* --- separate contact points, so that both methods start with an empty history --- */
+        cpId[k] = crgContactPointCreate( dataSetId );
+        crgContactPointSetDefaultOptions( cpId[k] );
+    }
+
+    /* --- x/y to u/v --- */
+    for ( i = 0; i < n; i++ )
+        crgEvalxy2uv( cpId[0], x[i], y[i], &res[0][0][i], &res[0][1][i] );
+
+    for ( i = 0; i < n; i += dBlockSize )
+    {
+        noPts = ( i + dBlockSize > n ) ? n - i : dBlockSize;
+
+        crgEvalxy2uvBatch( cpId[1], noPts, &x[i], &y[i], &res[1][0][i], &res[1][1][i] );
+    }
+
+    noDiffs  = countDiffs( res[0][0], res[1][0], n ) + countDiffs( res[0][1], res[1][1], n );
+    noTotal += noDiffs;
+
+    crgMsgPrint( dCrgMsgLevelNotice, "checkBatch:     x/y to u/v:         %d of %d results differ\n", noDiffs, n );
+
+    /* --- u/v to z, once for each interpolation kernel available on this CPU --- */
+    for ( i = 0; i < n; i++ )
+        stat[0][i] = crgEvaluv2z( cpId[0], u[i], v[i], &res[0][0][i] );
+
+    for ( kernel = dCrgKernelScalar; kernel <= dCrgKernelAVX2; kernel++ )
+    {
+        if ( !crgEvalzSetKernel( kernel ) )
+            continue;
+
+        for ( i = 0; i < n; i += dBlockSize )
+        {
+            noPts = ( i + dBlockSize > n ) ? n - i : dBlockSize;
+
+            crgEvaluv2zBatch( cpId[1], noPts, &u[i], &v[i], &res[1][0][i], &stat[1][i] );
+        }
+
+        noDiffs = countDiffs( res[0][0], res[1][0], n );
+
+        for ( i = 0; i < n; i++ )
+            if ( stat[0][i] != stat[1][i] )
+                noDiffs++;
+
+        noTotal += noDiffs;
+
+        crgMsgPrint( dCrgMsgLevelNotice, "checkBatch:     u/v to z, %s kernel: %d of %d results differ\n", crgEvalzGetKernelName(), noDiffs, n );
+    }
+
+    crgEvalzSetKernel( dCrgKernelAuto );
+
+    for ( k = 0; k < 2; k++ )
+    {
+        crgContactPointDelete( cpId[k] );
+
+        free( res[k][0] );
+        free( res[k][1] );
+        free( stat[k] );
+    }
+
+    return noTotal;
+}
+
+static int
+checkFused( int dataSetId, const double* x, const double* y, int n )
+{
+    const char* name[3] = { "separate calls", "crgEvalxy2all", "crgEvalxy2allBatch" };
+    int     cpId;
+    int     i;
+    int     k;
+    int     m;
+    int     noPts;
+    int     noDiffs;
+    int     noTotal = 0;
+    double* res[3][5];
+
+    for ( k = 0; k < 3; k++ )
+    {
+        for ( m = 0; m < 5; m++ )
+            res[k][m] = allocArray( n );
+
+        /* --- a new contact point per variant, so that all start with an empty history --- */
+        cpId = crgContactPointCreate( dataSetId );
+        crgContactPointSetDefaultOptions( cpId );
+
+        if ( !k )
+        {
+            for ( i = 0; i < n; i++ )
+            {
+                crgEvalxy2uv( cpId, x[i], y[i], &res[k][0][i], &res[k][1][i] );
+                crgEvaluv2z( cpId, res[k][0][i], res[k][1][i], &res[k][2][i] );
+                crgEvaluv2pk( cpId, res[k][0][i], res[k][1][i], &res[k][3][i], &res[k][4][i] );
+            }
+        }
+        else if ( k == 1 )
+        {
+            for ( i = 0; i < n; i++ )
+                crgEvalxy2all( cpId, x[i], y[i], &res[k][0][i], &res[k][1][i], &res[k][2][i], &res[k][3][i], &res[k][4][i] );
+        }
+        else
+        {
+            for ( i = 0; i < n; i += dBlockSize )
+            {
+                noPts = ( i + dBlockSize > n ) ? n - i : dBlockSize;
+
+                crgEvalxy2allBatch( cpId, noPts, &x[i], &y[i], &res[k][0][i], &res[k][1][i], &res[k][2][i], &res[k][3][i], &res[k][4][i] );
+            }
+        }
+
+        crgContactPointDelete( cpId );
+    }
+
+    /* --- u, v, z, phi and curvature must be identical to those of the separate calls --- */
+    for ( k = 1; k < 3; k++ )
+    {
+        noDiffs = 0;
+
+        for ( m = 0; m < 5; m++ )
+            noDiffs += countDiffs( res[0][m], res[k][m], n );
+
+        noTotal += noDiffs;
+
+        crgMsgPrint( dCrgMsgLevelNotice, "checkFused:     %-18s  %d of %d results differ from %s\n", name[k], noDiffs, n, name[0] );
+    }
+
+    for ( k = 0; k < 3; k++ )
+        for ( m = 0; m < 5; m++ )
+            free( res[k][m] );
+
+    return noTotal;
+}
+
+static int
+checkKernels( int dataSetId, const double* u, const double* v, int n )
+{
+    const char* name[3] = { "default options", "smoothing zones", "border mode repeat" };
+    CrgContactPointStruct* cp;
+    int     cpId;
+    int     optSet;
+    int     i;
+    int     noDiffs;
+    int     noTotal = 0;
+    double  uMin;
+    double  uMax;
+    double  zone;
+    double* res[2];
+
+    res[0] = allocArray( n );
+    res[1] = allocArray( n );
+
+    crgDataSetGetURange( dataSetId, &uMin, &uMax );
+
+    /* --- the zones must leave a core area for the specialized kernel --- */
+    zone = 0.1 * ( uMax - uMin );
+
+    if ( zone > 1.0 )
+        zone = 1.0;
+
+    cpId = crgContactPointCreate( dataSetId );
+    cp   = crgContactPointGetFromId( cpId );
+
+    for ( optSet = 0; optSet < 3; optSet++ )
+    {
+        crgContactPointSetDefaultOptions( cpId );
+
+        if ( optSet == 1 )
+        {
+            crgContactPointOptionSetDouble( cpId, dCrgCpOptionSmoothUBegin, zone );
+            crgContactPointOptionSetDouble( cpId, dCrgCpOptionSmoothUEnd,   zone );
+        }
+        else if ( optSet == 2 )
+        {
+            crgContactPointOptionSetInt( cpId, dCrgCpOptionBorderModeU, dCrgBorderModeRepeat );
+            crgContactPointOptionSetInt( cpId, dCrgCpOptionBorderModeV, dCrgBorderModeRepeat );
+        }
+
+        /* --- the generic evaluation against the kernel selected for the contact point --- */
+        for ( i = 0; i < n; i++ )
+        {
+            crgDataEvaluv2z( cp->crgData, &( cp->options ), &( cp->perfStat ), u[i], v[i], &res[0][i] );
+            crgEvaluv2zPtr( cp, u[i], v[i], &res[1][i] );
+        }
+
+        noDiffs  = countDiffs( res[0], res[1], n );
+        noTotal += noDiffs;
+
+        crgMsgPrint( dCrgMsgLevelNotice, "checkKernels:   %-18s  %d of %d results differ\n", name[optSet], noDiffs, n );
+    }
+
+    crgContactPointDelete( cpId );
+
+    free( res[0] );
+    free( res[1] );
+
+    return noTotal;
+}
+
+static int
+checkNormal( int dataSetId, const double* u, const double* v, int n )
+{
+    int     cpId;
+    int     i;
+    int     k;
+    int     m;
+    int     noPts;
+    int     noDiffs;
+    int     noTotal = 0;
+    int*    stat[2];
+    double* z;
+    double* res[2][4];
+
+    z = allocArray( n );
+
+    /* --- z, derivatives by u and v, and three components of the normal per position --- */
+    for ( k = 0; k < 2; k++ )
+    {
+        for ( m = 0; m < 3; m++ )
+            res[k][m] = allocArray( n );
+
+        res[k][3] = allocArray( 3 * n );
+
+        if ( !( stat[k] = ( int* ) calloc( n, sizeof( int ) ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "checkNormal: could not allocate memory.\n" );
+            exit( -1 );
+        }
+    }
+
+    cpId = crgContactPointCreate( dataSetId );
+    crgContactPointSetDefaultOptions( cpId );
+
+    for ( i = 0; i < n; i++ )
+    {
+        crgEvaluv2z( cpId, u[i], v[i], &z[i] );
+        stat[0][i] = crgEvaluv2zn( cpId, u[i], v[i], &res[0][0][i], &res[0][1][i], &res[0][2][i], &res[0][3][3*i] );
+    }
+
+    /* --- z of the surface normal query must be identical to that of crgEvaluv2z() --- */
+    noDiffs  = countDiffs( z, res[0][0], n );
+    noTotal += noDiffs;
+
+    crgMsgPrint( dCrgMsgLevelNotice, "checkNormal:    z of crgEvaluv2zn   %d of %d results differ\n", noDiffs, n );
+
+    for ( i = 0; i < n; i += dBlockSize )
+    {
+        noPts = ( i + dBlockSize > n ) ? n - i : dBlockSize;
+
+        crgEvaluv2znBatch( cpId, noPts, &u[i], &v[i], &res[1][0][i], &res[1][1][i], &res[1][2][i], &res[1][3][3*i], &stat[1][i] );
+    }
+
+    noDiffs = countDiffs( res[0][3], res[1][3], 3 * n );
+
+    for ( m = 0; m < 3; m++ )
+        noDiffs += countDiffs( res[0][m], res[1][m], n );
+
+    for ( i = 0; i < n; i++ )
+        if ( stat[0][i] != stat[1][i] )
+            noDiffs++;
+
+    noTotal += noDiffs;
+
+    crgMsgPrint( dCrgMsgLevelNotice, "checkNormal:    crgEvaluv2znBatch   %d of %d results differ\n", noDiffs, n );
+
+    crgContactPointDelete( cpId );
+
+    free( z );
+
+    for ( k = 0; k < 2; k++ )
+    {
+        for ( m = 0; m < 4; m++ )
+            free( res[k][m] );
+
+        free( stat[k] );
+    }
+
+    return noTotal;
+}
+
+static int
+checkSpatialIndex( int dataSetId, const double* x, const double* y, int n )
+{
+    CrgDataStruct* crgData = crgDataSetAccess( dataSetId );
+    int     cpId;
+    int     i;
+    int     k;
+    int     idx;
+    int     noDiffs;
+    double* res[2][2];
+
+    for ( k = 0; k < 2; k++ )
+    {
+        res[k][0] = allocArray( dNoColdStarts );
+        res[k][1] = allocArray( dNoColdStarts );
+    }
+
+    /* --- without history, every query is a cold start --- */
+    cpId = crgContactPointCreate( dataSetId );
+    crgContactPointSetHistory( cpId, 0 );
+
+    for ( k = 0; k < 2; k++ )
+    {
+        /* --- first pass scans the reference line, second pass uses the spatial index --- */
+        if ( !k )
+            crgEvalxy2uvReleaseIndex( crgData );
+        else
+            crgEvalxy2uvBuildIndex( crgData );
+
+        srand( 1 );
+
+        for ( i = 0; i < dNoColdStarts; i++ )
+        {
+            idx = ( int ) ( ( double ) rand() / ( ( double ) RAND_MAX + 1.0 ) * n );
+
+            crgEvalxy2uv( cpId, x[idx], y[idx], &res[k][0][i], &res[k][1][i] );
+        }
+    }
+
+    noDiffs = countDiffs( res[0][0], res[1][0], dNoColdStarts ) + countDiffs( res[0][1], res[1][1], dNoColdStarts );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "checkSpatialIndex: x/y to u/v     %d of %d results differ\n", noDiffs, dNoColdStarts );
+
+    crgContactPointDelete( cpId );
+
+    for ( k = 0; k < 2; k++ )
+    {
+        free( res[k][0] );
+        free( res[k][1] );
+    }
+
+    return noDiffs;
+}
+
+static int
+countDiffs( const double* a, const double* b, int n )
+{
+    int i;
+    int noDiffs = 0;
+
+    /* --- the variants must be bit-identical --- */
+    for ( i = 0; i < n; i++ )
+    {
+        if ( memcmp( &a[i], &b[i], sizeof( double ) ) )
+        {
+            if ( !noDiffs )
+                crgMsgPrint( dCrgMsgLevelWarn, "countDiffs: first difference at %d: %.17g vs. %.17g\n", i, a[i], b[i] );
+
+            noDiffs++;
+        }
+    }
+
+    return noDiffs;
+}
+
+static double*
+allocArray( int n )
+{
+    double* array = ( double* ) calloc( n, sizeof( double ) );
+
+    if ( !array )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "allocArray: could not allocate memory.\n" );
+        exit( -1 );
+    }
+
+    return array;
+}
@@ -0,0 +1,503 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              filtering the elevation grid by the
+ *              grid filter modifiers and comparing
+ *              the result with a direct evaluation
+ *              of the masks of crg_filter.m
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoCases    7
+#define dMaxMask    16
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    const char* name;
+    int    mode;
+    int    sizeU;
+    int    sizeV;
+    double weight;
+    int    repeat;
+    int    subRange;        /* filter the inner half of the grid only */
+} FilterCaseStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static const FilterCaseStruct mCase[dNoCases] =
+{
+    { "mean 3x3",              dCrgFilterMean,    3, 3, 1.0, 1, 0 },
+    { "mean 5x3 x3, range",    dCrgFilterMean,    5, 3, 1.0, 3, 1 },
+    { "gauss 5x5 x2",          dCrgFilterGauss,   5, 5, 1.0, 2, 0 },
+    { "sobel 3x3",             dCrgFilterSobel,   3, 3, 1.0, 1, 0 },
+    { "2diff 5x3, weight 0.5", dCrgFilter2Diff,   5, 3, 0.5, 1, 0 },
+    { "laplace 3x3, range",    dCrgFilterLaplace, 3, 3, 1.0, 1, 1 },
+    { "mask 2x3 x2",           dCrgFilterMask,    2, 3, 1.0, 2, 0 }
+};
+
+/* mask of the last case, asymmetric to check the orientation of the convolution */
+static const double mMask[6] = { 0.1, 0.3,
+                                 0.0, 0.4,
+                                 0.15, 0.05 };
+
+static int mNoThreads = 0;
+
+/* ====== LOCAL METHODS ====== */
+static int filterFile( const char* filename );
+static int loadFiltered( const char* filename, const FilterCaseStruct* fc, CrgDataStruct* base, int noThreads, double* tApply );
+static void setRange( int dataSetId, CrgDataStruct* base, const FilterCaseStruct* fc );
+static void getRange( CrgDataStruct* base, const FilterCaseStruct* fc, size_t* iu0, size_t* iu1, size_t* iv0, size_t* iv1 );
+static void buildMask( const FilterCaseStruct* fc, double* mask );
+static void binomial( double* coef, int n, int k );
+static size_t compareReference( CrgDataStruct* base, CrgDataStruct* filtered, const FilterCaseStruct* fc, double* maxDiff, size_t* noChanged );
+static size_t compareGrids( CrgDataStruct* a, CrgDataStruct* b );
+static double getTime( void );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgGridFilter [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -t <n>     number of threads compared with a single thread (default: one per processor)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file(s) as input file(s)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    int noFiles  = 0;
+    int noFailed = 0;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        if ( !strcmp( *argv, "-t" ) && argc )
+        {
+            argv++;
+            argc--;
+            mNoThreads = atoi( *argv );
+
+            if ( mNoThreads < 0 )
+                usage();
+            continue;
+        }
+
+        noFiles++;
+
+        if ( !filterFile( *argv ) )
+            noFailed++;
+    }
+
+    if ( !noFiles )
+        usage();
+
+    crgMemRelease();
+
+    if ( noFailed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: %d of %d files could NOT be filtered correctly.\n", noFailed, noFiles );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: all %d files have been filtered correctly.\n", noFiles );
+
+    return 0;
+}
+
+static int
+filterFile( const char* filename )
+{
+    CrgDataStruct* base;
+    int    baseId;
+    int    idSingle;
+    int    idMulti;
+    int    i;
+    int    noThreads = mNoThreads ? mNoThreads : crgPortGetNoProcessors();
+    size_t noDiffs   = 0;
+    size_t diffs;
+    size_t noChanged;
+    double maxDiff;
+    double tBase;
+    double tSingle;
+    double tMulti;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    crgLoaderSetNoThreads( 1 );
+
+    if ( ( baseId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "filterFile: could not load <%s>.\n", filename );
+        return 0;
+    }
+
+    tBase = getTime();
+    crgDataSetModifiersApply( baseId );
+    tBase = getTime() - tBase;
+
+    base = crgDataSetAccess( baseId );
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    crgMsgPrint( dCrgMsgLevelNotice, "filterFile: file <%s>, %ld x %ld samples, modifiers applied in %.3f ms\n",
+                 filename, base->channelU.info.size, base->channelV.info.size, tBase * 1.0e3 );
+
+    for ( i = 0; i < dNoCases; i++ )
+    {
+        if ( base->channelU.info.size < ( size_t ) ( 2 * mCase[i].sizeU ) || base->channelV.info.size < ( size_t ) ( 2 * mCase[i].sizeV ) )
+        {
+            crgMsgPrint( dCrgMsgLevelNotice, "filterFile:     %-22s: grid too small, skipped\n", mCase[i].name );
+            continue;
+        }
+
+        if ( ( idSingle = loadFiltered( filename, &mCase[i], base, 1, &tSingle ) ) <= 0 )
+        {
+            noDiffs++;
+            continue;
+        }
+
+        if ( ( idMulti = loadFiltered( filename, &mCase[i], base, noThreads, &tMulti ) ) <= 0 )
+        {
+            crgDataSetRelease( idSingle );
+            noDiffs++;
+            continue;
+        }
+
+        /* --- the threads must not change the result at all --- */
+        diffs  = compareGrids( crgDataSetAccess( idSingle ), crgDataSetAccess( idMulti ) );
+        diffs += compareReference( base, crgDataSetAccess( idSingle ), &mCase[i], &maxDiff, &noChanged );
+
+        crgMsgPrint( dCrgMsgLevelNotice, "filterFile:     %-22s: %9.3f ms with 1 thread, %9.3f ms with %d threads, %ld samples changed, max. deviation %.3e m, %ld differences\n",
+                     mCase[i].name, tSingle * 1.0e3, tMulti * 1.0e3, noThreads, noChanged, maxDiff, diffs );
+
+        noDiffs += diffs;
+
+        crgMsgSetLevel( dCrgMsgLevelWarn );
+        crgDataSetRelease( idSingle );
+        crgDataSetRelease( idMulti );
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+    }
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    crgDataSetRelease( baseId );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "filterFile:     %ld differences\n", noDiffs );
+
+    return !noDiffs;
+}
+
+static int
+loadFiltered( const char* filename, const FilterCaseStruct* fc, CrgDataStruct* base, int noThreads, double* tApply )
+{
+    int dataSetId;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    crgLoaderSetNoThreads( noThreads );
+
+    if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "loadFiltered: could not load <%s>.\n", filename );
+        return 0;
+    }
+
+    if ( fc->mode == dCrgFilterMask )
+        crgDataSetModifierSetFilterMask( dataSetId, mMask, fc->sizeU, fc->sizeV );
+    else
+    {
+        crgDataSetModifierSetInt( dataSetId, dCrgModFilterMode,  fc->mode );
+        crgDataSetModifierSetInt( dataSetId, dCrgModFilterSizeU, fc->sizeU );
+        crgDataSetModifierSetInt( dataSetId, dCrgModFilterSizeV, fc->sizeV );
+    }
+
+    crgDataSetModifierSetDouble( dataSetId, dCrgModFilterWeight, fc->weight );
+    crgDataSetModifierSetInt(    dataSetId, dCrgModFilterRepeat, fc->repeat );
+
+    if ( fc->subRange )
+        setRange( dataSetId, base, fc );
+
+    *tApply = getTime();
+    crgDataSetModifiersApply( dataSetId );
+    *tApply = getTime() - *tApply;
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    return dataSetId;
+}
+
+static void
+getRange( CrgDataStruct* base, const FilterCaseStruct* fc, size_t* iu0, size_t* iu1, size_t* iv0, size_t* iv1 )
+{
+    size_t nu = base->channelU.info.size;
+    size_t nv = base->channelV.info.size;
+
+    *iu0 = 0;
+    *iu1 = nu - 1;
+    *iv0 = 0;
+    *iv1 = nv - 1;
+
+    if ( !fc->subRange )
+        return;
+
+    *iu0 = nu / 4;
+    *iu1 = nu - 1 - nu / 4;
+    *iv0 = nv / 4;
+    *iv1 = nv - 1 - nv / 4;
+}
+
+static void
+setRange( int dataSetId, CrgDataStruct* base, const FilterCaseStruct* fc )
+{
+    size_t iu0;
+    size_t iu1;
+    size_t iv0;
+    size_t iv1;
+
+    getRange( base, fc, &iu0, &iu1, &iv0, &iv1 );
+
+    crgDataSetModifierSetDouble( dataSetId, dCrgModFilterUBegin, base->channelU.info.first + iu0 * base->channelU.info.inc );
+    crgDataSetModifierSetDouble( dataSetId, dCrgModFilterUEnd,   base->channelU.info.first + iu1 * base->channelU.info.inc );
+    crgDataSetModifierSetDouble( dataSetId, dCrgModFilterVBegin, base->channelV.data[iv0] );
+    crgDataSetModifierSetDouble( dataSetId, dCrgModFilterVEnd,   base->channelV.data[iv1] );
+}
+
+static void
+binomial( double* coef, int n, int k )
+{
+    double tmp[dMaxMask];
+    int    m = 1;
+    int    i;
+    int    j;
+
+    /* --- binf() of crg_filter.m: conv with [1 1] ( n - k - 1 ) times, with [-1 1] k times --- */
+    coef[0] = 1.0;
+
+    for ( j = 0; j < n - 1; j++ )
+    {
+        double b0 = ( j < n - k - 1 ) ? 1.0 : -1.0;
+
+        for ( i = 0; i <= m; i++ )
+            tmp[i] = ( i < m ? b0 * coef[i] : 0.0 ) + ( i > 0 ? coef[i-1] : 0.0 );
+
+        m++;
+        memcpy( coef, tmp, m * sizeof( double ) );
+    }
+
+    for ( i = 0; i < n; i++ )
+        coef[i] *= pow( 2.0, -( n - k - 1 ) );
+}
+
+static void
+buildMask( const FilterCaseStruct* fc, double* mask )
+{
+    double cu[dMaxMask];
+    double cv[dMaxMask];
+    int    i;
+    int    j;
+
+    /* --- mask[j * sizeU + i] is the coefficient for u offset i and v offset j --- */
+    switch ( fc->mode )
+    {
+        case dCrgFilterMean:
+            for ( i = 0; i < fc->sizeU * fc->sizeV; i++ )
+                mask[i] = 1.0 / ( fc->sizeU * fc->sizeV );
+            return;
+
+        case dCrgFilterMask:
+            memcpy( mask, mMask, fc->sizeU * fc->sizeV * sizeof( double ) );
+            return;
+
+        case dCrgFilterGauss:
+            binomial( cu, fc->sizeU, 0 );
+            binomial( cv, fc->sizeV, 0 );
+            break;
+
+        case dCrgFilterSobel:
+            binomial( cu, fc->sizeU, 1 );
+            binomial( cv, fc->sizeV, 0 );
+            break;
+
+        case dCrgFilter2Diff:
+            binomial( cu, fc->sizeU, 2 );
+            binomial( cv, fc->sizeV, 0 );
+            break;
+
+        case dCrgFilterLaplace:
+            binomial( cu, fc->sizeU, 2 );
+            binomial( cv, fc->sizeV, 2 );
+            break;
+    }
+
+    for ( j = 0; j < fc->sizeV; j++ )
+        for ( i = 0; i < fc->sizeU; i++ )
+            mask[j * fc->sizeU + i] = cu[i] * cv[j];
+
+    /* --- derivative masks sum up to zero and get the sample itself added --- */
+    if ( fc->mode != dCrgFilterGauss )
+        mask[( ( fc->sizeV + 1 ) / 2 - 1 ) * fc->sizeU + ( fc->sizeU + 1 ) / 2 - 1] += 1.0;
+}
+
+static size_t
+compareReference( CrgDataStruct* base, CrgDataStruct* filtered, const FilterCaseStruct* fc, double* maxDiff, size_t* noChanged )
+{
+    double  mask[dMaxMask * dMaxMask];
+    double* z;
+    double* t;
+    double  sum;
+    double  zMax = 0.0;
+    double  diff;
+    size_t  iu0;
+    size_t  iu1;
+    size_t  iv0;
+    size_t  iv1;
+    size_t  nu;
+    size_t  nv;
+    size_t  iu;
+    size_t  iv;
+    size_t  noDiffs = 0;
+    int     offU    = ( fc->sizeU + 1 ) / 2 - 1;
+    int     offV    = ( fc->sizeV + 1 ) / 2 - 1;
+    int     i;
+    int     j;
+    int     pass;
+
+    *maxDiff   = 0.0;
+    *noChanged = 0;
+
+    buildMask( fc, mask );
+    getRange( base, fc, &iu0, &iu1, &iv0, &iv1 );
+
+    nu = iu1 - iu0 + 1;
+    nv = iv1 - iv0 + 1;
+    z  = ( double* ) calloc( nu * nv, sizeof( double ) );
+    t  = ( double* ) calloc( nu * nv, sizeof( double ) );
+
+    if ( !z || !t )
+        return 1;
+
+    for ( iv = 0; iv < nv; iv++ )
+        for ( iu = 0; iu < nu; iu++ )
+            z[iv * nu + iu] = base->channelZ[iv0 + iv].data[iu0 + iu];
+
+    /* --- conv2( z, fmask * weight, 'valid' ), written back to the inner samples --- */
+    for ( pass = 0; pass < fc->repeat; pass++ )
+    {
+        memcpy( t, z, nu * nv * sizeof( double ) );
+
+        for ( iv = 0; iv + fc->sizeV <= nv; iv++ )
+        {
+            for ( iu = 0; iu + fc->sizeU <= nu; iu++ )
+            {
+                sum = 0.0;
+
+                for ( j = 0; j < fc->sizeV; j++ )
+                    for ( i = 0; i < fc->sizeU; i++ )
+                        sum += mask[j * fc->sizeU + i] * t[( iv + fc->sizeV - 1 - j ) * nu + iu + fc->sizeU - 1 - i];
+
+                sum *= fc->weight;
+
+                if ( sum == sum )
+                    z[( iv + offV ) * nu + iu + offU] = sum;
+            }
+        }
+    }
+
+    for ( iv = 0; iv < nv; iv++ )
+        for ( iu = 0; iu < nu; iu++ )
+            if ( fabs( z[iv * nu + iu] ) > zMax )
+                zMax = fabs( z[iv * nu + iu] );
+
+    /* --- the library accumulates in single precision --- */
+    for ( iv = 0; iv < base->channelV.info.size; iv++ )
+    {
+        for ( iu = 0; iu < base->channelU.info.size; iu++ )
+        {
+            double ref = base->channelZ[iv].data[iu];
+            float  val = filtered->channelZ[iv].data[iu];
+
+            if ( iv >= iv0 && iv <= iv1 && iu >= iu0 && iu <= iu1 )
+                ref = z[( iv - iv0 ) * nu + iu - iu0];
+
+            if ( crgIsNan( &ref ) || crgIsNanf( &val ) )
+            {
+                noDiffs += ( crgIsNan( &ref ) != crgIsNanf( &val ) );
+                continue;
+            }
+
+            *noChanged += ( val != base->channelZ[iv].data[iu] );
+
+            diff = fabs( val - ref );
+
+            if ( diff > *maxDiff )
+                *maxDiff = diff;
+
+            if ( diff > 1.0e-5 * ( zMax + 1.0 ) )
+                noDiffs++;
+        }
+    }
+
+    free( z );
+    free( t );
+
+    return noDiffs;
+}
+
+static size_t
+compareGrids( CrgDataStruct* a, CrgDataStruct* b )
+{
+    size_t i;
+    size_t noDiffs = 0;
+
+    if ( a->channelV.info.size != b->channelV.info.size || a->channelU.info.size != b->channelU.info.size )
+        return 1;
+
+    for ( i = 0; i < a->channelV.info.size; i++ )
+        if ( memcmp( a->channelZ[i].data, b->channelZ[i].data, a->channelU.info.size * sizeof( float ) ) )
+            noDiffs++;
+
+    return noDiffs;
+}
+
+static double
+getTime( void )
+{
+    struct timeval tme;
+
+    gettimeofday( &tme, 0 );
+
+    return 1.0 * tme.tv_sec + 1.0e-6 * tme.tv_usec;
+}
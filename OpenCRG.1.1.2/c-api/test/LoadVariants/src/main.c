@@ -0,0 +1,364 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              loading data sets from snapshots,
+ *              headers, with other file access and
+ *              grid settings, and comparing their
+ *              evaluation with the loaded file
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoPositions    20000     /* positions per file                            */
+#define dNoResults      5         /* z, x, y, u and v per position                 */
+#define dNoMeta         6         /* u range, v range and increments of a data set */
+#define dMaxPath        1024
+
+/* ====== LOCAL METHODS ====== */
+static int checkFile( const char* filename, const char* prefix );
+static int checkSnapshot( int refId, const double* ref, const char* prefix );
+static int checkHeader( const char* filename, int refId, const double* ref );
+static int checkSettings( const char* filename, const double* ref );
+static int compareLoaded( int dataSetId, const double* ref, const char* label );
+static void evaluate( int dataSetId, double* res );
+static void getMetaData( int dataSetId, double* meta );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgLoadVariants [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -o <name>  prefix of the snapshot written (default: crgLoadVariants)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file(s) as input file(s)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    const char* prefix   = "crgLoadVariants";
+    int         noFiles  = 0;
+    int         noFailed = 0;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        if ( !strcmp( *argv, "-o" ) && argc )
+        {
+            argv++;
+            argc--;
+            prefix = *argv;
+
+            if ( strlen( prefix ) > dMaxPath - 16 )
+                usage();
+            continue;
+        }
+
+        noFiles++;
+
+        if ( !checkFile( *argv, prefix ) )
+            noFailed++;
+    }
+
+    if ( !noFiles )
+        usage();
+
+    crgMemRelease();
+
+    if ( noFailed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: %d of %d files could NOT be loaded identically.\n", noFailed, noFiles );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: all %d files have been loaded identically.\n", noFiles );
+
+    return 0;
+}
+
+static int
+checkFile( const char* filename, const char* prefix )
+{
+    int     refId;
+    int     noDiffs = 0;
+    double* ref;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( ( refId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "checkFile: could not load <%s>.\n", filename );
+        return 0;
+    }
+
+    crgDataSetModifiersApply( refId );
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    crgMsgPrint( dCrgMsgLevelNotice, "checkFile: file <%s>\n", filename );
+
+    if ( !( ref = ( double* ) calloc( dNoResults * dNoPositions, sizeof( double ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "checkFile: could not allocate memory.\n" );
+        exit( -1 );
+    }
+
+    evaluate( refId, ref );
+
+    noDiffs += checkSnapshot( refId, ref, prefix );
+    noDiffs += checkHeader( filename, refId, ref );
+    noDiffs += checkSettings( filename, ref );
+
+    crgDataSetRelease( refId );
+
+    free( ref );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "checkFile:     %d differences\n", noDiffs );
+
+    return !noDiffs;
+}
+
+static int
+checkSnapshot( int refId, const double* ref, const char* prefix )
+{
+    char name[dMaxPath];
+    int  dataSetId;
+    int  noDiffs;
+
+    sprintf( name, "%s.snapshot", prefix );
+
+    if ( !crgDataSetSave( refId, name ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "checkSnapshot: could not save <%s>.\n", name );
+        return 1;
+    }
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    dataSetId = crgDataSetLoadSnapshot( name );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    remove( name );
+
+    if ( dataSetId <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "checkSnapshot: could not load <%s>.\n", name );
+        return 1;
+    }
+
+    /* --- modifiers are part of the snapshot, applying them again must not change anything --- */
+    crgDataSetModifiersApply( dataSetId );
+
+    noDiffs = compareLoaded( dataSetId, ref, "snapshot" );
+
+    crgDataSetRelease( dataSetId );
+
+    return noDiffs;
+}
+
+static int
+checkHeader( const char* filename, int refId, const double* ref )
+{
+    int    dataSetId;
+    int    noDiffs = 0;
+    double meta[2][dNoMeta];
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    dataSetId = crgLoaderReadHeader( filename );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    if ( dataSetId <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "checkHeader: could not read the header of <%s>.\n", filename );
+        return 1;
+    }
+
+    /* --- the header only must give the metadata of the complete file --- */
+    getMetaData( refId, meta[0] );
+    getMetaData( dataSetId, meta[1] );
+
+    if ( memcmp( meta[0], meta[1], sizeof( meta[0] ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "checkHeader: metadata of the header differs from that of the file.\n" );
+        noDiffs++;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "checkHeader:   %-18s %d of %d results differ\n", "header metadata", noDiffs, dNoMeta );
+
+    /* --- the upgraded data set must be ready for evaluations --- */
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( !crgLoaderReadData( dataSetId ) )
+    {
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+        crgMsgPrint( dCrgMsgLevelWarn, "checkHeader: could not read the data of <%s>.\n", filename );
+        crgDataSetRelease( dataSetId );
+        return noDiffs + 1;
+    }
+
+    crgDataSetModifiersApply( dataSetId );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    noDiffs += compareLoaded( dataSetId, ref, "header, then data" );
+
+    crgDataSetRelease( dataSetId );
+
+    return noDiffs;
+}
+
+static int
+checkSettings( const char* filename, const double* ref )
+{
+    const char* name[3] = { "buffered access", "contiguous grid", "streamed grid" };
+    int            setting;
+    int            dataSetId;
+    int            noDiffs = 0;
+    CrgDataStruct* crgData;
+
+    for ( setting = 0; setting < 3; setting++ )
+    {
+        if ( !setting )
+            crgLoaderSetFileAccess( dCrgFileAccessBuffered );
+        else if ( setting == 1 )
+            crgLoaderSetGridLayout( dCrgGridLayoutContiguous );
+        else
+            crgLoaderSetStreaming( 10.0, 50.0 );
+
+        crgMsgSetLevel( dCrgMsgLevelWarn );
+        dataSetId = crgLoaderReadFile( filename );
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+
+        crgLoaderSetFileAccess( dCrgFileAccessMapped );
+        crgLoaderSetGridLayout( dCrgGridLayoutRows );
+        crgLoaderSetStreaming( 0.0, 0.0 );
+
+        if ( dataSetId <= 0 )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "checkSettings: could not load <%s> with %s.\n", filename, name[setting] );
+            noDiffs++;
+            continue;
+        }
+
+        crgData = crgDataSetAccess( dataSetId );
+
+        /* --- only binary files with fixed record sizes can be streamed --- */
+        if ( setting == 2 && !crgData->gridStream.valid )
+            crgMsgPrint( dCrgMsgLevelNotice, "checkSettings: %-18s not available for this file\n", name[setting] );
+        else
+        {
+            crgDataSetModifiersApply( dataSetId );
+
+            noDiffs += compareLoaded( dataSetId, ref, name[setting] );
+        }
+
+        crgDataSetRelease( dataSetId );
+    }
+
+    return noDiffs;
+}
+
+static int
+compareLoaded( int dataSetId, const double* ref, const char* label )
+{
+    int     i;
+    int     noDiffs = 0;
+    double* res;
+
+    if ( !( res = ( double* ) calloc( dNoResults * dNoPositions, sizeof( double ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "compareLoaded: could not allocate memory.\n" );
+        exit( -1 );
+    }
+
+    evaluate( dataSetId, res );
+
+    /* --- all results must be bit-identical to those of the loaded file --- */
+    for ( i = 0; i < dNoPositions; i++ )
+    {
+        if ( memcmp( &res[dNoResults * i], &ref[dNoResults * i], dNoResults * sizeof( double ) ) )
+        {
+            if ( !noDiffs )
+                crgMsgPrint( dCrgMsgLevelWarn, "compareLoaded: %s: first difference at u/v = %.6f / %.6f: z = %.12f / %.12f\n",
+                             label, ref[dNoResults * i + 3], ref[dNoResults * i + 4], ref[dNoResults * i], res[dNoResults * i] );
+            noDiffs++;
+        }
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "compareLoaded: %-18s %d of %d results differ\n", label, noDiffs, dNoPositions );
+
+    free( res );
+
+    return noDiffs;
+}
+
+static void
+evaluate( int dataSetId, double* res )
+{
+    int    cpId;
+    int    i;
+    double uMin;
+    double uMax;
+    double vMin;
+    double vMax;
+    double u;
+    double v;
+
+    crgDataSetGetURange( dataSetId, &uMin, &uMax );
+    crgDataSetGetVRange( dataSetId, &vMin, &vMax );
+
+    cpId = crgContactPointCreate( dataSetId );
+    crgContactPointSetDefaultOptions( cpId );
+
+    /* --- the same random positions for each data set: z, x/y and the way back to u/v --- */
+    srand( 1 );
+
+    for ( i = 0; i < dNoPositions; i++ )
+    {
+        u = uMin + ( uMax - uMin ) * rand() / RAND_MAX;
+        v = vMin + ( vMax - vMin ) * rand() / RAND_MAX;
+
+        crgEvaluv2z( cpId, u, v, &res[dNoResults * i] );
+        crgEvaluv2xy( cpId, u, v, &res[dNoResults * i + 1], &res[dNoResults * i + 2] );
+        crgEvalxy2uv( cpId, res[dNoResults * i + 1], res[dNoResults * i + 2], &res[dNoResults * i + 3], &res[dNoResults * i + 4] );
+    }
+
+    crgContactPointDelete( cpId );
+}
+
+static void
+getMetaData( int dataSetId, double* meta )
+{
+    crgDataSetGetURange( dataSetId, &meta[0], &meta[1] );
+    crgDataSetGetVRange( dataSetId, &meta[2], &meta[3] );
+    crgDataSetGetIncrements( dataSetId, &meta[4], &meta[5] );
+}
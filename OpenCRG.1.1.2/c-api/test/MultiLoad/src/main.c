@@ -0,0 +1,337 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              loading CRG files concurrently from
+ *              several threads and comparing the
+ *              results with a sequential load
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dMaxFiles   64
+#define dMaxThreads 64
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    int           threadId;     /* index of the thread                    [-] */
+    int           noLoads;      /* number of loads to perform             [-] */
+    int           noFailed;     /* number of loads which failed           [-] */
+    int           noMismatch;   /* number of loads not matching reference [-] */
+    pthread_t     thread;       /* the thread itself                      [-] */
+} ThreadDataStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static char*         mFileName[dMaxFiles];
+static unsigned long mRefPrint[dMaxFiles];
+static int           mNoFiles = 0;
+
+/* ====== LOCAL METHODS ====== */
+static unsigned long hashBytes( unsigned long hash, const void* data, size_t size );
+static unsigned long hashChannel( unsigned long hash, CrgChannelStruct* channel );
+static unsigned long hashOptions( unsigned long hash, CrgOptionsStruct* options );
+static unsigned long fingerprint( int dataSetId );
+static int loadFile( int fileIdx, unsigned long* print );
+static void* loadThread( void* arg );
+static double getTime( void );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgMultiLoad [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -t <n>     number of loader threads (default: 4)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -n <n>     number of loads per thread (default: 8)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -d <n>     number of ASCII decoding threads per load in parallel pass (default: 1)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file(s) as input file(s)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    ThreadDataStruct threadData[dMaxThreads];
+    int    noThreads = 4;
+    int    noLoads   = 8;
+    int    noDecoders = 1;
+    int    noFailed  = 0;
+    int    noMismatch = 0;
+    int    i;
+    double tStart;
+    double tSeq;
+    double tPar;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        if ( !strcmp( *argv, "-t" ) && argc )
+        {
+            argv++;
+            argc--;
+            noThreads = atoi( *argv );
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-n" ) && argc )
+        {
+            argv++;
+            argc--;
+            noLoads = atoi( *argv );
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-d" ) && argc )
+        {
+            argv++;
+            argc--;
+            noDecoders = atoi( *argv );
+            continue;
+        }
+
+        if ( mNoFiles < dMaxFiles )
+            mFileName[mNoFiles++] = *argv;
+    }
+
+    if ( !mNoFiles || noThreads < 1 || noThreads > dMaxThreads || noLoads < 1 || noDecoders < 1 )
+        usage();
+
+    /* --- only report real problems while loading --- */
+    crgMsgSetLevel( dCrgMsgLevelFatal );
+
+    /* --- sequential pass, yields the reference fingerprints --- */
+    crgLoaderSetNoThreads( 1 );
+
+    tStart = getTime();
+
+    for ( i = 0; i < mNoFiles; i++ )
+    {
+        if ( !loadFile( i, &mRefPrint[i] ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "main: could not load reference for file <%s>.\n", mFileName[i] );
+            return -1;
+        }
+    }
+
+    tSeq = ( getTime() - tStart ) / mNoFiles;
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    for ( i = 0; i < mNoFiles; i++ )
+        crgMsgPrint( dCrgMsgLevelNotice, "main: file <%s>, fingerprint = %016lx\n", mFileName[i], mRefPrint[i] );
+
+    /* --- parallel pass --- */
+    crgLoaderSetNoThreads( noDecoders );
+    crgMsgSetLevel( dCrgMsgLevelFatal );
+
+    tStart = getTime();
+
+    for ( i = 0; i < noThreads; i++ )
+    {
+        threadData[i].threadId   = i;
+        threadData[i].noLoads    = noLoads;
+        threadData[i].noFailed   = 0;
+        threadData[i].noMismatch = 0;
+
+        if ( pthread_create( &threadData[i].thread, NULL, loadThread, &threadData[i] ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "main: could not create thread %d.\n", i );
+            return -1;
+        }
+    }
+
+    for ( i = 0; i < noThreads; i++ )
+    {
+        pthread_join( threadData[i].thread, NULL );
+
+        noFailed   += threadData[i].noFailed;
+        noMismatch += threadData[i].noMismatch;
+    }
+
+    tPar = getTime() - tStart;
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: sequential load:    %.3f ms per file\n", tSeq * 1.0e3 );
+    crgMsgPrint( dCrgMsgLevelNotice, "main: parallel load:      %d threads x %d loads (%d decoders) in %.3f ms (%.3f ms per file)\n",
+                 noThreads, noLoads, noDecoders, tPar * 1.0e3, tPar * 1.0e3 / ( noThreads * noLoads ) );
+    crgMsgPrint( dCrgMsgLevelNotice, "main: failed loads:       %d\n", noFailed );
+    crgMsgPrint( dCrgMsgLevelNotice, "main: mismatching loads:  %d\n", noMismatch );
+
+    crgMemRelease();
+
+    if ( noFailed || noMismatch )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: parallel loading is NOT identical to sequential loading.\n" );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: parallel loading is identical to sequential loading.\n" );
+
+    return 0;
+}
+
+static void*
+loadThread( void* arg )
+{
+    ThreadDataStruct* data = ( ThreadDataStruct* ) arg;
+    unsigned long     print;
+    int               fileIdx;
+    int               i;
+
+    for ( i = 0; i < data->noLoads; i++ )
+    {
+        fileIdx = ( data->threadId + i ) % mNoFiles;
+
+        if ( !loadFile( fileIdx, &print ) )
+            data->noFailed++;
+        else if ( print != mRefPrint[fileIdx] )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "loadThread: thread %d, file <%s>: fingerprint %016lx differs from reference.\n",
+                         data->threadId, mFileName[fileIdx], print );
+            data->noMismatch++;
+        }
+    }
+
+    return NULL;
+}
+
+static int
+loadFile( int fileIdx, unsigned long* print )
+{
+    int dataSetId = crgLoaderReadFile( mFileName[fileIdx] );
+
+    if ( dataSetId <= 0 )
+        return 0;
+
+    crgDataSetModifiersApply( dataSetId );
+
+    *print = fingerprint( dataSetId );
+
+    crgDataSetRelease( dataSetId );
+
+    return 1;
+}
+
+static unsigned long
+fingerprint( int dataSetId )
+{
+    CrgDataStruct* crgData = crgDataSetAccess( dataSetId );
+    unsigned long  hash    = 14695981039346656037UL;
+    size_t         i;
+
+    if ( !crgData )
+        return 0;
+
+    hash = hashChannel( hash, &( crgData->channelV ) );
+    hash = hashChannel( hash, &( crgData->channelX ) );
+    hash = hashChannel( hash, &( crgData->channelY ) );
+    hash = hashChannel( hash, &( crgData->channelU ) );
+    hash = hashChannel( hash, &( crgData->channelPhi ) );
+    hash = hashChannel( hash, &( crgData->channelSlope ) );
+    hash = hashChannel( hash, &( crgData->channelBank ) );
+    hash = hashChannel( hash, &( crgData->channelRefZ ) );
+
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    {
+        hash = hashBytes( hash, &( crgData->channelZ[i].info ), sizeof( CrgChannelInfoStruct ) );
+
+        if ( crgData->channelZ[i].data )
+            hash = hashBytes( hash, crgData->channelZ[i].data, crgData->channelZ[i].info.size * sizeof( float ) );
+    }
+
+    hash = hashOptions( hash, &( crgData->modifiers ) );
+    hash = hashOptions( hash, &( crgData->options ) );
+    hash = hashBytes( hash, &( crgData->util ), sizeof( CrgUtilityStruct ) );
+
+    return hash;
+}
+
+static unsigned long
+hashChannel( unsigned long hash, CrgChannelStruct* channel )
+{
+    hash = hashBytes( hash, &( channel->info ), sizeof( CrgChannelInfoStruct ) );
+
+    if ( channel->data )
+        hash = hashBytes( hash, channel->data, channel->info.size * sizeof( double ) );
+
+    return hash;
+}
+
+static unsigned long
+hashOptions( unsigned long hash, CrgOptionsStruct* options )
+{
+    unsigned int i;
+
+    if ( !options->entry )
+        return hash;
+
+    for ( i = 0; i < options->noEntries; i++ )
+    {
+        if ( !options->entry[i].valid )
+            continue;
+
+        hash = hashBytes( hash, &( options->entry[i].id ),     sizeof( unsigned int ) );
+        hash = hashBytes( hash, &( options->entry[i].dValue ), sizeof( double ) );
+        hash = hashBytes( hash, &( options->entry[i].iValue ), sizeof( int ) );
+    }
+
+    return hash;
+}
+
+static unsigned long
+hashBytes( unsigned long hash, const void* data, size_t size )
+{
+    const unsigned char* ptr = ( const unsigned char* ) data;
+
+    /* --- FNV-1a --- */
+    while ( size-- )
+    {
+        hash ^= *ptr++;
+        hash *= 1099511628211UL;
+    }
+
+    return hash;
+}
+
+static double
+getTime( void )
+{
+    struct timeval tme;
+
+    gettimeofday( &tme, 0 );
+
+    return 1.0 * tme.tv_sec + 1.0e-6 * tme.tv_usec;
+}
@@ -0,0 +1,324 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              evaluating one data set from several
+ *              threads, each with contact points of
+ *              its own; checks the results against
+ *              a sequential evaluation and reports the
+ *              scaling of the evaluation rate
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dMaxThreads   64
+#define dNoPathPoints 10000     /* points on the path driven by every thread            */
+#define dChurnPeriod  4096      /* evaluations between creation / deletion of a scratch */
+                                /* contact point, exercising the contact point table    */
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    int           threadId;     /* index of the thread                       [-] */
+    int           noPasses;     /* number of passes along the path           [-] */
+    int           noFailed;     /* number of failed evaluations              [-] */
+    int           noMismatch;   /* number of results differing from reference [-] */
+    pthread_t     thread;       /* the thread itself                         [-] */
+} ThreadDataStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static int    mDataSetId = 0;
+static double mUStart;
+static double mPathX[dNoPathPoints];
+static double mPathY[dNoPathPoints];
+static double mRefZ[dNoPathPoints];
+
+/* ====== LOCAL METHODS ====== */
+static int driveOnePass( int cpId, double* z );
+static void* evalThread( void* arg );
+static double getTime( void );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgMultiThread [options] <filename>\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -t <n>     maximum number of evaluating threads (default: 4)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -n <n>     number of passes along the path per thread (default: 100)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -s <len>   stream the grid of a binary file, keeping <len> m behind and ahead\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file as input file\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    ThreadDataStruct threadData[dMaxThreads];
+    char*  filename  = NULL;
+    int    maxThreads = 4;
+    int    noPasses  = 100;
+    long   noMisses;
+    long   noLoads;
+    int    noThreads;
+    int    noFailed  = 0;
+    int    noMismatch = 0;
+    int    cpId;
+    int    i;
+    double uMin;
+    double uMax;
+    double vMin;
+    double vMax;
+    double u;
+    double v;
+    double tStart;
+    double tEval;
+    double rate;
+    double rateSingle = 0.0;
+    double streamLength = 0.0;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        if ( !strcmp( *argv, "-t" ) && argc )
+        {
+            argv++;
+            argc--;
+            maxThreads = atoi( *argv );
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-n" ) && argc )
+        {
+            argv++;
+            argc--;
+            noPasses = atoi( *argv );
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-s" ) && argc )
+        {
+            argv++;
+            argc--;
+            streamLength = atof( *argv );
+            continue;
+        }
+
+        filename = *argv;
+    }
+
+    if ( !filename || maxThreads < 1 || maxThreads > dMaxThreads || noPasses < 1 || streamLength < 0.0 )
+        usage();
+
+    /* --- load and prepare the data set --- */
+    crgLoaderSetStreaming( streamLength, streamLength );
+
+    if ( ( mDataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: error reading data.\n" );
+        return -1;
+    }
+
+    crgDataSetModifiersPrint( mDataSetId );
+    crgDataSetModifiersApply( mDataSetId );
+
+    if ( !crgDataSetGetURange( mDataSetId, &uMin, &uMax ) || !crgDataSetGetVRange( mDataSetId, &vMin, &vMax ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: could not get u/v range of data set.\n" );
+        return -1;
+    }
+
+    /* --- path meandering along the reference line, also leaving the data set laterally --- */
+    if ( ( cpId = crgContactPointCreate( mDataSetId ) ) < 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: could not create contact point.\n" );
+        return -1;
+    }
+
+    mUStart = uMin;
+
+    for ( i = 0; i < dNoPathPoints; i++ )
+    {
+        u = uMin + ( uMax - uMin ) * i / ( dNoPathPoints - 1 );
+        v = 0.5 * ( vMin + vMax ) + 0.6 * ( vMax - vMin ) * ( ( i % 200 ) / 100.0 - 1.0 );
+
+        crgEvaluv2xy( cpId, u, v, &mPathX[i], &mPathY[i] );
+    }
+
+    /* --- sequential reference --- */
+    if ( !driveOnePass( cpId, mRefZ ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: could not evaluate reference.\n" );
+        return -1;
+    }
+
+    crgContactPointDelete( cpId );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: %d path points, %d passes per thread\n", dNoPathPoints, noPasses );
+    crgMsgPrint( dCrgMsgLevelNotice, "main: threads   evaluations/s   speed-up   efficiency\n" );
+
+    /* --- evaluate with increasing number of threads --- */
+    for ( noThreads = 1; ; noThreads *= 2 )
+    {
+        if ( noThreads > maxThreads )
+            noThreads = maxThreads;
+
+        tStart = getTime();
+
+        for ( i = 0; i < noThreads; i++ )
+        {
+            threadData[i].threadId   = i;
+            threadData[i].noPasses   = noPasses;
+            threadData[i].noFailed   = 0;
+            threadData[i].noMismatch = 0;
+
+            if ( pthread_create( &threadData[i].thread, NULL, evalThread, &threadData[i] ) )
+            {
+                crgMsgPrint( dCrgMsgLevelFatal, "main: could not create thread %d.\n", i );
+                return -1;
+            }
+        }
+
+        for ( i = 0; i < noThreads; i++ )
+        {
+            pthread_join( threadData[i].thread, NULL );
+
+            noFailed   += threadData[i].noFailed;
+            noMismatch += threadData[i].noMismatch;
+        }
+
+        tEval = getTime() - tStart;
+        rate  = 1.0 * noThreads * noPasses * dNoPathPoints / tEval;
+
+        if ( noThreads == 1 )
+            rateSingle = rate;
+
+        crgMsgPrint( dCrgMsgLevelNotice, "main: %7d   %13.0f   %8.2f   %9.1f%%\n",
+                     noThreads, rate, rate / rateSingle, 100.0 * rate / rateSingle / noThreads );
+
+        if ( noThreads == maxThreads )
+            break;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: failed evaluations:      %d\n", noFailed );
+    crgMsgPrint( dCrgMsgLevelNotice, "main: mismatching evaluations: %d\n", noMismatch );
+
+    /* --- evaluations wait for the file on a miss only --- */
+    if ( crgDataSetGetStreamStat( mDataSetId, &noMisses, &noLoads ) )
+        crgMsgPrint( dCrgMsgLevelNotice, "main: streamed grid:           %ld misses, %ld pages read\n", noMisses, noLoads );
+
+    crgMemRelease();
+
+    if ( noFailed || noMismatch )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: concurrent evaluation is NOT identical to sequential evaluation.\n" );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: concurrent evaluation is identical to sequential evaluation.\n" );
+
+    return 0;
+}
+
+static void*
+evalThread( void* arg )
+{
+    ThreadDataStruct* data = ( ThreadDataStruct* ) arg;
+    double*           z;
+    int               cpId;
+    int               scratchId;
+    int               pass;
+    int               i;
+
+    z = ( double* ) malloc( dNoPathPoints * sizeof( double ) );
+
+    /* --- contact points are created while other threads evaluate --- */
+    if ( !z || ( cpId = crgContactPointCreate( mDataSetId ) ) < 0 )
+    {
+        data->noFailed++;
+        free( z );
+        return NULL;
+    }
+
+    for ( pass = 0; pass < data->noPasses; pass++ )
+    {
+        if ( !driveOnePass( cpId, z ) )
+            data->noFailed++;
+
+        for ( i = 0; i < dNoPathPoints; i++ )
+        {
+            if ( memcmp( &z[i], &mRefZ[i], sizeof( double ) ) )
+                data->noMismatch++;
+
+            /* --- keep the contact point table busy --- */
+            if ( ( ( pass * dNoPathPoints + i ) % dChurnPeriod ) == data->threadId )
+            {
+                if ( ( scratchId = crgContactPointCreate( mDataSetId ) ) < 0 )
+                    data->noFailed++;
+                else
+                    crgContactPointDelete( scratchId );
+            }
+        }
+    }
+
+    crgContactPointDelete( cpId );
+    free( z );
+
+    return NULL;
+}
+
+static int
+driveOnePass( int cpId, double* z )
+{
+    int i;
+    int result = 1;
+
+    /* --- every pass starts from the same history --- */
+    crgContactPointOptionSetDouble( cpId, dCrgCpOptionRefLineSearchU, mUStart );
+
+    for ( i = 0; i < dNoPathPoints; i++ )
+        result = crgEvalxy2z( cpId, mPathX[i], mPathY[i], &z[i] ) && result;
+
+    return result;
+}
+
+static double
+getTime( void )
+{
+    struct timeval tme;
+
+    gettimeofday( &tme, 0 );
+
+    return 1.0 * tme.tv_sec + 1.0e-6 * tme.tv_usec;
+}
@@ -0,0 +1,800 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              detecting and limiting peaks of the
+ *              elevation grid and comparing the result
+ *              with a direct evaluation of the method
+ *              of crg_peakfinder.m and crg_limiter.m
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoCases        2
+#define dMinMedian      0.05f   /* lower bound of the median of a window, see crg_peakfinder.m */
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    const char* name;
+    int    subRange;        /* scan the inner half of the grid only */
+} PeakCaseStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static const PeakCaseStruct mCase[dNoCases] =
+{
+    { "complete grid", 0 },
+    { "inner range",   1 }
+};
+
+static int         mNoThreads = 0;
+static int         mRepeat    = 1;
+static int         mRadius    = 3;
+static double      mThreshold = 0.5;
+static const char* mOutDir    = "/tmp";
+
+/* ====== LOCAL METHODS ====== */
+static int peakFile( const char* filename );
+static int scaleFile( const char* filename, const char* outName );
+static int loadSpiked( const char* filename, int noThreads, int noSegments );
+static int loadLimited( const char* filename, const PeakCaseStruct* pc, CrgDataStruct* base, int noSegments, int noThreads,
+                        float zMin, float zMax, double* tApply );
+static void injectSpikes( CrgDataStruct* crgData, int noSegments );
+static void setBlock( CrgDataStruct* crgData, size_t iu, size_t iv, size_t n, float z );
+static void setRange( int dataSetId, CrgDataStruct* base, const PeakCaseStruct* pc );
+static void getRange( CrgDataStruct* base, const PeakCaseStruct* pc, size_t* iu0, size_t* iu1, size_t* iv0, size_t* iv1 );
+static size_t referencePeaks( CrgDataStruct* base, size_t iu0, size_t iu1, size_t iv0, size_t iv1, float* limit );
+static size_t compareList( CrgDataStruct* base, size_t iu0, size_t iv0, size_t nu, size_t nv, const float* limit,
+                           const double* u, const double* v, const double* z );
+static size_t compareLimited( CrgDataStruct* base, CrgDataStruct* limited, size_t iu0, size_t iu1, size_t iv0, size_t iv1,
+                              const float* limit, float zMin, float zMax, size_t* noChanged );
+static size_t compareGrids( CrgDataStruct* a, CrgDataStruct* b );
+static int compareFloat( const void* a, const void* b );
+static double getTime( void );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgPeakLimit [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -t <n>     number of threads compared with a single thread (default: one per processor)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -r <n>     scale binary files up by repeating the grid <n> times in u direction (default: 1)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -o <dir>   directory of the scaled files (default: /tmp)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -th <x>    threshold of the peak detection (default: 0.5)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -ra <n>    radius of the window of the peak detection (default: 3)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file(s) as input file(s)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    int noFiles  = 0;
+    int noFailed = 0;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        if ( !strcmp( *argv, "-t" ) && argc )
+        {
+            argv++;
+            argc--;
+            mNoThreads = atoi( *argv );
+
+            if ( mNoThreads < 0 )
+                usage();
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-r" ) && argc )
+        {
+            argv++;
+            argc--;
+            mRepeat = atoi( *argv );
+
+            if ( mRepeat < 1 )
+                usage();
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-o" ) && argc )
+        {
+            argv++;
+            argc--;
+            mOutDir = *argv;
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-th" ) && argc )
+        {
+            argv++;
+            argc--;
+            mThreshold = atof( *argv );
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-ra" ) && argc )
+        {
+            argv++;
+            argc--;
+            mRadius = atoi( *argv );
+
+            if ( mRadius < 1 )
+                usage();
+            continue;
+        }
+
+        noFiles++;
+
+        if ( !peakFile( *argv ) )
+            noFailed++;
+    }
+
+    if ( !noFiles )
+        usage();
+
+    crgMemRelease();
+
+    if ( noFailed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: %d of %d files could NOT be limited correctly.\n", noFailed, noFiles );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: all %d files have been limited correctly.\n", noFiles );
+
+    return 0;
+}
+
+static int
+peakFile( const char* filename )
+{
+    CrgDataStruct* base;
+    const char* name       = filename;
+    char   scaled[1024];
+    int    baseId;
+    int    idSingle;
+    int    idMulti;
+    int    i;
+    int    noSegments = 1;
+    int    noThreads  = mNoThreads ? mNoThreads : crgPortGetNoProcessors();
+    int    noSingle;
+    int    noMulti;
+    float* limit;
+    float  zMin = 0.0f;
+    float  zMax = 0.0f;
+    float  zRange = 0.0f;
+    double* u;
+    double* v;
+    double* z;
+    double tSingle;
+    double tMulti;
+    double tApplySingle;
+    double tApplyMulti;
+    size_t noDiffs = 0;
+    size_t diffs;
+    size_t noRef;
+    size_t noChanged;
+    size_t iu0;
+    size_t iu1;
+    size_t iv0;
+    size_t iv1;
+    size_t iu;
+    size_t iv;
+
+    /* --- binary files may be scaled up for the timing --- */
+    if ( mRepeat > 1 )
+    {
+        sprintf( scaled, "%s/crgPeakLimit_%d.crg", mOutDir, mRepeat );
+
+        if ( scaleFile( filename, scaled ) )
+        {
+            name       = scaled;
+            noSegments = mRepeat;
+        }
+        else
+            crgMsgPrint( dCrgMsgLevelNotice, "peakFile: <%s> is not scaled, only binary files can be repeated.\n", filename );
+    }
+
+    if ( ( baseId = loadSpiked( name, 1, noSegments ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "peakFile: could not load <%s>.\n", name );
+        return 0;
+    }
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    tApplySingle = getTime();
+    crgDataSetModifiersApply( baseId );
+    tApplySingle = getTime() - tApplySingle;
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    base = crgDataSetAccess( baseId );
+
+    /* --- the limiter cuts a tenth of the range of the original values at both ends; the spikes exceed twice the original values --- */
+    for ( iv = 0; iv < base->channelV.info.size; iv++ )
+        for ( iu = 0; iu < base->channelU.info.size; iu++ )
+            if ( fabs( base->channelZ[iv].data[iu] ) > zRange )
+                zRange = ( float ) fabs( base->channelZ[iv].data[iu] );
+
+    zMin =  zRange;
+    zMax = -zRange;
+
+    for ( iv = 0; iv < base->channelV.info.size; iv++ )
+    {
+        for ( iu = 0; iu < base->channelU.info.size; iu++ )
+        {
+            float x = base->channelZ[iv].data[iu];
+
+            if ( fabs( x ) <= 0.5f * zRange && x < zMin )
+                zMin = x;
+            if ( fabs( x ) <= 0.5f * zRange && x > zMax )
+                zMax = x;
+        }
+    }
+
+    zRange = zMax - zMin;
+    zMin   = zMin + 0.1f * zRange;
+    zMax   = zMax - 0.1f * zRange;
+
+    crgMsgPrint( dCrgMsgLevelNotice, "peakFile: file <%s>, %ld x %ld samples, modifiers applied in %.3f ms, threshold %.3f, radius %d, limits [%.4f, %.4f] m\n",
+                 name, ( long ) base->channelU.info.size, ( long ) base->channelV.info.size, tApplySingle * 1.0e3, mThreshold, mRadius, zMin, zMax );
+
+    for ( i = 0; i < dNoCases; i++ )
+    {
+        getRange( base, &mCase[i], &iu0, &iu1, &iv0, &iv1 );
+
+        if ( iu1 - iu0 < 2 || iv1 - iv0 < 2 )
+        {
+            crgMsgPrint( dCrgMsgLevelNotice, "peakFile:     %-14s: grid too small, skipped\n", mCase[i].name );
+            continue;
+        }
+
+        limit = ( float* ) calloc( ( iu1 - iu0 + 1 ) * ( iv1 - iv0 + 1 ), sizeof( float ) );
+        noRef = limit ? referencePeaks( base, iu0, iu1, iv0, iv1, limit ) : 0;
+        u     = ( double* ) calloc( noRef + 1, sizeof( double ) );
+        v     = ( double* ) calloc( noRef + 1, sizeof( double ) );
+        z     = ( double* ) calloc( noRef + 1, sizeof( double ) );
+
+        if ( !limit || !u || !v || !z )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "peakFile: could not allocate reference.\n" );
+            return 0;
+        }
+
+        /* --- report the peaks of the spiked grid --- */
+        crgDataSetModifierRemove( baseId, dCrgModLimitUBegin );
+        crgDataSetModifierRemove( baseId, dCrgModLimitUEnd );
+        crgDataSetModifierRemove( baseId, dCrgModLimitVBegin );
+        crgDataSetModifierRemove( baseId, dCrgModLimitVEnd );
+
+        if ( mCase[i].subRange )
+            setRange( baseId, base, &mCase[i] );
+
+        crgMsgSetLevel( dCrgMsgLevelWarn );
+
+        crgLoaderSetNoThreads( 1 );
+        tSingle  = getTime();
+        noSingle = crgDataSetGetPeaks( baseId, mThreshold, mRadius, u, v, z, ( int ) noRef );
+        tSingle  = getTime() - tSingle;
+
+        diffs = compareList( base, iu0, iv0, iu1 - iu0 + 1, iv1 - iv0 + 1, limit, u, v, z );
+
+        crgLoaderSetNoThreads( noThreads );
+        tMulti  = getTime();
+        noMulti = crgDataSetGetPeaks( baseId, mThreshold, mRadius, u, v, z, ( int ) noRef );
+        tMulti  = getTime() - tMulti;
+
+        diffs += compareList( base, iu0, iv0, iu1 - iu0 + 1, iv1 - iv0 + 1, limit, u, v, z );
+        diffs += ( noSingle != ( int ) noRef ) + ( noMulti != ( int ) noRef );
+
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+
+        crgMsgPrint( dCrgMsgLevelNotice, "peakFile:     %-14s: %9.3f ms with 1 thread, %9.3f ms with %d threads, %ld peaks, %ld differences\n",
+                     mCase[i].name, tSingle * 1.0e3, tMulti * 1.0e3, noThreads, ( long ) noRef, ( long ) diffs );
+
+        noDiffs += diffs;
+
+        /* --- limit the peaks and the values while loading --- */
+        if ( ( idSingle = loadLimited( name, &mCase[i], base, noSegments, 1, zMin, zMax, &tApplySingle ) ) <= 0 )
+            noDiffs++;
+        else if ( ( idMulti = loadLimited( name, &mCase[i], base, noSegments, noThreads, zMin, zMax, &tApplyMulti ) ) <= 0 )
+        {
+            crgDataSetRelease( idSingle );
+            noDiffs++;
+        }
+        else
+        {
+            /* --- the threads must not change the result at all --- */
+            diffs  = compareGrids( crgDataSetAccess( idSingle ), crgDataSetAccess( idMulti ) );
+            diffs += compareLimited( base, crgDataSetAccess( idSingle ), iu0, iu1, iv0, iv1, limit, zMin, zMax, &noChanged );
+
+            crgMsgPrint( dCrgMsgLevelNotice, "peakFile:     %-14s: %9.3f ms with 1 thread, %9.3f ms with %d threads, %ld samples limited, %ld differences (modifiers)\n",
+                         mCase[i].name, tApplySingle * 1.0e3, tApplyMulti * 1.0e3, noThreads, ( long ) noChanged, ( long ) diffs );
+
+            noDiffs += diffs;
+
+            crgMsgSetLevel( dCrgMsgLevelWarn );
+            crgDataSetRelease( idSingle );
+            crgDataSetRelease( idMulti );
+            crgMsgSetLevel( dCrgMsgLevelNotice );
+        }
+
+        free( limit );
+        free( u );
+        free( v );
+        free( z );
+    }
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    crgDataSetRelease( baseId );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    if ( name != filename )
+        remove( name );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "peakFile:     %ld differences\n", ( long ) noDiffs );
+
+    return !noDiffs;
+}
+
+static int
+scaleFile( const char* filename, const char* outName )
+{
+    FILE*  fp;
+    char*  buffer;
+    char*  line;
+    char*  next;
+    char*  data = NULL;
+    long   size;
+    long   nu;
+    long   recordSize;
+    long   dataSize;
+    double startU = 0.0;
+    double endU   = 0.0;
+    double incU   = 0.0;
+    int    i;
+
+    if ( !( fp = fopen( filename, "rb" ) ) )
+        return 0;
+
+    fseek( fp, 0, SEEK_END );
+    size = ftell( fp );
+    fseek( fp, 0, SEEK_SET );
+
+    if ( size <= 0 || !( buffer = ( char* ) malloc( size + 1 ) ) )
+    {
+        fclose( fp );
+        return 0;
+    }
+
+    if ( fread( buffer, 1, size, fp ) != ( size_t ) size )
+        size = 0;
+
+    buffer[size] = '\0';
+    fclose( fp );
+
+    /* --- the binary data follow the line of dollar signs --- */
+    for ( line = buffer; line < buffer + size; line = next + 1 )
+    {
+        if ( !( next = ( char* ) memchr( line, '\n', buffer + size - line ) ) )
+            break;
+
+        sscanf( line, "reference_line_start_u = %lf", &startU );
+        sscanf( line, "reference_line_end_u = %lf", &endU );
+        sscanf( line, "reference_line_increment = %lf", &incU );
+
+        if ( !strncmp( line, "$$$$$$$$", 8 ) )
+        {
+            data = next + 1;
+            break;
+        }
+    }
+
+    if ( !data || !( incU > 0.0 ) || !( endU > startU ) )
+    {
+        free( buffer );
+        return 0;
+    }
+
+    nu         = ( long ) floor( ( endU - startU ) / incU + 0.5 ) + 1;
+    dataSize   = buffer + size - data;
+    recordSize = dataSize / nu;
+
+    if ( recordSize < 4 || !( fp = fopen( outName, "wb" ) ) )
+    {
+        free( buffer );
+        return 0;
+    }
+
+    /* --- the end of the reference line is re-computed by the loader --- */
+    for ( line = buffer; line < data; line = next + 1 )
+    {
+        next = ( char* ) memchr( line, '\n', data - line );
+
+        if ( !strncmp( line, "reference_line_end_u", 20 ) )
+            fprintf( fp, "reference_line_end_u     = %23.16e\n", startU + ( mRepeat * nu - 1 ) * incU );
+        else if ( strncmp( line, "reference_line_end_", 19 ) )
+            fwrite( line, 1, next - line + 1, fp );
+    }
+
+    for ( i = 0; i < mRepeat; i++ )
+        fwrite( data, 1, nu * recordSize, fp );
+
+    fwrite( data + nu * recordSize, 1, dataSize - nu * recordSize, fp );
+
+    fclose( fp );
+    free( buffer );
+
+    return 1;
+}
+
+static int
+loadSpiked( const char* filename, int noThreads, int noSegments )
+{
+    int dataSetId;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    crgLoaderSetNoThreads( noThreads );
+
+    if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+        return 0;
+    }
+
+    injectSpikes( crgDataSetAccess( dataSetId ), noSegments );
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    return dataSetId;
+}
+
+static int
+loadLimited( const char* filename, const PeakCaseStruct* pc, CrgDataStruct* base, int noSegments, int noThreads,
+             float zMin, float zMax, double* tApply )
+{
+    int dataSetId;
+
+    if ( ( dataSetId = loadSpiked( filename, noThreads, noSegments ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "loadLimited: could not load <%s>.\n", filename );
+        return 0;
+    }
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    crgDataSetModifierSetDouble( dataSetId, dCrgModPeakLimit,  mThreshold );
+    crgDataSetModifierSetInt(    dataSetId, dCrgModPeakRadius, mRadius );
+    crgDataSetModifierSetDouble( dataSetId, dCrgModLimitZMin,  zMin );
+    crgDataSetModifierSetDouble( dataSetId, dCrgModLimitZMax,  zMax );
+
+    if ( pc->subRange )
+        setRange( dataSetId, base, pc );
+
+    *tApply = getTime();
+    crgDataSetModifiersApply( dataSetId );
+    *tApply = getTime() - *tApply;
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    return dataSetId;
+}
+
+static void
+injectSpikes( CrgDataStruct* crgData, int noSegments )
+{
+    size_t nu     = crgData->channelU.info.size / noSegments;
+    size_t nv     = crgData->channelV.info.size;
+    size_t iu;
+    size_t iv;
+    float  offset = 0.0f;
+    int    i;
+
+    /* --- the spikes are raised above twice the largest value, so that they stand out of elevated grids, too --- */
+    for ( iv = 0; iv < nv; iv++ )
+        for ( iu = 0; iu < crgData->channelU.info.size; iu++ )
+            if ( fabs( crgData->channelZ[iv].data[iu] ) > offset )
+                offset = ( float ) fabs( crgData->channelZ[iv].data[iu] );
+
+    offset *= 2.0f;
+
+    /* --- the spikes of crg_test_peakfinder.m, placed relative to the size of each repetition --- */
+    for ( i = 0; i < noSegments; i++ )
+    {
+        setBlock( crgData, i * nu + nu / 5,      nv / 5, 11,   0.5f + offset );
+        setBlock( crgData, i * nu + 3 * nu / 10, nv / 2, 6,    0.2f + offset );
+        setBlock( crgData, i * nu + 4 * nu / 5,  nv / 2, 1,  -(0.5f + offset ) );
+    }
+}
+
+static void
+setBlock( CrgDataStruct* crgData, size_t iu, size_t iv, size_t n, float z )
+{
+    size_t i;
+    size_t j;
+
+    for ( j = iv; j < iv + n && j < crgData->channelV.info.size; j++ )
+        for ( i = iu; i < iu + n && i < crgData->channelU.info.size; i++ )
+            crgData->channelZ[j].data[i] = z;
+}
+
+static void
+getRange( CrgDataStruct* base, const PeakCaseStruct* pc, size_t* iu0, size_t* iu1, size_t* iv0, size_t* iv1 )
+{
+    size_t nu = base->channelU.info.size;
+    size_t nv = base->channelV.info.size;
+
+    *iu0 = 0;
+    *iu1 = nu - 1;
+    *iv0 = 0;
+    *iv1 = nv - 1;
+
+    if ( !pc->subRange )
+        return;
+
+    *iu0 = nu / 4;
+    *iu1 = nu - 1 - nu / 4;
+    *iv0 = nv / 4;
+    *iv1 = nv - 1 - nv / 4;
+}
+
+static void
+setRange( int dataSetId, CrgDataStruct* base, const PeakCaseStruct* pc )
+{
+    size_t iu0;
+    size_t iu1;
+    size_t iv0;
+    size_t iv1;
+
+    getRange( base, pc, &iu0, &iu1, &iv0, &iv1 );
+
+    crgDataSetModifierSetDouble( dataSetId, dCrgModLimitUBegin, base->channelU.info.first + iu0 * base->channelU.info.inc );
+    crgDataSetModifierSetDouble( dataSetId, dCrgModLimitUEnd,   base->channelU.info.first + iu1 * base->channelU.info.inc );
+    crgDataSetModifierSetDouble( dataSetId, dCrgModLimitVBegin, base->channelV.data[iv0] );
+    crgDataSetModifierSetDouble( dataSetId, dCrgModLimitVEnd,   base->channelV.data[iv1] );
+}
+
+static size_t
+referencePeaks( CrgDataStruct* base, size_t iu0, size_t iu1, size_t iv0, size_t iv1, float* limit )
+{
+    float* window;
+    float  mv;
+    float  bound;
+    double lap;
+    size_t nu     = iu1 - iu0 + 1;
+    size_t nv     = iv1 - iv0 + 1;
+    size_t ra     = ( size_t ) mRadius;
+    size_t winU   = ( 2 * ra + 1 < nu ) ? 2 * ra + 1 : nu;
+    size_t winV   = ( 2 * ra + 1 < nv ) ? 2 * ra + 1 : nv;
+    size_t noPeaks = 0;
+    size_t n;
+    size_t iu;
+    size_t iv;
+    size_t u0;
+    size_t v0;
+    size_t i;
+    size_t j;
+    int    di;
+    int    dj;
+    int    hasNaN;
+
+#define Z( _iu, _iv ) ( base->channelZ[iv0 + ( _iv )].data[iu0 + ( _iu )] )
+
+    if ( !( window = ( float* ) calloc( winU * winV, sizeof( float ) ) ) )
+        return 0;
+
+    for ( iv = 1; iv + 1 < nv; iv++ )
+    {
+        for ( iu = 1; iu + 1 < nu; iu++ )
+        {
+            /* --- filter2( 10 * [ -1 -1 -1; -1 8 -1; -1 -1 -1 ], abs( z ), 'valid' ) > th --- */
+            lap = 0.0;
+
+            for ( dj = -1; dj <= 1; dj++ )
+                for ( di = -1; di <= 1; di++ )
+                    lap += ( ( di || dj ) ? -10.0 : 80.0 ) * fabs( Z( iu + di, iv + dj ) );
+
+            if ( !( lap > mThreshold ) )
+                continue;
+
+            /* --- the window is kept within the range --- */
+            u0 = ( iu > ra ) ? iu - ra : 0;
+            v0 = ( iv > ra ) ? iv - ra : 0;
+
+            if ( u0 > nu - winU )
+                u0 = nu - winU;
+            if ( v0 > nv - winV )
+                v0 = nv - winV;
+
+            /* --- max( median( zi(:) ), 0.05 ) --- */
+            n      = 0;
+            hasNaN = 0;
+
+            for ( j = v0; j < v0 + winV; j++ )
+                for ( i = u0; i < u0 + winU; i++ )
+                {
+                    window[n] = Z( i, j );
+                    hasNaN |= ( window[n] != window[n] );
+                    n++;
+                }
+
+            mv = dMinMedian;
+
+            if ( !hasNaN )
+            {
+                qsort( window, n, sizeof( float ), compareFloat );
+
+                if ( n % 2 )
+                    mv = window[n / 2];
+                else
+                    mv = 0.5f * ( window[n / 2 - 1] + window[n / 2] );
+
+                if ( mv < dMinMedian )
+                    mv = dMinMedian;
+            }
+
+            bound = mv + mv;
+
+            for ( j = v0; j < v0 + winV; j++ )
+                for ( i = u0; i < u0 + winU; i++ )
+                    if ( fabs( Z( i, j ) ) > bound && ( limit[j * nu + i] == 0.0f || bound < limit[j * nu + i] ) )
+                        limit[j * nu + i] = bound;
+        }
+    }
+
+#undef Z
+
+    for ( i = 0; i < nu * nv; i++ )
+        noPeaks += ( limit[i] > 0.0f );
+
+    free( window );
+
+    return noPeaks;
+}
+
+static size_t
+compareList( CrgDataStruct* base, size_t iu0, size_t iv0, size_t nu, size_t nv, const float* limit,
+             const double* u, const double* v, const double* z )
+{
+    size_t iu;
+    size_t iv;
+    size_t k       = 0;
+    size_t noDiffs = 0;
+
+    /* --- the peaks are sorted by u and then by v, as the indices of crg_peakfinder.m --- */
+    for ( iu = 0; iu < nu; iu++ )
+    {
+        for ( iv = 0; iv < nv; iv++ )
+        {
+            if ( !( limit[iv * nu + iu] > 0.0f ) )
+                continue;
+
+            noDiffs += ( u[k] != base->channelU.info.first + ( iu0 + iu ) * base->channelU.info.inc );
+            noDiffs += ( v[k] != base->channelV.data[iv0 + iv] );
+            noDiffs += ( z[k] != base->channelZ[iv0 + iv].data[iu0 + iu] );
+            k++;
+        }
+    }
+
+    return noDiffs;
+}
+
+static size_t
+compareLimited( CrgDataStruct* base, CrgDataStruct* limited, size_t iu0, size_t iu1, size_t iv0, size_t iv1,
+                const float* limit, float zMin, float zMax, size_t* noChanged )
+{
+    size_t nu      = iu1 - iu0 + 1;
+    size_t iu;
+    size_t iv;
+    size_t noDiffs = 0;
+    float  ref;
+    float  val;
+    float  l;
+
+    *noChanged = 0;
+
+    if ( base->channelV.info.size != limited->channelV.info.size || base->channelU.info.size != limited->channelU.info.size )
+        return 1;
+
+    for ( iv = 0; iv < base->channelV.info.size; iv++ )
+    {
+        for ( iu = 0; iu < base->channelU.info.size; iu++ )
+        {
+            ref = base->channelZ[iv].data[iu];
+            val = limited->channelZ[iv].data[iu];
+
+            /* --- peaks are limited to their detection bound first, then all values to [zMin, zMax] --- */
+            if ( iv >= iv0 && iv <= iv1 && iu >= iu0 && iu <= iu1 )
+            {
+                l = limit[( iv - iv0 ) * nu + iu - iu0];
+
+                if ( l > 0.0f && ref > l )
+                    ref = l;
+                if ( l > 0.0f && ref < -l )
+                    ref = -l;
+                if ( ref < zMin )
+                    ref = zMin;
+                if ( ref > zMax )
+                    ref = zMax;
+            }
+
+            if ( ref != ref || val != val )
+            {
+                noDiffs += ( ( ref != ref ) != ( val != val ) );
+                continue;
+            }
+
+            *noChanged += ( val != base->channelZ[iv].data[iu] );
+            noDiffs    += ( val != ref );
+        }
+    }
+
+    return noDiffs;
+}
+
+static size_t
+compareGrids( CrgDataStruct* a, CrgDataStruct* b )
+{
+    size_t i;
+    size_t noDiffs = 0;
+
+    if ( a->channelV.info.size != b->channelV.info.size || a->channelU.info.size != b->channelU.info.size )
+        return 1;
+
+    for ( i = 0; i < a->channelV.info.size; i++ )
+        if ( memcmp( a->channelZ[i].data, b->channelZ[i].data, a->channelU.info.size * sizeof( float ) ) )
+            noDiffs++;
+
+    return noDiffs;
+}
+
+static int
+compareFloat( const void* a, const void* b )
+{
+    float x = *( const float* ) a;
+    float y = *( const float* ) b;
+
+    return ( x > y ) - ( x < y );
+}
+
+static double
+getTime( void )
+{
+    struct timeval tme;
+
+    gettimeofday( &tme, 0 );
+
+    return 1.0 * tme.tv_sec + 1.0e-6 * tme.tv_usec;
+}
@@ -29,6 +29,7 @@
 #include <string.h>
 #include <math.h>
 #include <sys/time.h>
+#include <sys/resource.h>
 #include "crgBaseLibPrivate.h"
 
 
@@ -36,10 +37,1263 @@ void usage()
 {
     crgMsgPrint( dCrgMsgLevelNotice, "usage: crgPerfTest [options] <filename>\n" );
     crgMsgPrint( dCrgMsgLevelNotice, "       options: -h    show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -b    time single and batch evaluation\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -a    time separate and fused evaluation of u, v, z, phi and curvature\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -n    compare analytic surface derivatives with finite differences\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -k    time generic and specialized evaluation kernels of z values\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -t    compare per-point evaluation of the wheel patches with the patch evaluation\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -c    time x/y searches without history with and without spatial index\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -w    query the wheels interleaved instead of one patch after the other\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -r    compare evaluations with and without precomputed reference line geometry\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -p    predict the reference line interval from the motion of the contact point\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -g    time memory layouts of the elevation grid\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -q    compare the float grid with a grid quantized to 16 bit\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -o    time the resident grid with a grid streamed from a binary file\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -l    report load time and peak memory using memory mapped file access\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -L    report load time and peak memory using buffered file access\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -s    time loading the file with loading a snapshot of it\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -m    time reading the header only with loading the file for metadata queries\n" );
     crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file as input file\n" );
     exit( -1 );
 }
 
+double getTime()
+{
+    struct timeval tme;
+    
+    gettimeofday(&tme, 0);
+    return tme.tv_sec + 1.0e-6 * tme.tv_usec;
+}
+
+void compareBatchEval( int dataSetId, double* testX, double* testY, size_t noTestPts, int blockSize )
+{
+    double *testU       = 0;
+    double *testV       = 0;
+    double *batchU      = 0;
+    double *batchV      = 0;
+    double *z           = 0;
+    size_t idxTestPt;
+    int    noPts;
+    int    cpId;
+    int    cpIdBatch;
+    int    kernel;
+    double startTime;
+    double timeSingle;
+    double timeBatch;
+    
+    testU  = ( double* ) calloc( noTestPts, sizeof( double ) );
+    testV  = ( double* ) calloc( noTestPts, sizeof( double ) );
+    batchU = ( double* ) calloc( noTestPts, sizeof( double ) );
+    batchV = ( double* ) calloc( noTestPts, sizeof( double ) );
+    z      = ( double* ) calloc( noTestPts, sizeof( double ) );
+    
+    if ( !testU || !testV || !batchU || !batchV || !z )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "compareBatchEval: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    /* --- use separate contact points, so that both methods start with an empty history --- */
+    cpId      = crgContactPointCreate( dataSetId );
+    cpIdBatch = crgContactPointCreate( dataSetId );
+    
+    if ( cpId < 0 || cpIdBatch < 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "compareBatchEval: could not create contact points.\n" );
+        exit( -1 );
+    }
+    
+    crgContactPointSetDefaultOptions( cpId );
+    crgContactPointSetDefaultOptions( cpIdBatch );
+    
+    /* --- single queries x/y to u/v --- */
+    startTime = getTime();
+    
+    for ( idxTestPt = 0; idxTestPt < noTestPts; idxTestPt++ )
+        crgEvalxy2uv( cpId, testX[idxTestPt], testY[idxTestPt], &testU[idxTestPt], &testV[idxTestPt] );
+    
+    timeSingle = getTime() - startTime;
+    
+    /* --- batch queries x/y to u/v, one batch per time step (i.e. all wheel patches);
+       the results of both are identical, see test EvalVariants --- */
+    startTime = getTime();
+    
+    for ( idxTestPt = 0; idxTestPt < noTestPts; idxTestPt += blockSize )
+    {
+        noPts = blockSize;
+        
+        if ( idxTestPt + noPts > noTestPts )
+            noPts = ( int ) ( noTestPts - idxTestPt );
+        
+        crgEvalxy2uvBatch( cpIdBatch, noPts, &testX[idxTestPt], &testY[idxTestPt], &batchU[idxTestPt], &batchV[idxTestPt] );
+    }
+    
+    timeBatch = getTime() - startTime;
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "compareBatchEval: single x/y to u/v: %.3lf seconds (i.e. %.3lfus per query)\n", timeSingle, timeSingle / noTestPts * 1.0e6 );
+    crgMsgPrint( dCrgMsgLevelNotice, "compareBatchEval: batch  x/y to u/v: %.3lf seconds (i.e. %.3lfus per query, %d queries per batch)\n", timeBatch, timeBatch / noTestPts * 1.0e6, blockSize );
+    
+    /* --- single queries u/v to z, based on the results of the single x/y queries --- */
+    startTime = getTime();
+    
+    for ( idxTestPt = 0; idxTestPt < noTestPts; idxTestPt++ )
+        crgEvaluv2z( cpId, testU[idxTestPt], testV[idxTestPt], &z[idxTestPt] );
+    
+    timeSingle = getTime() - startTime;
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "compareBatchEval: single u/v to z: %.3lf seconds (i.e. %.3lfus per query)\n", timeSingle, timeSingle / noTestPts * 1.0e6 );
+    
+    /* --- batch queries u/v to z, once for each interpolation kernel available on this CPU --- */
+    for ( kernel = dCrgKernelScalar; kernel <= dCrgKernelAVX2; kernel++ )
+    {
+        if ( !crgEvalzSetKernel( kernel ) )
+            continue;
+        
+        startTime = getTime();
+        
+        for ( idxTestPt = 0; idxTestPt < noTestPts; idxTestPt += blockSize )
+        {
+            noPts = blockSize;
+            
+            if ( idxTestPt + noPts > noTestPts )
+                noPts = ( int ) ( noTestPts - idxTestPt );
+            
+            crgEvaluv2zBatch( cpId, noPts, &testU[idxTestPt], &testV[idxTestPt], &z[idxTestPt], NULL );
+        }
+        
+        timeBatch = getTime() - startTime;
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareBatchEval: batch  u/v to z (%s): %.3lf seconds (i.e. %.3lfus per query, %d queries per batch)\n", 
+                     crgEvalzGetKernelName(), timeBatch, timeBatch / noTestPts * 1.0e6, blockSize );
+    }
+    
+    crgEvalzSetKernel( dCrgKernelAuto );
+    
+    crgContactPointDelete( cpId );
+    crgContactPointDelete( cpIdBatch );
+    
+    free( testU );
+    free( testV );
+    free( batchU );
+    free( batchV );
+    free( z );
+}
+
+void compareGridLayouts( const char* filename, int noLookups )
+{
+    int    layout;
+    int    dataSetId;
+    int    cpId;
+    int    i;
+    double uMin;
+    double uMax;
+    double vMin;
+    double vMax;
+    double startTime;
+    double timeUsed;
+    double *testU = 0;
+    double *testV = 0;
+    double *z     = 0;
+    
+    testU = ( double* ) calloc( noLookups, sizeof( double ) );
+    testV = ( double* ) calloc( noLookups, sizeof( double ) );
+    z     = ( double* ) calloc( noLookups, sizeof( double ) );
+    
+    if ( !testU || !testV || !z )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "compareGridLayouts: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    for ( layout = dCrgGridLayoutRows; layout <= dCrgGridLayoutContiguous; layout++ )
+    {
+        crgLoaderSetGridLayout( layout );
+        crgMsgSetLevel( dCrgMsgLevelWarn );
+        
+        if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "compareGridLayouts: error reading data.\n" );
+            exit( -1 );
+        }
+        
+        crgDataSetModifiersApply( dataSetId );
+        
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+        
+        cpId = crgContactPointCreate( dataSetId );
+        crgContactPointSetDefaultOptions( cpId );
+        
+        /* --- random positions all over the grid, i.e. without any locality --- */
+        if ( layout == dCrgGridLayoutRows )
+        {
+            crgDataSetGetURange( dataSetId, &uMin, &uMax );
+            crgDataSetGetVRange( dataSetId, &vMin, &vMax );
+            
+            srand( 1 );
+            
+            for ( i = 0; i < noLookups; i++ )
+            {
+                testU[i] = uMin + ( uMax - uMin ) * rand() / RAND_MAX;
+                testV[i] = vMin + ( vMax - vMin ) * rand() / RAND_MAX;
+            }
+        }
+        
+        startTime = getTime();
+        
+        for ( i = 0; i < noLookups; i++ )
+            crgEvaluv2z( cpId, testU[i], testV[i], &z[i] );
+        
+        timeUsed = getTime() - startTime;
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareGridLayouts: %-10s layout, random single lookups: %.3lf Mio. lookups/s\n",
+                     layout == dCrgGridLayoutRows ? "row" : "contiguous", 1.0e-6 * noLookups / timeUsed );
+        
+        startTime = getTime();
+        
+        crgEvaluv2zBatch( cpId, noLookups, testU, testV, z, NULL );
+        
+        timeUsed = getTime() - startTime;
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareGridLayouts: %-10s layout, random batch  lookups: %.3lf Mio. lookups/s\n",
+                     layout == dCrgGridLayoutRows ? "row" : "contiguous", 1.0e-6 * noLookups / timeUsed );
+        
+        crgDataSetRelease( dataSetId );
+    }
+    
+    /* --- the layout does not change the results, see test LoadVariants --- */
+    crgLoaderSetGridLayout( dCrgGridLayoutRows );
+    
+    free( testU );
+    free( testV );
+    free( z );
+}
+
+void compareQuantizedGrid( const char* filename, int noLookups, double maxError )
+{
+    int    quantized;
+    int    dataSetId;
+    int    cpId;
+    int    i;
+    int    noExceed = 0;
+    size_t gridSize;
+    double uMin;
+    double uMax;
+    double vMin;
+    double vMax;
+    double maxDev = 0.0;
+    double startTime;
+    double timeUsed;
+    double *testU = 0;
+    double *testV = 0;
+    double *zRef  = 0;
+    double *z     = 0;
+    CrgDataStruct* crgData;
+    
+    testU = ( double* ) calloc( noLookups, sizeof( double ) );
+    testV = ( double* ) calloc( noLookups, sizeof( double ) );
+    zRef  = ( double* ) calloc( noLookups, sizeof( double ) );
+    z     = ( double* ) calloc( noLookups, sizeof( double ) );
+    
+    if ( !testU || !testV || !zRef || !z )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "compareQuantizedGrid: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    for ( quantized = 0; quantized < 2; quantized++ )
+    {
+        crgLoaderSetGridQuantization( quantized ? maxError : 0.0 );
+        crgMsgSetLevel( dCrgMsgLevelWarn );
+        
+        if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "compareQuantizedGrid: error reading data.\n" );
+            exit( -1 );
+        }
+        
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+        
+        /* --- no modifiers: a reference point would shift the surface by the error at that point --- */
+        cpId = crgContactPointCreate( dataSetId );
+        crgContactPointSetDefaultOptions( cpId );
+        
+        crgData = crgDataSetAccess( dataSetId );
+        
+        if ( crgData->gridQuant.valid )
+            gridSize = crgData->channelU.info.size * crgData->channelV.info.size * sizeof( short ) +
+                       crgData->gridQuant.noBlocksU * crgData->gridQuant.noBlocksV * 2 * sizeof( double );
+        else
+            gridSize = crgData->channelU.info.size * crgData->channelV.info.size * sizeof( float );
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareQuantizedGrid: %-9s grid, %.3lf MB\n",
+                     crgData->gridQuant.valid ? "quantized" : "float", 1.0e-6 * gridSize );
+        
+        /* --- random positions all over the grid, i.e. without any locality --- */
+        if ( !quantized )
+        {
+            crgDataSetGetURange( dataSetId, &uMin, &uMax );
+            crgDataSetGetVRange( dataSetId, &vMin, &vMax );
+            
+            srand( 1 );
+            
+            for ( i = 0; i < noLookups; i++ )
+            {
+                testU[i] = uMin + ( uMax - uMin ) * rand() / RAND_MAX;
+                testV[i] = vMin + ( vMax - vMin ) * rand() / RAND_MAX;
+            }
+        }
+        
+        startTime = getTime();
+        
+        for ( i = 0; i < noLookups; i++ )
+            crgEvaluv2z( cpId, testU[i], testV[i], &z[i] );
+        
+        timeUsed = getTime() - startTime;
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareQuantizedGrid: %-9s grid, random single lookups: %.3lf Mio. lookups/s\n",
+                     quantized ? "quantized" : "float", 1.0e-6 * noLookups / timeUsed );
+        
+        startTime = getTime();
+        
+        crgEvaluv2zBatch( cpId, noLookups, testU, testV, z, NULL );
+        
+        timeUsed = getTime() - startTime;
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareQuantizedGrid: %-9s grid, random batch  lookups: %.3lf Mio. lookups/s\n",
+                     quantized ? "quantized" : "float", 1.0e-6 * noLookups / timeUsed );
+        
+        /* --- the interpolated values must stay within the bound of the samples --- */
+        if ( !quantized )
+            memcpy( zRef, z, noLookups * sizeof( double ) );
+        else
+        {
+            for ( i = 0; i < noLookups; i++ )
+            {
+                if ( fabs( z[i] - zRef[i] ) > maxDev )
+                    maxDev = fabs( z[i] - zRef[i] );
+                
+                if ( fabs( z[i] - zRef[i] ) > crgData->gridQuant.maxError + 1.0e-9 )
+                    noExceed++;
+            }
+            
+            crgMsgSetLevel( dCrgMsgLevelWarn );
+            crgCheck( dataSetId );
+            crgMsgSetLevel( dCrgMsgLevelNotice );
+            
+            crgMsgPrint( dCrgMsgLevelNotice, "compareQuantizedGrid: maximum deviation %.3e m, achieved error %.3e m, bound %.3e m, %d of %d results exceed the error\n",
+                         maxDev, crgData->gridQuant.maxError, maxError, noExceed, noLookups );
+        }
+        
+        crgDataSetRelease( dataSetId );
+    }
+    
+    crgLoaderSetGridQuantization( 0.0 );
+    
+    free( testU );
+    free( testV );
+    free( zRef );
+    free( z );
+}
+
+void waitUntil( double time )
+{
+    struct timeval tme;
+    double         delay = time - getTime();
+    
+    if ( delay <= 0.0 )
+        return;
+    
+    tme.tv_sec  = ( long ) delay;
+    tme.tv_usec = ( long ) ( 1.0e6 * ( delay - tme.tv_sec ) );
+    
+    select( 0, NULL, NULL, NULL, &tme );
+}
+
+void compareStreamedGrid( const char* filename, double uBehind, double uAhead, double speed, double timeStep, int noLookups )
+{
+    const double wheelBase = 2.7;
+    int    streamed;
+    int    dataSetId;
+    int    cpId;
+    int    i;
+    int    k;
+    int    noSteps = 0;
+    long   noMisses;
+    long   noLoads;
+    size_t gridSize;
+    double uMin;
+    double uMax;
+    double vMin;
+    double vMax;
+    double u;
+    double startTime;
+    double timeUsed;
+    double *testU = 0;
+    double *testV = 0;
+    double *z     = 0;
+    CrgDataStruct* crgData;
+    
+    for ( streamed = 0; streamed < 2; streamed++ )
+    {
+        crgLoaderSetStreaming( streamed ? uBehind : 0.0, streamed ? uAhead : 0.0 );
+        crgMsgSetLevel( dCrgMsgLevelWarn );
+        
+        if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "compareStreamedGrid: error reading data.\n" );
+            exit( -1 );
+        }
+        
+        crgDataSetModifiersApply( dataSetId );
+        
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+        
+        cpId = crgContactPointCreate( dataSetId );
+        crgContactPointSetDefaultOptions( cpId );
+        
+        crgData = crgDataSetAccess( dataSetId );
+        
+        if ( streamed && !crgData->gridStream.valid )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "compareStreamedGrid: grid of <%s> cannot be streamed.\n", filename );
+            crgDataSetRelease( dataSetId );
+            break;
+        }
+        
+        if ( streamed )
+            gridSize = crgData->gridStream.noSlots * crgData->channelV.info.size * dCrgStreamPageSize * sizeof( float );
+        else
+            gridSize = crgData->channelU.info.size * crgData->channelV.info.size * sizeof( float );
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareStreamedGrid: %-8s grid, %.3lf MB resident\n",
+                     streamed ? "streamed" : "float", 1.0e-6 * gridSize );
+        
+        /* --- four wheels driving along the road, then random positions all over the grid --- */
+        if ( !streamed )
+        {
+            crgDataSetGetURange( dataSetId, &uMin, &uMax );
+            crgDataSetGetVRange( dataSetId, &vMin, &vMax );
+            
+            noSteps = ( int ) ( ( uMax - uMin - wheelBase ) / ( speed * timeStep ) );
+            
+            if ( noSteps < 0 )
+                noSteps = 0;
+            
+            testU = ( double* ) calloc( 4 * noSteps + noLookups, sizeof( double ) );
+            testV = ( double* ) calloc( 4 * noSteps + noLookups, sizeof( double ) );
+            z     = ( double* ) calloc( 4 * noSteps + noLookups, sizeof( double ) );
+            
+            if ( !testU || !testV || !z )
+            {
+                crgMsgPrint( dCrgMsgLevelNotice, "compareStreamedGrid: could not allocate memory. Sorry.\n" );
+                exit( -1 );
+            }
+            
+            for ( i = 0; i < noSteps; i++ )
+            {
+                u = uMin + wheelBase + i * speed * timeStep;
+                
+                for ( k = 0; k < 4; k++ )
+                {
+                    testU[4*i+k] = u - ( k >> 1 ) * wheelBase;
+                    testV[4*i+k] = 0.5 * ( vMin + vMax ) + ( ( k & 1 ) ? 0.4 : -0.4 ) * ( vMax - vMin );
+                }
+            }
+            
+            srand( 1 );
+            
+            for ( i = 4 * noSteps; i < 4 * noSteps + noLookups; i++ )
+            {
+                testU[i] = uMin + ( uMax - uMin ) * rand() / RAND_MAX;
+                testV[i] = vMin + ( vMax - vMin ) * rand() / RAND_MAX;
+            }
+        }
+        
+        /* --- the wheels are queried in real time, so the prefetch thread may run ahead --- */
+        crgDataSetResetStreamStat( dataSetId );
+        
+        startTime = getTime();
+        
+        for ( i = 0; i < noSteps; i++ )
+        {
+            for ( k = 0; k < 4; k++ )
+                crgEvaluv2z( cpId, testU[4*i+k], testV[4*i+k], &z[4*i+k] );
+            
+            waitUntil( startTime + ( i + 1 ) * timeStep );
+        }
+        
+        timeUsed = getTime() - startTime;
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareStreamedGrid: %-8s grid, drive at %.1lf m/s over %.1lf m in %.3lf s\n",
+                     streamed ? "streamed" : "float", speed, noSteps * speed * timeStep, timeUsed );
+        
+        if ( streamed && crgDataSetGetStreamStat( dataSetId, &noMisses, &noLoads ) )
+            crgMsgPrint( dCrgMsgLevelNotice, "compareStreamedGrid: %-8s grid, drive: %ld misses, %ld pages read\n",
+                         "streamed", noMisses, noLoads );
+        
+        crgDataSetResetStreamStat( dataSetId );
+        
+        startTime = getTime();
+        
+        for ( i = 4 * noSteps; i < 4 * noSteps + noLookups; i++ )
+            crgEvaluv2z( cpId, testU[i], testV[i], &z[i] );
+        
+        timeUsed = getTime() - startTime;
+        
+        crgMsgPrint( dCrgMsgLevelNotice, "compareStreamedGrid: %-8s grid, random single lookups: %.3lf Mio. lookups/s\n",
+                     streamed ? "streamed" : "float", 1.0e-6 * noLookups / timeUsed );
+        
+        if ( streamed && crgDataSetGetStreamStat( dataSetId, &noMisses, &noLoads ) )
+            crgMsgPrint( dCrgMsgLevelNotice, "compareStreamedGrid: %-8s grid, random: %ld misses, %ld pages read\n",
+                         "streamed", noMisses, noLoads );
+        
+        crgDataSetRelease( dataSetId );
+    }
+    
+    /* --- streaming does not change the results, see test LoadVariants --- */
+    crgLoaderSetStreaming( 0.0, 0.0 );
+    
+    free( testU );
+    free( testV );
+    free( z );
+}
+
+void compareSnapshot( const char* filename )
+{
+    const char* snapshotFile = "crgPerfTest.snapshot";
+    int    dataSetId[2];
+    double startTime;
+    double timeUsed[2];
+    
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    
+    /* --- cold start: parse and prepare the CRG file --- */
+    startTime = getTime();
+    
+    if ( ( dataSetId[0] = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "compareSnapshot: error reading data.\n" );
+        exit( -1 );
+    }
+    
+    crgDataSetModifiersApply( dataSetId[0] );
+    
+    timeUsed[0] = getTime() - startTime;
+    
+    if ( !crgDataSetSave( dataSetId[0], snapshotFile ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "compareSnapshot: error saving snapshot.\n" );
+        exit( -1 );
+    }
+    
+    /* --- warm start: both data sets give identical results, see test LoadVariants --- */
+    startTime = getTime();
+    
+    if ( ( dataSetId[1] = crgDataSetLoadSnapshot( snapshotFile ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "compareSnapshot: error loading snapshot.\n" );
+        exit( -1 );
+    }
+    
+    crgDataSetModifiersApply( dataSetId[1] );
+    
+    timeUsed[1] = getTime() - startTime;
+    
+    crgDataSetRelease( dataSetId[0] );
+    crgDataSetRelease( dataSetId[1] );
+    remove( snapshotFile );
+    
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "compareSnapshot: load time: file %.3lf ms, snapshot %.3lf ms\n", 1.0e3 * timeUsed[0], 1.0e3 * timeUsed[1] );
+}
+
+void compareHeaderOpen( const char* filename, int noRuns )
+{
+    int    dataSetId[2];
+    int    i;
+    int    k;
+    double startTime;
+    double timeUsed[2] = { 0.0, 0.0 };
+    double meta[2][6];
+    
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    
+    for ( i = 0; i < noRuns; i++ )
+    {
+        for ( k = 0; k < 2; k++ )
+        {
+            startTime = getTime();
+            
+            dataSetId[k] = k ? crgLoaderReadFile( filename ) : crgLoaderReadHeader( filename );
+            
+            if ( dataSetId[k] <= 0 )
+            {
+                crgMsgPrint( dCrgMsgLevelFatal, "compareHeaderOpen: error reading data.\n" );
+                exit( -1 );
+            }
+            
+            crgDataSetGetURange( dataSetId[k], &meta[k][0], &meta[k][1] );
+            crgDataSetGetVRange( dataSetId[k], &meta[k][2], &meta[k][3] );
+            crgDataSetGetIncrements( dataSetId[k], &meta[k][4], &meta[k][5] );
+            
+            timeUsed[k] += getTime() - startTime;
+        }
+        
+        /* --- both give the same metadata, see test LoadVariants --- */
+        crgDataSetRelease( dataSetId[0] );
+        crgDataSetRelease( dataSetId[1] );
+    }
+    
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "compareHeaderOpen: open time: header %.3lf ms, file %.3lf ms\n",
+                                     1.0e3 * timeUsed[0] / noRuns, 1.0e3 * timeUsed[1] / noRuns );
+}
+
+void compareColdStart( int dataSetId, double* testX, double* testY, size_t noTestPts, int noLookups )
+{
+    CrgDataStruct* crgData = crgDataSetAccess( dataSetId );
+    int    cpId;
+    int    i;
+    int    k;
+    size_t idx;
+    double startTime;
+    double timeUsed[2];
+    double* res[2];
+    
+    if ( !crgData || !noTestPts || noLookups < 1 )
+        return;
+    
+    res[0] = ( double* ) calloc( 2 * noLookups, sizeof( double ) );
+    res[1] = ( double* ) calloc( 2 * noLookups, sizeof( double ) );
+    
+    if ( !res[0] || !res[1] )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "compareColdStart: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    /* --- without history, every query is a cold start --- */
+    cpId = crgContactPointCreate( dataSetId );
+    crgContactPointSetHistory( cpId, 0 );
+    
+    for ( k = 0; k < 2; k++ )
+    {
+        /* --- first pass scans the reference line, second pass uses the spatial index --- */
+        if ( !k )
+            crgEvalxy2uvReleaseIndex( crgData );
+        else
+            crgEvalxy2uvBuildIndex( crgData );
+        
+        srand( 1 );
+        
+        startTime = getTime();
+        
+        for ( i = 0; i < noLookups; i++ )
+        {
+            idx = ( size_t ) ( ( double ) rand() / ( ( double ) RAND_MAX + 1.0 ) * noTestPts );
+            
+            crgEvalxy2uv( cpId, testX[idx], testY[idx], &res[k][2*i], &res[k][2*i+1] );
+        }
+        
+        timeUsed[k] = getTime() - startTime;
+    }
+    
+    /* --- both give identical results, see test EvalVariants --- */
+    crgMsgPrint( dCrgMsgLevelNotice, "compareColdStart: reference line scan: %.3lf us per query\n", 1.0e6 * timeUsed[0] / noLookups );
+    crgMsgPrint( dCrgMsgLevelNotice, "compareColdStart: spatial index:       %.3lf us per query\n", 1.0e6 * timeUsed[1] / noLookups );
+    
+    crgContactPointDelete( cpId );
+    
+    free( res[0] );
+    free( res[1] );
+}
+
+#define dNoTimingPasses 5
+
+void compareSurfaceNormal( int dataSetId, double* testX, double* testY, size_t noTestPts )
+{
+    const double h = 1.0e-5;    /* [m] offset for finite differences */
+    int    cpId;
+    int    pass;
+    size_t i;
+    double startTime;
+    double tPass;
+    double timeFD = 0.0;
+    double timeZn = 0.0;
+    double maxDev = 0.0;
+    double maxGrad = 0.0;
+    double zu;
+    double zv;
+    double* u;
+    double* v;
+    double* z;
+    double* res;
+    
+    if ( !noTestPts )
+        return;
+    
+    if ( noTestPts > 1000000 )
+        noTestPts = 1000000;
+    
+    u   = ( double* ) calloc( noTestPts, sizeof( double ) );
+    v   = ( double* ) calloc( noTestPts, sizeof( double ) );
+    z   = ( double* ) calloc( noTestPts, sizeof( double ) );
+    res = ( double* ) calloc( 6 * noTestPts, sizeof( double ) );
+    
+    if ( !u || !v || !z || !res )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "compareSurfaceNormal: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    cpId = crgContactPointCreate( dataSetId );
+    crgContactPointSetDefaultOptions( cpId );
+    
+    for ( i = 0; i < noTestPts; i++ )
+        crgEvalxy2uv( cpId, testX[i], testY[i], &u[i], &v[i] );
+    
+    for ( pass = 0; pass < dNoTimingPasses; pass++ )
+    {
+        /* --- three queries per position with forward differences --- */
+        startTime = getTime();
+        
+        for ( i = 0; i < noTestPts; i++ )
+        {
+            crgEvaluv2z( cpId, u[i], v[i], &z[i] );
+            crgEvaluv2z( cpId, u[i] + h, v[i], &zu );
+            crgEvaluv2z( cpId, u[i], v[i] + h, &zv );
+            
+            res[6*i]   = ( zu - z[i] ) / h;
+            res[6*i+1] = ( zv - z[i] ) / h;
+        }
+        
+        tPass = getTime() - startTime;
+        
+        if ( !pass || tPass < timeFD )
+            timeFD = tPass;
+        
+        /* --- one query per position with analytic derivatives and normal --- */
+        startTime = getTime();
+        
+        for ( i = 0; i < noTestPts; i++ )
+            crgEvaluv2zn( cpId, u[i], v[i], &res[6*i+2], &res[6*i+3], &res[6*i+4], NULL );
+        
+        tPass = getTime() - startTime;
+        
+        if ( !pass || tPass < timeZn )
+            timeZn = tPass;
+    }
+    
+    /* --- derivatives agree except where the offset crosses a grid line; z is identical, see test EvalVariants --- */
+    for ( i = 0; i < noTestPts; i++ )
+    {
+        if ( fabs( res[6*i] ) > maxGrad )
+            maxGrad = fabs( res[6*i] );
+        
+        if ( fabs( res[6*i+1] ) > maxGrad )
+            maxGrad = fabs( res[6*i+1] );
+    }
+    
+    for ( i = 0; i < noTestPts; i++ )
+    {
+        crgEvaluv2z( cpId, u[i] - h, v[i], &zu );
+        crgEvaluv2z( cpId, u[i], v[i] - h, &zv );
+        
+        /* --- positions on a grid line have a kink, their forward and backward differences differ --- */
+        if ( fabs( ( z[i] - zu ) / h - res[6*i] ) > 1.0e-6 * ( 1.0 + fabs( res[6*i] ) ) ||
+             fabs( ( z[i] - zv ) / h - res[6*i+1] ) > 1.0e-6 * ( 1.0 + fabs( res[6*i+1] ) ) )
+            continue;
+        
+        if ( fabs( res[6*i+3] - res[6*i] ) > maxDev )
+            maxDev = fabs( res[6*i+3] - res[6*i] );
+        
+        if ( fabs( res[6*i+4] - res[6*i+1] ) > maxDev )
+            maxDev = fabs( res[6*i+4] - res[6*i+1] );
+    }
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "compareSurfaceNormal: 3 x crgEvaluv2z:  %.3lf us per position\n", 1.0e6 * timeFD / noTestPts );
+    crgMsgPrint( dCrgMsgLevelNotice, "compareSurfaceNormal: 1 x crgEvaluv2zn: %.3lf us per position\n", 1.0e6 * timeZn / noTestPts );
+    crgMsgPrint( dCrgMsgLevelNotice, "compareSurfaceNormal: max. deviation of derivatives = %.3e (max. gradient %.3f)\n", maxDev, maxGrad );
+    
+    crgContactPointDelete( cpId );
+    
+    free( u );
+    free( v );
+    free( z );
+    free( res );
+}
+
+void compareFusedEval( int dataSetId, double* testX, double* testY, size_t noTestPts, int blockSize )
+{
+    const char* name[3] = { "separate calls", "crgEvalxy2all", "crgEvalxy2allBatch" };
+    int    cpId;
+    int    pass;
+    int    k;
+    int    noPts;
+    size_t i;
+    double startTime;
+    double timeUsed[3];
+    double tPass;
+    double* res[3];
+    
+    if ( !noTestPts || blockSize < 1 )
+        return;
+    
+    if ( noTestPts > 1000000 )
+        noTestPts = 1000000;
+    
+    for ( k = 0; k < 3; k++ )
+    {
+        if ( !( res[k] = ( double* ) calloc( 5 * noTestPts, sizeof( double ) ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelNotice, "compareFusedEval: could not allocate memory. Sorry.\n" );
+            exit( -1 );
+        }
+    }
+    
+    /* --- alternate the variants and keep the fastest of several passes --- */
+    for ( pass = 0; pass < 3 * dNoTimingPasses; pass++ )
+    {
+        k = pass % 3;
+        
+        /* --- a new contact point per variant, so that all start with an empty history --- */
+        cpId = crgContactPointCreate( dataSetId );
+        crgContactPointSetDefaultOptions( cpId );
+        
+        startTime = getTime();
+        
+        if ( !k )
+        {
+            for ( i = 0; i < noTestPts; i++ )
+            {
+                crgEvalxy2uv( cpId, testX[i], testY[i], &res[k][i], &res[k][noTestPts+i] );
+                crgEvaluv2z( cpId, res[k][i], res[k][noTestPts+i], &res[k][2*noTestPts+i] );
+                crgEvaluv2pk( cpId, res[k][i], res[k][noTestPts+i], &res[k][3*noTestPts+i], &res[k][4*noTestPts+i] );
+            }
+        }
+        else if ( k == 1 )
+        {
+            for ( i = 0; i < noTestPts; i++ )
+                crgEvalxy2all( cpId, testX[i], testY[i], &res[k][i], &res[k][noTestPts+i], &res[k][2*noTestPts+i],
+                               &res[k][3*noTestPts+i], &res[k][4*noTestPts+i] );
+        }
+        else
+        {
+            for ( i = 0; i < noTestPts; i += blockSize )
+            {
+                noPts = blockSize;
+                
+                if ( i + noPts > noTestPts )
+                    noPts = ( int ) ( noTestPts - i );
+                
+                crgEvalxy2allBatch( cpId, noPts, &testX[i], &testY[i], &res[k][i], &res[k][noTestPts+i], &res[k][2*noTestPts+i],
+                                    &res[k][3*noTestPts+i], &res[k][4*noTestPts+i] );
+            }
+        }
+        
+        tPass = getTime() - startTime;
+        
+        if ( pass < 3 || tPass < timeUsed[k] )
+            timeUsed[k] = tPass;
+        
+        crgContactPointDelete( cpId );
+    }
+    
+    /* --- all variants give identical results, see test EvalVariants --- */
+    for ( k = 0; k < 3; k++ )
+        crgMsgPrint( dCrgMsgLevelNotice, "compareFusedEval: %-18s %.3lf us per position\n", name[k], 1.0e6 * timeUsed[k] / noTestPts );
+    
+    for ( k = 0; k < 3; k++ )
+        free( res[k] );
+}
+
+
+void compareEvalKernels( int dataSetId, double* testX, double* testY, size_t noTestPts )
+{
+    const char* name[3] = { "default options", "smoothing zones", "border mode repeat" };
+    CrgContactPointStruct* cp;
+    int    cpId;
+    int    optSet;
+    int    pass;
+    int    k;
+    size_t i;
+    double startTime;
+    double timeUsed[2];
+    double tPass;
+    double* testU;
+    double* testV;
+    double* res[2];
+    
+    if ( !noTestPts )
+        return;
+    
+    if ( noTestPts > 1000000 )
+        noTestPts = 1000000;
+    
+    testU  = ( double* ) calloc( noTestPts, sizeof( double ) );
+    testV  = ( double* ) calloc( noTestPts, sizeof( double ) );
+    res[0] = ( double* ) calloc( noTestPts, sizeof( double ) );
+    res[1] = ( double* ) calloc( noTestPts, sizeof( double ) );
+    
+    if ( !testU || !testV || !res[0] || !res[1] )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "compareEvalKernels: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    cpId = crgContactPointCreate( dataSetId );
+    cp   = crgContactPointGetFromId( cpId );
+    
+    for ( i = 0; i < noTestPts; i++ )
+        crgEvalxy2uv( cpId, testX[i], testY[i], &testU[i], &testV[i] );
+    
+    for ( optSet = 0; optSet < 3; optSet++ )
+    {
+        crgContactPointSetDefaultOptions( cpId );
+        
+        /* --- the zones must not cover all test points, which are taken from the begin of long files --- */
+        if ( optSet == 1 )
+        {
+            crgContactPointOptionSetDouble( cpId, dCrgCpOptionSmoothUBegin, 1.0 );
+            crgContactPointOptionSetDouble( cpId, dCrgCpOptionSmoothUEnd,   1.0 );
+        }
+        else if ( optSet == 2 )
+        {
+            crgContactPointOptionSetInt( cpId, dCrgCpOptionBorderModeU, dCrgBorderModeRepeat );
+            crgContactPointOptionSetInt( cpId, dCrgCpOptionBorderModeV, dCrgBorderModeRepeat );
+        }
+        
+        /* --- alternate the generic and the specialized evaluation and keep the fastest of several passes --- */
+        for ( pass = 0; pass < 2 * dNoTimingPasses; pass++ )
+        {
+            k = pass % 2;
+            
+            startTime = getTime();
+            
+            if ( !k )
+            {
+                for ( i = 0; i < noTestPts; i++ )
+                    crgDataEvaluv2z( cp->crgData, &( cp->options ), &( cp->perfStat ), testU[i], testV[i], &res[k][i] );
+            }
+            else
+            {
+                for ( i = 0; i < noTestPts; i++ )
+                    crgEvaluv2zPtr( cp, testU[i], testV[i], &res[k][i] );
+            }
+            
+            tPass = getTime() - startTime;
+            
+            if ( pass < 2 || tPass < timeUsed[k] )
+                timeUsed[k] = tPass;
+        }
+        
+        /* --- both give identical results, see test EvalVariants --- */
+        crgMsgPrint( dCrgMsgLevelNotice, "compareEvalKernels: %-18s generic %.3lf us, specialized %.3lf us per query\n",
+                     name[optSet], 1.0e6 * timeUsed[0] / noTestPts, 1.0e6 * timeUsed[1] / noTestPts );
+    }
+    
+    crgContactPointDelete( cpId );
+    
+    free( testU );
+    free( testV );
+    free( res[0] );
+    free( res[1] );
+}
+
+
+void compareContactPatch( int dataSetId, double* patchX, double* patchY, double* patchPhi, size_t noPatches,
+                          double length, double width, int nLength, int nWidth )
+{
+    const char* name[2] = { "per-point crgEvalxy2z", "crgEvalPatch" };
+    int    cpId;
+    int    pass;
+    int    noPtsPerPatch = nLength * nWidth;
+    int    j;
+    int    k;
+    size_t i;
+    size_t idx;
+    size_t noPts;
+    double startTime;
+    double timeUsed[2];
+    double tPass;
+    double s;
+    double t;
+    double dev;
+    double maxDev = 0.0;
+    double sumDev = 0.0;
+    double stat[dCrgPatchStatSize];
+    double* ptX;
+    double* ptY;
+    double* res[2];
+    
+    if ( !noPatches || noPtsPerPatch < 1 )
+        return;
+    
+    if ( noPatches * noPtsPerPatch > 1000000 )
+        noPatches = 1000000 / noPtsPerPatch;
+    
+    noPts = noPatches * noPtsPerPatch;
+    ptX    = ( double* ) calloc( noPts, sizeof( double ) );
+    ptY    = ( double* ) calloc( noPts, sizeof( double ) );
+    res[0] = ( double* ) calloc( noPts, sizeof( double ) );
+    res[1] = ( double* ) calloc( noPts, sizeof( double ) );
+    
+    if ( !ptX || !ptY || !res[0] || !res[1] )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "compareContactPatch: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    /* --- the samples of the per-point loop, laid out like those of the patch --- */
+    for ( i = 0, idx = 0; i < noPatches; i++ )
+    {
+        for ( j = 0; j < nLength; j++ )
+        {
+            s = nLength > 1 ? ( ( double ) j / ( nLength - 1 ) - 0.5 ) * length : 0.0;
+            
+            for ( k = 0; k < nWidth; k++, idx++ )
+            {
+                t = nWidth > 1 ? ( ( double ) k / ( nWidth - 1 ) - 0.5 ) * width : 0.0;
+                
+                ptX[idx] = patchX[i] + s * cos( patchPhi[i] ) - t * sin( patchPhi[i] );
+                ptY[idx] = patchY[i] + t * cos( patchPhi[i] ) + s * sin( patchPhi[i] );
+            }
+        }
+    }
+    
+    /* --- alternate the variants and keep the fastest of several passes --- */
+    for ( pass = 0; pass < 2 * dNoTimingPasses; pass++ )
+    {
+        k = pass % 2;
+        
+        cpId = crgContactPointCreate( dataSetId );
+        crgContactPointSetDefaultOptions( cpId );
+        
+        startTime = getTime();
+        
+        if ( !k )
+        {
+            for ( idx = 0; idx < noPts; idx++ )
+                crgEvalxy2z( cpId, ptX[idx], ptY[idx], &res[k][idx] );
+        }
+        else
+        {
+            for ( i = 0; i < noPatches; i++ )
+                crgEvalPatch( cpId, patchX[i], patchY[i], patchPhi[i], length, width, nLength, nWidth, &res[k][i * noPtsPerPatch], stat );
+        }
+        
+        tPass = getTime() - startTime;
+        
+        if ( pass < 2 || tPass < timeUsed[k] )
+            timeUsed[k] = tPass;
+        
+        crgContactPointDelete( cpId );
+    }
+    
+    /* --- samples are interpolated in (u,v) space, so small deviations are expected on curved reference lines --- */
+    for ( idx = 0; idx < noPts; idx++ )
+    {
+        dev     = fabs( res[1][idx] - res[0][idx] );
+        sumDev += dev;
+        
+        if ( dev > maxDev )
+            maxDev = dev;
+    }
+    
+    for ( k = 0; k < 2; k++ )
+        crgMsgPrint( dCrgMsgLevelNotice, "compareContactPatch: %-21s %.3lf us per patch of %d x %d samples\n",
+                     name[k], 1.0e6 * timeUsed[k] / noPatches, nLength, nWidth );
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "compareContactPatch: %ld patches, max. deviation = %.3e m, mean deviation = %.3e m\n",
+                 ( long ) noPatches, maxDev, sumDev / noPts );
+    
+    free( ptX );
+    free( ptY );
+    free( res[0] );
+    free( res[1] );
+}
+
+
+void compareRefLineGeom( int dataSetId, double* testX, double* testY, size_t noTestPts )
+{
+    CrgDataStruct* crgData = crgDataSetAccess( dataSetId );
+    const char* name[3] = { "xy2uv", "uv2xy", "uv2pk" };
+    int    cpId;
+    int    pass;
+    int    k;
+    int    m;
+    size_t i;
+    double startTime;
+    double timeUsed[2][3] = { { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+    double tPass;
+    double maxDev[3] = { 0.0, 0.0, 0.0 };
+    double* res[2];
+    
+    if ( !crgData || !noTestPts )
+        return;
+    
+    if ( noTestPts > 1000000 )
+        noTestPts = 1000000;
+    
+    res[0] = ( double* ) calloc( 6 * noTestPts, sizeof( double ) );
+    res[1] = ( double* ) calloc( 6 * noTestPts, sizeof( double ) );
+    
+    if ( !res[0] || !res[1] )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "compareRefLineGeom: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    cpId = crgContactPointCreate( dataSetId );
+    
+    /* --- alternate both variants and keep the fastest of several passes --- */
+    for ( pass = 0; pass < 2 * dNoTimingPasses; pass++ )
+    {
+        k = pass % 2;
+        
+        /* --- even passes compute the geometry on the fly, odd passes use the tables --- */
+        if ( !k )
+            crgReleaseRefLineGeom( crgData );
+        else
+            crgCalcRefLineGeom( crgData );
+        
+        crgContactPointOptionSetDouble( cpId, dCrgCpOptionRefLineSearchU, crgData->channelU.info.first );
+        
+        for ( m = 0; m < 3; m++ )
+        {
+            startTime = getTime();
+            
+            /* --- u/v input for the inverse transformations is the same for both variants --- */
+            for ( i = 0; i < noTestPts; i++ )
+            {
+                if ( !m )
+                    crgEvalxy2uv( cpId, testX[i], testY[i], &res[k][6*i], &res[k][6*i+1] );
+                else if ( m == 1 )
+                    crgEvaluv2xy( cpId, res[0][6*i], res[0][6*i+1], &res[k][6*i+2], &res[k][6*i+3] );
+                else
+                    crgEvaluv2pk( cpId, res[0][6*i], res[0][6*i+1], &res[k][6*i+4], &res[k][6*i+5] );
+            }
+            
+            tPass = getTime() - startTime;
+            
+            if ( pass < 2 || tPass < timeUsed[k][m] )
+                timeUsed[k][m] = tPass;
+        }
+    }
+    
+    for ( i = 0; i < noTestPts; i++ )
+    {
+        for ( m = 0; m < 3; m++ )
+        {
+            if ( fabs( res[1][6*i+2*m] - res[0][6*i+2*m] ) > maxDev[m] )
+                maxDev[m] = fabs( res[1][6*i+2*m] - res[0][6*i+2*m] );
+            
+            if ( fabs( res[1][6*i+2*m+1] - res[0][6*i+2*m+1] ) > maxDev[m] )
+                maxDev[m] = fabs( res[1][6*i+2*m+1] - res[0][6*i+2*m+1] );
+        }
+    }
+    
+    for ( m = 0; m < 3; m++ )
+        crgMsgPrint( dCrgMsgLevelNotice, "compareRefLineGeom: %s: on the fly %.3lf us, tables %.3lf us per call, max. deviation %.3g\n",
+                     name[m], 1.0e6 * timeUsed[0][m] / noTestPts, 1.0e6 * timeUsed[1][m] / noTestPts, maxDev[m] );
+    
+    crgContactPointDelete( cpId );
+    
+    free( res[0] );
+    free( res[1] );
+}
+
+void interleaveWheels( double* testX, double* testY, size_t noTestPts, int noWheels, int noPtsPerWheel )
+{
+    double* tmp;
+    size_t  blockSize = ( size_t ) noWheels * noPtsPerWheel;
+    size_t  block;
+    int     i;
+    int     j;
+    
+    tmp = ( double* ) calloc( 2 * blockSize, sizeof( double ) );
+    
+    if ( !tmp )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "interleaveWheels: could not allocate memory. Sorry.\n" );
+        exit( -1 );
+    }
+    
+    /* --- per time step, query point j of all wheels before point j+1 --- */
+    for ( block = 0; block + blockSize <= noTestPts; block += blockSize )
+    {
+        for ( i = 0; i < noWheels; i++ )
+        {
+            for ( j = 0; j < noPtsPerWheel; j++ )
+            {
+                tmp[j * noWheels + i]             = testX[block + i * noPtsPerWheel + j];
+                tmp[blockSize + j * noWheels + i] = testY[block + i * noPtsPerWheel + j];
+            }
+        }
+        
+        memcpy( &testX[block], tmp, blockSize * sizeof( double ) );
+        memcpy( &testY[block], &tmp[blockSize], blockSize * sizeof( double ) );
+    }
+    
+    free( tmp );
+}
+
+void testLoading( const char* filename, int accessMode )
+{
+    int            dataSetId;
+    size_t         i;
+    size_t         j;
+    unsigned long  checkSum = 0;
+    long           rssBefore;
+    double         startTime;
+    double         timeUsed;
+    struct rusage  usage;
+    CrgDataStruct* crgData;
+    
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    crgLoaderSetFileAccess( accessMode );
+    
+    /* --- peak memory is tracked per process, so run one access method per process only --- */
+    getrusage( RUSAGE_SELF, &usage );
+    rssBefore = usage.ru_maxrss;
+    
+    startTime = getTime();
+    
+    if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "testLoading: error reading data.\n" );
+        exit( -1 );
+    }
+    
+    timeUsed = getTime() - startTime;
+    
+    getrusage( RUSAGE_SELF, &usage );
+    
+    /* --- checksum of the elevation grid for comparing the access methods --- */
+    crgData = crgDataSetAccess( dataSetId );
+    
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    {
+        for ( j = 0; j < crgData->channelZ[i].info.size; j++ )
+        {
+            unsigned int bits;
+            
+            memcpy( &bits, &( crgData->channelZ[i].data[j] ), sizeof( bits ) );
+            checkSum = checkSum * 31 + bits;
+        }
+    }
+    
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "testLoading: %s file access: load time %.3lf ms, peak memory %ld kB (+%ld kB), grid checksum %08lx\n",
+                                     ( accessMode == dCrgFileAccessMapped ) ? "mapped" : "buffered", 1.0e3 * timeUsed,
+                                     usage.ru_maxrss, usage.ru_maxrss - rssBefore, checkSum & 0xffffffffUL );
+    
+    crgDataSetRelease( dataSetId );
+}
+
 int main( int argc, char** argv ) 
 {
     char*  filename = "";
@@ -48,6 +1302,21 @@ int main( int argc, char** argv )
     int    j;
     int    k;
     int    cpId;
+    int    testBatch = 0;
+    int    testColdStart = 0;
+    int    testInterleave = 0;
+    int    usePrediction = 0;
+    int    testGeom = 0;
+    int    testFused = 0;
+    int    testNormal = 0;
+    int    testPatch = 0;
+    int    testKernels = 0;
+    int    testLayout = 0;
+    int    testQuant = 0;
+    int    testStream = 0;
+    int    testLoad = -1;
+    int    testSnapshot = 0;
+    int    testHeader = 0;
     double uMin;
     double uMax;
     double vMin;
@@ -91,6 +1360,10 @@ int main( int argc, char** argv )
     
     double *testX = 0;      /* array of x positions to be used for queries */
     double *testY = 0;      /* array of y positions to be used for queries */
+    double *patchX = 0;     /* array of x positions of the patch centers   */
+    double *patchY = 0;     /* array of y positions of the patch centers   */
+    double *patchPhi = 0;   /* array of headings of the patches            */
+    size_t noPatches = 0;   /* number of patches                           */
     size_t noTestPts;       /* size of the test point array                */
     size_t idxTestPt;       /* test point index                            */
 
@@ -112,6 +1385,54 @@ int main( int argc, char** argv )
         if ( !strcmp( *argv, "-h" ) )
             usage();
         
+        if ( !strcmp( *argv, "-b" ) )
+            testBatch = 1;
+        
+        if ( !strcmp( *argv, "-a" ) )
+            testFused = 1;
+        
+        if ( !strcmp( *argv, "-n" ) )
+            testNormal = 1;
+        
+        if ( !strcmp( *argv, "-t" ) )
+            testPatch = 1;
+        
+        if ( !strcmp( *argv, "-k" ) )
+            testKernels = 1;
+        
+        if ( !strcmp( *argv, "-c" ) )
+            testColdStart = 1;
+        
+        if ( !strcmp( *argv, "-w" ) )
+            testInterleave = 1;
+        
+        if ( !strcmp( *argv, "-p" ) )
+            usePrediction = 1;
+        
+        if ( !strcmp( *argv, "-r" ) )
+            testGeom = 1;
+        
+        if ( !strcmp( *argv, "-g" ) )
+            testLayout = 1;
+        
+        if ( !strcmp( *argv, "-q" ) )
+            testQuant = 1;
+        
+        if ( !strcmp( *argv, "-o" ) )
+            testStream = 1;
+        
+        if ( !strcmp( *argv, "-l" ) )
+            testLoad = dCrgFileAccessMapped;
+        
+        if ( !strcmp( *argv, "-L" ) )
+            testLoad = dCrgFileAccessBuffered;
+        
+        if ( !strcmp( *argv, "-s" ) )
+            testSnapshot = 1;
+        
+        if ( !strcmp( *argv, "-m" ) )
+            testHeader = 1;
+        
         if ( !argc ) /* last argument is the filename */
         {
             crgMsgPrint( dCrgMsgLevelInfo, "searching file\n" );
@@ -126,6 +1447,13 @@ int main( int argc, char** argv )
         }
     }
     
+    /* --- load test only? --- */
+    if ( testLoad >= 0 )
+    {
+        testLoading( filename, testLoad );
+        return 1;
+    }
+    
     /* --- now load the file --- */
     crgMsgSetLevel( dCrgMsgLevelNotice );
     
@@ -165,14 +1493,21 @@ int main( int argc, char** argv )
     
     /* --- set and print the current options --- */
     crgContactPointSetDefaultOptions( cpId );
+    
+    if ( usePrediction )
+        crgContactPointOptionSetInt( cpId, dCrgCpOptionRefLinePredict, 1 );
+    
     crgContactPointOptionsPrint( cpId );
     
     crgMsgPrint( dCrgMsgLevelDebug, "main: generating %ld test points\n", noTestPts );
     
     testX = ( double* ) calloc( noTestPts, sizeof( double ) );
     testY = ( double* ) calloc( noTestPts, sizeof( double ) );
+    patchX   = ( double* ) calloc( noTestPts / ( noPtsPatchWidth * noPtsPatchLength ) + 1, sizeof( double ) );
+    patchY   = ( double* ) calloc( noTestPts / ( noPtsPatchWidth * noPtsPatchLength ) + 1, sizeof( double ) );
+    patchPhi = ( double* ) calloc( noTestPts / ( noPtsPatchWidth * noPtsPatchLength ) + 1, sizeof( double ) );
     
-    if ( !testX || !testY )
+    if ( !testX || !testY || !patchX || !patchY || !patchPhi )
     {
         crgMsgPrint( dCrgMsgLevelNotice, "main: could not allocate memory. Sorry.\n" );
         exit( -1 );
@@ -222,6 +1557,11 @@ int main( int argc, char** argv )
                         break;
                 }
                 
+                patchX[noPatches]   = x + dx * cos( phi ) - dy * sin( phi );
+                patchY[noPatches]   = y + dy * cos( phi ) + dx * sin( phi );
+                patchPhi[noPatches] = phi;
+                noPatches++;
+                
                 for ( j = 0; j < noPtsPatchLength; j++ )
                 {
                     if ( noPtsPatchLength > 1 )
@@ -251,6 +1591,9 @@ int main( int argc, char** argv )
     if ( idxTestPt < noTestPts )
         noTestPts = idxTestPt;
 
+    if ( testInterleave )
+        interleaveWheels( testX, testY, noTestPts, noWheels, noPtsPatchWidth * noPtsPatchLength );
+
     crgMsgPrint( dCrgMsgLevelNotice, "main: generated %d test points. Now running actual test....\n", idxTestPt );
 
     crgContactPointActivatePerfStat( cpId );
@@ -282,6 +1625,43 @@ int main( int argc, char** argv )
     
     crgContactPointPrintPerfStat( cpId );
 
+    if ( testBatch )
+        compareBatchEval( dataSetId, testX, testY, noTestPts, noWheels * noPtsPatchWidth * noPtsPatchLength );
+    
+    if ( testColdStart )
+        compareColdStart( dataSetId, testX, testY, noTestPts, 20000 );
+    
+    if ( testFused )
+        compareFusedEval( dataSetId, testX, testY, noTestPts, noWheels * noPtsPatchWidth * noPtsPatchLength );
+    
+    if ( testNormal )
+        compareSurfaceNormal( dataSetId, testX, testY, noTestPts );
+    
+    if ( testKernels )
+        compareEvalKernels( dataSetId, testX, testY, noTestPts );
+    
+    if ( testPatch )
+        compareContactPatch( dataSetId, patchX, patchY, patchPhi, noPatches,
+                             wheelPatchLength, wheelPatchWidth, noPtsPatchLength, noPtsPatchWidth );
+    
+    if ( testGeom )
+        compareRefLineGeom( dataSetId, testX, testY, noTestPts );
+    
+    if ( testLayout )
+        compareGridLayouts( filename, 2000000 );
+    
+    if ( testQuant )
+        compareQuantizedGrid( filename, 2000000, 1.0e-3 );
+    
+    if ( testStream )
+        compareStreamedGrid( filename, 10.0, 50.0, 100.0, 5.0e-4, 20000 );
+    
+    if ( testSnapshot )
+        compareSnapshot( filename );
+    
+    if ( testHeader )
+        compareHeaderOpen( filename, 20 );
+    
     crgMsgPrint( dCrgMsgLevelNotice, "main: normal termination\n" );
     
     return 1;
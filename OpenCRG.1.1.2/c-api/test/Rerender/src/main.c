@@ -0,0 +1,439 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              re-rendering a data set with several
+ *              u and v increments and comparing the
+ *              results with the evaluation of the
+ *              source data set
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoCases        5
+#define dMaxNodes       200000  /* maximum number of nodes compared per case */
+#define dTolZ           1.0e-6  /* relative tolerance of z, the grid is stored as float  [-] */
+#define dTolXY          1.0e-9  /* relative tolerance of x and y                         [-] */
+#define dTolFile        1.0e-3  /* tolerance of x and y after writing and reading       [m] */
+
+#define dVKeep          0       /* keep the long sections of the source */
+#define dVRegular       1       /* regular long sections */
+#define dVExplicit      2       /* explicit, irregular long sections */
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    const char* name;
+    double uScale;          /* u increment relative to the source */
+    int    vMode;           /* definition of the long sections [dVxxx] */
+    double vScale;          /* number of regular v intervals relative to the source */
+} RerenderCaseStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static const RerenderCaseStruct mCase[dNoCases] =
+{
+    { "finer u",     0.5, dVKeep,     0.0 },
+    { "coarser u",   2.0, dVKeep,     0.0 },
+    { "regular v",   1.0, dVRegular,  2.0 },
+    { "coarse grid", 4.0, dVRegular,  0.5 },
+    { "explicit v",  1.5, dVExplicit, 0.0 }
+};
+
+static int         mNoThreads = 0;
+static const char* mOutDir    = "/tmp";
+
+/* ====== LOCAL METHODS ====== */
+static int rerenderFile( const char* filename );
+static int rerender( int baseId, const RerenderCaseStruct* rc, int noThreads, double* tRender );
+static size_t compareNodes( int baseId, int dataSetId, double tolXY, double* maxDiff );
+static size_t compareFile( int dataSetId, const char* name, double* maxDiff );
+static size_t compareGrids( CrgDataStruct* a, CrgDataStruct* b );
+static double getTime( void );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgRerender [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -t <n>     number of threads compared with a single thread (default: one per processor)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -o <dir>   directory of the written data sets (default: /tmp)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file(s) as input file(s)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    int noFiles  = 0;
+    int noFailed = 0;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        if ( !strcmp( *argv, "-t" ) && argc )
+        {
+            argv++;
+            argc--;
+            mNoThreads = atoi( *argv );
+
+            if ( mNoThreads < 0 )
+                usage();
+            continue;
+        }
+
+        if ( !strcmp( *argv, "-o" ) && argc )
+        {
+            argv++;
+            argc--;
+            mOutDir = *argv;
+            continue;
+        }
+
+        noFiles++;
+
+        if ( !rerenderFile( *argv ) )
+            noFailed++;
+    }
+
+    if ( !noFiles )
+        usage();
+
+    crgMemRelease();
+
+    if ( noFailed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: %d of %d files could NOT be re-rendered correctly.\n", noFailed, noFiles );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: all %d files have been re-rendered correctly.\n", noFiles );
+
+    return 0;
+}
+
+static int
+rerenderFile( const char* filename )
+{
+    CrgDataStruct* base;
+    char   name[1024];
+    int    baseId;
+    int    idSingle;
+    int    idMulti;
+    int    i;
+    int    noThreads = mNoThreads ? mNoThreads : crgPortGetNoProcessors();
+    int    noSets    = 0;
+    size_t noDiffs   = 0;
+    size_t diffs;
+    double maxDiff;
+    double maxDiffFile;
+    double tLoad;
+    double tSingle;
+    double tMulti;
+    double tTotal = 0.0;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    tLoad = getTime();
+
+    if ( ( baseId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "rerenderFile: could not load <%s>.\n", filename );
+        return 0;
+    }
+
+    crgDataSetModifiersApply( baseId );
+
+    tLoad = getTime() - tLoad;
+    base  = crgDataSetAccess( baseId );
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    crgMsgPrint( dCrgMsgLevelNotice, "rerenderFile: file <%s>, %ld x %ld samples, u increment %.4f m, %s v, loaded in %.3f ms\n",
+                 filename, ( long ) base->channelU.info.size, ( long ) base->channelV.info.size, base->channelU.info.inc,
+                 ( base->admin.defMask & dCrgDataDefVIndex ) ? "regular" : "irregular", tLoad * 1.0e3 );
+
+    /* --- all resolutions are rendered from the source loaded once --- */
+    for ( i = 0; i < dNoCases; i++ )
+    {
+        if ( base->channelU.info.last - base->channelU.info.first < mCase[i].uScale * base->channelU.info.inc )
+        {
+            crgMsgPrint( dCrgMsgLevelNotice, "rerenderFile:     %-12s: data set too short, skipped\n", mCase[i].name );
+            continue;
+        }
+
+        if ( ( idSingle = rerender( baseId, &mCase[i], 1, &tSingle ) ) <= 0 )
+        {
+            noDiffs++;
+            continue;
+        }
+
+        if ( ( idMulti = rerender( baseId, &mCase[i], noThreads, &tMulti ) ) <= 0 )
+        {
+            crgDataSetRelease( idSingle );
+            noDiffs++;
+            continue;
+        }
+
+        tTotal += tMulti;
+        noSets++;
+
+        /* --- the threads must not change the result at all --- */
+        diffs  = compareGrids( crgDataSetAccess( idSingle ), crgDataSetAccess( idMulti ) );
+        diffs += !crgCheck( idSingle );
+        diffs += compareNodes( baseId, idSingle, dTolXY, &maxDiff );
+
+        /* --- the data set is written and read as any other --- */
+        sprintf( name, "%s/crgRerender_%d.crg", mOutDir, i );
+        diffs += compareFile( idSingle, name, &maxDiffFile );
+
+        crgMsgPrint( dCrgMsgLevelNotice, "rerenderFile:     %-12s: %6ld x %4ld samples, %9.3f ms with 1 thread, %9.3f ms with %d threads, max. deviation %.3e m (%.3e m from file), %ld differences\n",
+                     mCase[i].name, ( long ) crgDataSetAccess( idSingle )->channelU.info.size, ( long ) crgDataSetAccess( idSingle )->channelV.info.size,
+                     tSingle * 1.0e3, tMulti * 1.0e3, noThreads, maxDiff, maxDiffFile, ( long ) diffs );
+
+        noDiffs += diffs;
+
+        crgMsgSetLevel( dCrgMsgLevelWarn );
+        crgDataSetRelease( idSingle );
+        crgDataSetRelease( idMulti );
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+    }
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    crgDataSetRelease( baseId );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "rerenderFile:     %d resolutions in %.3f ms from one load, %ld differences\n", noSets, tTotal * 1.0e3, ( long ) noDiffs );
+
+    return !noDiffs;
+}
+
+static int
+rerender( int baseId, const RerenderCaseStruct* rc, int noThreads, double* tRender )
+{
+    CrgDataStruct* base = crgDataSetAccess( baseId );
+    double uInc  = rc->uScale * base->channelU.info.inc;
+    double vInc  = 0.0;
+    double vMin  = base->channelV.data[0];
+    double vMax  = base->channelV.data[base->channelV.info.size - 1];
+    double v[5];
+    int    noV   = 0;
+    int    noInt;
+    int    dataSetId;
+
+    if ( rc->vMode == dVRegular )
+    {
+        noInt = ( int ) ( ( base->channelV.info.size - 1 ) * rc->vScale );
+        vInc  = ( vMax - vMin ) / ( noInt < 1 ? 1 : noInt );
+    }
+    else if ( rc->vMode == dVExplicit )
+    {
+        v[0] = vMin;
+        v[1] = vMin + 0.1  * ( vMax - vMin );
+        v[2] = vMin + 0.15 * ( vMax - vMin );
+        v[3] = vMin + 0.6  * ( vMax - vMin );
+        v[4] = vMax;
+        noV  = 5;
+    }
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    crgLoaderSetNoThreads( noThreads );
+
+    *tRender  = getTime();
+    dataSetId = crgDataSetRerender( baseId, uInc, vInc, noV ? v : NULL, noV );
+    *tRender  = getTime() - *tRender;
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    if ( dataSetId <= 0 )
+        crgMsgPrint( dCrgMsgLevelFatal, "rerender: could not re-render data set <%d>.\n", baseId );
+
+    return dataSetId;
+}
+
+static size_t
+compareNodes( int baseId, int dataSetId, double tolXY, double* maxDiff )
+{
+    CrgDataStruct* crgData = crgDataSetAccess( dataSetId );
+    int    cpBase = crgContactPointCreate( baseId );
+    int    cpNew  = crgContactPointCreate( dataSetId );
+    size_t noDiffs = 0;
+    size_t step;
+    size_t iu;
+    size_t iv;
+    double u;
+    double v;
+    double zBase;
+    double zNew;
+    double xBase;
+    double yBase;
+    double xNew;
+    double yNew;
+
+    *maxDiff = 0.0;
+
+    if ( cpBase < 0 || cpNew < 0 )
+        return 1;
+
+    step = crgData->channelU.info.size * crgData->channelV.info.size / dMaxNodes + 1;
+
+    /* --- the nodes of the new grid are evaluated on the source without the float rounding of the grid --- */
+    for ( iu = 0; iu < crgData->channelU.info.size; iu += step )
+    {
+        u = crgData->channelU.info.first + iu * crgData->channelU.info.inc;
+
+        for ( iv = 0; iv < crgData->channelV.info.size; iv++ )
+        {
+            v = crgData->channelV.data[iv];
+
+            if ( !crgEvaluv2z( cpBase, u, v, &zBase ) || !crgEvaluv2z( cpNew, u, v, &zNew ) )
+            {
+                noDiffs++;
+                continue;
+            }
+
+            /* --- the evaluation returns NaN at nodes next to NaN samples, the new grid takes the node value of the source --- */
+            if ( crgIsNan( &zBase ) || crgIsNan( &zNew ) )
+            {
+                noDiffs += !crgIsNan( &zBase ) && crgIsNanf( &( crgData->channelZ[iv].data[iu] ) );
+                continue;
+            }
+
+            if ( fabs( zNew - zBase ) > *maxDiff )
+                *maxDiff = fabs( zNew - zBase );
+
+            if ( fabs( zNew - zBase ) > dTolZ * ( 1.0 + fabs( zBase ) ) )
+                noDiffs++;
+        }
+
+        /* --- the reference line passes through the same points --- */
+        if ( !crgEvaluv2xy( cpBase, u, 0.0, &xBase, &yBase ) || !crgEvaluv2xy( cpNew, u, 0.0, &xNew, &yNew ) )
+            noDiffs++;
+        else if ( fabs( xNew - xBase ) > tolXY * ( 1.0 + fabs( xBase ) ) || fabs( yNew - yBase ) > tolXY * ( 1.0 + fabs( yBase ) ) )
+            noDiffs++;
+    }
+
+    crgContactPointDelete( cpBase );
+    crgContactPointDelete( cpNew );
+
+    return noDiffs;
+}
+
+static size_t
+compareFile( int dataSetId, const char* name, double* maxDiff )
+{
+    CrgDataStruct* crgData = crgDataSetAccess( dataSetId );
+    CrgDataStruct* loaded;
+    int    loadedId;
+    size_t noDiffs = 0;
+    size_t iu;
+    size_t iv;
+    double dx;
+    double dy;
+    double lost = 0.0;
+
+    *maxDiff = 0.0;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( !crgDataSetWrite( dataSetId, name, dCrgFileFormatBinaryDouble ) || ( loadedId = crgLoaderReadFile( name ) ) <= 0 )
+    {
+        crgMsgSetLevel( dCrgMsgLevelNotice );
+        crgMsgPrint( dCrgMsgLevelFatal, "compareFile: could not write and read <%s>.\n", name );
+        return 1;
+    }
+
+    crgDataSetModifiersApply( loadedId );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    loaded = crgDataSetAccess( loadedId );
+
+    /* --- the grid is written as is, the reference line is integrated from the headings again --- */
+    noDiffs += compareGrids( crgData, loaded );
+
+    for ( iv = 0; iv < crgData->channelV.info.size && !noDiffs; iv++ )
+        noDiffs += fabs( loaded->channelV.data[iv] - crgData->channelV.data[iv] ) > dTolXY * ( 1.0 + fabs( crgData->channelV.data[iv] ) );
+
+    for ( iu = 0; iu < crgData->channelU.info.size && !noDiffs; iu++ )
+    {
+        if ( fabs( loaded->channelX.data[iu] - crgData->channelX.data[iu] ) > *maxDiff )
+            *maxDiff = fabs( loaded->channelX.data[iu] - crgData->channelX.data[iu] );
+
+        if ( fabs( loaded->channelY.data[iu] - crgData->channelY.data[iu] ) > *maxDiff )
+            *maxDiff = fabs( loaded->channelY.data[iu] - crgData->channelY.data[iu] );
+    }
+
+    /* --- the file integrates the headings by the u increment, the polygon loses some length on curves --- */
+    for ( iu = 1; iu < crgData->channelU.info.size; iu++ )
+    {
+        dx    = crgData->channelX.data[iu] - crgData->channelX.data[iu-1];
+        dy    = crgData->channelY.data[iu] - crgData->channelY.data[iu-1];
+        lost += crgData->channelU.info.inc - sqrt( dx * dx + dy * dy );
+    }
+
+    noDiffs += *maxDiff > dTolFile + lost;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    crgDataSetRelease( loadedId );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    remove( name );
+
+    return noDiffs;
+}
+
+static size_t
+compareGrids( CrgDataStruct* a, CrgDataStruct* b )
+{
+    size_t i;
+    size_t noDiffs = 0;
+
+    if ( a->channelV.info.size != b->channelV.info.size || a->channelU.info.size != b->channelU.info.size )
+        return 1;
+
+    for ( i = 0; i < a->channelV.info.size; i++ )
+        if ( memcmp( a->channelZ[i].data, b->channelZ[i].data, a->channelU.info.size * sizeof( float ) ) )
+            noDiffs++;
+
+    return noDiffs;
+}
+
+static double
+getTime( void )
+{
+    struct timeval tme;
+
+    gettimeofday( &tme, 0 );
+
+    return 1.0 * tme.tv_sec + 1.0e-6 * tme.tv_usec;
+}
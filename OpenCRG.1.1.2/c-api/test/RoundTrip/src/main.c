@@ -0,0 +1,349 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              writing data sets in all supported
+ *              file formats and comparing the files
+ *              read back with the original data
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoFormats  4
+#define dMaxPath    1024
+
+/* ====== LOCAL VARIABLES ====== */
+static const char* mFormatName[dNoFormats] = { "KRBI", "KDBI", "LRFI", "LDFI" };
+
+/* relative tolerance of the values read back, compared with the original data */
+static const double mFormatTol[dNoFormats] = { 1.0e-6, 0.0, 1.0e-6, 1.0e-12 };
+
+/* ====== LOCAL METHODS ====== */
+static int roundTrip( const char* filename, const char* prefix );
+static int writeAndRead( int dataSetId, const char* filename, int format, double* tWrite );
+static int compareDataSets( int idA, int idB, double tol, int derived, const char* label );
+static int compareChannel( CrgChannelStruct* a, CrgChannelStruct* b, double tol, const char* name, const char* label );
+static int compareOptions( CrgOptionsStruct* a, CrgOptionsStruct* b, const char* name, const char* label );
+static int compareValue( double a, double b, double tol );
+static double getTime( void );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgRoundTrip [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -o <name>  prefix of the files written (default: crgRoundTrip)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file(s) as input file(s)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    const char* prefix  = "crgRoundTrip";
+    int         noFiles = 0;
+    int         noFailed = 0;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        if ( !strcmp( *argv, "-o" ) && argc )
+        {
+            argv++;
+            argc--;
+            prefix = *argv;
+
+            if ( strlen( prefix ) > dMaxPath - 16 )
+                usage();
+            continue;
+        }
+
+        noFiles++;
+
+        if ( !roundTrip( *argv, prefix ) )
+            noFailed++;
+    }
+
+    if ( !noFiles )
+        usage();
+
+    crgMemRelease();
+
+    if ( noFailed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: %d of %d files could NOT be written and read back identically.\n", noFailed, noFiles );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: all %d files have been written and read back identically.\n", noFiles );
+
+    return 0;
+}
+
+static int
+roundTrip( const char* filename, const char* prefix )
+{
+    char   nameC[dMaxPath];
+    char   nameD[dMaxPath];
+    int    idA;
+    int    idC;
+    int    idD;
+    int    format;
+    int    noDiffs = 0;
+    double tWrite;
+    double tDummy;
+    struct stat fileStat;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( ( idA = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "roundTrip: could not load <%s>.\n", filename );
+        return 0;
+    }
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    crgMsgPrint( dCrgMsgLevelNotice, "roundTrip: file <%s>\n", filename );
+
+    for ( format = 0; format < dNoFormats; format++ )
+    {
+        sprintf( nameC, "%s_1.crg", prefix );
+        sprintf( nameD, "%s_2.crg", prefix );
+
+        /* --- first generation, compared with the original data --- */
+        if ( ( idC = writeAndRead( idA, nameC, format, &tWrite ) ) <= 0 )
+        {
+            noDiffs++;
+            continue;
+        }
+
+        /* --- second generation, must be identical to the first one --- */
+        if ( ( idD = writeAndRead( idC, nameD, format, &tDummy ) ) <= 0 )
+        {
+            crgDataSetRelease( idC );
+            noDiffs++;
+            continue;
+        }
+
+        if ( stat( nameC, &fileStat ) )
+            fileStat.st_size = 0;
+
+        noDiffs += compareDataSets( idA, idC, mFormatTol[format], mFormatTol[format] == 0.0, mFormatName[format] );
+        noDiffs += compareDataSets( idC, idD, 0.0, 1, mFormatName[format] );
+
+        crgMsgPrint( dCrgMsgLevelNotice, "roundTrip:     %s: %10.3f MB written in %8.3f ms (%8.1f MB/s)\n",
+                     mFormatName[format], fileStat.st_size / 1048576.0, tWrite * 1.0e3,
+                     tWrite > 0.0 ? fileStat.st_size / 1048576.0 / tWrite : 0.0 );
+
+        crgDataSetRelease( idC );
+        crgDataSetRelease( idD );
+
+        remove( nameC );
+        remove( nameD );
+    }
+
+    crgDataSetRelease( idA );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "roundTrip:     %d differences\n", noDiffs );
+
+    return !noDiffs;
+}
+
+static int
+writeAndRead( int dataSetId, const char* filename, int format, double* tWrite )
+{
+    int    newId;
+    double tStart = getTime();
+
+    if ( !crgDataSetWrite( dataSetId, filename, format ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "writeAndRead: could not write <%s> as %s.\n", filename, mFormatName[format] );
+        return 0;
+    }
+
+    *tWrite = getTime() - tStart;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+    newId = crgLoaderReadFile( filename );
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    if ( newId <= 0 )
+        crgMsgPrint( dCrgMsgLevelFatal, "writeAndRead: could not read <%s> as %s.\n", filename, mFormatName[format] );
+
+    return newId;
+}
+
+static int
+compareDataSets( int idA, int idB, double tol, int derived, const char* label )
+{
+    CrgDataStruct* a = crgDataSetAccess( idA );
+    CrgDataStruct* b = crgDataSetAccess( idB );
+    int            noDiffs = 0;
+    size_t         i;
+    size_t         j;
+
+    noDiffs += compareChannel( &( a->channelV ),     &( b->channelV ),     tol, "v",     label );
+    noDiffs += compareChannel( &( a->channelU ),     &( b->channelU ),     tol, "u",     label );
+    noDiffs += compareChannel( &( a->channelPhi ),   &( b->channelPhi ),   tol, "phi",   label );
+    noDiffs += compareChannel( &( a->channelSlope ), &( b->channelSlope ), tol, "slope", label );
+    noDiffs += compareChannel( &( a->channelBank ),  &( b->channelBank ),  tol, "bank",  label );
+
+    /* --- channels integrated from the values read accumulate their deviations --- */
+    if ( derived || a->channelX.info.defined )
+    {
+        noDiffs += compareChannel( &( a->channelX ), &( b->channelX ), tol, "x", label );
+        noDiffs += compareChannel( &( a->channelY ), &( b->channelY ), tol, "y", label );
+    }
+
+    if ( derived )
+        noDiffs += compareChannel( &( a->channelRefZ ), &( b->channelRefZ ), tol, "z", label );
+
+    if ( a->channelV.info.size != b->channelV.info.size )
+        return noDiffs + 1;
+
+    for ( i = 0; i < a->channelV.info.size; i++ )
+    {
+        if ( a->channelZ[i].info.size != b->channelZ[i].info.size )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "compareDataSets: %s: size of long section %lu differs.\n", label, ( unsigned long ) i );
+            noDiffs++;
+            continue;
+        }
+
+        for ( j = 0; j < a->channelZ[i].info.size; j++ )
+        {
+            double za;
+            double zb;
+
+            if ( crgIsNanf( &( a->channelZ[i].data[j] ) ) )
+                crgSetNan( &za );
+            else
+                za = a->channelZ[i].data[j];
+
+            if ( crgIsNanf( &( b->channelZ[i].data[j] ) ) )
+                crgSetNan( &zb );
+            else
+                zb = b->channelZ[i].data[j];
+
+            if ( !compareValue( za, zb, tol ) )
+            {
+                crgMsgPrint( dCrgMsgLevelWarn, "compareDataSets: %s: z[%lu][%lu] differs: %.9g vs. %.9g.\n",
+                             label, ( unsigned long ) i, ( unsigned long ) j, za, zb );
+                noDiffs++;
+                break;
+            }
+        }
+    }
+
+    noDiffs += compareOptions( &( a->options ),   &( b->options ),   "options",   label );
+    noDiffs += compareOptions( &( a->modifiers ), &( b->modifiers ), "modifiers", label );
+
+    return noDiffs;
+}
+
+static int
+compareChannel( CrgChannelStruct* a, CrgChannelStruct* b, double tol, const char* name, const char* label )
+{
+    size_t i;
+
+    if ( a->info.size != b->info.size || ( !a->data != !b->data ) ||
+         !compareValue( a->info.first, b->info.first, tol ) ||
+         !compareValue( a->info.last,  b->info.last,  tol ) ||
+         !compareValue( a->info.inc,   b->info.inc,   tol ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "compareChannel: %s: channel %s differs: size %lu vs. %lu, range %.17g..%.17g vs. %.17g..%.17g\n",
+                     label, name, ( unsigned long ) a->info.size, ( unsigned long ) b->info.size, a->info.first, a->info.last, b->info.first, b->info.last );
+        return 1;
+    }
+
+    if ( !a->data )
+        return 0;
+
+    for ( i = 0; i < a->info.size; i++ )
+    {
+        if ( !compareValue( a->data[i], b->data[i], tol ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "compareChannel: %s: channel %s differs at %lu: %.17g vs. %.17g\n",
+                         label, name, ( unsigned long ) i, a->data[i], b->data[i] );
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+compareOptions( CrgOptionsStruct* a, CrgOptionsStruct* b, const char* name, const char* label )
+{
+    unsigned int i;
+    unsigned int noEntries = ( a->noEntries > b->noEntries ) ? a->noEntries : b->noEntries;
+
+    for ( i = 0; i < noEntries; i++ )
+    {
+        CrgOptionEntryStruct* ea = ( i < a->noEntries && a->entry[i].valid ) ? &( a->entry[i] ) : NULL;
+        CrgOptionEntryStruct* eb = ( i < b->noEntries && b->entry[i].valid ) ? &( b->entry[i] ) : NULL;
+
+        if ( !ea && !eb )
+            continue;
+
+        if ( !ea || !eb || ea->id != eb->id || ea->iValue != eb->iValue || ea->dValue != eb->dValue )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "compareOptions: %s: %s differ at entry %u.\n", label, name, i );
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+compareValue( double a, double b, double tol )
+{
+    if ( crgIsNan( &a ) || crgIsNan( &b ) )
+        return crgIsNan( &a ) && crgIsNan( &b );
+
+    return fabs( a - b ) <= tol * ( fabs( a ) > 1.0 ? fabs( a ) : 1.0 );
+}
+
+static double
+getTime( void )
+{
+    struct timeval tme;
+
+    gettimeofday( &tme, 0 );
+
+    return 1.0 * tme.tv_sec + 1.0e-6 * tme.tv_usec;
+}
@@ -0,0 +1,472 @@
+/* ===================================================
+ *  file:       main.c
+ * ---------------------------------------------------
+ *  purpose:    main program for CRG test program
+ *              creating views of data sets and
+ *              appending data sets, comparing the
+ *              results with the evaluation of the
+ *              sources and reporting the memory usage
+ * ---------------------------------------------------
+ *  first edit: 17.10.2026 by OpenCRG contributors
+ * ===================================================
+    Copyright 2014 VIRES Simulationstechnologie GmbH
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dMaxPoints      200000  /* maximum number of points compared per data set */
+#define dFracU          0.37    /* position of the points within the u intervals                 [-] */
+#define dFracV          0.41    /* position of the points within the v intervals                 [-] */
+#define dTolZ           1.0e-9  /* relative tolerance of z of a view, the grid is the same       [-] */
+#define dTolZCopy       1.0e-6  /* relative tolerance of z of a copy, the grid is stored as float [-] */
+#define dTolXY          1.0e-9  /* relative tolerance of x and y                                 [-] */
+#define dTolDist        1.0e-6  /* relative tolerance of distances on an appended data set       [-] */
+
+/* ====== LOCAL METHODS ====== */
+static int viewFile( const char* filename );
+static int createView( int dataSetId, int iuBeg, int iuEnd, int ivBeg, int ivEnd );
+static size_t compareView( int baseId, int dataSetId, double tolZ, double* maxDiff );
+static size_t compareAppended( int baseId, int dataSetId, double* maxDiff );
+static size_t dataSetBytes( int dataSetId );
+static double getTime( void );
+
+void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgViewAppend [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file(s) as input file(s)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    int noFiles  = 0;
+    int noFailed = 0;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    argc--;
+
+    while( argc )
+    {
+        argv++;
+        argc--;
+
+        if ( !strcmp( *argv, "-h" ) )
+            usage();
+
+        noFiles++;
+
+        if ( !viewFile( *argv ) )
+            noFailed++;
+    }
+
+    if ( !noFiles )
+        usage();
+
+    crgMemRelease();
+
+    if ( noFailed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: %d of %d files could NOT be viewed and appended correctly.\n", noFailed, noFiles );
+        return -1;
+    }
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: all %d files have been viewed and appended correctly.\n", noFiles );
+
+    return 0;
+}
+
+static int
+viewFile( const char* filename )
+{
+    CrgDataStruct* base;
+    int    baseId;
+    int    ids[2];
+    int    viewId;
+    int    innerId;
+    int    copyId;
+    int    firstId = 0;
+    int    secondId = 0;
+    int    joinedId = 0;
+    int    twiceId;
+    int    nu;
+    int    nv;
+    int    iuBeg;
+    int    iuEnd;
+    int    ivBeg;
+    int    ivEnd;
+    size_t noDiffs = 0;
+    double maxView;
+    double maxInner;
+    double maxCopy;
+    double maxJoined = 0.0;
+    double maxTwice;
+    double tView;
+    double tCopy;
+    double tAppend;
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( ( baseId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "viewFile: could not load <%s>.\n", filename );
+        return 0;
+    }
+
+    crgDataSetModifiersApply( baseId );
+
+    base = crgDataSetAccess( baseId );
+    nu   = ( int ) base->channelU.info.size;
+    nv   = ( int ) base->channelV.info.size;
+
+    /* --- the central half of the data set, and the inner part of it --- */
+    iuBeg = ( nu - 1 ) / 4;
+    iuEnd = nu - 1 - ( nu - 1 ) / 4;
+    ivBeg = ( nv - 1 ) / 4;
+    ivEnd = nv - 1 - ( nv - 1 ) / 4;
+
+    tView  = getTime();
+    viewId = createView( baseId, iuBeg, iuEnd, ivBeg, ivEnd );
+    tView  = getTime() - tView;
+
+    if ( viewId <= 0 )
+    {
+        crgDataSetRelease( baseId );
+        return 0;
+    }
+
+    innerId = createView( viewId, iuEnd - iuBeg > 2 ? 1 : 0, iuEnd - iuBeg > 2 ? iuEnd - iuBeg - 1 : iuEnd - iuBeg,
+                                  ivEnd - ivBeg > 2 ? 1 : 0, ivEnd - ivBeg > 2 ? ivEnd - ivBeg - 1 : ivEnd - ivBeg );
+
+    /* --- a single data set is copied --- */
+    tCopy  = getTime();
+    copyId = crgDataSetAppend( &baseId, 1 );
+    tCopy  = getTime() - tCopy;
+
+    /* --- the halves of the data set are joined again --- */
+    if ( nu > 2 )
+    {
+        firstId  = createView( baseId, 0, ( nu - 1 ) / 2, 0, nv - 1 );
+        secondId = createView( baseId, ( nu - 1 ) / 2, nu - 1, 0, nv - 1 );
+        ids[0]   = firstId;
+        ids[1]   = secondId;
+
+        if ( firstId > 0 && secondId > 0 )
+            joinedId = crgDataSetAppend( ids, 2 );
+
+        noDiffs += joinedId <= 0;
+    }
+
+    ids[0]  = baseId;
+    ids[1]  = baseId;
+    tAppend = getTime();
+    twiceId = crgDataSetAppend( ids, 2 );
+    tAppend = getTime() - tAppend;
+
+    if ( innerId <= 0 || copyId <= 0 || twiceId <= 0 )
+        noDiffs++;
+
+    /* --- the grid is shared with the views, so the data set must not be released --- */
+    crgMsgSetLevel( dCrgMsgLevelFatal );
+    noDiffs += crgDataSetRelease( baseId ) != 0;
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    noDiffs += !crgCheck( viewId );
+    noDiffs += compareView( baseId, viewId, dTolZ, &maxView );
+
+    if ( innerId > 0 )
+        noDiffs += !crgCheck( innerId ) + compareView( baseId, innerId, dTolZ, &maxInner );
+
+    if ( copyId > 0 )
+        noDiffs += !crgCheck( copyId ) + compareView( baseId, copyId, dTolZCopy, &maxCopy );
+
+    if ( joinedId > 0 )
+        noDiffs += !crgCheck( joinedId ) + compareView( baseId, joinedId, dTolZCopy, &maxJoined );
+
+    if ( twiceId > 0 )
+        noDiffs += !crgCheck( twiceId ) + compareAppended( baseId, twiceId, &maxTwice );
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+    crgMsgPrint( dCrgMsgLevelNotice, "viewFile: file <%s>, %d x %d samples\n", filename, nu, nv );
+    crgMsgPrint( dCrgMsgLevelNotice, "viewFile:     source:  %10ld bytes\n", ( long ) dataSetBytes( baseId ) );
+    crgMsgPrint( dCrgMsgLevelNotice, "viewFile:     view:    %10ld bytes, %4ld x %4ld samples in %9.3f ms, max. deviation %.3e m\n",
+                 ( long ) dataSetBytes( viewId ), ( long ) crgDataSetAccess( viewId )->channelU.info.size,
+                 ( long ) crgDataSetAccess( viewId )->channelV.info.size, tView * 1.0e3, maxView );
+
+    if ( innerId > 0 )
+        crgMsgPrint( dCrgMsgLevelNotice, "viewFile:     inner:   %10ld bytes, view of the view, max. deviation %.3e m\n",
+                     ( long ) dataSetBytes( innerId ), maxInner );
+
+    if ( copyId > 0 )
+        crgMsgPrint( dCrgMsgLevelNotice, "viewFile:     copy:    %10ld bytes, %9.3f ms, max. deviation %.3e m\n",
+                     ( long ) dataSetBytes( copyId ), tCopy * 1.0e3, maxCopy );
+
+    if ( joinedId > 0 )
+        crgMsgPrint( dCrgMsgLevelNotice, "viewFile:     halves:  %10ld bytes, appended from two views, max. deviation %.3e m\n",
+                     ( long ) dataSetBytes( joinedId ), maxJoined );
+
+    if ( twiceId > 0 )
+        crgMsgPrint( dCrgMsgLevelNotice, "viewFile:     twice:   %10ld bytes, %9.3f ms, max. deviation %.3e m\n",
+                     ( long ) dataSetBytes( twiceId ), tAppend * 1.0e3, maxTwice );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "viewFile:     %ld differences\n", ( long ) noDiffs );
+
+    /* --- views before the data set they refer to --- */
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( innerId > 0 )
+        crgDataSetRelease( innerId );
+
+    if ( firstId > 0 )
+        crgDataSetRelease( firstId );
+
+    if ( secondId > 0 )
+        crgDataSetRelease( secondId );
+
+    if ( joinedId > 0 )
+        crgDataSetRelease( joinedId );
+
+    if ( copyId > 0 )
+        crgDataSetRelease( copyId );
+
+    if ( twiceId > 0 )
+        crgDataSetRelease( twiceId );
+
+    crgDataSetRelease( viewId );
+    noDiffs += !crgDataSetRelease( baseId );
+
+    crgMsgSetLevel( dCrgMsgLevelNotice );
+
+    return !noDiffs;
+}
+
+static int
+createView( int dataSetId, int iuBeg, int iuEnd, int ivBeg, int ivEnd )
+{
+    int viewId = crgDataSetCreateView( dataSetId, iuBeg, iuEnd, ivBeg, ivEnd );
+
+    if ( viewId <= 0 )
+        crgMsgPrint( dCrgMsgLevelFatal, "createView: could not create view [%d, %d] x [%d, %d] of data set <%d>.\n",
+                     iuBeg, iuEnd, ivBeg, ivEnd, dataSetId );
+
+    return viewId;
+}
+
+static size_t
+compareView( int baseId, int dataSetId, double tolZ, double* maxDiff )
+{
+    CrgDataStruct* crgData = crgDataSetAccess( dataSetId );
+    int    cpBase  = crgContactPointCreate( baseId );
+    int    cpNew   = crgContactPointCreate( dataSetId );
+    size_t noDiffs = 0;
+    size_t step;
+    size_t iu;
+    size_t iv;
+    double u;
+    double v;
+    double zBase;
+    double zNew;
+    double xBase;
+    double yBase;
+    double xNew;
+    double yNew;
+
+    *maxDiff = 0.0;
+
+    if ( cpBase < 0 || cpNew < 0 )
+        return 1;
+
+    step = crgData->channelU.info.size * crgData->channelV.info.size / dMaxPoints + 1;
+
+    /* --- points between the nodes, so that both data sets use the same cells --- */
+    for ( iu = 0; iu < crgData->channelU.info.size - 1; iu += step )
+    {
+        u = crgData->channelU.info.first + ( iu + dFracU ) * crgData->channelU.info.inc;
+
+        for ( iv = 0; iv < crgData->channelV.info.size - 1; iv++ )
+        {
+            v = crgData->channelV.data[iv] + dFracV * ( crgData->channelV.data[iv+1] - crgData->channelV.data[iv] );
+
+            if ( !crgEvaluv2z( cpBase, u, v, &zBase ) || !crgEvaluv2z( cpNew, u, v, &zNew ) )
+            {
+                noDiffs++;
+                continue;
+            }
+
+            if ( crgIsNan( &zBase ) || crgIsNan( &zNew ) )
+            {
+                noDiffs += !crgIsNan( &zBase ) || !crgIsNan( &zNew );
+                continue;
+            }
+
+            if ( fabs( zNew - zBase ) > *maxDiff )
+                *maxDiff = fabs( zNew - zBase );
+
+            if ( fabs( zNew - zBase ) > tolZ * ( 1.0 + fabs( zBase ) ) )
+                noDiffs++;
+        }
+
+        /* --- the reference line passes through the same points --- */
+        if ( !crgEvaluv2xy( cpBase, u, 0.0, &xBase, &yBase ) || !crgEvaluv2xy( cpNew, u, 0.0, &xNew, &yNew ) )
+            noDiffs++;
+        else if ( fabs( xNew - xBase ) > dTolXY * ( 1.0 + fabs( xBase ) ) || fabs( yNew - yBase ) > dTolXY * ( 1.0 + fabs( yBase ) ) )
+            noDiffs++;
+    }
+
+    crgContactPointDelete( cpBase );
+    crgContactPointDelete( cpNew );
+
+    return noDiffs;
+}
+
+static size_t
+compareAppended( int baseId, int dataSetId, double* maxDiff )
+{
+    CrgDataStruct* base = crgDataSetAccess( baseId );
+    int    cpBase  = crgContactPointCreate( baseId );
+    int    cpNew   = crgContactPointCreate( dataSetId );
+    size_t noDiffs = 0;
+    size_t step;
+    size_t iu;
+    size_t iv;
+    double shift   = ( base->channelU.info.size - 1 ) * base->channelU.info.inc;
+    double uRef    = 0.5 * ( base->channelU.info.first + base->channelU.info.last );
+    double dz      = 0.0;
+    int    hasDz   = 0;
+    double u;
+    double v;
+    double zBase;
+    double zNew;
+    double xRef[2];
+    double yRef[2];
+    double xBase;
+    double yBase;
+    double xNew;
+    double yNew;
+    double dBase;
+    double dNew;
+
+    *maxDiff = 0.0;
+
+    if ( cpBase < 0 || cpNew < 0 )
+        return 1;
+
+    if ( !crgEvaluv2xy( cpBase, uRef, 0.0, &xRef[0], &yRef[0] ) || !crgEvaluv2xy( cpNew, uRef + shift, 0.0, &xRef[1], &yRef[1] ) )
+        return 1;
+
+    step = base->channelU.info.size * base->channelV.info.size / dMaxPoints + 1;
+
+    /* --- the second copy is moved, turned and shifted in z; the first and last intervals neighbour other segments --- */
+    for ( iu = 1; iu + 2 < base->channelU.info.size; iu += step )
+    {
+        u = base->channelU.info.first + ( iu + dFracU ) * base->channelU.info.inc;
+
+        for ( iv = 0; iv < base->channelV.info.size - 1; iv++ )
+        {
+            v = base->channelV.data[iv] + dFracV * ( base->channelV.data[iv+1] - base->channelV.data[iv] );
+
+            if ( !crgEvaluv2z( cpBase, u, v, &zBase ) || !crgEvaluv2z( cpNew, u + shift, v, &zNew ) ||
+                 !crgEvaluv2xy( cpBase, u, v, &xBase, &yBase ) || !crgEvaluv2xy( cpNew, u + shift, v, &xNew, &yNew ) )
+            {
+                noDiffs++;
+                continue;
+            }
+
+            /* --- distances within the copy are kept --- */
+            dBase = sqrt( ( xBase - xRef[0] ) * ( xBase - xRef[0] ) + ( yBase - yRef[0] ) * ( yBase - yRef[0] ) );
+            dNew  = sqrt( ( xNew  - xRef[1] ) * ( xNew  - xRef[1] ) + ( yNew  - yRef[1] ) * ( yNew  - yRef[1] ) );
+
+            if ( fabs( dNew - dBase ) > dTolDist * ( 1.0 + dBase ) )
+                noDiffs++;
+
+            if ( crgIsNan( &zBase ) || crgIsNan( &zNew ) )
+            {
+                noDiffs += !crgIsNan( &zBase ) || !crgIsNan( &zNew );
+                continue;
+            }
+
+            /* --- elevations differ by a constant --- */
+            if ( !hasDz )
+            {
+                dz    = zNew - zBase;
+                hasDz = 1;
+            }
+
+            if ( fabs( zNew - zBase - dz ) > *maxDiff )
+                *maxDiff = fabs( zNew - zBase - dz );
+
+            if ( fabs( zNew - zBase - dz ) > dTolZCopy * ( 1.0 + fabs( zBase ) + fabs( dz ) ) )
+                noDiffs++;
+        }
+    }
+
+    crgContactPointDelete( cpBase );
+    crgContactPointDelete( cpNew );
+
+    return noDiffs;
+}
+
+static size_t
+dataSetBytes( int dataSetId )
+{
+    CrgDataStruct* crgData = crgDataSetAccess( dataSetId );
+    CrgChannelStruct* channels[7];
+    size_t bytes;
+    size_t i;
+
+    if ( !crgData )
+        return 0;
+
+    channels[0] = &( crgData->channelV );
+    channels[1] = &( crgData->channelX );
+    channels[2] = &( crgData->channelY );
+    channels[3] = &( crgData->channelPhi );
+    channels[4] = &( crgData->channelSlope );
+    channels[5] = &( crgData->channelBank );
+    channels[6] = &( crgData->channelRefZ );
+
+    /* --- the data set itself, the channels of the reference line and the table of the long sections --- */
+    bytes = sizeof( CrgDataStruct ) + ( crgData->channelV.info.size + 1 ) * sizeof( CrgChannelFStruct );
+
+    for ( i = 0; i < 7; i++ )
+        if ( channels[i]->data )
+            bytes += channels[i]->info.size * sizeof( double );
+
+    /* --- the grid, unless it is referred to --- */
+    if ( !crgData->admin.viewOwner )
+        bytes += crgData->channelU.info.size * crgData->channelV.info.size * sizeof( float );
+
+    return bytes;
+}
+
+static double
+getTime( void )
+{
+    struct timeval tme;
+
+    gettimeofday( &tme, 0 );
+
+    return 1.0 * tme.tv_sec + 1.0e-6 * tme.tv_usec;
+}